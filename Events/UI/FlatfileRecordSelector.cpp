@@ -0,0 +1,781 @@
+/* *****************************************************************************
+Copyright (c) 2016-2021, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+// Written by: Stevan Gavrilovic
+
+#include "FlatfileRecordSelector.h"
+#include "CSVReaderWriter.h"
+
+#include <QHash>
+#include <QtConcurrent/QtConcurrent>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+FlatfileRecordSelector::FlatfileRecordSelector()
+{
+    rsnColumnName = "Record Sequence Number";
+    magnitudeColumnName = "Earthquake Magnitude";
+    distanceColumnName = "ClstD (km)";
+    vs30ColumnName = "Vs30 (m/s) selected for analysis";
+}
+
+
+void FlatfileRecordSelector::setColumnNames(const QString& recordSequenceNumber, const QString& magnitude, const QString& distance, const QString& vs30)
+{
+    rsnColumnName = recordSequenceNumber;
+    magnitudeColumnName = magnitude;
+    distanceColumnName = distance;
+    vs30ColumnName = vs30;
+}
+
+
+int FlatfileRecordSelector::loadFlatfile(const QString& pathToFlatfile, const QString& pathToSpectraTable, QString& err)
+{
+    this->clear();
+
+    CSVReaderWriter csvTool;
+
+    auto flatfileData = csvTool.parseCSVFile(pathToFlatfile, err);
+
+    if(!err.isEmpty())
+        return -1;
+
+    if(flatfileData.size() < 2)
+    {
+        err = "Error, the flatfile "+pathToFlatfile+" does not contain any records";
+        return -1;
+    }
+
+    const auto& header = flatfileData.first();
+
+    auto rsnCol = header.indexOf(rsnColumnName);
+    auto magCol = header.indexOf(magnitudeColumnName);
+    auto distCol = header.indexOf(distanceColumnName);
+    auto vs30Col = header.indexOf(vs30ColumnName);
+
+    if(rsnCol == -1 || magCol == -1 || distCol == -1 || vs30Col == -1)
+    {
+        err = "Error, the flatfile "+pathToFlatfile+" must contain the columns '"+rsnColumnName+"', '"+magnitudeColumnName+"', '"+distanceColumnName+"' and '"+vs30ColumnName+"'";
+        return -1;
+    }
+
+    const auto numRows = flatfileData.size() - 1;
+
+    QVector<int> metadataIDs;
+    metadataIDs.reserve(numRows);
+    magnitudes.reserve(numRows);
+    distances.reserve(numRows);
+    vs30s.reserve(numRows);
+
+    // Missing metadata is stored as NaN, such records are only excluded by the bounds on that quantity
+    auto toDouble = [](const QString& str)
+    {
+        bool OK = false;
+        auto val = str.toDouble(&OK);
+
+        return OK ? val : std::numeric_limits<double>::quiet_NaN();
+    };
+
+    for(int i = 1; i<flatfileData.size(); ++i)
+    {
+        const auto& row = flatfileData.at(i);
+
+        if(row.size() != header.size())
+        {
+            err = "Error, the number of columns in row "+QString::number(i+1)+" of the flatfile does not match the number of columns in the header";
+            this->clear();
+            return -1;
+        }
+
+        bool OK = false;
+        auto rsn = row.at(rsnCol).toInt(&OK);
+
+        if(!OK)
+        {
+            err = "Error, could not convert the record sequence number '"+row.at(rsnCol)+"' in row "+QString::number(i+1)+" of the flatfile to an integer";
+            this->clear();
+            return -1;
+        }
+
+        metadataIDs.append(rsn);
+        magnitudes.append(toDouble(row.at(magCol)));
+        distances.append(toDouble(row.at(distCol)));
+        vs30s.append(toDouble(row.at(vs30Col)));
+    }
+
+    QVector<int> spectraIDs;
+
+    if(pathToSpectraTable.isEmpty())
+    {
+        if(this->loadSpectra(flatfileData, rsnCol, 1, spectraIDs, err) != 0)
+        {
+            this->clear();
+            return -1;
+        }
+    }
+    else
+    {
+        // Release the metadata before parsing the spectra
+        flatfileData.clear();
+
+        auto spectraData = csvTool.parseCSVFile(pathToSpectraTable, err);
+
+        if(!err.isEmpty())
+        {
+            this->clear();
+            return -1;
+        }
+
+        if(this->loadSpectra(spectraData, 0, 1, spectraIDs, err) != 0)
+        {
+            this->clear();
+            return -1;
+        }
+    }
+
+    // Line up the metadata with the rows of the spectra, the records without spectra are dropped
+    QHash<int, int> metadataRows;
+    metadataRows.reserve(metadataIDs.size());
+
+    for(int i = 0; i<metadataIDs.size(); ++i)
+        metadataRows.insert(metadataIDs.at(i), i);
+
+    const auto numPeriods = periods.size();
+
+    QVector<double> alignedMagnitudes, alignedDistances, alignedVs30s;
+    alignedMagnitudes.reserve(spectraIDs.size());
+    alignedDistances.reserve(spectraIDs.size());
+    alignedVs30s.reserve(spectraIDs.size());
+
+    int numKept = 0;
+    for(int i = 0; i<spectraIDs.size(); ++i)
+    {
+        auto it = metadataRows.constFind(spectraIDs.at(i));
+
+        if(it == metadataRows.constEnd())
+            continue;
+
+        alignedMagnitudes.append(magnitudes.at(it.value()));
+        alignedDistances.append(distances.at(it.value()));
+        alignedVs30s.append(vs30s.at(it.value()));
+
+        recordSequenceNumbers.append(spectraIDs.at(i));
+
+        if(numKept != i)
+            std::copy(lnSpectra.cbegin() + i*numPeriods, lnSpectra.cbegin() + (i+1)*numPeriods, lnSpectra.begin() + numKept*numPeriods);
+
+        ++numKept;
+    }
+
+    lnSpectra.resize(numKept*numPeriods);
+    magnitudes = alignedMagnitudes;
+    distances = alignedDistances;
+    vs30s = alignedVs30s;
+
+    if(numKept == 0)
+    {
+        err = "Error, none of the records in the spectra table were found in the flatfile";
+        this->clear();
+        return -1;
+    }
+
+    return 0;
+}
+
+
+int FlatfileRecordSelector::loadSpectra(const QVector<QStringList>& data, const int idColumn, const int firstRow, QVector<int>& ids, QString& err)
+{
+    const auto& header = data.first();
+
+    QVector<int> periodColumns;
+
+    for(int j = 0; j<header.size(); ++j)
+    {
+        if(j == idColumn)
+            continue;
+
+        auto period = parsePeriod(header.at(j));
+
+        if(period < 0.0)
+            continue;
+
+        periodColumns.append(j);
+        periods.append(period);
+    }
+
+    if(periodColumns.isEmpty())
+    {
+        err = "Error, could not find any spectral acceleration columns, the headers of these columns should be the period, e.g., 0.2 or T0.200S";
+        return -1;
+    }
+
+    for(int j = 1; j<periods.size(); ++j)
+    {
+        if(periods.at(j) <= periods.at(j-1))
+        {
+            err = "Error, the periods of the spectral acceleration columns must be unique and in ascending order";
+            return -1;
+        }
+    }
+
+    const auto numPeriods = periods.size();
+    const auto numRecords = data.size() - firstRow;
+
+    ids.reserve(numRecords);
+    lnSpectra.fill(std::numeric_limits<double>::quiet_NaN(), numRecords*numPeriods);
+
+    for(int i = firstRow; i<data.size(); ++i)
+    {
+        const auto& row = data.at(i);
+
+        if(row.size() != header.size())
+        {
+            err = "Error, the number of columns in row "+QString::number(i+1)+" of the spectra does not match the number of columns in the header";
+            return -1;
+        }
+
+        bool OK = false;
+        auto rsn = row.at(idColumn).toInt(&OK);
+
+        if(!OK)
+        {
+            err = "Error, could not convert the record sequence number '"+row.at(idColumn)+"' in row "+QString::number(i+1)+" of the spectra to an integer";
+            return -1;
+        }
+
+        ids.append(rsn);
+
+        auto rowPtr = lnSpectra.data() + (i-firstRow)*numPeriods;
+
+        for(int j = 0; j<numPeriods; ++j)
+        {
+            auto sa = row.at(periodColumns.at(j)).toDouble(&OK);
+
+            // Missing and non-positive values stay NaN, the records with NaN at the target periods are not selected
+            if(OK && sa > 0.0)
+                rowPtr[j] = std::log(sa);
+        }
+    }
+
+    return 0;
+}
+
+
+int FlatfileRecordSelector::setRecords(const QVector<int>& recordSequenceNumbers, const QVector<double>& magnitudes, const QVector<double>& distances, const QVector<double>& vs30s,
+                                       const QVector<double>& periods, const QVector<double>& spectra, QString& err)
+{
+    this->clear();
+
+    const auto numRecords = recordSequenceNumbers.size();
+
+    if(magnitudes.size() != numRecords || distances.size() != numRecords || vs30s.size() != numRecords)
+    {
+        err = "Error, the metadata columns must have one value for each record";
+        return -1;
+    }
+
+    if(periods.isEmpty() || spectra.size() != numRecords*periods.size())
+    {
+        err = "Error, the spectra must have a row for each record and a column for each period";
+        return -1;
+    }
+
+    for(int j = 1; j<periods.size(); ++j)
+    {
+        if(periods.at(j) <= periods.at(j-1))
+        {
+            err = "Error, the periods of the spectra must be unique and in ascending order";
+            return -1;
+        }
+    }
+
+    this->recordSequenceNumbers = recordSequenceNumbers;
+    this->magnitudes = magnitudes;
+    this->distances = distances;
+    this->vs30s = vs30s;
+    this->periods = periods;
+
+    lnSpectra.resize(spectra.size());
+
+    for(int i = 0; i<spectra.size(); ++i)
+        lnSpectra[i] = spectra.at(i) > 0.0 ? std::log(spectra.at(i)) : std::numeric_limits<double>::quiet_NaN();
+
+    return 0;
+}
+
+
+int FlatfileRecordSelector::selectRecords(const RecordSelectionCriteria& criteria, QVector<SelectedRecord>& selectedRecords, QString& err) const
+{
+    selectedRecords.clear();
+
+    if(recordSequenceNumbers.isEmpty())
+    {
+        err = "Error, there are no records to select from, load a flatfile first";
+        return -1;
+    }
+
+    const auto& targetPeriods = criteria.targetPeriods;
+    const auto& targetSpectrum = criteria.targetSpectrum;
+
+    if(targetPeriods.isEmpty() || targetPeriods.size() != targetSpectrum.size())
+    {
+        err = "Error, the target spectrum must have a spectral acceleration for each target period";
+        return -1;
+    }
+
+    if(!criteria.weights.isEmpty() && criteria.weights.size() != targetPeriods.size())
+    {
+        err = "Error, the number of weights must be equal to the number of target periods";
+        return -1;
+    }
+
+    for(int i = 0; i<targetPeriods.size(); ++i)
+    {
+        if(targetPeriods.at(i) <= 0.0 || targetSpectrum.at(i) <= 0.0)
+        {
+            err = "Error, the periods and the spectral accelerations of the target spectrum must be greater than zero";
+            return -1;
+        }
+
+        if(i > 0 && targetPeriods.at(i) <= targetPeriods.at(i-1))
+        {
+            err = "Error, the periods of the target spectrum must be unique and in ascending order";
+            return -1;
+        }
+
+        if(!criteria.weights.isEmpty() && criteria.weights.at(i) < 0.0)
+        {
+            err = "Error, the weights of the target periods cannot be negative";
+            return -1;
+        }
+    }
+
+    if(criteria.numRecords <= 0)
+    {
+        err = "Error, the number of records to select must be greater than zero";
+        return -1;
+    }
+
+    if(criteria.scaleRecords && (criteria.maxScaleFactor <= 0.0 || criteria.maxScaleFactor < criteria.minScaleFactor))
+    {
+        err = "Error, the maximum scale factor must be greater than zero and greater than or equal to the minimum scale factor";
+        return -1;
+    }
+
+    // Interpolate the target in log-log space onto the periods of the table that are within the range of the target periods
+    QVector<int> columns;
+    std::vector<double> lnTarget;
+    std::vector<double> weights;
+
+    double sumWeights = 0.0;
+
+    for(int j = 0; j<periods.size(); ++j)
+    {
+        const auto period = periods.at(j);
+
+        if(period < targetPeriods.first() || period > targetPeriods.last())
+            continue;
+
+        auto upper = std::lower_bound(targetPeriods.cbegin(), targetPeriods.cend(), period) - targetPeriods.cbegin();
+
+        double lnSa = 0.0;
+        double weight = 1.0;
+
+        if(targetPeriods.at(upper) == period)
+        {
+            lnSa = std::log(targetSpectrum.at(upper));
+
+            if(!criteria.weights.isEmpty())
+                weight = criteria.weights.at(upper);
+        }
+        else
+        {
+            const auto lower = upper - 1;
+
+            const double t = (std::log(period) - std::log(targetPeriods.at(lower)))/(std::log(targetPeriods.at(upper)) - std::log(targetPeriods.at(lower)));
+
+            lnSa = (1.0 - t)*std::log(targetSpectrum.at(lower)) + t*std::log(targetSpectrum.at(upper));
+
+            if(!criteria.weights.isEmpty())
+                weight = (1.0 - t)*criteria.weights.at(lower) + t*criteria.weights.at(upper);
+        }
+
+        if(weight == 0.0)
+            continue;
+
+        columns.append(j);
+        lnTarget.push_back(lnSa);
+        weights.push_back(weight);
+
+        sumWeights += weight;
+    }
+
+    if(columns.isEmpty())
+    {
+        err = "Error, none of the periods of the spectra table are within the range of the target periods, or all of their weights are zero";
+        return -1;
+    }
+
+    for(auto&& it : weights)
+        it /= sumWeights;
+
+    const double lnMinScale = criteria.minScaleFactor > 0.0 ? std::log(criteria.minScaleFactor) : -std::numeric_limits<double>::infinity();
+    const double lnMaxScale = std::log(criteria.maxScaleFactor);
+
+    // A NaN value is outside of the range only if the range is bounded
+    auto inRange = [](const double val, const double min, const double max)
+    {
+        if(std::isnan(val))
+            return std::isinf(min) && min < 0.0 && std::isinf(max) && max > 0.0;
+
+        return val >= min && val <= max;
+    };
+
+    using Candidate = std::pair<double, int>;
+
+    struct Job
+    {
+        int firstRow = 0;
+        int numRows = 0;
+
+        // Max-heap of the best candidates of the block, ordered by misfit
+        std::vector<Candidate> best;
+
+        // The log spectral accelerations of the current record at the target periods
+        std::vector<double> lnSa;
+    };
+
+    const int numRecords = recordSequenceNumbers.size();
+    const int numColumns = columns.size();
+    const int numPeriods = periods.size();
+    const size_t numToSelect = criteria.numRecords;
+
+    const int blockSize = 1024;
+
+    std::vector<Job> jobs;
+    jobs.reserve(numRecords/blockSize + 1);
+
+    for(int firstRow = 0; firstRow<numRecords; firstRow += blockSize)
+    {
+        Job job;
+        job.firstRow = firstRow;
+        job.numRows = std::min(blockSize, numRecords - firstRow);
+
+        jobs.push_back(job);
+    }
+
+    auto evaluateBlock = [&](Job& job)
+    {
+        job.best.reserve(numToSelect+1);
+        job.lnSa.resize(numColumns);
+
+        double* const lnSa = job.lnSa.data();
+
+        for(int i = job.firstRow; i<job.firstRow+job.numRows; ++i)
+        {
+            if(!inRange(magnitudes.at(i), criteria.minMagnitude, criteria.maxMagnitude) ||
+                    !inRange(distances.at(i), criteria.minDistance, criteria.maxDistance) ||
+                    !inRange(vs30s.at(i), criteria.minVs30, criteria.maxVs30))
+                continue;
+
+            // Gather the record at the target periods so that the loops below are contiguous
+            const double* rowPtr = lnSpectra.constData() + static_cast<qint64>(i)*numPeriods;
+
+            bool isValid = true;
+            for(int k = 0; k<numColumns; ++k)
+            {
+                lnSa[k] = rowPtr[columns.at(k)];
+
+                if(std::isnan(lnSa[k]))
+                    isValid = false;
+            }
+
+            if(!isValid)
+                continue;
+
+            double lnScale = 0.0;
+
+            if(criteria.scaleRecords)
+            {
+                for(int k = 0; k<numColumns; ++k)
+                    lnScale += weights[k]*(lnTarget[k] - lnSa[k]);
+
+                lnScale = std::min(std::max(lnScale, lnMinScale), lnMaxScale);
+            }
+
+            double misfit = 0.0;
+
+            switch(criteria.errorMetric)
+            {
+            case RecordSelectionConfig::ErrorMetric::AbsSum:
+                for(int k = 0; k<numColumns; ++k)
+                    misfit += weights[k]*std::fabs(lnTarget[k] - lnSa[k] - lnScale);
+                break;
+            case RecordSelectionConfig::ErrorMetric::RMSE:
+            case RecordSelectionConfig::ErrorMetric::MSE:
+                for(int k = 0; k<numColumns; ++k)
+                {
+                    const double residual = lnTarget[k] - lnSa[k] - lnScale;
+                    misfit += weights[k]*residual*residual;
+                }
+                break;
+            case RecordSelectionConfig::ErrorMetric::MAPE:
+                for(int k = 0; k<numColumns; ++k)
+                    misfit += weights[k]*std::fabs(std::exp(lnSa[k] + lnScale - lnTarget[k]) - 1.0)*100.0;
+                break;
+            }
+
+            if(criteria.errorMetric == RecordSelectionConfig::ErrorMetric::RMSE)
+                misfit = std::sqrt(misfit);
+
+            if(job.best.size() == numToSelect && misfit >= job.best.front().first)
+                continue;
+
+            job.best.emplace_back(misfit, i);
+            std::push_heap(job.best.begin(), job.best.end());
+
+            if(job.best.size() > numToSelect)
+            {
+                std::pop_heap(job.best.begin(), job.best.end());
+                job.best.pop_back();
+            }
+        }
+    };
+
+    QtConcurrent::blockingMap(jobs, evaluateBlock);
+
+    // Merge the best candidates of the blocks, ties are broken by the row so that the selection does not depend on the blocks
+    std::vector<Candidate> candidates;
+
+    for(auto&& job : jobs)
+        candidates.insert(candidates.end(), job.best.cbegin(), job.best.cend());
+
+    const auto numSelected = std::min(candidates.size(), numToSelect);
+
+    std::partial_sort(candidates.begin(), candidates.begin() + numSelected, candidates.end());
+
+    selectedRecords.reserve(numSelected);
+
+    for(size_t i = 0; i<numSelected; ++i)
+    {
+        const auto row = candidates.at(i).second;
+        const double* rowPtr = lnSpectra.constData() + static_cast<qint64>(row)*numPeriods;
+
+        double lnScale = 0.0;
+
+        if(criteria.scaleRecords)
+        {
+            for(int k = 0; k<numColumns; ++k)
+                lnScale += weights[k]*(lnTarget[k] - rowPtr[columns.at(k)]);
+
+            lnScale = std::min(std::max(lnScale, lnMinScale), lnMaxScale);
+        }
+
+        SelectedRecord record;
+        record.recordSequenceNumber = recordSequenceNumbers.at(row);
+        record.scaleFactor = std::exp(lnScale);
+        record.misfit = candidates.at(i).first;
+        record.magnitude = magnitudes.at(row);
+        record.distance = distances.at(row);
+        record.vs30 = vs30s.at(row);
+
+        selectedRecords.append(record);
+    }
+
+    if(selectedRecords.isEmpty())
+    {
+        err = "Error, none of the records satisfy the selection criteria";
+        return -1;
+    }
+
+    return 0;
+}
+
+
+int FlatfileRecordSelector::getNumRecords(void) const
+{
+    return recordSequenceNumbers.size();
+}
+
+
+QVector<double> FlatfileRecordSelector::getPeriods(void) const
+{
+    return periods;
+}
+
+
+void FlatfileRecordSelector::clear(void)
+{
+    recordSequenceNumbers.clear();
+    magnitudes.clear();
+    distances.clear();
+    vs30s.clear();
+    periods.clear();
+    lnSpectra.clear();
+}
+
+
+QStringList FlatfileRecordSelector::getRecordSequenceNumbers(const QVector<SelectedRecord>& selectedRecords)
+{
+    QStringList rsnList;
+    rsnList.reserve(selectedRecords.size());
+
+    for(auto&& it : selectedRecords)
+        rsnList.append(QString::number(it.recordSequenceNumber));
+
+    return rsnList;
+}
+
+
+int FlatfileRecordSelector::saveSelection(const QVector<SelectedRecord>& selectedRecords, const QString& pathToFile, QString& err)
+{
+    QVector<QStringList> data;
+    data.reserve(selectedRecords.size()+1);
+
+    data.append(QStringList({"RSN", "Scale Factor", "Misfit", "Magnitude", "Distance (km)", "Vs30 (m/s)"}));
+
+    for(auto&& it : selectedRecords)
+    {
+        data.append(QStringList({QString::number(it.recordSequenceNumber),
+                                 QString::number(it.scaleFactor),
+                                 QString::number(it.misfit),
+                                 QString::number(it.magnitude),
+                                 QString::number(it.distance),
+                                 QString::number(it.vs30)}));
+    }
+
+    CSVReaderWriter csvTool;
+
+    return csvTool.saveCSVFile(data, pathToFile, err);
+}
+
+
+int FlatfileRecordSelector::writeSyntheticFlatfile(const int numRecords, const QString& pathToFlatfile, const QString& pathToSpectraTable, QString& err, const unsigned int seed)
+{
+    if(numRecords <= 0)
+    {
+        err = "Error, the number of synthetic records must be greater than zero";
+        return -1;
+    }
+
+    std::mt19937 generator(seed);
+    std::uniform_real_distribution<double> magnitudeDist(4.0, 8.0);
+    std::uniform_real_distribution<double> lnDistanceDist(std::log(1.0), std::log(300.0));
+    std::uniform_real_distribution<double> lnVs30Dist(std::log(150.0), std::log(1500.0));
+    std::normal_distribution<double> epsilonDist(0.0, 0.6);
+
+    // 100 periods between 0.01 and 10 s, a count similar to the NGA-West2 spectra
+    const int numPeriods = 100;
+
+    QVector<double> periods(numPeriods);
+    for(int j = 0; j<numPeriods; ++j)
+        periods[j] = 0.01*std::pow(1000.0, static_cast<double>(j)/(numPeriods-1));
+
+    QVector<QStringList> flatfile;
+    flatfile.reserve(numRecords+1);
+    flatfile.append(QStringList({"Record Sequence Number", "Earthquake Magnitude", "ClstD (km)", "Vs30 (m/s) selected for analysis"}));
+
+    QVector<QStringList> spectra;
+    spectra.reserve(numRecords+1);
+
+    QStringList spectraHeader = {"Record Sequence Number"};
+    for(auto&& period : periods)
+        spectraHeader.append("T"+QString::number(period, 'g', 4)+"S");
+
+    spectra.append(spectraHeader);
+
+    for(int i = 0; i<numRecords; ++i)
+    {
+        const double magnitude = magnitudeDist(generator);
+        const double distance = std::exp(lnDistanceDist(generator));
+        const double vs30 = std::exp(lnVs30Dist(generator));
+
+        flatfile.append(QStringList({QString::number(i+1), QString::number(magnitude), QString::number(distance), QString::number(vs30)}));
+
+        // A simple spectral shape whose corner period grows with the magnitude, with a between-record and a smoothly varying within-record residual
+        const double cornerPeriod = std::pow(10.0, 0.5*(magnitude - 6.5));
+        const double lnPga = -1.5 + 0.9*(magnitude - 6.0) - 1.2*std::log(distance + 10.0) + 0.4*std::log(760.0/vs30) + epsilonDist(generator);
+
+        double epsilon = 0.0;
+
+        QStringList row;
+        row.reserve(numPeriods+1);
+        row.append(QString::number(i+1));
+
+        for(auto&& period : periods)
+        {
+            epsilon = 0.9*epsilon + 0.2*epsilonDist(generator);
+
+            const double amplification = 2.5/(1.0 + std::pow(0.15/period, 2.0))/(1.0 + std::pow(period/cornerPeriod, 1.5));
+            const double sa = std::exp(lnPga + epsilon)*std::max(amplification, 1.0e-3);
+
+            row.append(QString::number(sa, 'g', 6));
+        }
+
+        spectra.append(row);
+    }
+
+    CSVReaderWriter csvTool;
+
+    if(csvTool.saveCSVFile(flatfile, pathToFlatfile, err) != 0)
+        return -1;
+
+    if(csvTool.saveCSVFile(spectra, pathToSpectraTable, err) != 0)
+        return -1;
+
+    return 0;
+}
+
+
+double FlatfileRecordSelector::parsePeriod(const QString& header)
+{
+    auto str = header.trimmed();
+
+    // NGA-West2 labels such as T0.010S
+    if(str.startsWith('T', Qt::CaseInsensitive) && str.endsWith('S', Qt::CaseInsensitive))
+        str = str.mid(1, str.size()-2);
+
+    bool OK = false;
+    auto period = str.toDouble(&OK);
+
+    if(!OK || period <= 0.0)
+        return -1.0;
+
+    return period;
+}
@@ -0,0 +1,155 @@
+#ifndef FLATFILERECORDSELECTOR_H
+#define FLATFILERECORDSELECTOR_H
+/* *****************************************************************************
+Copyright (c) 2016-2021, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+// Written by: Stevan Gavrilovic
+
+#include "RecordSelectionConfig.h"
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+#include <limits>
+
+// Bounds and target of a selection, the spectrum is given at the target periods and is interpolated in log-log space onto the periods of the spectra table
+struct RecordSelectionCriteria
+{
+    QVector<double> targetPeriods;
+    QVector<double> targetSpectrum;
+
+    // Optional weight of each target period, equal weights are used if empty
+    QVector<double> weights;
+
+    int numRecords = 30;
+
+    double minMagnitude = -std::numeric_limits<double>::infinity();
+    double maxMagnitude = std::numeric_limits<double>::infinity();
+
+    double minDistance = -std::numeric_limits<double>::infinity();
+    double maxDistance = std::numeric_limits<double>::infinity();
+
+    double minVs30 = -std::numeric_limits<double>::infinity();
+    double maxVs30 = std::numeric_limits<double>::infinity();
+
+    // The optimal scale factor of a record is clamped to these bounds before its misfit is computed
+    double minScaleFactor = 0.0;
+    double maxScaleFactor = std::numeric_limits<double>::infinity();
+
+    // Set to false to compare the records without scaling them
+    bool scaleRecords = true;
+
+    RecordSelectionConfig::ErrorMetric errorMetric = RecordSelectionConfig::ErrorMetric::MSE;
+};
+
+
+struct SelectedRecord
+{
+    int recordSequenceNumber = -1;
+    double scaleFactor = 1.0;
+    double misfit = 0.0;
+
+    double magnitude = 0.0;
+    double distance = 0.0;
+    double vs30 = 0.0;
+};
+
+
+// Offline record selection and scaling against a local NGA-West2 style flatfile
+// The metadata and the spectra of the records are kept in a columnar store with the spectra in a row-major matrix, and the misfit of every candidate
+// record is computed on the thread pool, so that a selection from a database of tens of thousands of records takes a fraction of a second
+// The misfit is computed on the natural logarithm of the spectral accelerations, and the scale factor of a record is the one that minimizes the mean
+// squared error of the logarithms, i.e., the weighted mean of ln(target) - ln(record)
+class FlatfileRecordSelector
+{
+public:
+    FlatfileRecordSelector();
+
+    // Loads the metadata flatfile and the spectra table, both are csv files with a header row
+    // The spectra table has the record sequence number in its first column and one column per period, the header of a period column is either
+    // the period, e.g., 0.2, or the NGA-West2 label, e.g., T0.200S
+    // If the path to the spectra table is empty, the period columns are read from the metadata flatfile
+    int loadFlatfile(const QString& pathToFlatfile, const QString& pathToSpectraTable, QString& err);
+
+    // Names of the metadata columns, the defaults are the column names in the NGA-West2 flatfile
+    void setColumnNames(const QString& recordSequenceNumber, const QString& magnitude, const QString& distance, const QString& vs30);
+
+    // Sets the store directly from columns, the spectra are row-major with a row for each record
+    int setRecords(const QVector<int>& recordSequenceNumbers, const QVector<double>& magnitudes, const QVector<double>& distances, const QVector<double>& vs30s,
+                   const QVector<double>& periods, const QVector<double>& spectra, QString& err);
+
+    // Returns the records with the smallest misfit in ascending order of misfit
+    int selectRecords(const RecordSelectionCriteria& criteria, QVector<SelectedRecord>& selectedRecords, QString& err) const;
+
+    int getNumRecords(void) const;
+
+    QVector<double> getPeriods(void) const;
+
+    void clear(void);
+
+    // The record sequence numbers of a selection in the format that is used to download the records from the PEER database
+    static QStringList getRecordSequenceNumbers(const QVector<SelectedRecord>& selectedRecords);
+
+    static int saveSelection(const QVector<SelectedRecord>& selectedRecords, const QString& pathToFile, QString& err);
+
+    // Writes a synthetic flatfile and spectra table with the given number of records to benchmark the selection
+    static int writeSyntheticFlatfile(const int numRecords, const QString& pathToFlatfile, const QString& pathToSpectraTable, QString& err, const unsigned int seed = 0);
+
+private:
+
+    // Parses the period from the header of a spectra column, returns a negative number if the header is not a period
+    static double parsePeriod(const QString& header);
+
+    int loadSpectra(const QVector<QStringList>& data, const int idColumn, const int firstRow, QVector<int>& ids, QString& err);
+
+    QString rsnColumnName;
+    QString magnitudeColumnName;
+    QString distanceColumnName;
+    QString vs30ColumnName;
+
+    // Columnar store of the records
+    QVector<int> recordSequenceNumbers;
+    QVector<double> magnitudes;
+    QVector<double> distances;
+    QVector<double> vs30s;
+
+    // Natural logarithm of the spectral accelerations, row-major with a row for each record, and NaN where a value is missing or not positive
+    QVector<double> periods;
+    QVector<double> lnSpectra;
+};
+
+#endif // FLATFILERECORDSELECTOR_H
@@ -41,7 +41,6 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 #include "GmAppConfig.h"
 #include "GmAppConfigWidget.h"
 #include "GmCommon.h"
-#include "GridNode.h"
 #include "Utils/ProgramOutputDialog.h"
 #include "MapViewSubWidget.h"
 #include "NGAW2Converter.h"
@@ -229,6 +228,8 @@ void GMWidget::setupConnections()
     connect(siteWidget->siteConfigWidget()->getSiteGridWidget(), &SiteGridWidget::selectGridOnMap, this, &GMWidget::showGISWindow);
 
 
+    connect(m_selectionWidget, &RecordSelectionWidget::offlineDownloadRequested, this, &GMWidget::downloadOfflineSelection);
+
     connect(&peerClient, &PeerNgaWest2Client::recordsDownloaded, this, [this](QString zipFile)
             {
                 this->parseDownloadedRecords(zipFile);
@@ -542,19 +543,17 @@ QVector<QStringList> GMWidget::getUserGridData(void)
 
     gridData.push_back(headerRow);
 
-    auto gridNodeVec = userGrid->getGridNodeVec();
+    auto gridPoints = userGrid->getGridPoints();
     auto mapCanvas = mapViewSubWidget->getMapCanvasWidget()->mapCanvas();
 
-    for(int i = 0; i<gridNodeVec.size(); ++i)
+    for(int i = 0; i<gridPoints.size(); ++i)
     {
-        auto gridNode = gridNodeVec.at(i);
-
         QStringList stationRow;
 
         // The station id
         stationRow.push_back(QString::number(i));
 
-        auto screenPoint = gridNode->getPoint();
+        auto screenPoint = gridPoints.at(i);
 
         // The latitude and longitude
         auto longitude = theVisualizationWidget->getLongFromScreenPoint(screenPoint,mapCanvas);
@@ -1043,7 +1042,17 @@ int GMWidget::downloadRecords(void)
 
     theRecordsListFile.close();
 
-    qDebug()<<QString::number(recordsListToDownload.empty());
+    this->downloadRecordList(recordsToDownload);
+
+    return 0;
+}
+
+
+void GMWidget::downloadRecordList(const QStringList& recordsToDownload)
+{
+    QString pathToGMFilesDirectory = m_appConfig->getOutputDirectoryPath() + QDir::separator();
+
+    recordsListToDownload.clear();
 
     // Check if any of the records exist, do not need to download them again
     const QFileInfo existingFilesInfo(pathToGMFilesDirectory);
@@ -1073,8 +1082,42 @@ int GMWidget::downloadRecords(void)
     {
         this->downloadRecordBatch();
     }
+}
 
-    return 0;
+
+void GMWidget::downloadOfflineSelection(QVector<SelectedRecord> selectedRecords)
+{
+    if(selectedRecords.isEmpty())
+        return;
+
+    QDir outputDir(m_appConfig->getOutputDirectoryPath());
+    if(!outputDir.exists() && !outputDir.mkpath("."))
+    {
+        this->errorMessage("Could not create the output directory " + outputDir.absolutePath());
+        return;
+    }
+
+    auto recordSequenceNumbers = FlatfileRecordSelector::getRecordSequenceNumbers(selectedRecords);
+
+    peerClient.signIn(getPEERUserName(), getPEERPassWord());
+
+    offlineDownload = true;
+    offlineSelection = selectedRecords;
+    numDownloaded = 0;
+
+    this->getProgressDialog()->showProgressBar();
+
+    this->statusMessage("Downloading the " + QString::number(recordSequenceNumbers.size()) + " records selected offline from the PEER NGA West 2 database");
+
+    this->downloadRecordList(recordSequenceNumbers);
+
+    // All of the records are in the output directory already
+    if(recordsListToDownload.isEmpty() && numDownloaded == 0)
+    {
+        offlineDownload = false;
+        this->getProgressDialog()->hideProgressBar();
+        this->statusMessage("The records selected offline are already in the folder: " + outputDir.absolutePath());
+    }
 }
 
 
@@ -1499,6 +1542,23 @@ int GMWidget::parseDownloadedRecords(QString zipFile)
         return res;
     }
 
+    if(offlineDownload)
+    {
+        offlineDownload = false;
+
+        // Keep the scale factors of the selection with the records
+        QString err;
+        auto pathToSelection = pathToOutputDirectory + QDir::separator() + "OfflineRecordSelection.csv";
+        if(FlatfileRecordSelector::saveSelection(offlineSelection, pathToSelection, err) != 0)
+            this->errorMessage(err);
+
+        this->statusMessage("Download of the records selected offline complete, the records are in the folder: " + pathToOutputDirectory + ", the scale factors are in the file " + pathToSelection);
+
+        this->getProgressDialog()->hideProgressBar();
+
+        return 0;
+    }
+
     auto res2 = this->processDownloadedRecords(errMsg);
     if(res2 != 0)
     {
@@ -42,6 +42,7 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 #include "GroundMotionStation.h"
 #include "PeerNgaWest2Client.h"
 #include "EventGMDirWidget.h"
+#include "FlatfileRecordSelector.h"
 
 #include <QProcess>
 #include <QJsonObject>
@@ -118,6 +119,10 @@ public slots:
     // Download records once selected
     void downloadRecordBatch(void);
 
+    // Downloads the records that were selected offline from a local flatfile, without running the hazard simulation
+    // The selection with its scale factors is saved next to the downloaded records once the download is complete
+    void downloadOfflineSelection(QVector<SelectedRecord> selectedRecords);
+
     // Process the outfile files once the hazard simulation is complete
     int parseDownloadedRecords(QString);
 
@@ -172,6 +177,14 @@ private:
 
     int numDownloaded;
     bool downloadComplete;
+
+    // Starts the download of the given records, skipping the ones that are already in the output directory
+    void downloadRecordList(const QStringList& recordsToDownload);
+
+    // True while the downloaded records come from an offline selection, which has no event grid to process
+    bool offlineDownload = false;
+    QVector<SelectedRecord> offlineSelection;
+
     QStringList recordsListToDownload;
     QJsonObject NGA2Results;
 };
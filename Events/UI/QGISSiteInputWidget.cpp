@@ -47,9 +47,17 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 #include <qgsvectorlayer.h>
 #include <qgsmarkersymbol.h>
 
+#include <QDialog>
+#include <QDialogButtonBox>
+#include <QFileDialog>
 #include <QFileInfo>
 #include <QDir>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QPushButton>
 #include <QScreen>
+#include <QTableWidget>
+#include <QVBoxLayout>
 
 QGISSiteInputWidget::QGISSiteInputWidget(QWidget *parent, VisualizationWidget* visWidget, QString componentType, QString appType) : AssetInputWidget(parent, visWidget, componentType, appType)
 {
@@ -67,9 +75,15 @@ QGISSiteInputWidget::QGISSiteInputWidget(QWidget *parent, VisualizationWidget* v
     QPushButton *showSiteTableButton = new QPushButton();
     showSiteTableButton->setText(tr("Show Site File (.csv) Table"));
 //    showSiteTableButton->setMaximumWidth(150);
-    mainWidgetLayout->addWidget(showSiteTableButton,3, 0, 1,4);
+    mainWidgetLayout->addWidget(showSiteTableButton,3, 0, 1,2);
     connect(showSiteTableButton,SIGNAL(clicked()),this,SLOT(showSiteTableWindow()));
 
+    QPushButton *extractRasterButton = new QPushButton();
+    extractRasterButton->setText(tr("Extract Site Parameters from Rasters"));
+    extractRasterButton->setToolTip(tr("Samples raster files at the sites and adds the values as columns of the site file"));
+    mainWidgetLayout->addWidget(extractRasterButton,3, 2, 1,2);
+    connect(extractRasterButton,&QPushButton::clicked,this,&QGISSiteInputWidget::showRasterExtractionDialog);
+
 }
 
 
@@ -350,6 +364,106 @@ void QGISSiteInputWidget::showSiteTableWindow(){
     componentTableView->show();
 }
 
+void QGISSiteInputWidget::showRasterExtractionDialog()
+{
+    if(pathToComponentInputFile.isEmpty())
+    {
+        this->errorMessage("Please load a site file before extracting raster parameters");
+        return;
+    }
+
+    QDialog dialog(this);
+    dialog.setWindowTitle("Extract Site Parameters from Rasters");
+
+    QVBoxLayout* dialogLayout = new QVBoxLayout(&dialog);
+
+    // A row for each raster band, the column of the site file that gets its values, the band, and the value of the sites outside of the raster, NaN if left empty
+    QTableWidget* bindingTable = new QTableWidget(0, 4, &dialog);
+    bindingTable->setHorizontalHeaderLabels({"Column", "Raster File", "Band", "No-Data Value"});
+    bindingTable->horizontalHeader()->setSectionResizeMode(1, QHeaderView::Stretch);
+    bindingTable->setMinimumWidth(600);
+
+    QPushButton* addButton = new QPushButton("Add Raster", &dialog);
+    QPushButton* removeButton = new QPushButton("Remove Selected", &dialog);
+
+    connect(addButton, &QPushButton::clicked, &dialog, [&]()
+    {
+        auto rasterFiles = QFileDialog::getOpenFileNames(&dialog, tr("Raster Files"), QFileInfo(pathToComponentInputFile).absolutePath(), "Rasters (*.tif *.tiff *.img *.asc *.vrt);;All Files (*)");
+
+        for(auto&& it : rasterFiles)
+        {
+            auto row = bindingTable->rowCount();
+            bindingTable->insertRow(row);
+            bindingTable->setItem(row, 0, new QTableWidgetItem(QFileInfo(it).baseName()));
+            bindingTable->setItem(row, 1, new QTableWidgetItem(it));
+            bindingTable->setItem(row, 2, new QTableWidgetItem("1"));
+            bindingTable->setItem(row, 3, new QTableWidgetItem(""));
+        }
+    });
+
+    connect(removeButton, &QPushButton::clicked, &dialog, [&]()
+    {
+        bindingTable->removeRow(bindingTable->currentRow());
+    });
+
+    QHBoxLayout* buttonLayout = new QHBoxLayout();
+    buttonLayout->addWidget(addButton);
+    buttonLayout->addWidget(removeButton);
+    buttonLayout->addStretch();
+
+    QDialogButtonBox* buttonBox = new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel, &dialog);
+    buttonBox->button(QDialogButtonBox::Ok)->setText("Extract");
+    connect(buttonBox, &QDialogButtonBox::accepted, &dialog, &QDialog::accept);
+    connect(buttonBox, &QDialogButtonBox::rejected, &dialog, &QDialog::reject);
+
+    dialogLayout->addWidget(bindingTable);
+    dialogLayout->addLayout(buttonLayout);
+    dialogLayout->addWidget(buttonBox);
+
+    if(dialog.exec() != QDialog::Accepted || bindingTable->rowCount() == 0)
+        return;
+
+    QVector<SiteRasterBinding> bindings;
+
+    for(int i = 0; i<bindingTable->rowCount(); ++i)
+    {
+        auto cellText = [&](const int col)
+        {
+            auto item = bindingTable->item(i, col);
+            return item == nullptr ? QString() : item->text().trimmed();
+        };
+
+        SiteRasterBinding binding;
+        binding.columnName = cellText(0);
+        binding.rasterPath = cellText(1);
+
+        bool OK1, OK2 = true;
+        binding.band = cellText(2).toInt(&OK1);
+
+        if(!cellText(3).isEmpty())
+            binding.noDataValue = cellText(3).toDouble(&OK2);
+
+        if(binding.columnName.isEmpty() || binding.rasterPath.isEmpty() || !OK1 || !OK2)
+        {
+            this->errorMessage("Error in row " + QString::number(i+1) + " of the rasters, each raster needs a column name, a file, an integer band, and a numeric or empty no-data value");
+            return;
+        }
+
+        bindings.append(binding);
+    }
+
+    QFileInfo siteFileInfo(pathToComponentInputFile);
+    auto defaultOutput = siteFileInfo.absolutePath() + QDir::separator() + siteFileInfo.baseName() + "_rasters.csv";
+
+    auto outputFile = QFileDialog::getSaveFileName(this, tr("Save the Site File with the Raster Parameters"), defaultOutput, "CSV (*.csv)");
+
+    if(outputFile.isEmpty())
+        return;
+
+    this->extractRasterParameters(bindings, outputFile);
+}
+
+
 void QGISSiteInputWidget::reloadComponentData(QString newDataFile)
 {
     QFileInfo newFilename(newDataFile);
@@ -505,6 +619,39 @@ void QGISSiteInputWidget::clear()
 }
 
 
+int QGISSiteInputWidget::extractRasterParameters(const QVector<SiteRasterBinding>& bindings, const QString& outputFile)
+{
+    if(pathToComponentInputFile.isEmpty())
+    {
+        this->errorMessage("Please load a site file before extracting raster parameters");
+        return -1;
+    }
+
+    this->statusMessage("Extracting site parameters from "+QString::number(bindings.size())+" rasters");
+
+    SiteRasterExtractor theExtractor;
+
+    for(auto&& it : bindings)
+        theExtractor.addBinding(it);
+
+    QString err;
+    auto res = theExtractor.extract(pathToComponentInputFile, outputFile, err);
+
+    for(auto&& it : theExtractor.getLog())
+        this->statusMessage(it);
+
+    if(res != 0)
+    {
+        this->errorMessage(err);
+        return res;
+    }
+
+    this->reloadComponentData(outputFile);
+
+    return 0;
+}
+
+
 void QGISSiteInputWidget::setSiteFilter(QString filter)
 {
     this->setFilterString(filter);
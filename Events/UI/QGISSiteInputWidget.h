@@ -39,6 +39,7 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 // Written by: Kuanshi Zhong
 
 #include "AssetInputWidget.h"
+#include "SiteRasterExtractor.h"
 
 class QgsVectorLayer;
 class QgsFeature;
@@ -60,6 +61,9 @@ public:
 
     void clear();
 
+    // Samples the rasters at every site in one pass, writes the enriched site file to outputFile and reloads it
+    int extractRasterParameters(const QVector<SiteRasterBinding>& bindings, const QString& outputFile);
+
 signals:
     void soilDataCompleteSignal(bool flag);
     void activateSoilModelWidget(bool flag);
@@ -68,6 +72,9 @@ public slots:
     void setSiteFilter(QString filter);
     void showSiteTableWindow();
 
+    // Dialog that binds columns of the site file to raster bands and runs the extraction
+    void showRasterExtractionDialog();
+
 private:
 
     void checkSoilPropComplete(void);
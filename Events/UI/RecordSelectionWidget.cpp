@@ -40,12 +40,15 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 #include "SC_DoubleLineEdit.h"
 #include "SC_IntLineEdit.h"
 #include "SC_ComboBox.h"
+#include "CSVReaderWriter.h"
 
 #include <QVBoxLayout>
 #include <QComboBox>
+#include <QFileDialog>
 #include <QLabel>
 #include <QGroupBox>
 #include <QLineEdit>
+#include <QPushButton>
 
 RecordSelectionWidget::RecordSelectionWidget(RecordSelectionConfig& selectionConfig, QWidget *parent) : SimCenterAppWidget(parent), m_selectionConfig(selectionConfig)
 {
@@ -96,6 +99,55 @@ RecordSelectionWidget::RecordSelectionWidget(RecordSelectionConfig& selectionCon
 
     layout->addWidget(selectionGroupBox);
 
+    // Offline selection against a local copy of the NGA-West2 flatfile
+    offlineGroupBox = new QGroupBox("Offline Selection from a Local Flatfile");
+    QGridLayout* offlineLayout = new QGridLayout(offlineGroupBox);
+
+    auto addFileRow = [&](const QString& labelText, const QString& toolTip, const int row)
+    {
+        QLineEdit* lineEdit = new QLineEdit();
+        lineEdit->setToolTip(toolTip);
+
+        QPushButton* browseButton = new QPushButton("Browse");
+        connect(browseButton, &QPushButton::clicked, this, [this, lineEdit, labelText]()
+        {
+            auto path = QFileDialog::getOpenFileName(this, labelText, QString(), "CSV (*.csv);;All Files (*)");
+            if(!path.isEmpty())
+                lineEdit->setText(path);
+        });
+
+        offlineLayout->addWidget(new QLabel(labelText), row, 0);
+        offlineLayout->addWidget(lineEdit, row, 1);
+        offlineLayout->addWidget(browseButton, row, 2);
+
+        return lineEdit;
+    };
+
+    flatfileLineEdit = addFileRow("Flatfile", "Metadata flatfile with the record sequence number, magnitude, rupture distance, and Vs30 of each record", 0);
+    spectraTableLineEdit = addFileRow("Spectra table", "Optional table of the spectral accelerations of the records, if empty they are read from the flatfile", 1);
+    targetSpectrumLineEdit = addFileRow("Target spectrum", "CSV file with the period in s and the spectral acceleration in g of the target spectrum in each row", 2);
+
+    QPushButton* selectButton = new QPushButton("Select Records Offline");
+    QPushButton* saveButton = new QPushButton("Save Selection");
+    connect(selectButton, &QPushButton::clicked, this, &RecordSelectionWidget::selectRecordsOffline);
+    connect(saveButton, &QPushButton::clicked, this, &RecordSelectionWidget::saveOfflineSelection);
+
+    // The download signs in to the PEER database and writes to the output directory, so it is only started by the user
+    downloadButton = new QPushButton("Download Selected Records");
+    downloadButton->setToolTip("Downloads the records of the offline selection from the PEER NGA West 2 database to the output directory");
+    downloadButton->setEnabled(false);
+    connect(downloadButton, &QPushButton::clicked, this, &RecordSelectionWidget::downloadOfflineSelection);
+
+    offlineSummaryLabel = new QLabel();
+    offlineSummaryLabel->setWordWrap(true);
+
+    offlineLayout->addWidget(selectButton, 3, 0);
+    offlineLayout->addWidget(saveButton, 3, 1, Qt::AlignLeft);
+    offlineLayout->addWidget(downloadButton, 3, 2);
+    offlineLayout->addWidget(offlineSummaryLabel, 4, 0, 1, 3);
+
+    layout->addWidget(offlineGroupBox);
+
     this->setLayout(layout);
     this->setSizePolicy(QSizePolicy::Expanding,QSizePolicy::Minimum);
     setScalingVisibility(false);
@@ -146,6 +198,133 @@ void RecordSelectionWidget::setScalingVisibility(bool val)
     scalingMax->setVisible(val);
     scalingMinLabel->setVisible(val);
     scalingMaxLabel->setVisible(val);
+    offlineGroupBox->setVisible(val);
+}
+
+
+void RecordSelectionWidget::selectRecordsOffline(void)
+{
+    offlineSummaryLabel->clear();
+    offlineSelection.clear();
+    downloadButton->setEnabled(false);
+
+    QString err;
+
+    auto flatfile = flatfileLineEdit->text().trimmed();
+    auto spectraTable = spectraTableLineEdit->text().trimmed();
+
+    if(flatfile.isEmpty())
+    {
+        this->errorMessage("Select the flatfile to select the records offline");
+        return;
+    }
+
+    if(flatfile != loadedFlatfile || spectraTable != loadedSpectraTable || offlineSelector.getNumRecords() == 0)
+    {
+        this->statusMessage("Loading the flatfile " + flatfile);
+
+        loadedFlatfile.clear();
+        loadedSpectraTable.clear();
+
+        if(offlineSelector.loadFlatfile(flatfile, spectraTable, err) != 0)
+        {
+            this->errorMessage(err);
+            return;
+        }
+
+        loadedFlatfile = flatfile;
+        loadedSpectraTable = spectraTable;
+    }
+
+    // The target spectrum has a period and a spectral acceleration in each row, rows that are not numbers such as a header are skipped
+    CSVReaderWriter csvTool;
+    auto targetData = csvTool.parseCSVFile(targetSpectrumLineEdit->text().trimmed(), err);
+
+    if(!err.isEmpty())
+    {
+        this->errorMessage(err);
+        return;
+    }
+
+    RecordSelectionCriteria criteria;
+
+    for(auto&& row : targetData)
+    {
+        if(row.size() < 2)
+            continue;
+
+        bool OK1, OK2;
+        auto period = row.at(0).toDouble(&OK1);
+        auto sa = row.at(1).toDouble(&OK2);
+
+        if(!OK1 || !OK2)
+            continue;
+
+        criteria.targetPeriods.append(period);
+        criteria.targetSpectrum.append(sa);
+    }
+
+    criteria.numRecords = std::max(this->getNumberOfGMPerSite(), 1);
+    criteria.minScaleFactor = scalingMin->text().toDouble();
+    criteria.maxScaleFactor = scalingMax->text().toDouble();
+    criteria.errorMetric = m_selectionConfig.getError();
+
+    if(offlineSelector.selectRecords(criteria, offlineSelection, err) != 0)
+    {
+        this->errorMessage(err);
+        return;
+    }
+
+    if(offlineSelection.isEmpty())
+    {
+        offlineSummaryLabel->setText("No records of the flatfile meet the selection criteria");
+        return;
+    }
+
+    auto recordNumbers = FlatfileRecordSelector::getRecordSequenceNumbers(offlineSelection);
+
+    offlineSummaryLabel->setText("Selected " + QString::number(offlineSelection.size()) + " of " + QString::number(offlineSelector.getNumRecords()) + " records, the misfit of the best record is "
+                                 + QString::number(offlineSelection.first().misfit, 'g', 3) + "\nRSN: " + recordNumbers.join(", "));
+
+    downloadButton->setEnabled(true);
+
+    emit offlineRecordsSelected(offlineSelection);
+}
+
+
+void RecordSelectionWidget::downloadOfflineSelection(void)
+{
+    if(offlineSelection.isEmpty())
+    {
+        this->errorMessage("Select the records offline before downloading them");
+        return;
+    }
+
+    emit offlineDownloadRequested(offlineSelection);
+}
+
+
+void RecordSelectionWidget::saveOfflineSelection(void)
+{
+    if(offlineSelection.isEmpty())
+    {
+        this->errorMessage("Select the records offline before saving the selection");
+        return;
+    }
+
+    auto pathToFile = QFileDialog::getSaveFileName(this, "Save Selection", QString(), "CSV (*.csv)");
+
+    if(pathToFile.isEmpty())
+        return;
+
+    QString err;
+    if(FlatfileRecordSelector::saveSelection(offlineSelection, pathToFile, err) != 0)
+    {
+        this->errorMessage(err);
+        return;
+    }
+
+    this->statusMessage("Saved the selection to " + pathToFile);
 }
 
 
@@ -39,9 +39,13 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 // Written by: Stevan Gavrilovic
 
 #include "RecordSelectionConfig.h"
+#include "FlatfileRecordSelector.h"
 #include "SimCenterAppWidget.h"
 
+class QGroupBox;
 class QLabel;
+class QLineEdit;
+class QPushButton;
 
 class SC_ComboBox;
 class SC_DoubleLineEdit;
@@ -58,10 +62,25 @@ public:
     bool outputToJSON(QJsonObject& obj);
     bool inputFromJSON(QJsonObject& obj);
 
+signals:
+
+    // Emitted with the records and their scale factors after each offline selection
+    void offlineRecordsSelected(QVector<SelectedRecord> selectedRecords);
+
+    // Emitted when the user asks to download the records of the last offline selection from the PEER database
+    void offlineDownloadRequested(QVector<SelectedRecord> selectedRecords);
+
 private slots:
 
     void handleDBSelection(const QString& selection);
 
+    // Selects and scales the records against a local NGA-West2 flatfile without contacting the PEER server
+    void selectRecordsOffline(void);
+
+    void saveOfflineSelection(void);
+
+    void downloadOfflineSelection(void);
+
 private:
     void setScalingVisibility(bool val);
 
@@ -75,6 +94,19 @@ private:
     QLabel* scalingMinLabel = nullptr;
     QLabel* scalingMaxLabel = nullptr;
 
+    // Offline selection against a local flatfile, the flatfile is only read again when its path changes
+    QGroupBox* offlineGroupBox = nullptr;
+    QLineEdit* flatfileLineEdit = nullptr;
+    QLineEdit* spectraTableLineEdit = nullptr;
+    QLineEdit* targetSpectrumLineEdit = nullptr;
+    QLabel* offlineSummaryLabel = nullptr;
+    QPushButton* downloadButton = nullptr;
+
+    FlatfileRecordSelector offlineSelector;
+    QString loadedFlatfile;
+    QString loadedSpectraTable;
+    QVector<SelectedRecord> offlineSelection;
+
 };
 
 #endif // RECORDSELECTIONWIDGET_H
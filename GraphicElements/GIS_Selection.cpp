@@ -40,8 +40,12 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 #include "QGISVisualizationWidget.h"
 #include "SimCenterMapcanvasWidget.h"
 #include <PlainRectangle.h>
-#include "GridNode.h"
+#include <qgscoordinatereferencesystem.h>
+#include <qgscoordinatetransform.h>
+#include <qgscsexception.h>
 #include <qgsmapcanvas.h>
+#include <qgsmaptopixel.h>
+#include <qgsproject.h>
 /*
 #include <qgsvectorlayer.h>
 #include <qgslinesymbol.h>
@@ -215,44 +219,63 @@ void GIS_Selection::handlePolygonSelect(void)
 }
 */
 
-QVector<double>
-GIS_Selection::getSelectedPoints(void){
-  return selectedPoints;
+const QVector<double>&
+GIS_Selection::getSelectedLatitudes(void) const {
+  return selectedLatitudes;
+}
+
+const QVector<double>&
+GIS_Selection::getSelectedLongitudes(void) const {
+  return selectedLongitudes;
+}
+
+int
+GIS_Selection::getNumSelectedPoints(void) const {
+  return selectedLatitudes.size();
 }
 
 void
 GIS_Selection::handleSelectionGeometryChange(void)
 {
-    selectedPoints.clear();
-    
-    if (userGrid != 0) {
-      
-      auto gridNodeVec = userGrid->getGridNodeVec();
-      QgsMapCanvas *mapCanvas = mapViewSubWidget->mapCanvas();
-
-        for(int i = 0; i<gridNodeVec.size(); ++i)
-        {
-
-            auto gridNode = gridNodeVec.at(i);
-            auto screenPoint = gridNode->getPoint();
+    if (userGrid == 0)
+      return;
 
-            // The latitude and longitude
-            auto longitude = theVisualizationWidget->getLongFromScreenPoint(screenPoint,mapCanvas);
-            auto latitude = theVisualizationWidget->getLatFromScreenPoint(screenPoint,mapCanvas);
-            selectedPoints.append(latitude);
-            selectedPoints.append(longitude);
-             qDebug() << i << " " << latitude << " " << longitude;
-        }
-
-        emit selectionGeometryChanged();
-    }
-}
+    // The rectangle only reports the end of a drag, but the map can still refresh while one is in progress
+    if (userGrid->isDragging())
+      return;
 
+    auto gridPoints = userGrid->getGridPoints();
+    QgsMapCanvas *mapCanvas = mapViewSubWidget->mapCanvas();
 
+    const int numPoints = gridPoints.size();
 
+    QVector<double> x(numPoints), y(numPoints), z(numPoints, 0.0);
 
+    // Screen to map coordinates, then map coordinates to lat/lon in a single transform of all of the points
+    const QgsMapToPixel* mapToPixel = mapCanvas->getCoordinateTransform();
 
+    for(int i = 0; i<numPoints; ++i)
+    {
+        auto mapPoint = mapToPixel->toMapCoordinates(gridPoints.at(i).x(), gridPoints.at(i).y());
+        x[i] = mapPoint.x();
+        y[i] = mapPoint.y();
+    }
 
+    QgsCoordinateReferenceSystem wgs84("EPSG:4326");
+    QgsCoordinateTransform transform(mapCanvas->mapSettings().destinationCrs(), wgs84, QgsProject::instance());
 
+    try
+    {
+        transform.transformCoords(numPoints, x.data(), y.data(), z.data());
+    }
+    catch (QgsCsException &e)
+    {
+        this->errorMessage("Error transforming the selection to latitude and longitude: " + QString(e.what()));
+        return;
+    }
 
+    selectedLongitudes = x;
+    selectedLatitudes = y;
 
+    emit selectionGeometryChanged();
+}
@@ -63,7 +63,12 @@ class GIS_Selection : public SimCenterAppWidget
 public:
   GIS_Selection(QGISVisualizationWidget* visWidget, QWidget *parent = nullptr);
   ~GIS_Selection();
-  QVector<double> getSelectedPoints(void);
+
+  // The latitudes and longitudes of the corners of the selection, in the order bottom left, top left, bottom right, top right
+  // The coordinates are stored as separate contiguous arrays, i.e., point i is (getSelectedLatitudes()[i], getSelectedLongitudes()[i])
+  const QVector<double>& getSelectedLatitudes(void) const;
+  const QVector<double>& getSelectedLongitudes(void) const;
+  int getNumSelectedPoints(void) const;
 		  
 public slots:
   
@@ -94,7 +99,8 @@ private:
 
   PlainRectangle *userGrid = 0;
 
-  QVector<double> selectedPoints;
+  QVector<double> selectedLatitudes;
+  QVector<double> selectedLongitudes;
 };
 
 
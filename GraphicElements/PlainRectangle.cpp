@@ -36,7 +36,6 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 
 // Written by: Stevan Gavrilovic
 
-#include "GridNode.h"
 #include "NodeHandle.h"
 #include "PlainRectangle.h"
 #include "SiteConfig.h"
@@ -48,7 +47,6 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 #include <QApplication>
 #include <QBitmap>
 #include <QCursor>
-#include <QDebug>
 #include <QDrag>
 #include <QGraphicsSceneMouseEvent>
 #include <QMimeData>
@@ -65,6 +63,9 @@ PlainRectangle::PlainRectangle(QgsMapCanvas* parent) : QgsMapTool(parent), mapCa
 
     changingDimensions = false;
     updateConnectedWidgets = true;
+    gridCreated = false;
+    dragging = false;
+    geometryChangePending = false;
 
     latMin = 0.0;
     lonMin = 0.0;
@@ -176,6 +177,9 @@ void PlainRectangle::canvasPressEvent( QgsMapMouseEvent *event )
     // Update the original mouse event accepted state.
     bool isAccepted = mouseEvent.isAccepted();
     event->setAccepted(isAccepted);
+
+    // A handle or the rectangle took the press, so the geometry may change until the mouse is released
+    dragging = isAccepted;
 }
 
 
@@ -231,6 +235,14 @@ void PlainRectangle::canvasReleaseEvent( QgsMapMouseEvent *event )
     mouseEvent.setAccepted(false);
 
     QApplication::sendEvent(mapCanvas->scene(), &mouseEvent);
+
+    if(dragging)
+    {
+        dragging = false;
+
+        if(geometryChangePending)
+            this->notifyGeometryChanged();
+    }
 }
 
 
@@ -273,13 +285,37 @@ void PlainRectangle::updateGeometry(void)
     topLeftNode->setPos(rectangleGeometry.topLeft());
     centerNode->setPos(centerPnt);
 
+    this->notifyGeometryChanged();
+}
+
+
+void PlainRectangle::notifyGeometryChanged(void)
+{
+    if(dragging)
+    {
+        geometryChangePending = true;
+        return;
+    }
+
+    geometryChangePending = false;
+
     emit geometryChanged();
 }
 
 
-QVector<GridNode *> PlainRectangle::getGridNodeVec() const
+bool PlainRectangle::isDragging() const
+{
+    return dragging;
+}
+
+
+QVector<QPointF> PlainRectangle::getGridPoints() const
 {
-    return gridNodeVec;
+    if(!gridCreated)
+        return QVector<QPointF>();
+
+    // The rectangle is a single cell, so the grid points are the corners themselves
+    return {bottomLeftNode->pos(), topLeftNode->pos(), bottomRightNode->pos(), topRightNode->pos()};
 }
 
 void PlainRectangle::setVisualizationWidget(VisualizationWidget *value)
@@ -312,7 +348,7 @@ QVariant PlainRectangle::itemChange(GraphicsItemChange change, const QVariant &v
 {
     switch (change) {
     case ItemPositionHasChanged:
-        emit geometryChanged();
+        this->notifyGeometryChanged();
         break;
     default:
         break;
@@ -486,66 +522,14 @@ void PlainRectangle::handleCenterNodeChanged(const QPointF& pos)
 
 void PlainRectangle::clearGrid()
 {
-    qDeleteAll(gridNodeVec);
-    gridNodeVec.clear();
+    gridCreated = false;
 }
 
 
 void PlainRectangle::createGrid()
 {
-    int ni = 1;
-    int nj = 1;
-
-    for (int i=0; i<=ni; ++i)
-    {
-        for (int j=0;j<=nj; ++j)
-        {
-
-            // X COORDINATE
-            std::function<double(void)> xCoordinatelambda = [=]
-            {
-                auto divisor = static_cast<double>(ni*nj);
-
-                auto n1X = bottomLeftNode->pos().x();
-                auto n2X = bottomRightNode->pos().x();
-                auto n3X = topRightNode->pos().x();
-                auto n4X = topLeftNode->pos().x();
-
-                return static_cast<double>(i*j*n1X-i*j*n2X+i*j*n3X-i*j*n4X-i*n1X*nj+i*n2X*nj-j*n1X*ni+j*n4X*ni+n1X*ni*nj)/(divisor);
-            };
-
-            // Y COORDINATE
-            std::function<double(void)> yCoordinatelambda = [=]
-            {
-                auto divisor = static_cast<double>(ni*nj);
-
-                auto n1Y = bottomLeftNode->pos().y();
-                auto n2Y = bottomRightNode->pos().y();
-                auto n3Y = topRightNode->pos().y();
-                auto n4Y = topLeftNode->pos().y();
-
-                return static_cast<double>(i*j*n1Y-i*j*n2Y+i*j*n3Y-i*j*n4Y-i*n1Y*nj+i*n2Y*nj-j*n1Y*ni+j*n4Y*ni+n1Y*ni*nj)/(divisor);
-            };
-
-            auto x = xCoordinatelambda();
-            auto y = yCoordinatelambda();
-
-            // Create the grid node
-            GridNode* newGridNode = new GridNode(this);
-
-	    qDebug() << i << " " << j << " " << x << " " << y << " " << xCoordinatelambda() << " " << yCoordinatelambda();
-            newGridNode->setX(x);
-            newGridNode->setY(y);
-
-            newGridNode->setXPos(xCoordinatelambda);
-            newGridNode->setYPos(yCoordinatelambda);
-
-            gridNodeVec.push_back(newGridNode);
-
-            connect(this,&PlainRectangle::geometryChanged,newGridNode,&GridNode::updateGeometry);
-        }
-    }
-    
+    // The grid points are not individual items, they are taken from the corner nodes when requested
+    gridCreated = true;
 }
 
 void PlainRectangle::handleLatLonChanged(void)
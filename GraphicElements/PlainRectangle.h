@@ -47,7 +47,6 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 
 class QgsMapCanvas;
 class NodeHandle;
-class GridNode;
 class SiteConfig;
 class VisualizationWidget;
 
@@ -61,15 +60,23 @@ public:
     PlainRectangle(QgsMapCanvas* parent);
     ~PlainRectangle();
 
-    QVector<GridNode *> getGridNodeVec() const; 
+    // The corners of the rectangle in the coordinates of the item, in the order bottom left, top left, bottom right, top right
+    // The points are empty if the grid is not created
+    QVector<QPointF> getGridPoints() const;
+
     void setVisualizationWidget(VisualizationWidget *value);
     void createGrid(); 
     void clearGrid(); 
     void removeGridFromScene(void); 
     void show();
 
+    // True while a corner or the center of the rectangle is being dragged
+    bool isDragging() const;
+
 signals:
     void selectionChanged(void);
+
+    // Emitted when the geometry changes, while dragging it is only emitted once when the drag ends
     void geometryChanged();
 
 private:  
@@ -116,6 +123,9 @@ protected:
     QVariant itemChange(GraphicsItemChange change, const QVariant &value) override;
     void updateGeometry(void);
 
+    // Emits geometryChanged, or defers it to the end of the drag if one is in progress
+    void notifyGeometryChanged(void);
+
 private:
     QColor color;
     QRect rectangleGeometry;
@@ -131,7 +141,11 @@ private:
     SiteConfig* gridSiteConfig;
     VisualizationWidget* theVisWidget;
 
-    QVector<GridNode*> gridNodeVec;
+    bool gridCreated;
+
+    // Geometry changes during a drag are held back until the mouse is released
+    bool dragging;
+    bool geometryChangePending;
 
     double latMin;
     double lonMin;
@@ -37,7 +37,6 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 
 // Written: Stevan Gavrilovic
 
-#include "GridNode.h"
 #include "NodeHandle.h"
 #include "RectangleGrid.h"
 #include "SiteConfig.h"
@@ -62,6 +61,7 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 RectangleGrid::RectangleGrid(QgsMapCanvas* parent) : QgsMapTool(parent), mapCanvas(parent)
 {
     gridSiteConfig = nullptr;
+    theVisWidget = nullptr;
 
     setCacheMode(DeviceCoordinateCache);
     setZValue(-1);
@@ -78,6 +78,10 @@ RectangleGrid::RectangleGrid(QgsMapCanvas* parent) : QgsMapTool(parent), mapCanv
     numDivisionsVertical = 5;
 
     color.setRgb(0,0,255,30);
+    nodeColor.setRgb(0,0,255,100);
+    nodeDiameter = 5.0;
+
+    gridCreated = false;
 
     auto width = 150;
     auto height = 150;
@@ -260,11 +264,21 @@ void RectangleGrid::paint(QPainter *painter, const QStyleOptionGraphicsItem *opt
     painter->setPen(Qt::NoPen);
     painter->setBrush(QBrush(color));
     painter->drawRect(rectangleGeometry);
+
+    if(gridPoints.isEmpty())
+        return;
+
+    // Draw all of the grid points in one call, the round cap makes each point a circle of the node diameter
+    QPen nodePen(nodeColor, nodeDiameter, Qt::SolidLine, Qt::RoundCap);
+    painter->setPen(nodePen);
+    painter->drawPoints(gridPoints.constData(), gridPoints.size());
 }
 
 
 void RectangleGrid::updateGeometry(void)
 {
+    this->prepareGeometryChange();
+
     auto bottomLeftPnt = rectangleGeometry.bottomLeft();
     auto topRightPnt = rectangleGeometry.topRight();
     auto centerPnt = rectangleGeometry.center();
@@ -275,6 +289,8 @@ void RectangleGrid::updateGeometry(void)
     topLeftNode->setPos(rectangleGeometry.topLeft());
     centerNode->setPos(centerPnt);
 
+    this->updateGridPoints();
+
     if(gridSiteConfig && updateConnectedWidgets)
     {
         latMin = theVisWidget->getLatFromScreenPoint(bottomLeftPnt,mapCanvas);
@@ -294,9 +310,53 @@ void RectangleGrid::updateGeometry(void)
 }
 
 
-QVector<GridNode *> RectangleGrid::getGridNodeVec() const
+void RectangleGrid::updateGridPoints(void)
+{
+    if(!gridCreated)
+        return;
+
+    const auto ni = numDivisionsHoriz;
+    const auto nj = numDivisionsVertical;
+
+    gridPoints.resize(static_cast<int>((ni+1)*(nj+1)));
+
+    const auto n1 = bottomLeftNode->pos();
+    const auto n2 = bottomRightNode->pos();
+    const auto n3 = topRightNode->pos();
+    const auto n4 = topLeftNode->pos();
+
+    // Bilinear interpolation between the corners, p = n1 + s*(n2-n1) + t*(n4-n1) + s*t*(n1-n2+n3-n4)
+    const auto twist = n1 - n2 + n3 - n4;
+
+    int k = 0;
+    for (size_t i=0; i<=ni; ++i)
+    {
+        const double s = ni > 0 ? static_cast<double>(i)/ni : 0.0;
+
+        const auto rowStart = n1 + s*(n2 - n1);
+        const auto rowDir = (n4 - n1) + s*twist;
+
+        for (size_t j=0;j<=nj; ++j)
+        {
+            const double t = nj > 0 ? static_cast<double>(j)/nj : 0.0;
+
+            gridPoints[k++] = rowStart + t*rowDir;
+        }
+    }
+
+    this->update();
+}
+
+
+QVector<QPointF> RectangleGrid::getGridPoints() const
 {
-    return gridNodeVec;
+    return gridPoints;
+}
+
+
+int RectangleGrid::getNumGridPoints() const
+{
+    return gridPoints.size();
 }
 
 
@@ -528,76 +588,30 @@ void RectangleGrid::handleCenterNodeChanged(const QPointF& pos)
     if(changingDimensions == true)
         return;
 
+    this->prepareGeometryChange();
     this->rectangleGeometry.moveCenter(pos.toPoint());
     bottomLeftNode->setPos(rectangleGeometry.bottomLeft());
     bottomRightNode->setPos(rectangleGeometry.bottomRight());
     topRightNode->setPos(rectangleGeometry.topRight());
     topLeftNode->setPos(rectangleGeometry.topLeft());
+
+    this->updateGridPoints();
 }
 
 
 void RectangleGrid::clearGrid()
 {
-    qDeleteAll(gridNodeVec);
-    gridNodeVec.clear();
+    gridCreated = false;
+    gridPoints.clear();
+    this->update();
 }
 
 
 void RectangleGrid::createGrid()
 {
-    auto ni = numDivisionsHoriz;
-    auto nj = numDivisionsVertical;
-
-    gridNodeVec.reserve(ni*nj);
-
-    for (size_t i=0; i<=ni; ++i)
-    {
-        for (size_t j=0;j<=nj; ++j)
-        {
-
-            // X COORDINATE
-            std::function<double(void)> xCoordinatelambda = [=]
-            {
-                auto divisor = static_cast<double>(ni*nj);
-
-                auto n1X = bottomLeftNode->pos().x();
-                auto n2X = bottomRightNode->pos().x();
-                auto n3X = topRightNode->pos().x();
-                auto n4X = topLeftNode->pos().x();
-
-                return static_cast<double>(i*j*n1X-i*j*n2X+i*j*n3X-i*j*n4X-i*n1X*nj+i*n2X*nj-j*n1X*ni+j*n4X*ni+n1X*ni*nj)/(divisor);
-            };
-
-            // Y COORDINATE
-            std::function<double(void)> yCoordinatelambda = [=]
-            {
-                auto divisor = static_cast<double>(ni*nj);
-
-                auto n1Y = bottomLeftNode->pos().y();
-                auto n2Y = bottomRightNode->pos().y();
-                auto n3Y = topRightNode->pos().y();
-                auto n4Y = topLeftNode->pos().y();
-
-                return static_cast<double>(i*j*n1Y-i*j*n2Y+i*j*n3Y-i*j*n4Y-i*n1Y*nj+i*n2Y*nj-j*n1Y*ni+j*n4Y*ni+n1Y*ni*nj)/(divisor);
-            };
-
-            auto x = xCoordinatelambda();
-            auto y = yCoordinatelambda();
-
-            // Create the grid node
-            GridNode* newGridNode = new GridNode(this);
-
-            newGridNode->setX(x);
-            newGridNode->setY(y);
-
-            newGridNode->setXPos(xCoordinatelambda);
-            newGridNode->setYPos(yCoordinatelambda);
-
-            gridNodeVec.push_back(newGridNode);
-
-            connect(this,&RectangleGrid::geometryChanged,newGridNode,&GridNode::updateGeometry);
-        }
-    }
+    // The grid points are not individual items, they are computed from the corner nodes and painted by the grid
+    gridCreated = true;
+    this->updateGridPoints();
 }
 
 
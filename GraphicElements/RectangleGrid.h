@@ -45,7 +45,6 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 
 class QgsMapCanvas;
 class NodeHandle;
-class GridNode;
 class SiteConfig;
 class VisualizationWidget;
 
@@ -59,7 +58,11 @@ class RectangleGrid : public QgsMapTool, public QGraphicsItem
     RectangleGrid(QgsMapCanvas* parent);
     ~RectangleGrid();
 
-    QVector<GridNode *> getGridNodeVec() const;
+    // The grid points in the coordinates of the grid item, in the order of the horizontal divisions and then the vertical divisions
+    // The points are empty if the grid is not created
+    QVector<QPointF> getGridPoints() const;
+    int getNumGridPoints() const;
+
     void setVisualizationWidget(VisualizationWidget *value);
     void clearGrid();
     void createGrid();
@@ -123,11 +126,16 @@ protected:
 
     void updateGeometry(void);
 
+    // Computes the positions of all of the grid points from the corner nodes in one pass
+    void updateGridPoints(void);
+
 signals:
     void geometryChanged();
 
 private:
     QColor color;
+    QColor nodeColor;
+    double nodeDiameter;
     QRect rectangleGeometry;
     bool changingDimensions;
     bool updateConnectedWidgets;
@@ -144,7 +152,8 @@ private:
     SiteConfig* gridSiteConfig;
     VisualizationWidget* theVisWidget;
 
-    QVector<GridNode*> gridNodeVec;
+    bool gridCreated;
+    QVector<QPointF> gridPoints;
 
     double latMin;
     double lonMin;
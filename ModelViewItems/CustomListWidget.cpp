@@ -315,7 +315,7 @@ void CustomListWidget::update()
 {
     auto childVec = treeModel->getAllChildren();
 
-    std::function<void(TreeItem* item)> nestedUpdater = [](TreeItem* item){
+    std::function<void(TreeItem* item)> nestedUpdater = [this](TreeItem* item){
 
         auto childItems = item->getChildItems();
 
@@ -336,7 +336,7 @@ void CustomListWidget::update()
 
             QString newItemText = QString::number(rowNum+1) + ". " + modelStr + " - weight="+ weightStr;
 
-            it->setData(newItemText,0);
+            treeModel->renameItem(it, newItemText);
         }
     };
 
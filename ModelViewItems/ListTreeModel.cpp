@@ -42,8 +42,12 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 #include <QDataStream>
 #include <QDebug>
 #include <QUuid>
+#include <QSet>
 #include <QStringList>
 
+#include <algorithm>
+#include <functional>
+
 ListTreeModel::ListTreeModel(QString headerText, QObject *parent) : QAbstractItemModel(parent)
 {
     rootItem = new TreeItem({headerText},0);
@@ -176,6 +180,8 @@ TreeItem* ListTreeModel::addItemToTree(const QString itemText, TreeItem* parent)
 
     parent->appendChild(childItem);
 
+    this->registerItem(childItem);
+
     emit layoutChanged();
 
     return childItem;
@@ -184,80 +190,147 @@ TreeItem* ListTreeModel::addItemToTree(const QString itemText, TreeItem* parent)
 
 TreeItem *ListTreeModel::getItem(const QString& itemID) const
 {
-    std::function<TreeItem*(TreeItem*, const QString&)> nestedItemFinder = [&](TreeItem* item, const QString& ID) -> TreeItem*
-    {
-        // First check for this item
-        auto thisItemID = item->getItemID();
+    return itemsByID.value(itemID, nullptr);
+}
 
-        if(ID.compare(thisItemID) == 0)
-            return item;
 
-        // Then check any and all children
-        QVector<TreeItem *> children = item->getChildItems();
-        for(int i = 0; i<children.size(); ++i)
-        {
-            auto child = children.at(i);
-            auto childID = child->getItemID();
+bool ListTreeModel::removeItemFromTree(const QString& itemID)
+{
+    auto item = itemsByID.value(itemID, nullptr);
 
-            if(ID.compare(childID) == 0)
-                return child;
+    if(item == nullptr || item == rootItem)
+    {
+        emit layoutChanged();
+        return false;
+    }
 
-            auto grandChild = nestedItemFinder(child,ID);
+    auto parentItem = item->getParentItem();
 
-            if(grandChild)
-                return grandChild;
-        }
+    auto row = item->row();
 
+    this->unregisterItem(item);
 
-        // if we got this far then item not found
-        return nullptr;
-    };
+    parentItem->removeChild(row);
 
-    auto res = nestedItemFinder(rootItem, itemID);
+    emit layoutChanged();
 
-    return res;
+    return true;
 }
 
 
-bool ListTreeModel::removeItemFromTree(const QString& itemID)
+int ListTreeModel::removeItemsFromTree(const QStringList& itemIDs)
 {
-    std::function<bool(TreeItem*, const QString&)> nestedDeleter = [&](TreeItem* item, const QString& ID)
+    // Group the rows to remove by their parents
+    QHash<TreeItem*, QVector<int>> rowsByParent;
+
+    for(auto&& itemID : itemIDs)
     {
-        QVector<TreeItem *> children = item->getChildItems();
+        auto item = itemsByID.value(itemID, nullptr);
 
-        auto index = -1;
-        for(int i = 0; i<children.size(); ++i)
-        {
-            auto child = children.at(i);
+        if(item == nullptr || item == rootItem)
+            continue;
 
-            auto childID = child->getItemID();
+        rowsByParent[item->getParentItem()].append(item->row());
+    }
+
+    // Items that are inside of the subtree of another item that is removed are removed together with it
+    QSet<TreeItem*> removedParents;
+    for(auto it = rowsByParent.constBegin(); it != rowsByParent.constEnd(); ++it)
+    {
+        for(auto&& row : it.value())
+            removedParents.insert(it.key()->child(row));
+    }
+
+    int numRemoved = 0;
+
+    for(auto it = rowsByParent.begin(); it != rowsByParent.end(); ++it)
+    {
+        auto parentItem = it.key();
 
-            if(ID.compare(childID) == 0)
+        bool isInRemovedSubtree = false;
+        for(auto ancestor = parentItem; ancestor != nullptr && ancestor != rootItem; ancestor = ancestor->getParentItem())
+        {
+            if(removedParents.contains(ancestor))
             {
-                index = i;
+                isInRemovedSubtree = true;
                 break;
             }
-
-            if(nestedDeleter(child,ID))
-                return true;
         }
 
-        if(index > -1)
+        if(isInRemovedSubtree)
+            continue;
+
+        auto& rows = it.value();
+
+        // Remove from the last row to the first so that the rows that are left do not shift
+        std::sort(rows.begin(), rows.end(), std::greater<int>());
+        rows.erase(std::unique(rows.begin(), rows.end()), rows.end());
+
+        const auto parentIndex = this->indexOfItem(parentItem);
+
+        int i = 0;
+        while(i < rows.size())
         {
-            item->removeChild(index);
+            // Find the block of contiguous rows
+            int j = i;
+            while(j+1 < rows.size() && rows.at(j+1) == rows.at(j) - 1)
+                ++j;
+
+            const auto firstRow = rows.at(j);
+            const auto lastRow = rows.at(i);
+
+            beginRemoveRows(parentIndex, firstRow, lastRow);
+
+            for(int row = lastRow; row >= firstRow; --row)
+            {
+                this->unregisterItem(parentItem->child(row));
+
+                parentItem->removeChild(row);
+
+                ++numRemoved;
+            }
 
-            return true;
+            endRemoveRows();
+
+            i = j+1;
         }
+    }
+
+    return numRemoved;
+}
 
+
+bool ListTreeModel::renameItem(TreeItem* item, const QString& newName)
+{
+    if(item == nullptr || item == rootItem)
         return false;
 
-    };
+    const auto oldName = item->data(0).toString();
 
-    auto res = nestedDeleter(rootItem, itemID);
+    if(oldName == newName)
+        return true;
 
-    emit layoutChanged();
+    // Re-key the item under its new name, the handler of its deletion captured the old name so it is replaced as well
+    disconnect(item, &QObject::destroyed, this, nullptr);
+    this->unregisterItem(item->getItemID(), oldName, item);
 
-    return res;
+    QString name = newName;
+    item->setData(name,0);
+
+    const auto itemID = item->getItemID();
+
+    itemsByID.insert(itemID, item);
+    itemsByName[newName].append(item);
+
+    connect(item, &QObject::destroyed, this, [this, itemID, newName, item]()
+    {
+        this->unregisterItem(itemID, newName, item);
+    });
+
+    auto itemIndex = this->indexOfItem(item);
+    emit dataChanged(itemIndex, itemIndex);
+
+    return true;
 }
 
 
@@ -276,37 +349,21 @@ TreeItem* ListTreeModel::getTreeItem(const QString& itemName, const TreeItem* pa
 
 TreeItem* ListTreeModel::getTreeItem(const QString& itemName, const QString& parentName) const
 {
+    auto it = itemsByName.constFind(itemName);
+
+    if(it == itemsByName.constEnd())
+        return nullptr;
 
-    std::function<TreeItem* (TreeItem*, const QString&, const QString&)> nestedItemFinder = [&](TreeItem* item, const QString& name, const QString& parentName) -> TreeItem*
+    for(auto&& item : it.value())
     {
         auto thisItemParent = item->getParentItem();
 
-        // Check if this is the item
-        auto thisItemName = item->data(0).toString();
-        if(name.compare(thisItemName) == 0 )
-        {
-            auto thisItemParentName = thisItemParent->getName();
-            if(thisItemParent == rootItem || parentName.compare(thisItemParentName) == 0)
-                return item;
-        }
-
-
-        // Now check the children of this item
-        QVector<TreeItem *> children = item->getChildItems();
-        for(int i = 0; i<children.size(); ++i)
-        {
-            auto child = children.at(i);
-
-            // Check the childrens children
-            if(auto foundChild = nestedItemFinder(child,name, parentName))
-                return foundChild;
-        }
-
-        // Return a null item if none is found
-        return nullptr;
-    };
+        if(thisItemParent == rootItem || parentName.compare(thisItemParent->getName()) == 0)
+            return item;
+    }
 
-    return nestedItemFinder(rootItem, itemName, parentName);
+    // Return a null item if none is found
+    return nullptr;
 }
 
 
@@ -342,16 +399,15 @@ bool ListTreeModel::clear(void)
 {
     auto children = rootItem->getChildItems();
 
-    for(auto&& child : children)
-    {
-        auto res = this->removeItemFromTree(child->getItemID());
+    QStringList childIDs;
+    childIDs.reserve(children.size());
 
-        if(res == false)
-            return false;
+    for(auto&& child : children)
+        childIDs.append(child->getItemID());
 
-    }
+    auto numRemoved = this->removeItemsFromTree(childIDs);
 
-    return true;
+    return numRemoved == children.size();
 }
 
 
@@ -380,3 +436,64 @@ QString ListTreeModel::uidItem(const QModelIndex &index)
 
     return item->getItemID();
 }
+
+
+void ListTreeModel::registerItem(TreeItem* item)
+{
+    const auto itemID = item->getItemID();
+    const auto itemName = item->data(0).toString();
+
+    itemsByID.insert(itemID, item);
+    itemsByName[itemName].append(item);
+
+    // Keep the tables valid if the item is deleted outside of the model
+    connect(item, &QObject::destroyed, this, [this, itemID, itemName, item]()
+    {
+        this->unregisterItem(itemID, itemName, item);
+    });
+
+    for(auto&& child : item->getChildItems())
+        this->registerItem(child);
+}
+
+
+void ListTreeModel::unregisterItem(TreeItem* item)
+{
+    if(item == nullptr)
+        return;
+
+    for(auto&& child : item->getChildItems())
+        this->unregisterItem(child);
+
+    disconnect(item, &QObject::destroyed, this, nullptr);
+
+    this->unregisterItem(item->getItemID(), item->data(0).toString(), item);
+}
+
+
+void ListTreeModel::unregisterItem(const QString& itemID, const QString& itemName, TreeItem* item)
+{
+    auto idIt = itemsByID.find(itemID);
+
+    if(idIt != itemsByID.end() && idIt.value() == item)
+        itemsByID.erase(idIt);
+
+    auto nameIt = itemsByName.find(itemName);
+
+    if(nameIt != itemsByName.end())
+    {
+        nameIt.value().removeOne(item);
+
+        if(nameIt.value().isEmpty())
+            itemsByName.erase(nameIt);
+    }
+}
+
+
+QModelIndex ListTreeModel::indexOfItem(TreeItem* item) const
+{
+    if(item == nullptr || item == rootItem)
+        return QModelIndex();
+
+    return createIndex(item->row(), 0, item);
+}
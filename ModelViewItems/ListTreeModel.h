@@ -39,6 +39,8 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 // Written by: Stevan Gavrilovic
 
 #include <QAbstractItemModel>
+#include <QHash>
+#include <QVector>
 
 class TreeItem;
 
@@ -75,6 +77,12 @@ public:
 
     bool removeItemFromTree(const QString& itemID);
 
+    // Removes the items with a single removal of rows for each contiguous block of rows under the same parent, returns the number of items removed
+    int removeItemsFromTree(const QStringList& itemIDs);
+
+    // Changes the text of an item and updates the name lookup table, items must be renamed through the model so that they can still be found by name
+    bool renameItem(TreeItem* item, const QString& newName);
+
     TreeItem *getTreeItem(const QString& itemName, const QString& parentName) const;
     TreeItem* getTreeItem(const QString& itemName, const TreeItem* parent) const;
 
@@ -95,7 +103,20 @@ signals:
     void rowPositionChanged(const int oldPos, const int newPos);
 
 private:
+
+    // Adds the item and all of its children to the lookup tables, and removes them again when they are deleted
+    void registerItem(TreeItem* item);
+    void unregisterItem(TreeItem* item);
+    void unregisterItem(const QString& itemID, const QString& itemName, TreeItem* item);
+
+    QModelIndex indexOfItem(TreeItem* item) const;
+
     TreeItem *rootItem;
+
+    // Lookup tables of the items in the tree, the items with the same name are kept in the order that they were added
+    // Moving rows keeps the items under the same parent, so the tables only change when items are added or removed
+    QHash<QString, TreeItem*> itemsByID;
+    QHash<QString, QVector<TreeItem*>> itemsByName;
 };
 
 #endif // ListTreeModel_H
@@ -98,6 +98,7 @@ SOURCES +=  $$PWD/Events/UI/BedrockDepth.cpp \
             $$PWD/Events/UI/PointSourceRuptureWidget.cpp \
             $$PWD/Events/UI/QGISSiteInputWidget.cpp \
             $$PWD/Events/UI/RecordSelectionConfig.cpp \
+            $$PWD/Events/UI/FlatfileRecordSelector.cpp \
             $$PWD/Events/UI/RecordSelectionWidget.cpp \
             $$PWD/Events/UI/RuptureLocation.cpp \
             $$PWD/Events/UI/RuptureWidget.cpp \
@@ -136,6 +137,21 @@ SOURCES +=  $$PWD/Events/UI/BedrockDepth.cpp \
             $$PWD/Tools/PelicunPostProcessor.cpp \
             $$PWD/Tools/CBCitiesPostProcessor.cpp \
             $$PWD/Tools/REmpiricalProbabilityDistribution.cpp \
+            $$PWD/Tools/OpenQuakeSourceModelReader.cpp \
+            $$PWD/Tools/QuantileSketch.cpp \
+            $$PWD/Tools/TimeSeriesAggregator.cpp \
+            $$PWD/Tools/NetworkConnectivity.cpp \
+            $$PWD/Tools/IDRangeSet.cpp \
+            $$PWD/Tools/AssetFilterExpression.cpp \
+            $$PWD/Tools/ResponseSpectrum.cpp \
+            $$PWD/Tools/HollandWindField.cpp \
+            $$PWD/Tools/CapacitySpectrumMethod.cpp \
+            $$PWD/Tools/NearestNeighbourMapper.cpp \
+            $$PWD/Tools/GeoJSONFootprintReader.cpp \
+            $$PWD/Tools/TrafficAssignment.cpp \
+            $$PWD/Tools/HazusMDOFGenerator.cpp \
+            $$PWD/Tools/IDHashJoin.cpp \
+            $$PWD/Tools/LayerClassifier.cpp \
             $$PWD/systemPerformanceWidgets/ResidualDemandResults.cpp \
             $$PWD/systemPerformanceWidgets/ResidualDemandWidget.cpp \	    
             $$PWD/Tools/TablePrinter.cpp \
@@ -172,6 +188,7 @@ SOURCES +=  $$PWD/Events/UI/BedrockDepth.cpp \
             $$PWD/UIWidgets/HazardsWidget.cpp \
             $$PWD/UIWidgets/HousingUnitAllocationWidget.cpp \
             $$PWD/UIWidgets/HurricaneParameterWidget.cpp \
+            $$PWD/UIWidgets/HurricaneTrackFilterWidget.cpp \
             $$PWD/UIWidgets/InputWidgetOpenSeesPyAnalysis.cpp \
             $$PWD/UIWidgets/ModelWidget.cpp \
             $$PWD/UIWidgets/MultiComponentR2D.cpp \
@@ -285,6 +302,7 @@ HEADERS +=  $$PWD/Events/UI/BedrockDepth.h \
             $$PWD/Events/UI/PointSourceRuptureWidget.h \
             $$PWD/Events/UI/QGISSiteInputWidget.h \
             $$PWD/Events/UI/RecordSelectionConfig.h \
+            $$PWD/Events/UI/FlatfileRecordSelector.h \
             $$PWD/Events/UI/RecordSelectionWidget.h \
             $$PWD/Events/UI/RuptureLocation.h \
             $$PWD/Events/UI/RuptureWidget.h \
@@ -319,6 +337,21 @@ HEADERS +=  $$PWD/Events/UI/BedrockDepth.h \
             $$PWD/Tools/PelicunPostProcessor.h \
             $$PWD/Tools/CBCitiesPostProcessor.h \
             $$PWD/Tools/REmpiricalProbabilityDistribution.h \
+            $$PWD/Tools/OpenQuakeSourceModelReader.h \
+            $$PWD/Tools/QuantileSketch.h \
+            $$PWD/Tools/TimeSeriesAggregator.h \
+            $$PWD/Tools/NetworkConnectivity.h \
+            $$PWD/Tools/IDRangeSet.h \
+            $$PWD/Tools/AssetFilterExpression.h \
+            $$PWD/Tools/ResponseSpectrum.h \
+            $$PWD/Tools/HollandWindField.h \
+            $$PWD/Tools/CapacitySpectrumMethod.h \
+            $$PWD/Tools/NearestNeighbourMapper.h \
+            $$PWD/Tools/GeoJSONFootprintReader.h \
+            $$PWD/Tools/TrafficAssignment.h \
+            $$PWD/Tools/HazusMDOFGenerator.h \
+            $$PWD/Tools/IDHashJoin.h \
+            $$PWD/Tools/LayerClassifier.h \
             $$PWD/systemPerformanceWidgets/ResidualDemandResults.h \
             $$PWD/systemPerformanceWidgets/ResidualDemandWidget.h \
             $$PWD/Tools/TableNumberItem.h \
@@ -357,6 +390,7 @@ HEADERS +=  $$PWD/Events/UI/BedrockDepth.h \
             $$PWD/UIWidgets/HazardsWidget.h \
             $$PWD/UIWidgets/HousingUnitAllocationWidget.h \
             $$PWD/UIWidgets/HurricaneParameterWidget.h \
+            $$PWD/UIWidgets/HurricaneTrackFilterWidget.h \
             $$PWD/UIWidgets/InputWidgetOpenSeesPyAnalysis.h \
             $$PWD/UIWidgets/ModelWidget.h \
             $$PWD/UIWidgets/MultiComponentR2D.h \
@@ -420,7 +454,9 @@ HEADERS +=  $$PWD/Events/UI/BedrockDepth.h \
 	    $$PWD/assetWidgets/EPANET2.2/src/text.h \
 	    $$PWD/assetWidgets/EPANET2.2/src/types.h \
 	    $$PWD/assetWidgets/EPANET2.2/src/version.h \
-	    $$PWD/assetWidgets/EPANET2.2/src/mempool.h 
+	    $$PWD/assetWidgets/EPANET2.2/src/mempool.h \
+	    $$PWD/assetWidgets/EPANET2.2/src/outputJSON.h \
+	    $$PWD/assetWidgets/EPANET2.2/geoJSON.h 
 
 #contains(DEFINES, ARC_GIS)  {
 
@@ -468,6 +504,8 @@ HEADERS +=  $$PWD/Events/UI/BedrockDepth.h \
 # Add QGIS sources and headers
 
 SOURCES +=  $$PWD/Tools/QGISHurricanePreprocessor.cpp \
+            $$PWD/Tools/HurricaneTrackIndex.cpp \
+            $$PWD/Tools/SiteRasterExtractor.cpp \
             $$PWD/UIWidgets/LineAssetInputWidget.cpp \
             $$PWD/UIWidgets/PointAssetInputWidget.cpp \
             $$PWD/UIWidgets/CSVWaterNetworkInputWidget.cpp \
@@ -484,6 +522,8 @@ SOURCES +=  $$PWD/Tools/QGISHurricanePreprocessor.cpp \
 #            $$PWD/ModelViewItems/LayerTreeView.cpp \
 
 HEADERS +=  $$PWD/Tools/QGISHurricanePreprocessor.h \
+            $$PWD/Tools/HurricaneTrackIndex.h \
+            $$PWD/Tools/SiteRasterExtractor.h \
             $$PWD/UIWidgets/LineAssetInputWidget.h \
             $$PWD/UIWidgets/PointAssetInputWidget.h \
             $$PWD/UIWidgets/CSVWaterNetworkInputWidget.h \
@@ -178,6 +178,8 @@ DATABASE_DIR=$$DESTDIR/Databases
 
     mkpath($$OUT_PWD/R2D.app/Contents/MacOS/Examples)
 
+    } else {
+    DATABASE_DIR=$$OUT_PWD/Databases
     }
 }
 
@@ -191,16 +193,32 @@ win32 {
 # CopyDLLs.commands = $(COPY_DIR) $$shell_quote($$shell_path($$PWD/winDLLS)) $$shell_quote($$shell_path($$DESTDIR))
 # first.depends += CopyDLLs
 
-# CopyDbs.commands = $(COPY_DIR) $$shell_quote($$shell_path($$PWD/Databases)) $$shell_quote($$shell_path($$DATABASE_DIR))
-# first.depends += CopyDbs
-
-# export(first.depends)
-# export(CopyDbs.commands)
 # export(CopyDLLs.commands)
 
-# QMAKE_EXTRA_TARGETS += first Copydata CopyDbs CopyDLLs
+# Copies the databases folder into the build directory
+CopyDbs.commands = $(COPY_DIR) $$shell_quote($$shell_path($$PWD/Databases)) $$shell_quote($$shell_path($$DATABASE_DIR))
+first.depends = $(first) CopyDbs
+
+export(first.depends)
+export(CopyDbs.commands)
+
+QMAKE_EXTRA_TARGETS += first CopyDbs
 
 }else {
+
+# Copies the databases folder into the build directory, the preview of the MDOF-LU models reads its tables from there
+mac {
+CopyDbs.commands = $(COPY_DIR) $$shell_quote($$shell_path($$PWD/Databases)) $$shell_quote($$shell_path($$DATABASE_DIR))
+} else {
+CopyDbs.commands = $(MKDIR) $$shell_quote($$shell_path($$DATABASE_DIR)) && $(COPY_DIR) $$shell_quote($$shell_path($$PWD/Databases/.)) $$shell_quote($$shell_path($$DATABASE_DIR))
+}
+first.depends = $(first) CopyDbs
+
+export(first.depends)
+export(CopyDbs.commands)
+
+QMAKE_EXTRA_TARGETS += first CopyDbs
+
 mac {
 
 message($$PATH_TO_EXAMPLES)
@@ -210,16 +228,12 @@ exists( $$shell_path($$PATH_TO_EXAMPLES/Examples.json) ) {
 # Copies the examples folder into the build directory
 #Copydata.commands = $(COPY_DIR) $$shell_quote($$shell_path($$PATH_TO_EXAMPLES/Examples.json)) $$shell_quote($$shell_path($$EXAMPLES_DIR))
 
-# Copies the databases folder into the build directory
-#CopyDbs.commands = $(COPY_DIR) $$shell_quote($$shell_path($$PWD/Databases)) $$shell_quote($$shell_path($$DATABASE_DIR))
-
-#first.depends += Copydata CopyDbs
+#first.depends += Copydata
 
 #export(first.depends)
 #export(Copydata.commands)
-#export(CopyDbs.commands)
 
-#QMAKE_EXTRA_TARGETS += first Copydata CopyDbs
+#QMAKE_EXTRA_TARGETS += first Copydata
 
 } else {
 message("Warning: Could not find Examples.json, skipping copy functionality")
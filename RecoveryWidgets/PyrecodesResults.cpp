@@ -39,6 +39,7 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 #include "PyrecodesResults.h"
 #include "VisualizationWidget.h"
 #include "QGISVisualizationWidget.h"
+#include "TimeSeriesAggregator.h"
 
 #include <QMap>
 #include <QComboBox>
@@ -273,33 +274,11 @@ int PyrecodesResults::processResults(QString &outputFile, QString &outputDirPath
 
   // loop foreach working dir
 
-  int counter = 0;
+  QStringList realizationDirs;
   for (const QString &work_directory : work_directories) {
 
     workDir.cd(work_directory);
-    
-    //
-    // foreach resource add supply line data
-    //
-
-    int resourceCounter = 0;
-    for (const QString &resource: resourceList) {
-	
-      // add supply curve for resource
-      QLineSeries *supplyLineSeries = new QLineSeries();
-      //QLineSeries *demandLineSeries = new QLineSeries();
-      //QLineSeries *consumptionLineSeries = new QLineSeries();      
-      QString fileName = workDir.absoluteFilePath(fileList[resourceCounter]);
-
-      readDemandSupplyJSON(fileName, supplyLineSeries);
-      supplyLineSeries->setName(work_directory);
-
-      SC_MLC_ChartData *resourceChartData = multipleLineChartData[resource];
-      supplyLineSeries->setPen(QPen(Qt::blue));
-      resourceChartData->theLines.append(supplyLineSeries);
-      
-      resourceCounter++;
-    }
+    realizationDirs.append(workDir.absolutePath());
 
     //
     // create a gif
@@ -315,9 +294,75 @@ int PyrecodesResults::processResults(QString &outputFile, QString &outputDirPath
     sdComboBox->addItem(work_directory);
     sdWorkDirs.append(workDir.absolutePath());    
 
-    counter++;
     workDir.cdUp();
-    
+  }
+
+  //
+  // aggregate the supply curves of all realizations in parallel, instead of one line series per realization & resource
+  //   - curves are put on a daily time axis starting the day before the event
+  //
+
+  auto supplyReader = [fileList](const QString &dirPath, QMap<QString, RealizationSeries> &series, QString &err) {
+
+    QDir realizationDir(dirPath);
+
+    for (const QString &fileName : fileList) {
+
+      QString resource = fileName.left(fileName.length() - QString("_supply_demand_consumption.json").length());
+      RealizationSeries &supplySeries = series[resource];
+      QVector<double> demand, consumption;
+
+      if (parseDemandSupplyJSON(realizationDir.absoluteFilePath(fileName), supplySeries.time, supplySeries.values, demand, consumption, err) != 0)
+	return -1;
+    }
+
+    return 0;
+  };
+
+  QMap<QString, TimeSeriesAggregator> supplyAggregators;
+  QString err;
+  int numSampled = 5;
+  QStringList skippedRealizations;
+  if (TimeSeriesAggregator::aggregateRealizations(realizationDirs, supplyReader, -1.0, 1.0, supplyAggregators, err, numSampled, &skippedRealizations) != 0) {
+    errorMessage(QString("PyrecodesResults: ") + err);
+    return -1;
+  }
+
+  // a realization that could not be read is left out of the curves instead of dropping all of the charts
+  for (const QString &skipped : skippedRealizations)
+    errorMessage(QString("PyrecodesResults: skipping the realization ") + skipped);
+
+  int counter = work_directories.size() - skippedRealizations.size();
+  
+  for (const QString &resource: resourceList) {
+
+    SC_MLC_ChartData *resourceChartData = multipleLineChartData[resource];
+    const TimeSeriesAggregator &supplyAggregator = supplyAggregators[resource];
+    QVector<double> timeAxis = supplyAggregator.getTimeAxis();
+
+    auto createSeries = [&timeAxis](const QVector<double> &values, const QString &name, const QPen &pen) {
+      QLineSeries *lineSeries = new QLineSeries();
+      QVector<QPointF> points(timeAxis.size());
+      for (int i = 0; i < timeAxis.size(); ++i)
+	points[i] = QPointF(timeAxis[i], values[i]);
+      lineSeries->replace(points);
+      lineSeries->setName(name);
+      lineSeries->setPen(pen);
+      return lineSeries;
+    };
+
+    // a few sampled realizations
+    auto sampledRealizations = supplyAggregator.getSampledRealizations();
+    for (auto it = sampledRealizations.constBegin(); it != sampledRealizations.constEnd(); ++it)
+      resourceChartData->theLines.append(createSeries(it.value(), it.key(), QPen(Qt::blue)));
+
+    // mean and percentile band once there are more realizations than are drawn
+    if (counter > numSampled) {
+      resourceChartData->theLines.append(createSeries(supplyAggregator.getPercentile(0.05), "5th Percentile", QPen(QColor("red"), 2, Qt::DashLine)));
+      resourceChartData->theLines.append(createSeries(supplyAggregator.getPercentile(0.95), "95th Percentile", QPen(QColor("red"), 2, Qt::DashLine)));
+      resourceChartData->theLines.append(createSeries(supplyAggregator.getMean(), "Mean", QPen(QColor("black"), 3, Qt::SolidLine)));
+      resourceChartData->showLegend = true;
+    }
   }
 
   supplyChart->setData(&multipleLineChartData);
@@ -349,6 +394,35 @@ PyrecodesResults::readDemandSupplyJSON(QString &filename,
 				       QtCharts::QLineSeries *demandSeries,
 				       QtCharts::QLineSeries *consumptionSeries) {
 
+  QVector<double> timeSteps, supply, demand, consumption;
+  QString err;
+
+  if (parseDemandSupplyJSON(filename, timeSteps, supply, demand, consumption, err) != 0) {
+    errorMessage(err);
+    return -1;
+  }
+
+  // append to line series, first point on line indicates day before event same as day 0
+  for (int i = 0; i < timeSteps.size(); ++i) {
+    supplySeries->append(timeSteps[i], supply[i]);
+    if (demandSeries != 0)    
+      demandSeries->append(timeSteps[i], demand[i]);
+    if (consumptionSeries != 0)    
+      consumptionSeries->append(timeSteps[i], consumption[i]); 
+  }
+  
+  return 0;
+}
+
+
+int
+PyrecodesResults::parseDemandSupplyJSON(const QString &filename,
+					QVector<double> &time,
+					QVector<double> &supply,
+					QVector<double> &demand,
+					QVector<double> &consumption,
+					QString &err) {
+
   //
   // Open the file in read-only mode & get JSON object
   //
@@ -356,8 +430,7 @@ PyrecodesResults::readDemandSupplyJSON(QString &filename,
   // open file
   QFile file(filename);
   if (!file.exists() || !file.open(QIODevice::ReadOnly)) {
-    QString message("PyrecodesResults Failed to open file specified"); message += filename;
-    errorMessage(message);
+    err = QString("PyrecodesResults Failed to open file specified ") + filename;
     return -1;
   }
   
@@ -367,47 +440,47 @@ PyrecodesResults::readDemandSupplyJSON(QString &filename,
   // Parse the JSON document and get a JSON object
   QJsonDocument jsonDoc = QJsonDocument::fromJson(fileData);
   if (jsonDoc.isNull() || !jsonDoc.isObject()) { 
-    errorMessage("PyrecodesResults: file specified is not in JSON format");
+    err = QString("PyrecodesResults: file specified is not in JSON format ") + filename;
     return -1;
   }
   QJsonObject jsonObj = jsonDoc.object();
 
   //
-  // now lets parse the JSON object for time and supply values & add to the QLineSeries
+  // now lets parse the JSON object for time and supply values
   //
   
   QJsonArray timeSteps = jsonObj["TimeStep"].toArray();
-  QJsonArray supply = jsonObj["Supply"].toArray();
-  QJsonArray consumption = jsonObj["Consumption"].toArray();
-  QJsonArray demand = jsonObj["Demand"].toArray();  
+  QJsonArray supplyArray = jsonObj["Supply"].toArray();
+  QJsonArray consumptionArray = jsonObj["Consumption"].toArray();
+  QJsonArray demandArray = jsonObj["Demand"].toArray();  
 
   // Check for matching array sizes
-  if (timeSteps.size() != supply.size() ||
-      timeSteps.size() != consumption.size() ||
-      timeSteps.size() != demand.size()) {
-    qDebug() << "PyrecodesResults:: readDataFROmJSON: Array sizes do not match for file: " << filename;
+  if (timeSteps.size() != supplyArray.size() ||
+      timeSteps.size() != consumptionArray.size() ||
+      timeSteps.size() != demandArray.size()) {
+    err = QString("PyrecodesResults:: readDataFROmJSON: Array sizes do not match for file: ") + filename;
     return -1;
   }
 
-  // loop over arrays and append to line series
+  int numPoints = timeSteps.isEmpty() ? 0 : timeSteps.size() + 1;
+  time.resize(numPoints);
+  supply.resize(numPoints);
+  demand.resize(numPoints);
+  consumption.resize(numPoints);
+
+  // loop over arrays, the first point indicates day before event same as day 0
   for (int i = 0; i < timeSteps.size(); ++i) {
-    int timeStep = timeSteps[i].toInt();
-    double supplyValue = supply[i].toDouble();
-    double consumptionValue = consumption[i].toDouble();
-    double demandValue = demand[i].toDouble();    
-    if (i == 0) {
-      // add a point on line to indicate day before event same as day 0      
-      supplySeries->append(-1, supplyValue);
-      if (demandSeries != 0)
-	demandSeries->append(-1, demandValue);
-      if (consumptionSeries != 0)
-	consumptionSeries->append(-1, consumptionValue);
-    }
-    supplySeries->append(timeStep, supplyValue);
-    if (demandSeries != 0)    
-      demandSeries->append(timeStep, demandValue);
-    if (consumptionSeries != 0)    
-      consumptionSeries->append(timeStep, consumptionValue); 
+    time[i+1] = timeSteps[i].toInt();
+    supply[i+1] = supplyArray[i].toDouble();
+    consumption[i+1] = consumptionArray[i].toDouble();
+    demand[i+1] = demandArray[i].toDouble();    
+  }
+
+  if (numPoints != 0) {
+    time[0] = -1;
+    supply[0] = supply[1];
+    consumption[0] = consumption[1];
+    demand[0] = demand[1];
   }
   
   return 0;
@@ -96,6 +96,14 @@ private:
 			   QtCharts::QLineSeries *consumptionSeries =0);
   int processSupplyDemandUpdate(QString &workdirPath);
 
+  // parses a *_supply_demand_consumption.json file, safe to call from worker threads
+  static int parseDemandSupplyJSON(const QString &filename,
+				   QVector<double> &time,
+				   QVector<double> &supply,
+				   QVector<double> &demand,
+				   QVector<double> &consumption,
+				   QString &err);
+
   // data
   QVBoxLayout* layout;
   QDockWidget* curveDockWidget;
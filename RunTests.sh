@@ -127,4 +127,35 @@ then
     exit $status;
 fi
 
+# Build and run the benchmarks, they check their results and fail if the results are wrong
+mkdir -p ./build/benchmarks
+
+cd ./build/benchmarks
+
+qmake ../../Tests/R2DBenchmarks.pri
+status=$?
+if [[ $status != 0 ]]
+then
+    echo "R2D Benchmarks: qmake failed";
+    exit $status;
+fi
+
+make -j8
+status=$?;
+if [[ $status != 0 ]]
+then
+    echo "R2D Benchmarks: make failed";
+    exit $status;
+fi
+
+./R2DBenchmarks
+status=$?
+if [[ $status != 0 ]]
+then
+    echo "R2D: benchmarks failed";
+    exit $status;
+fi
+
+cd ../..
+
 echo "All R2D Unit Tests Passed!"
\ No newline at end of file
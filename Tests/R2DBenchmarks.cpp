@@ -0,0 +1,662 @@
+/* *****************************************************************************
+Copyright (c) 2016-2021, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+// Written by: Stevan Gavrilovic
+
+// Benchmarks of the tools that process large tables and networks, run with the name of the benchmark as the argument, e.g., R2DBenchmarks flatfile
+// Each benchmark times a tool on synthetic data against a serial or a reference implementation and checks that they give the same result
+
+#include "FlatfileRecordSelector.h"
+#include "GeoJSONFootprintReader.h"
+#include "IDHashJoin.h"
+#include "NearestNeighbourMapper.h"
+#include "epanet2_2.h"
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include <QThreadPool>
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <random>
+#include <unordered_map>
+
+namespace {
+
+// Runs the function with the given number of threads in the global thread pool and returns the elapsed time in ms
+qint64 timeWithThreads(const int numThreads, const std::function<int(void)>& function, int& result)
+{
+    auto threadPool = QThreadPool::globalInstance();
+    auto defaultThreads = threadPool->maxThreadCount();
+
+    threadPool->setMaxThreadCount(numThreads);
+
+    QElapsedTimer timer;
+    timer.start();
+
+    result = function();
+
+    auto elapsed = timer.elapsed();
+
+    threadPool->setMaxThreadCount(defaultThreads);
+
+    return elapsed;
+}
+
+
+int benchmarkFlatfile(void)
+{
+    const int numRecords = 20000;
+
+    QTemporaryDir tempDir;
+    if(!tempDir.isValid())
+    {
+        qCritical()<<"Could not create a temporary directory";
+        return -1;
+    }
+
+    auto pathToFlatfile = tempDir.filePath("Flatfile.csv");
+    auto pathToSpectra = tempDir.filePath("Spectra.csv");
+
+    QString err;
+    if(FlatfileRecordSelector::writeSyntheticFlatfile(numRecords, pathToFlatfile, pathToSpectra, err, 1) != 0)
+    {
+        qCritical()<<err;
+        return -1;
+    }
+
+    FlatfileRecordSelector selector;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    if(selector.loadFlatfile(pathToFlatfile, pathToSpectra, err) != 0)
+    {
+        qCritical()<<err;
+        return -1;
+    }
+
+    qInfo()<<"Loaded"<<selector.getNumRecords()<<"records in"<<timer.elapsed()<<"ms";
+
+    // A target spectrum with the shape of a design spectrum on the periods of the flatfile
+    RecordSelectionCriteria criteria;
+    criteria.numRecords = 40;
+    criteria.minScaleFactor = 0.5;
+    criteria.maxScaleFactor = 4.0;
+
+    for(auto&& period : selector.getPeriods())
+    {
+        criteria.targetPeriods.append(period);
+        criteria.targetSpectrum.append(period < 0.6 ? 1.0 : 0.6/period);
+    }
+
+    QVector<SelectedRecord> serialRecords;
+    QVector<SelectedRecord> parallelRecords;
+
+    int serialResult = 0;
+    int parallelResult = 0;
+
+    auto serialTime = timeWithThreads(1, [&]() { return selector.selectRecords(criteria, serialRecords, err); }, serialResult);
+    auto parallelTime = timeWithThreads(QThread::idealThreadCount(), [&]() { return selector.selectRecords(criteria, parallelRecords, err); }, parallelResult);
+
+    if(serialResult != 0 || parallelResult != 0)
+    {
+        qCritical()<<err;
+        return -1;
+    }
+
+    qInfo()<<"Selection with 1 thread:"<<serialTime<<"ms, with"<<QThread::idealThreadCount()<<"threads:"<<parallelTime<<"ms";
+
+    if(FlatfileRecordSelector::getRecordSequenceNumbers(serialRecords) != FlatfileRecordSelector::getRecordSequenceNumbers(parallelRecords))
+    {
+        qCritical()<<"The serial and the parallel selection differ";
+        return -1;
+    }
+
+    return 0;
+}
+
+
+
+int benchmarkIDJoin(void)
+{
+    const int numIDs = 1000000;
+
+    // Shuffled site and asset IDs, every 1000th asset has an ID without a site
+    std::mt19937_64 generator(3);
+
+    QVector<qint64> siteIDs(numIDs);
+    QVector<qint64> assetIDs(numIDs);
+    for(int i = 0; i<numIDs; ++i)
+    {
+        siteIDs[i] = i+1;
+        assetIDs[i] = i+1;
+    }
+
+    std::shuffle(siteIDs.begin(), siteIDs.end(), generator);
+    std::shuffle(assetIDs.begin(), assetIDs.end(), generator);
+
+    for(int i = 0; i<numIDs; i += 1000)
+        assetIDs[i] += 5*numIDs;
+
+    QString err;
+    QVector<int> duplicateSites;
+    IDJoinResult result;
+    IDHashJoin hashJoin;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    if(hashJoin.setSiteIDs(siteIDs, duplicateSites, err) != 0)
+    {
+        qCritical()<<err;
+        return -1;
+    }
+
+    auto buildTime = timer.restart();
+
+    if(hashJoin.join(assetIDs, result, err) != 0)
+    {
+        qCritical()<<err;
+        return -1;
+    }
+
+    auto joinTime = timer.restart();
+
+    // Reference join with the standard library hash map
+    std::unordered_map<qint64, int> siteRows;
+    siteRows.reserve(numIDs);
+    for(int i = 0; i<numIDs; ++i)
+        siteRows.emplace(siteIDs.at(i), i);
+
+    int numReferenceMatched = 0;
+    for(auto&& id : assetIDs)
+        numReferenceMatched += siteRows.count(id);
+
+    auto referenceTime = timer.elapsed();
+
+    qInfo()<<"Hash join of"<<numIDs<<"IDs, build:"<<buildTime<<"ms, join:"<<joinTime<<"ms, std::unordered_map:"<<referenceTime<<"ms";
+
+    int numWrong = 0;
+    for(int i = 0; i<numIDs; ++i)
+    {
+        auto row = result.siteRows.at(i);
+        if(row != -1 && siteIDs.at(row) != assetIDs.at(i))
+            ++numWrong;
+    }
+
+    if(numWrong != 0 || result.numMatched != numReferenceMatched || result.unmatchedAssets.size() != numIDs - numReferenceMatched)
+    {
+        qCritical()<<"The hash join does not agree with the reference join";
+        return -1;
+    }
+
+    return 0;
+}
+
+
+// Writes an EPANET input file of a square grid of junctions with the given number of junctions on each side, fed by a reservoir at two opposite corners
+int writeGridNetwork(const int numSide, const QString& pathToInp, QString& err)
+{
+    QFile file(pathToInp);
+    if(!file.open(QIODevice::WriteOnly | QIODevice::Text))
+    {
+        err = "Could not open the file " + pathToInp + " for writing";
+        return -1;
+    }
+
+    std::mt19937_64 generator(5);
+    std::uniform_real_distribution<double> elevation(0.0, 20.0);
+    std::uniform_real_distribution<double> demand(0.0, 0.05);
+    std::uniform_int_distribution<int> diameter(0, 3);
+    const int diameters[] = {6, 8, 10, 12};
+
+    auto junction = [](int i, int j) { return QString("J%1_%2").arg(i).arg(j); };
+
+    QTextStream out(&file);
+
+    out<<"[TITLE]\nSynthetic grid\n\n[JUNCTIONS]\n";
+    for(int i = 0; i<numSide; ++i)
+        for(int j = 0; j<numSide; ++j)
+            out<<junction(i,j)<<"\t"<<elevation(generator)<<"\t"<<demand(generator)<<"\tP1\n";
+
+    out<<"\n[RESERVOIRS]\nR1\t120\n\n[PIPES]\n";
+    int numPipes = 0;
+    for(int i = 0; i<numSide; ++i)
+    {
+        for(int j = 0; j<numSide; ++j)
+        {
+            if(j+1 < numSide)
+                out<<"P"<<++numPipes<<"\t"<<junction(i,j)<<"\t"<<junction(i,j+1)<<"\t100\t"<<diameters[diameter(generator)]<<"\t120\t0\tOpen\n";
+            if(i+1 < numSide)
+                out<<"P"<<++numPipes<<"\t"<<junction(i,j)<<"\t"<<junction(i+1,j)<<"\t100\t"<<diameters[diameter(generator)]<<"\t120\t0\tOpen\n";
+        }
+    }
+    out<<"S1\tR1\t"<<junction(0,0)<<"\t10\t48\t130\t0\tOpen\n";
+    out<<"S2\tR1\t"<<junction(numSide-1,numSide-1)<<"\t10\t48\t130\t0\tOpen\n";
+
+    out<<"\n[PATTERNS]\nP1\t1.0\t0.8\t0.6\t0.9\t1.2\t1.4\n";
+    out<<"\n[TIMES]\nDuration\t24:00\nHydraulic Timestep\t1:00\nPattern Timestep\t4:00\n";
+    out<<"\n[OPTIONS]\nUnits\tGPM\nHeadloss\tH-W\n\n[END]\n";
+
+    return 0;
+}
+
+
+// Runs the hydraulics of the network in a new project that is deleted afterwards
+// Returns the time to open the hydraulics in ms, which includes the symbolic factorization of the matrix, and the sum of the heads at all nodes and time steps
+int solveNetwork(const QString& pathToInp, const QString& pathToReport, double& openTime, double& sumOfHeads, QString& err)
+{
+    EN_Project project = nullptr;
+    EN_createproject(&project);
+
+    auto errorCode = EN_open(project, pathToInp.toLocal8Bit().constData(), pathToReport.toLocal8Bit().constData(), "");
+
+    QElapsedTimer timer;
+    timer.start();
+
+    if(errorCode == 0)
+        errorCode = EN_openH(project);
+
+    openTime = timer.nsecsElapsed()/1.0e6;
+
+    int numNodes = 0;
+    if(errorCode == 0)
+        errorCode = EN_getcount(project, EN_NODECOUNT, &numNodes);
+
+    if(errorCode == 0)
+        errorCode = EN_initH(project, 0);
+
+    sumOfHeads = 0.0;
+    long time = 0;
+    long timeStep = 0;
+    do
+    {
+        if(errorCode != 0)
+            break;
+
+        errorCode = EN_runH(project, &time);
+        if(errorCode > 100)
+            break;
+
+        for(int i = 1; i<=numNodes; ++i)
+        {
+            double head = 0.0;
+            EN_getnodevalue(project, i, EN_HEAD, &head);
+            sumOfHeads += head;
+        }
+
+        errorCode = EN_nextH(project, &timeStep);
+
+    } while(timeStep > 0);
+
+    EN_closeH(project);
+    EN_close(project);
+    EN_deleteproject(project);
+
+    if(errorCode > 100)
+    {
+        err = "EPANET failed with the error code " + QString::number(errorCode);
+        return -1;
+    }
+
+    return 0;
+}
+
+
+int benchmarkEPANET(void)
+{
+    const int numSide = 100;
+    const int numRuns = 3;
+
+    QTemporaryDir tempDir;
+    if(!tempDir.isValid())
+    {
+        qCritical()<<"Could not create a temporary directory";
+        return -1;
+    }
+
+    auto pathToInp = tempDir.filePath("Grid.inp");
+    auto pathToReport = tempDir.filePath("Grid.rpt");
+
+    QString err;
+    if(writeGridNetwork(numSide, pathToInp, err) != 0)
+    {
+        qCritical()<<err;
+        return -1;
+    }
+
+    QVector<double> sumsOfHeads;
+
+    // Without another project the symbolic factorization cache is emptied when each project is deleted, so every run factorizes the matrix
+    for(int i = 0; i<numRuns; ++i)
+    {
+        double openTime = 0.0;
+        double sumOfHeads = 0.0;
+        if(solveNetwork(pathToInp, pathToReport, openTime, sumOfHeads, err) != 0)
+        {
+            qCritical()<<err;
+            return -1;
+        }
+
+        qInfo()<<"Run"<<i+1<<"of a grid of"<<numSide*numSide<<"junctions, open hydraulics:"<<openTime<<"ms";
+        sumsOfHeads.append(sumOfHeads);
+    }
+
+    // A project that stays open keeps the cache alive, so the runs reuse its symbolic factorization
+    EN_Project holder = nullptr;
+    EN_createproject(&holder);
+
+    auto errorCode = EN_open(holder, pathToInp.toLocal8Bit().constData(), tempDir.filePath("Holder.rpt").toLocal8Bit().constData(), "");
+    if(errorCode == 0)
+        errorCode = EN_openH(holder);
+
+    for(int i = 0; i<numRuns && errorCode == 0; ++i)
+    {
+        double openTime = 0.0;
+        double sumOfHeads = 0.0;
+        if(solveNetwork(pathToInp, pathToReport, openTime, sumOfHeads, err) != 0)
+        {
+            errorCode = -1;
+            break;
+        }
+
+        qInfo()<<"Run"<<i+1<<"with a shared symbolic factorization, open hydraulics:"<<openTime<<"ms";
+        sumsOfHeads.append(sumOfHeads);
+    }
+
+    EN_closeH(holder);
+    EN_close(holder);
+    EN_deleteproject(holder);
+
+    if(errorCode != 0)
+    {
+        qCritical()<<(err.isEmpty() ? "EPANET failed with the error code " + QString::number(errorCode) : err);
+        return -1;
+    }
+
+    // The shared factorization is the same as the one of each run, so the heads must agree exactly
+    for(auto&& sumOfHeads : sumsOfHeads)
+    {
+        if(sumOfHeads != sumsOfHeads.first())
+        {
+            qCritical()<<"The heads of the runs differ";
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+
+int benchmarkFootprints(void)
+{
+    const int numFootprints = 100000;
+    const int verticesPerEdge = 25;
+    const int chunkSize = 10000;
+
+    // Tolerance of the overview layer of the inventory generator, about 10 m
+    const double tolerance = 1.0e-4;
+
+    // A region of about 20 km by 20 km so that the footprints are of the size of buildings
+    const QRectF region(-122.4, 37.6, 0.2, 0.2);
+
+    QTemporaryDir tempDir;
+    if(!tempDir.isValid())
+    {
+        qCritical()<<"Could not create a temporary directory";
+        return -1;
+    }
+
+    auto pathToFile = tempDir.filePath("Footprints.geojson");
+
+    QString err;
+    if(GeoJSONFootprintReader::writeSyntheticFootprints(pathToFile, numFootprints, verticesPerEdge, region, err) != 0)
+    {
+        qCritical()<<err;
+        return -1;
+    }
+
+    GeoJSONFootprintReader reader;
+    reader.setSimplificationTolerances({tolerance});
+
+    QElapsedTimer timer;
+    timer.start();
+
+    if(reader.open(pathToFile, err) != 0)
+    {
+        qCritical()<<err;
+        return -1;
+    }
+
+    // The footprints are laid out on a grid, with each one in the middle of its cell
+    const int numColumns = static_cast<int>(std::ceil(std::sqrt(static_cast<double>(numFootprints))));
+    const double cellWidth = region.width()/numColumns;
+    const double cellHeight = region.height()/numColumns;
+
+    qint64 numSimplifiedVertices = 0;
+    int count = 0;
+
+    QVector<BuildingFootprint> footprints;
+    while(true)
+    {
+        auto numRead = reader.readChunk(chunkSize, footprints, err);
+
+        if(numRead < 0)
+        {
+            qCritical()<<err;
+            return -1;
+        }
+
+        if(numRead == 0)
+            break;
+
+        for(auto&& footprint : footprints)
+        {
+            const double cellX = region.left() + (count % numColumns + 0.5)*cellWidth;
+            const double cellY = region.top() + (count / numColumns + 0.5)*cellHeight;
+
+            if(std::abs(footprint.centroid.x() - cellX) > 0.05*cellWidth || std::abs(footprint.centroid.y() - cellY) > 0.05*cellHeight)
+            {
+                qCritical()<<"The centroid of the footprint"<<count<<"is not in the middle of its cell";
+                return -1;
+            }
+
+            for(auto&& polygon : footprint.simplifiedPolygons.first())
+                for(auto&& ring : polygon)
+                    numSimplifiedVertices += ring.size();
+
+            ++count;
+        }
+    }
+
+    auto elapsed = timer.elapsed();
+
+    if(reader.getNumFeaturesRead() != numFootprints || count != numFootprints)
+    {
+        qCritical()<<"Read"<<count<<"footprints, expected"<<numFootprints;
+        return -1;
+    }
+
+    qInfo()<<"Read"<<count<<"footprints with"<<reader.getNumVerticesRead()<<"vertices in"<<elapsed<<"ms, the overview keeps"<<numSimplifiedVertices<<"vertices";
+
+    return 0;
+}
+
+
+int benchmarkNearestNeighbour(void)
+{
+    const int numAssets = 1000000;
+    const int numStations = 100000;
+    const int numNeighbours = 4;
+    const int numSamples = 5;
+    const int seed = 42;
+
+    // Number of assets whose nearest station is checked against a brute force search
+    const int numChecked = 1000;
+
+    // Stations and assets spread over a region the size of a large county
+    std::mt19937 generator(seed);
+    std::uniform_real_distribution<double> latDistribution(37.0, 38.5);
+    std::uniform_real_distribution<double> lonDistribution(-123.0, -121.5);
+
+    QVector<double> stationLatitudes(numStations), stationLongitudes(numStations);
+    for(int i = 0; i<numStations; ++i)
+    {
+        stationLatitudes[i] = latDistribution(generator);
+        stationLongitudes[i] = lonDistribution(generator);
+    }
+
+    QVector<double> assetLatitudes(numAssets), assetLongitudes(numAssets);
+    for(int i = 0; i<numAssets; ++i)
+    {
+        assetLatitudes[i] = latDistribution(generator);
+        assetLongitudes[i] = lonDistribution(generator);
+    }
+
+    QString err;
+    NearestNeighbourMapper mapper;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    if(mapper.setStations(stationLatitudes, stationLongitudes, err) != 0)
+    {
+        qCritical()<<err;
+        return -1;
+    }
+
+    qInfo()<<"Built the tree of"<<numStations<<"stations in"<<timer.elapsed()<<"ms";
+
+    QVector<int> serialSamples, parallelSamples;
+    QVector<double> serialDistances, parallelDistances;
+
+    int serialResult = 0;
+    int parallelResult = 0;
+
+    auto serialTime = timeWithThreads(1, [&]() { return mapper.computeMapping(assetLatitudes, assetLongitudes, numNeighbours, numSamples, seed, serialSamples, serialDistances, err); }, serialResult);
+    auto parallelTime = timeWithThreads(QThread::idealThreadCount(), [&]() { return mapper.computeMapping(assetLatitudes, assetLongitudes, numNeighbours, numSamples, seed, parallelSamples, parallelDistances, err); }, parallelResult);
+
+    if(serialResult != 0 || parallelResult != 0)
+    {
+        qCritical()<<err;
+        return -1;
+    }
+
+    qInfo()<<"Mapping of"<<numAssets<<"assets with 1 thread:"<<serialTime<<"ms, with"<<QThread::idealThreadCount()<<"threads:"<<parallelTime<<"ms";
+
+    if(serialSamples != parallelSamples || serialDistances != parallelDistances)
+    {
+        qCritical()<<"The serial and the parallel mapping differ";
+        return -1;
+    }
+
+    // The nearest station of the tree must be the one of a linear scan with the same planar distance in degrees
+    for(int i = 0; i<numChecked; ++i)
+    {
+        const int asset = i*(numAssets/numChecked);
+
+        int nearestStation = 0;
+        double nearestDistance = -1.0;
+
+        for(int j = 0; j<numStations; ++j)
+        {
+            const double dx = stationLongitudes.at(j) - assetLongitudes.at(asset);
+            const double dy = stationLatitudes.at(j) - assetLatitudes.at(asset);
+            const double distance = dx*dx + dy*dy;
+
+            if(nearestDistance < 0.0 || distance < nearestDistance)
+            {
+                nearestStation = j;
+                nearestDistance = distance;
+            }
+        }
+
+        QVector<int> indices;
+        QVector<double> distances;
+        mapper.findNearest(assetLatitudes.at(asset), assetLongitudes.at(asset), 1, indices, distances);
+
+        if(indices.isEmpty() || indices.first() != nearestStation)
+        {
+            qCritical()<<"The nearest station of asset"<<asset<<"differs from the one of a brute force search";
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+}
+
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    const QMap<QString, std::function<int(void)>> benchmarks = {
+        {"flatfile", benchmarkFlatfile},
+        {"idjoin", benchmarkIDJoin},
+        {"epanet", benchmarkEPANET},
+        {"footprints", benchmarkFootprints},
+        {"nearest", benchmarkNearestNeighbour},
+    };
+
+    auto args = app.arguments();
+
+    // Run all of the benchmarks if none is given
+    QStringList toRun = args.size() > 1 ? args.mid(1) : benchmarks.keys();
+
+    for(auto&& name : toRun)
+    {
+        if(!benchmarks.contains(name))
+        {
+            qCritical()<<"Unknown benchmark"<<name<<", the benchmarks are:"<<benchmarks.keys();
+            return 1;
+        }
+
+        qInfo()<<"Running the benchmark"<<name;
+
+        if(benchmarks.value(name)() != 0)
+            return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,58 @@
+TARGET    = R2DBenchmarks
+CONFIG   += console
+CONFIG   -= app_bundle
+
+
+# C++17 support
+CONFIG += c++17
+
+PATH_TO_COMMON=../../SimCenterCommon
+
+# The benchmarks only build the tools that they time, so that they do not need the GIS libraries
+QT += widgets concurrent
+
+INCLUDEPATH += $$PWD/../Events/UI \
+               $$PWD/../Tools \
+               $$PWD/../assetWidgets/EPANET2.2/include \
+               $$PWD/../assetWidgets/EPANET2.2/src \
+               $$PATH_TO_COMMON/Common \
+
+
+HEADERS += \
+        $$PWD/../Events/UI/JsonSerializable.h \
+        $$PWD/../Events/UI/RecordSelectionConfig.h \
+        $$PWD/../Events/UI/FlatfileRecordSelector.h \
+        $$PWD/../Tools/CSVReaderWriter.h \
+        $$PWD/../Tools/GeoJSONFootprintReader.h \
+        $$PWD/../Tools/IDHashJoin.h \
+        $$PWD/../Tools/NearestNeighbourMapper.h \
+
+
+SOURCES += \
+        $$PWD/R2DBenchmarks.cpp \
+        $$PWD/../Events/UI/RecordSelectionConfig.cpp \
+        $$PWD/../Events/UI/FlatfileRecordSelector.cpp \
+        $$PWD/../Tools/CSVReaderWriter.cpp \
+        $$PWD/../Tools/GeoJSONFootprintReader.cpp \
+        $$PWD/../Tools/IDHashJoin.cpp \
+        $$PWD/../Tools/NearestNeighbourMapper.cpp \
+        $$PWD/../assetWidgets/EPANET2.2/src/epanet.c \
+        $$PWD/../assetWidgets/EPANET2.2/src/genmmd.c \
+        $$PWD/../assetWidgets/EPANET2.2/src/hash.c \
+        $$PWD/../assetWidgets/EPANET2.2/src/hydcoeffs.c \
+        $$PWD/../assetWidgets/EPANET2.2/src/hydraul.c \
+        $$PWD/../assetWidgets/EPANET2.2/src/hydsolver.c \
+        $$PWD/../assetWidgets/EPANET2.2/src/hydstatus.c \
+        $$PWD/../assetWidgets/EPANET2.2/src/inpfile.c \
+        $$PWD/../assetWidgets/EPANET2.2/src/input1.c \
+        $$PWD/../assetWidgets/EPANET2.2/src/input2.c \
+        $$PWD/../assetWidgets/EPANET2.2/src/input3.c \
+        $$PWD/../assetWidgets/EPANET2.2/src/mempool.c \
+        $$PWD/../assetWidgets/EPANET2.2/src/output.c \
+        $$PWD/../assetWidgets/EPANET2.2/src/project.c \
+        $$PWD/../assetWidgets/EPANET2.2/src/quality.c \
+        $$PWD/../assetWidgets/EPANET2.2/src/qualreact.c \
+        $$PWD/../assetWidgets/EPANET2.2/src/qualroute.c \
+        $$PWD/../assetWidgets/EPANET2.2/src/report.c \
+        $$PWD/../assetWidgets/EPANET2.2/src/rules.c \
+        $$PWD/../assetWidgets/EPANET2.2/src/smatrix.c \
@@ -41,6 +41,8 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 #include "MainWindowWorkflowApp.h"
 #include "LocalApplication.h"
 #include "SimCenterPreferences.h"
+#include "LayerClassifier.h"
+#include "QuantileSketch.h"
 
 #include <QRegExp>
 #include <QCoreApplication>
@@ -77,6 +79,7 @@ public:
     }
 
 private slots:
+    void testLayerClassifierBreaks();
     void testExamples();
 
 private:
@@ -87,6 +90,29 @@ private:
 };
 
 
+void R2DUnitTests::testLayerClassifierBreaks()
+{
+    // The sketch is exact for this few values, so the breaks can be compared exactly
+    QuantileSketch sketch;
+    for(auto&& it : {10.0, 1.0, 2.0, 12.0, 1.0, 3.0, 10.0, 2.0, 11.0, 1.0})
+        sketch.add(it);
+
+    // The lower quantiles at 0.25, 0.5, and 0.75 are 1, 2, and 10, the tied values at the minimum give no break of their own
+    QCOMPARE(LayerClassifier::getQuantileBreaks(sketch, 4), QVector<double>({1.0, 2.0, 10.0, 12.0}));
+
+    // The least sum of squared deviations is that of the classes {1,1,1}, {2,2,3}, and {10,10,11,12}, with the breaks halfway between the classes
+    QCOMPARE(LayerClassifier::getNaturalBreaks(sketch, 3), QVector<double>({1.0, 1.5, 6.5, 12.0}));
+
+    // All of the values tied give a single class
+    QuantileSketch tiedSketch;
+    for(int i = 0; i<3; ++i)
+        tiedSketch.add(5.0);
+
+    QCOMPARE(LayerClassifier::getQuantileBreaks(tiedSketch, 3), QVector<double>({5.0, 5.0}));
+    QCOMPARE(LayerClassifier::getNaturalBreaks(tiedSketch, 3), QVector<double>({5.0, 5.0}));
+}
+
+
 void R2DUnitTests::testExamples()
 {
 
@@ -41,14 +41,28 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 #include <QRegExpValidator>
 
 #include <qgsvectorlayer.h>
+#include <qgsvectordataprovider.h>
+
+#include <limits>
 
 AssetFilterDelegate::AssetFilterDelegate(QgsVectorLayer *layer) : mainLayer(layer)
 {
     qb = std::make_unique<QgsQueryBuilder>(layer);
+
+    if(layer == nullptr)
+        return;
+
+    // The column copies are stale once the layer is edited, or once its subset string changes the features that the layer returns
+    connect(layer, &QgsVectorLayer::subsetStringChanged, this, &AssetFilterDelegate::clearColumnCache);
+    connect(layer, &QgsVectorLayer::attributeValueChanged, this, &AssetFilterDelegate::clearColumnCache);
+    connect(layer, &QgsVectorLayer::featureAdded, this, &AssetFilterDelegate::clearColumnCache);
+    connect(layer, &QgsVectorLayer::featuresDeleted, this, &AssetFilterDelegate::clearColumnCache);
+    connect(layer, &QgsVectorLayer::updatedFields, this, &AssetFilterDelegate::clearColumnCache);
+    connect(layer->dataProvider(), &QgsDataProvider::dataChanged, this, &AssetFilterDelegate::clearColumnCache);
 }
 
 
-int AssetFilterDelegate::openQueryBuilderDialog(QVector<int>& filterIds)
+int AssetFilterDelegate::openQueryBuilderDialog(IDRangeSet& filterIds)
 {
     // launch the query builder
     QString subsetBefore = qb->sql();
@@ -66,7 +80,7 @@ int AssetFilterDelegate::openQueryBuilderDialog(QVector<int>& filterIds)
 }
 
 
-int AssetFilterDelegate::setFilterString(const QString& filter, QVector<int>& filterIds)
+int AssetFilterDelegate::setFilterString(const QString& filter, IDRangeSet& filterIds)
 {
     // Quick return if the filter string is empty
     if(filter.isEmpty())
@@ -77,24 +91,170 @@ int AssetFilterDelegate::setFilterString(const QString& filter, QVector<int>& fi
     if(fieldIndex == -1)
         return -1;
 
+    // Try the compiled filter first, any expression outside of the supported subset falls through to the QGIS expression engine below
+    AssetFilterExpression compiledFilter;
+    QString err;
+    if(compiledFilter.compile(filter, this->getFieldTypes(), err) == 0 &&
+            this->loadColumns(compiledFilter.getReferencedFields(), err) == 0 &&
+            compiledFilter.evaluate(columnCache, columnIDs, filterIds, err) == 0)
+        return 0;
+
+    QVector<qint64> ids;
+
     QgsFeatureIterator filteredFeats = mainLayer->getFeatures(filter);
 
     QgsFeature feature;
     while (filteredFeats.nextFeature(feature))
     {
         bool ok = false;
-        auto featId = feature.attribute(fieldIndex).toInt(&ok);
+        auto featId = feature.attribute(fieldIndex).toLongLong(&ok);
 
         if(ok)
-            filterIds.push_back(featId);
+            ids.push_back(featId);
         else
             return -1;
     }
 
+    filterIds = IDRangeSet::fromIDs(ids);
+
     return 0;
 }
 
 
+int AssetFilterDelegate::loadColumns(const QStringList& fieldNames, QString& err)
+{
+    if(columnIDs.size() != mainLayer->featureCount())
+        this->clearColumnCache();
+
+    // Reload the columns that are already cached together with the new ones so that all of the columns have the same row order
+    QStringList loadFields = columnCache.keys();
+
+    bool missingField = columnIDs.isEmpty();
+    for(auto&& it : fieldNames)
+    {
+        if(!columnCache.contains(it))
+        {
+            loadFields.append(it);
+            missingField = true;
+        }
+    }
+
+    if(!missingField)
+        return 0;
+
+    auto pr = mainLayer->dataProvider();
+
+    auto idIndex = pr->fieldNameIndex("ID");
+
+    if(idIndex == -1)
+    {
+        err = "Could not find the ID field in the layer "+mainLayer->name();
+        return -1;
+    }
+
+    auto fields = pr->fields();
+
+    QgsAttributeList attributeIndexes = {idIndex};
+    QVector<int> fieldIndexes;
+    QVector<AssetFilterColumn> columns(loadFields.size());
+
+    for(int i = 0; i<loadFields.size(); ++i)
+    {
+        auto index = pr->fieldNameIndex(loadFields.at(i));
+
+        if(index == -1)
+        {
+            err = "Could not find the field "+loadFields.at(i)+" in the layer "+mainLayer->name();
+            return -1;
+        }
+
+        fieldIndexes.append(index);
+        attributeIndexes.append(index);
+
+        columns[i].type = fields.at(index).isNumeric() ? AssetFilterColumn::Numeric : AssetFilterColumn::String;
+    }
+
+    auto numFeatures = mainLayer->featureCount();
+
+    QVector<qint64> ids;
+    ids.reserve(numFeatures);
+
+    for(auto&& it : columns)
+    {
+        if(it.type == AssetFilterColumn::Numeric)
+            it.numbers.reserve(numFeatures);
+        else
+            it.strings.reserve(numFeatures);
+    }
+
+    QgsFeatureRequest featRequest;
+    featRequest.setFlags(QgsFeatureRequest::NoGeometry);
+    featRequest.setSubsetOfAttributes(attributeIndexes);
+
+    auto featIt = mainLayer->getFeatures(featRequest);
+
+    const double nanVal = std::numeric_limits<double>::quiet_NaN();
+
+    QgsFeature feat;
+    while (featIt.nextFeature(feat))
+    {
+        bool OK = false;
+        auto id = feat.attribute(idIndex).toLongLong(&OK);
+
+        if(!OK)
+        {
+            err = "Could not convert the ID of feature "+QString::number(feat.id())+" to an integer";
+            return -1;
+        }
+
+        ids.append(id);
+
+        for(int i = 0; i<columns.size(); ++i)
+        {
+            auto val = feat.attribute(fieldIndexes.at(i));
+
+            auto& column = columns[i];
+
+            if(column.type == AssetFilterColumn::Numeric)
+            {
+                auto num = val.toDouble(&OK);
+                column.numbers.append(val.isNull() || !OK ? nanVal : num);
+            }
+            else
+            {
+                column.strings.append(val.isNull() ? QString() : val.toString());
+            }
+        }
+    }
+
+    columnIDs = ids;
+
+    columnCache.clear();
+    for(int i = 0; i<loadFields.size(); ++i)
+        columnCache.insert(loadFields.at(i), columns.at(i));
+
+    return 0;
+}
+
+
+void AssetFilterDelegate::clearColumnCache(void)
+{
+    columnIDs.clear();
+    columnCache.clear();
+}
+
+
+QHash<QString, AssetFilterColumn::Type> AssetFilterDelegate::getFieldTypes(void) const
+{
+    QHash<QString, AssetFilterColumn::Type> fieldTypes;
+
+    for(auto&& field : mainLayer->fields())
+        fieldTypes.insert(field.name(), field.isNumeric() ? AssetFilterColumn::Numeric : AssetFilterColumn::String);
+
+    return fieldTypes;
+}
+
+
 QString AssetFilterDelegate::getFilterString(void)
 {
     return mainLayer->subsetString();
@@ -103,6 +263,6 @@ QString AssetFilterDelegate::getFilterString(void)
 
 void AssetFilterDelegate::clear()
 {
-
+    this->clearColumnCache();
 }
 
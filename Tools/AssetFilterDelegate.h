@@ -40,12 +40,13 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 
 class QgsVectorLayer;
 
+#include "AssetFilterExpression.h"
+#include "IDRangeSet.h"
+
 #include <qgsquerybuilder.h>
 
 #include <QObject>
 
-#include <set>
-
 class AssetFilterDelegate : public QObject
 {
     Q_OBJECT
@@ -53,23 +54,35 @@ class AssetFilterDelegate : public QObject
 public:
     AssetFilterDelegate(QgsVectorLayer *layer);
 
-    int setFilterString(const QString& filter, QVector<int>& filterIds);
+    // Filters in the subset that AssetFilterExpression supports are evaluated on a column copy of the layer, other filters go through the QGIS expression engine
+    int setFilterString(const QString& filter, IDRangeSet& filterIds);
 
     QString getFilterString(void);
 
     void clear();
 
-    int openQueryBuilderDialog(QVector<int>& filterIds);
+    int openQueryBuilderDialog(IDRangeSet& filterIds);
 
 signals:
     void filteringComplete(void);
 
 private:
 
+    // Reads the ID column and the given columns of the layer into the column cache in a single iteration
+    int loadColumns(const QStringList& fieldNames, QString& err);
+
+    void clearColumnCache(void);
+
+    QHash<QString, AssetFilterColumn::Type> getFieldTypes(void) const;
+
     std::unique_ptr<QgsQueryBuilder> qb = nullptr;
 
     QgsVectorLayer* mainLayer = nullptr;
 
+    // Typed copies of the columns that filters have used, cleared when the layer is edited or its subset string changes
+    QVector<qint64> columnIDs;
+    QHash<QString, AssetFilterColumn> columnCache;
+
 };
 
 #endif // AssetFilterDelegate_H
@@ -0,0 +1,882 @@
+/* *****************************************************************************
+Copyright (c) 2016-2021, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+// Written by: Stevan Gavrilovic
+
+#include "AssetFilterExpression.h"
+
+#include <QtConcurrent/QtConcurrent>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace
+{
+// Number of rows that are evaluated together, small enough that the masks of a block stay in the cache
+const int blockSize = 8192;
+
+// Three-valued logic
+const char FALSE_VAL = 0;
+const char TRUE_VAL = 1;
+const char NULL_VAL = 2;
+
+template <typename Predicate>
+void compareNumbers(const double* values, const int numRows, char* result, Predicate predicate)
+{
+    for(int i = 0; i<numRows; ++i)
+    {
+        auto val = values[i];
+        result[i] = std::isnan(val) ? NULL_VAL : (predicate(val) ? TRUE_VAL : FALSE_VAL);
+    }
+}
+
+template <typename Predicate>
+void compareStrings(const QString* values, const int numRows, char* result, Predicate predicate)
+{
+    for(int i = 0; i<numRows; ++i)
+    {
+        const auto& val = values[i];
+        result[i] = val.isNull() ? NULL_VAL : (predicate(val) ? TRUE_VAL : FALSE_VAL);
+    }
+}
+}
+
+
+AssetFilterExpression::AssetFilterExpression()
+{
+
+}
+
+
+int AssetFilterExpression::compile(const QString& expression, const QHash<QString, AssetFilterColumn::Type>& fieldTypes, QString& err)
+{
+    nodes.clear();
+    referencedFields.clear();
+    root = -1;
+    position = 0;
+
+    this->fieldTypes = fieldTypes;
+
+    if(this->tokenize(expression, err) != 0)
+        return -1;
+
+    root = this->parseOr(err);
+
+    if(root == -1)
+    {
+        nodes.clear();
+        return -1;
+    }
+
+    if(tokens.at(position).type != Token::End)
+    {
+        err = "Unexpected '"+tokens.at(position).text+"' in the filter expression";
+        nodes.clear();
+        root = -1;
+        return -1;
+    }
+
+    tokens.clear();
+
+    return 0;
+}
+
+
+bool AssetFilterExpression::isCompiled(void) const
+{
+    return root != -1;
+}
+
+
+QStringList AssetFilterExpression::getReferencedFields(void) const
+{
+    return referencedFields;
+}
+
+
+int AssetFilterExpression::evaluate(const QHash<QString, AssetFilterColumn>& columns, const QVector<qint64>& ids, IDRangeSet& matches, QString& err) const
+{
+    matches.clear();
+
+    if(root == -1)
+    {
+        err = "The filter expression is not compiled";
+        return -1;
+    }
+
+    const int numRows = ids.size();
+
+    QVector<const AssetFilterColumn*> columnPtrs;
+    for(auto&& field : referencedFields)
+    {
+        auto it = columns.constFind(field);
+
+        if(it == columns.constEnd())
+        {
+            err = "Could not find the column "+field+" to evaluate the filter";
+            return -1;
+        }
+
+        const auto& column = it.value();
+
+        auto columnSize = column.type == AssetFilterColumn::Numeric ? column.numbers.size() : column.strings.size();
+
+        if(columnSize != numRows)
+        {
+            err = "The number of rows in the column "+field+" does not match the number of assets";
+            return -1;
+        }
+
+        columnPtrs.append(&column);
+    }
+
+    struct Block
+    {
+        int firstRow = 0;
+        int numRows = 0;
+        QVector<qint64> matches;
+    };
+
+    std::vector<Block> blocks;
+    blocks.reserve(numRows/blockSize + 1);
+    for(int i = 0; i<numRows; i += blockSize)
+    {
+        Block block;
+        block.firstRow = i;
+        block.numRows = std::min(blockSize, numRows - i);
+        blocks.push_back(block);
+    }
+
+    QtConcurrent::blockingMap(blocks, [&](Block& block)
+    {
+        std::vector<char> result(block.numRows);
+
+        this->evaluateNode(root, columnPtrs, block.firstRow, block.numRows, result.data());
+
+        for(int i = 0; i<block.numRows; ++i)
+            if(result[i] == TRUE_VAL)
+                block.matches.append(ids.at(block.firstRow+i));
+    });
+
+    QVector<qint64> matchingIDs;
+    for(auto&& block : blocks)
+        matchingIDs.append(block.matches);
+
+    matches = IDRangeSet::fromIDs(matchingIDs);
+
+    return 0;
+}
+
+
+void AssetFilterExpression::evaluateNode(const int nodeIndex, const QVector<const AssetFilterColumn*>& columns, const int firstRow, const int numRows, char* result) const
+{
+    const auto& node = nodes.at(nodeIndex);
+
+    switch(node.kind)
+    {
+    case Node::And:
+    case Node::Or:
+    {
+        this->evaluateNode(node.left, columns, firstRow, numRows, result);
+
+        std::vector<char> rightResult(numRows);
+        this->evaluateNode(node.right, columns, firstRow, numRows, rightResult.data());
+
+        if(node.kind == Node::And)
+        {
+            for(int i = 0; i<numRows; ++i)
+            {
+                auto a = result[i];
+                auto b = rightResult[i];
+                result[i] = (a == FALSE_VAL || b == FALSE_VAL) ? FALSE_VAL : ((a == NULL_VAL || b == NULL_VAL) ? NULL_VAL : TRUE_VAL);
+            }
+        }
+        else
+        {
+            for(int i = 0; i<numRows; ++i)
+            {
+                auto a = result[i];
+                auto b = rightResult[i];
+                result[i] = (a == TRUE_VAL || b == TRUE_VAL) ? TRUE_VAL : ((a == NULL_VAL || b == NULL_VAL) ? NULL_VAL : FALSE_VAL);
+            }
+        }
+
+        return;
+    }
+    case Node::Not:
+    {
+        this->evaluateNode(node.left, columns, firstRow, numRows, result);
+
+        for(int i = 0; i<numRows; ++i)
+            if(result[i] != NULL_VAL)
+                result[i] = result[i] == TRUE_VAL ? FALSE_VAL : TRUE_VAL;
+
+        return;
+    }
+    default:
+        break;
+    }
+
+    const auto column = columns.at(node.column);
+
+    if(node.numeric)
+    {
+        const double* values = column->numbers.constData() + firstRow;
+
+        switch(node.kind)
+        {
+        case Node::Compare:
+        {
+            const auto x = node.number;
+
+            switch(node.op)
+            {
+            case Equal:
+                compareNumbers(values, numRows, result, [x](double v){ return v == x; });
+                break;
+            case NotEqual:
+                compareNumbers(values, numRows, result, [x](double v){ return v != x; });
+                break;
+            case Less:
+                compareNumbers(values, numRows, result, [x](double v){ return v < x; });
+                break;
+            case LessEqual:
+                compareNumbers(values, numRows, result, [x](double v){ return v <= x; });
+                break;
+            case Greater:
+                compareNumbers(values, numRows, result, [x](double v){ return v > x; });
+                break;
+            case GreaterEqual:
+                compareNumbers(values, numRows, result, [x](double v){ return v >= x; });
+                break;
+            }
+            break;
+        }
+        case Node::In:
+        {
+            const auto& list = node.numberList;
+            const bool negate = node.negate;
+            compareNumbers(values, numRows, result, [&list, negate](double v){ return std::binary_search(list.begin(), list.end(), v) != negate; });
+            break;
+        }
+        case Node::Between:
+        {
+            const auto low = node.lowNumber;
+            const auto high = node.highNumber;
+            const bool negate = node.negate;
+            compareNumbers(values, numRows, result, [low, high, negate](double v){ return (v >= low && v <= high) != negate; });
+            break;
+        }
+        case Node::IsNull:
+        {
+            for(int i = 0; i<numRows; ++i)
+                result[i] = std::isnan(values[i]) != node.negate ? TRUE_VAL : FALSE_VAL;
+            break;
+        }
+        default:
+            break;
+        }
+    }
+    else
+    {
+        const QString* values = column->strings.constData() + firstRow;
+
+        switch(node.kind)
+        {
+        case Node::Compare:
+        {
+            const auto& x = node.string;
+
+            switch(node.op)
+            {
+            case Equal:
+                compareStrings(values, numRows, result, [&x](const QString& v){ return v == x; });
+                break;
+            case NotEqual:
+                compareStrings(values, numRows, result, [&x](const QString& v){ return v != x; });
+                break;
+            case Less:
+                compareStrings(values, numRows, result, [&x](const QString& v){ return v < x; });
+                break;
+            case LessEqual:
+                compareStrings(values, numRows, result, [&x](const QString& v){ return v <= x; });
+                break;
+            case Greater:
+                compareStrings(values, numRows, result, [&x](const QString& v){ return v > x; });
+                break;
+            case GreaterEqual:
+                compareStrings(values, numRows, result, [&x](const QString& v){ return v >= x; });
+                break;
+            }
+            break;
+        }
+        case Node::In:
+        {
+            const auto& list = node.stringList;
+            const bool negate = node.negate;
+            compareStrings(values, numRows, result, [&list, negate](const QString& v){ return list.contains(v) != negate; });
+            break;
+        }
+        case Node::Between:
+        {
+            const auto& low = node.lowString;
+            const auto& high = node.highString;
+            const bool negate = node.negate;
+            compareStrings(values, numRows, result, [&low, &high, negate](const QString& v){ return (v >= low && v <= high) != negate; });
+            break;
+        }
+        case Node::IsNull:
+        {
+            for(int i = 0; i<numRows; ++i)
+                result[i] = values[i].isNull() != node.negate ? TRUE_VAL : FALSE_VAL;
+            break;
+        }
+        default:
+            break;
+        }
+    }
+}
+
+
+int AssetFilterExpression::tokenize(const QString& expression, QString& err)
+{
+    tokens.clear();
+
+    const int length = expression.length();
+
+    int i = 0;
+    while(i < length)
+    {
+        auto c = expression.at(i);
+
+        if(c.isSpace())
+        {
+            ++i;
+            continue;
+        }
+
+        Token token;
+
+        if(c == '(' || c == ')' || c == ',')
+        {
+            token.type = c == '(' ? Token::LeftParen : (c == ')' ? Token::RightParen : Token::Comma);
+            token.text = c;
+            ++i;
+        }
+        else if(c == '\'' || c == '"')
+        {
+            // Quoted strings and identifiers, a doubled quote is an escaped quote
+            token.type = c == '\'' ? Token::String : Token::QuotedIdentifier;
+
+            ++i;
+            bool closed = false;
+            while(i < length)
+            {
+                if(expression.at(i) == c)
+                {
+                    if(i+1 < length && expression.at(i+1) == c)
+                    {
+                        token.text.append(c);
+                        i += 2;
+                        continue;
+                    }
+
+                    closed = true;
+                    ++i;
+                    break;
+                }
+
+                token.text.append(expression.at(i));
+                ++i;
+            }
+
+            if(!closed)
+            {
+                err = "Unterminated quote in the filter expression";
+                return -1;
+            }
+
+            // Make sure that an empty string is not null
+            if(token.type == Token::String && token.text.isNull())
+                token.text = QLatin1String("");
+        }
+        else if(c.isDigit() || c == '.' || (c == '-' && i+1 < length && (expression.at(i+1).isDigit() || expression.at(i+1) == '.')))
+        {
+            // A minus sign directly in front of a number is part of the number, the subset does not include arithmetic
+            token.type = Token::Number;
+
+            auto start = i;
+            ++i;
+            while(i < length)
+            {
+                auto d = expression.at(i);
+
+                if(d.isDigit() || d == '.')
+                {
+                    ++i;
+                }
+                else if((d == 'e' || d == 'E') && i+1 < length)
+                {
+                    i += (expression.at(i+1) == '-' || expression.at(i+1) == '+') ? 2 : 1;
+                }
+                else
+                {
+                    break;
+                }
+            }
+
+            token.text = expression.mid(start, i-start);
+        }
+        else if(c.isLetter() || c == '_')
+        {
+            token.type = Token::Identifier;
+
+            auto start = i;
+            while(i < length && (expression.at(i).isLetterOrNumber() || expression.at(i) == '_'))
+                ++i;
+
+            token.text = expression.mid(start, i-start);
+        }
+        else if(c == '=' || c == '!' || c == '<' || c == '>')
+        {
+            token.type = Token::Operator;
+
+            auto next = i+1 < length ? expression.at(i+1) : QChar();
+
+            if(next == '=' || (c == '<' && next == '>'))
+            {
+                token.text = expression.mid(i, 2);
+                i += 2;
+            }
+            else
+            {
+                token.text = c;
+                ++i;
+            }
+
+            if(token.text == "!")
+            {
+                err = "Unsupported operator '!' in the filter expression";
+                return -1;
+            }
+        }
+        else
+        {
+            err = "Unsupported character '"+QString(c)+"' in the filter expression";
+            return -1;
+        }
+
+        tokens.append(token);
+    }
+
+    Token endToken;
+    endToken.type = Token::End;
+    tokens.append(endToken);
+
+    return 0;
+}
+
+
+bool AssetFilterExpression::isKeyword(const QString& keyword) const
+{
+    const auto& token = tokens.at(position);
+
+    return token.type == Token::Identifier && token.text.compare(keyword, Qt::CaseInsensitive) == 0;
+}
+
+
+int AssetFilterExpression::parseOr(QString& err)
+{
+    auto left = this->parseAnd(err);
+
+    while(left != -1 && this->isKeyword("OR"))
+    {
+        ++position;
+
+        auto right = this->parseAnd(err);
+
+        if(right == -1)
+            return -1;
+
+        Node node;
+        node.kind = Node::Or;
+        node.left = left;
+        node.right = right;
+        nodes.append(node);
+
+        left = nodes.size()-1;
+    }
+
+    return left;
+}
+
+
+int AssetFilterExpression::parseAnd(QString& err)
+{
+    auto left = this->parseNot(err);
+
+    while(left != -1 && this->isKeyword("AND"))
+    {
+        ++position;
+
+        auto right = this->parseNot(err);
+
+        if(right == -1)
+            return -1;
+
+        Node node;
+        node.kind = Node::And;
+        node.left = left;
+        node.right = right;
+        nodes.append(node);
+
+        left = nodes.size()-1;
+    }
+
+    return left;
+}
+
+
+int AssetFilterExpression::parseNot(QString& err)
+{
+    if(this->isKeyword("NOT"))
+    {
+        ++position;
+
+        auto child = this->parseNot(err);
+
+        if(child == -1)
+            return -1;
+
+        Node node;
+        node.kind = Node::Not;
+        node.left = child;
+        nodes.append(node);
+
+        return nodes.size()-1;
+    }
+
+    return this->parsePredicate(err);
+}
+
+
+int AssetFilterExpression::parseColumn(bool& numeric, QString& err)
+{
+    const auto& token = tokens.at(position);
+
+    if(token.type != Token::Identifier && token.type != Token::QuotedIdentifier)
+    {
+        err = "Expected a field name in the filter expression";
+        return -1;
+    }
+
+    // Match the field name exactly first and then without regard to case
+    QString fieldName;
+    if(fieldTypes.contains(token.text))
+    {
+        fieldName = token.text;
+    }
+    else
+    {
+        for(auto it = fieldTypes.constBegin(); it != fieldTypes.constEnd(); ++it)
+        {
+            if(it.key().compare(token.text, Qt::CaseInsensitive) == 0)
+            {
+                fieldName = it.key();
+                break;
+            }
+        }
+    }
+
+    if(fieldName.isEmpty())
+    {
+        err = "Could not find the field "+token.text+" in the assets";
+        return -1;
+    }
+
+    ++position;
+
+    numeric = fieldTypes.value(fieldName) == AssetFilterColumn::Numeric;
+
+    auto index = referencedFields.indexOf(fieldName);
+    if(index == -1)
+    {
+        referencedFields.append(fieldName);
+        index = referencedFields.size()-1;
+    }
+
+    return index;
+}
+
+
+bool AssetFilterExpression::parseLiteral(const bool numeric, double& number, QString& string, QString& err)
+{
+    const auto& token = tokens.at(position);
+
+    if(token.type != Token::Number && token.type != Token::String)
+    {
+        err = "Expected a value in the filter expression";
+        return false;
+    }
+
+    if(numeric)
+    {
+        // Numeric columns are compared to quoted numbers as numbers, as in the QGIS expression engine
+        bool OK = false;
+        number = token.text.toDouble(&OK);
+
+        if(!OK)
+        {
+            err = "Comparing the numeric field to the text '"+token.text+"' is not supported";
+            return false;
+        }
+    }
+    else
+    {
+        // Leave the implicit conversions of text fields to numbers to the QGIS expression engine
+        if(token.type != Token::String)
+        {
+            err = "Comparing the text field to the number "+token.text+" is not supported";
+            return false;
+        }
+
+        string = token.text;
+    }
+
+    ++position;
+
+    return true;
+}
+
+
+int AssetFilterExpression::parsePredicate(QString& err)
+{
+    const auto& token = tokens.at(position);
+
+    if(token.type == Token::LeftParen)
+    {
+        ++position;
+
+        auto inner = this->parseOr(err);
+
+        if(inner == -1)
+            return -1;
+
+        if(tokens.at(position).type != Token::RightParen)
+        {
+            err = "Missing a closing parenthesis in the filter expression";
+            return -1;
+        }
+
+        ++position;
+
+        return inner;
+    }
+
+    Node node;
+
+    // A literal on the left of a comparison, e.g., 5 < "NumberOfStories", is handled by flipping the operator
+    if(token.type == Token::Number || token.type == Token::String)
+    {
+        auto literalPos = position;
+
+        ++position;
+
+        const auto& opToken = tokens.at(position);
+        if(opToken.type != Token::Operator)
+        {
+            err = "Expected a comparison after the value "+token.text+" in the filter expression";
+            return -1;
+        }
+
+        auto opText = opToken.text;
+
+        ++position;
+
+        node.column = this->parseColumn(node.numeric, err);
+
+        if(node.column == -1)
+            return -1;
+
+        auto afterColumn = position;
+
+        position = literalPos;
+        if(!this->parseLiteral(node.numeric, node.number, node.string, err))
+            return -1;
+
+        position = afterColumn;
+
+        const QHash<QString, CompareOp> flippedOps = {{"=", Equal}, {"==", Equal}, {"!=", NotEqual}, {"<>", NotEqual},
+                                                      {"<", Greater}, {"<=", GreaterEqual}, {">", Less}, {">=", LessEqual}};
+
+        node.kind = Node::Compare;
+        node.op = flippedOps.value(opText);
+
+        nodes.append(node);
+
+        return nodes.size()-1;
+    }
+
+    node.column = this->parseColumn(node.numeric, err);
+
+    if(node.column == -1)
+        return -1;
+
+    if(tokens.at(position).type == Token::Operator)
+    {
+        const QHash<QString, CompareOp> ops = {{"=", Equal}, {"==", Equal}, {"!=", NotEqual}, {"<>", NotEqual},
+                                               {"<", Less}, {"<=", LessEqual}, {">", Greater}, {">=", GreaterEqual}};
+
+        node.kind = Node::Compare;
+        node.op = ops.value(tokens.at(position).text);
+
+        ++position;
+
+        if(!this->parseLiteral(node.numeric, node.number, node.string, err))
+            return -1;
+
+        nodes.append(node);
+
+        return nodes.size()-1;
+    }
+
+    if(this->isKeyword("IS"))
+    {
+        ++position;
+
+        if(this->isKeyword("NOT"))
+        {
+            node.negate = true;
+            ++position;
+        }
+
+        if(!this->isKeyword("NULL"))
+        {
+            err = "Expected NULL after IS in the filter expression";
+            return -1;
+        }
+
+        ++position;
+
+        node.kind = Node::IsNull;
+        nodes.append(node);
+
+        return nodes.size()-1;
+    }
+
+    if(this->isKeyword("NOT"))
+    {
+        node.negate = true;
+        ++position;
+    }
+
+    if(this->isKeyword("IN"))
+    {
+        ++position;
+
+        if(tokens.at(position).type != Token::LeftParen)
+        {
+            err = "Expected a list of values after IN in the filter expression";
+            return -1;
+        }
+
+        ++position;
+
+        while(true)
+        {
+            double number = 0.0;
+            QString string;
+
+            if(!this->parseLiteral(node.numeric, number, string, err))
+                return -1;
+
+            if(node.numeric)
+                node.numberList.append(number);
+            else
+                node.stringList.insert(string);
+
+            if(tokens.at(position).type == Token::Comma)
+            {
+                ++position;
+                continue;
+            }
+
+            if(tokens.at(position).type == Token::RightParen)
+            {
+                ++position;
+                break;
+            }
+
+            err = "Expected a comma or a closing parenthesis in the IN list of the filter expression";
+            return -1;
+        }
+
+        std::sort(node.numberList.begin(), node.numberList.end());
+
+        node.kind = Node::In;
+        nodes.append(node);
+
+        return nodes.size()-1;
+    }
+
+    if(this->isKeyword("BETWEEN"))
+    {
+        ++position;
+
+        if(!this->parseLiteral(node.numeric, node.lowNumber, node.lowString, err))
+            return -1;
+
+        if(!this->isKeyword("AND"))
+        {
+            err = "Expected AND in the BETWEEN of the filter expression";
+            return -1;
+        }
+
+        ++position;
+
+        if(!this->parseLiteral(node.numeric, node.highNumber, node.highString, err))
+            return -1;
+
+        node.kind = Node::Between;
+        nodes.append(node);
+
+        return nodes.size()-1;
+    }
+
+    err = "Unsupported syntax after the field "+referencedFields.at(node.column)+" in the filter expression";
+    return -1;
+}
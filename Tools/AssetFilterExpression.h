@@ -0,0 +1,153 @@
+#ifndef ASSETFILTEREXPRESSION_H
+#define ASSETFILTEREXPRESSION_H
+/* *****************************************************************************
+Copyright (c) 2016-2021, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+// Written by: Stevan Gavrilovic
+
+#include "IDRangeSet.h"
+
+#include <QHash>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+// Typed in-memory copy of a column of the asset table, missing numeric values are NaN and missing strings are null
+struct AssetFilterColumn
+{
+    enum Type {Numeric, String};
+
+    Type type = Numeric;
+
+    QVector<double> numbers;
+    QVector<QString> strings;
+};
+
+
+// Compiler for the common subset of the filter expressions that are created in the query builder, i.e.,
+// comparisons (=, !=, <>, <, <=, >, >=), AND, OR, NOT, IN, BETWEEN and IS NULL on numeric and string columns
+// The compiled predicate is evaluated over blocks of rows of the column copies on the thread pool and returns the matching IDs directly
+// NULL values follow the three-valued logic of SQL, so that the results are the same as those of the QGIS expression engine
+class AssetFilterExpression
+{
+public:
+    AssetFilterExpression();
+
+    // Returns -1 if the expression is not valid or uses syntax outside of the supported subset, in which case the caller should fall back to the QGIS expression engine
+    int compile(const QString& expression, const QHash<QString, AssetFilterColumn::Type>& fieldTypes, QString& err);
+
+    bool isCompiled(void) const;
+
+    // The fields that the expression reads, the columns for these fields need to be passed to evaluate
+    QStringList getReferencedFields(void) const;
+
+    // The columns must have one row for each ID
+    int evaluate(const QHash<QString, AssetFilterColumn>& columns, const QVector<qint64>& ids, IDRangeSet& matches, QString& err) const;
+
+private:
+
+    enum CompareOp {Equal, NotEqual, Less, LessEqual, Greater, GreaterEqual};
+
+    struct Node
+    {
+        enum Kind {And, Or, Not, Compare, In, Between, IsNull};
+
+        Kind kind = Compare;
+
+        // Child nodes of the logical operators
+        int left = -1;
+        int right = -1;
+
+        // Index of the column in the referenced fields
+        int column = -1;
+        bool numeric = true;
+
+        // NOT IN, NOT BETWEEN and IS NOT NULL
+        bool negate = false;
+
+        CompareOp op = Equal;
+
+        double number = 0.0;
+        QString string;
+
+        double lowNumber = 0.0;
+        double highNumber = 0.0;
+        QString lowString;
+        QString highString;
+
+        // Sorted values of a numeric IN list
+        QVector<double> numberList;
+        QSet<QString> stringList;
+    };
+
+    struct Token
+    {
+        enum Type {Identifier, QuotedIdentifier, String, Number, Operator, LeftParen, RightParen, Comma, End};
+
+        Type type = End;
+        QString text;
+    };
+
+    int tokenize(const QString& expression, QString& err);
+
+    // Recursive descent parser, each function returns the index of the node that it creates or -1 on error
+    int parseOr(QString& err);
+    int parseAnd(QString& err);
+    int parseNot(QString& err);
+    int parsePredicate(QString& err);
+
+    // Parses a literal that is compared to a column of the given type
+    bool parseLiteral(const bool numeric, double& number, QString& string, QString& err);
+
+    int parseColumn(bool& numeric, QString& err);
+
+    bool isKeyword(const QString& keyword) const;
+
+    // Evaluates a node over a block of rows, the results are 0 for false, 1 for true and 2 for NULL
+    void evaluateNode(const int nodeIndex, const QVector<const AssetFilterColumn*>& columns, const int firstRow, const int numRows, char* result) const;
+
+    QVector<Node> nodes;
+    int root = -1;
+
+    QStringList referencedFields;
+    QHash<QString, AssetFilterColumn::Type> fieldTypes;
+
+    QVector<Token> tokens;
+    int position = 0;
+};
+
+#endif // ASSETFILTEREXPRESSION_H
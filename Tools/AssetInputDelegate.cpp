@@ -40,8 +40,6 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 
 #include <QRegExpValidator>
 
-#include <sstream>
-
 AssetInputDelegate::AssetInputDelegate()
 {
     // this->setMaximumWidth(1000);
@@ -81,8 +79,18 @@ void AssetInputDelegate::insertSelectedComponent(const int id)
 
 void AssetInputDelegate::insertSelectedComponents(const QVector<int>& ids)
 {
-    for(auto&& id : ids)
-        selectedComponentIDs.insert(id);
+    QVector<qint64> newIDs(ids.begin(), ids.end());
+
+    selectedComponentIDs = selectedComponentIDs.united(IDRangeSet::fromIDs(newIDs));
+
+    // Reset the text on the line edit
+    this->setText(this->getComponentAnalysisList());
+}
+
+
+void AssetInputDelegate::insertSelectedComponents(const IDRangeSet& ids)
+{
+    selectedComponentIDs = selectedComponentIDs.united(ids);
 
     // Reset the text on the line edit
     this->setText(this->getComponentAnalysisList());
@@ -102,60 +110,12 @@ void AssetInputDelegate::selectComponents()
     if(inputText.isEmpty())
         return;
 
-    // Remove any white space from the string
-    inputText.remove(" ");
-
-    // Split the incoming text into the parts delimited by commas
-    std::vector<std::string> subStringVec;
-
-    // Create string stream from the string
-    std::stringstream s_stream(inputText.toStdString());
-
-    // Split the input string to substrings at the comma
-    while(s_stream.good()) {
-        std:: string subString;
-        getline(s_stream, subString, ',');
-
-        if(!subString.empty())
-            subStringVec.push_back(subString);
-    }
-
-
-    // Check for the case where the IDs are given as a range
-    std::string dashDelim = "-";
-
-    for(auto&& subStr : subStringVec)
+    // Parse the ranges directly, the IDs in a range are never expanded
+    QString err;
+    if(selectedComponentIDs.fromString(inputText, err) != 0)
     {
-        // Handle the case where there is a range of assets separated by a '-'
-        if (subStr.find(dashDelim) != std::string::npos)
-        {
-            auto pos = subStr.find(dashDelim);
-            // Get the strings on either side of the '-' character
-            std::string intStart = subStr.substr(0, pos);
-            std::string intEnd = subStr.substr(pos + dashDelim.length());
-
-            // Convert them into integers
-            auto IDStart = std::stoi(intStart);
-            auto IDEnd = std::stoi(intEnd);
-
-            // Make sure that the end integer is greater than the first
-            if(IDStart>IDEnd)
-            {
-                QString err = "Error in the range of asset IDs provided in the Component asset selection box";
-                throw err;
-                continue;
-            }
-
-            // Add the IDs to the set
-            for(int ID = IDStart; ID<=IDEnd; ++ID)
-                selectedComponentIDs.insert(ID);
-        }
-        else // Asset ID is given individually
-        {
-            auto ID = std::stoi(subStr);
-
-            selectedComponentIDs.insert(ID);
-        }
+        err = "Error in the asset IDs provided in the Component asset selection box. "+err;
+        throw err;
     }
 
     // Reset the text on the line edit
@@ -168,7 +128,7 @@ void AssetInputDelegate::selectComponents()
 }
 
 
-std::set<int> AssetInputDelegate::getSelectedComponentIDs() const
+const IDRangeSet& AssetInputDelegate::getSelectedComponentIDs() const
 {
     return selectedComponentIDs;
 }
@@ -176,32 +136,5 @@ std::set<int> AssetInputDelegate::getSelectedComponentIDs() const
 
 QString AssetInputDelegate::getComponentAnalysisList()
 {
-    QString stringList;
-
-    std::set<int>::iterator it;
-    for (it = selectedComponentIDs.begin(); it != selectedComponentIDs.end(); ++it)
-    {
-        int first = *it;
-        int next = *it;
-        while(std::next(it, 1) != selectedComponentIDs.end() && *std::next(it, 1) == *it +1 )
-        {
-            next = *std::next(it, 1);
-            ++it;
-        }
-
-        if(next == first)
-        {
-            stringList.append(QString::number(*it)+",");
-        }
-        else
-        {
-            stringList.append(QString::number(first)+"-"+QString::number(next)+",");
-        }
-    }
-
-    // Remove the last comma
-    stringList.truncate(stringList.lastIndexOf(QChar(',')));
-
-    return stringList;
+    return selectedComponentIDs.toString();
 }
-
@@ -38,9 +38,9 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 
 // Written by: Stevan Gavrilovic
 
-#include <QLineEdit>
+#include "IDRangeSet.h"
 
-#include <set>
+#include <QLineEdit>
 
 class AssetInputDelegate : public QLineEdit
 {
@@ -49,12 +49,14 @@ class AssetInputDelegate : public QLineEdit
 public:
     AssetInputDelegate();
 
-    std::set<int> getSelectedComponentIDs() const;
+    const IDRangeSet& getSelectedComponentIDs() const;
 
     void insertSelectedComponent(const int id);
 
     void insertSelectedComponents(const QVector<int>& ids);
 
+    void insertSelectedComponents(const IDRangeSet& ids);
+
     void clear();
 
     int size();
@@ -70,7 +72,7 @@ signals:
 
 private:
 
-    std::set<int> selectedComponentIDs;
+    IDRangeSet selectedComponentIDs;
 
     QString prevText;
 };
@@ -485,10 +485,10 @@ int CBCitiesPostProcessor::createHistogramChart(REmpiricalProbabilityDistributio
 
 
 
-void CBCitiesPostProcessor::processResultsSubset(const std::set<int>& selectedComponentIDs)
+void CBCitiesPostProcessor::processResultsSubset(const IDRangeSet& selectedComponentIDs)
 {
 
-    if(selectedComponentIDs.empty())
+    if(selectedComponentIDs.isEmpty())
         return;
 
     if(DVdata.size() < numHeaderRows)
@@ -507,37 +507,34 @@ void CBCitiesPostProcessor::processResultsSubset(const std::set<int>& selectedCo
 
     auto lastID = objectToInt(DVdata.last().at(0));
 
+    // Check that the IDs fall within the bounds of the data
+    if(selectedComponentIDs.first()<firstID || selectedComponentIDs.last()>lastID)
+    {
+        auto id = selectedComponentIDs.first()<firstID ? selectedComponentIDs.first() : selectedComponentIDs.last();
+        QString msg = "ID " + QString::number(id) + " is out of bounds of the results";
+        throw msg;
+    }
+
     QVector<QStringList> DVsubset(&DVdata[0],&DVdata[numHeaderRows]);
 
-    for(auto&& id : selectedComponentIDs)
+    // Single pass over the results, each row is kept if its ID is in the selection
+    IDRangeSet foundIDs;
+    for(int i = numHeaderRows; i<DVdata.size(); ++i)
     {
-        // Check that the ID falls within the bounds of the data
-        if(id<firstID || id>lastID)
-        {
-            QString msg = "ID " + QString::number(id) + " is out of bounds of the results";
-            throw msg;
-        }
+        auto buildingID = objectToInt(DVdata.at(i).at(0));
 
-        auto found = false;
-        for(int i = numHeaderRows; i<DVdata.size(); ++i)
+        if(selectedComponentIDs.contains(buildingID) && !foundIDs.contains(buildingID))
         {
-            auto inputRow = DVdata.at(i);
-
-            auto buildingID = objectToInt(inputRow.at(0));
-
-            if(id == buildingID)
-            {
-                DVsubset << inputRow;
-                found = true;
-                break;
-            }
+            DVsubset << DVdata.at(i);
+            foundIDs.insert(buildingID);
         }
+    }
 
-        if(!found)
-        {
-            QString msg = "ID " + QString::number(id) + " cannot be found in the results";
-            throw msg;
-        }
+    if(foundIDs.size() != selectedComponentIDs.size())
+    {
+        auto missingIDs = selectedComponentIDs.subtracted(foundIDs);
+        QString msg = "ID " + QString::number(missingIDs.first()) + " cannot be found in the results";
+        throw msg;
     }
 
     this->processDVResults(DVsubset);
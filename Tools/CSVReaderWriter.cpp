@@ -120,6 +120,34 @@ int CSVReaderWriter::saveCSVFile(const QVector<QStringList>& data, const QString
     return 0;
 }
 
+QString CSVReaderWriter::quoteCell(const QString& cell)
+{
+    if(!cell.contains(',') && !cell.contains('"') && !cell.contains('\n') && !cell.contains('\r'))
+        return cell;
+
+    auto newStr = cell;
+    newStr.replace("\"","\"\"");
+
+    return "\"" + newStr + "\"";
+}
+
+
+QString CSVReaderWriter::joinRow(const QStringList& cells)
+{
+    QString row;
+
+    for(int i = 0; i<cells.size(); ++i)
+    {
+        if(i != 0)
+            row += ",";
+
+        row += quoteCell(cells.at(i));
+    }
+
+    return row;
+}
+
+
 int CSVReaderWriter::saveCSVFile(const QVector<QStringList>& data, const QString& pathToFile, QString& err, int precision)
 {
 
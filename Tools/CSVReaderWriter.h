@@ -58,10 +58,15 @@ public:
     // The string list corresponds to the items within a row, i.e., the values in the cells. There are as many items in the string list as there are in the row of the CSV file
     QVector<QStringList> parseCSVFile(const QString &pathToFile, QString& err);
 
-private:
-
+    // Parses a single row of a CSV file, handles quoted values
     QStringList parseLineCSV(const QString &csvString);
 
+    // Quotes a cell that contains a comma, a double-quote, or a line break, and doubles the double-quotes inside of it, so that parseLineCSV reads it back unchanged
+    static QString quoteCell(const QString& cell);
+
+    // Joins the cells of a row with commas, quoting them as needed
+    static QString joinRow(const QStringList& cells);
+
 };
 
 #endif // CSVREADERWRITER_H
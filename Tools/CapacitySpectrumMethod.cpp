@@ -0,0 +1,438 @@
+/* *****************************************************************************
+Copyright (c) 2016-2021, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+// Written by: Stevan Gavrilovic
+
+#include "CapacitySpectrumMethod.h"
+
+#include <QtConcurrent/QtConcurrent>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace {
+
+// Acceleration of gravity in in/s^2
+const double gravity = 386.089;
+
+// Capacity curve with the parameters of the elliptic segment worked out once
+struct CapacityCurve
+{
+    double yieldDisplacement = 0.0;
+    double yieldAcceleration = 0.0;
+    double ultimateDisplacement = 0.0;
+    double ultimateAcceleration = 0.0;
+
+    double stiffness = 0.0;
+
+    // The ellipse is centered at the ultimate displacement, tangent to the elastic line at the yield point and horizontal at the ultimate point
+    // Curves where such an ellipse does not exist are joined with a straight line between the yield and ultimate points
+    bool isElliptic = false;
+    double centerAcceleration = 0.0;
+    double verticalAxis = 0.0;
+    double inverseHorizontalAxisSquared = 0.0;
+
+    double elasticDamping = 0.0;
+    double kappa = 0.0;
+};
+
+
+CapacityCurve getCapacityCurve(const CapacityCurveParameters& building)
+{
+    CapacityCurve curve;
+    curve.yieldDisplacement = building.yieldDisplacement;
+    curve.yieldAcceleration = building.yieldAcceleration;
+    curve.ultimateDisplacement = std::max(building.ultimateDisplacement, building.yieldDisplacement);
+    curve.ultimateAcceleration = std::max(building.ultimateAcceleration, building.yieldAcceleration);
+    curve.stiffness = building.yieldAcceleration/building.yieldDisplacement;
+    curve.elasticDamping = building.elasticDamping;
+    curve.kappa = building.kappa;
+
+    // Rise of the curve from the yield to the ultimate point, and the rise of the elastic line over the same displacements
+    const double rise = curve.ultimateAcceleration - curve.yieldAcceleration;
+    const double elasticRise = curve.stiffness*(curve.ultimateDisplacement - curve.yieldDisplacement);
+
+    if(rise > 0.0 && elasticRise > 2.0*rise)
+    {
+        curve.isElliptic = true;
+        curve.verticalAxis = rise*(elasticRise - rise)/(elasticRise - 2.0*rise);
+        curve.centerAcceleration = curve.ultimateAcceleration - curve.verticalAxis;
+
+        const double heightAtYield = curve.verticalAxis - rise;
+        curve.inverseHorizontalAxisSquared = elasticRise*heightAtYield/(curve.verticalAxis*curve.verticalAxis*std::pow(curve.ultimateDisplacement - curve.yieldDisplacement, 2));
+    }
+
+    return curve;
+}
+
+
+double getCapacity(const CapacityCurve& curve, const double displacement)
+{
+    if(displacement <= curve.yieldDisplacement)
+        return curve.stiffness*displacement;
+
+    if(displacement >= curve.ultimateDisplacement)
+        return curve.ultimateAcceleration;
+
+    if(curve.isElliptic)
+    {
+        const double dx = displacement - curve.ultimateDisplacement;
+        return curve.centerAcceleration + curve.verticalAxis*std::sqrt(std::max(0.0, 1.0 - dx*dx*curve.inverseHorizontalAxisSquared));
+    }
+
+    return curve.yieldAcceleration + (curve.ultimateAcceleration - curve.yieldAcceleration)*(displacement - curve.yieldDisplacement)/(curve.ultimateDisplacement - curve.yieldDisplacement);
+}
+
+
+// Spectral acceleration of the Hazus demand spectrum, the damping is in percent
+double getDemand(const double shortPeriodSa, const double oneSecondSa, const double displacementPeriod, const double period, const double damping)
+{
+    const double logDamping = std::log(damping);
+
+    const double accelerationReduction = 2.12/(3.21 - 0.68*logDamping);
+    const double velocityReduction = 1.65/(2.31 - 0.41*logDamping);
+
+    const double plateau = shortPeriodSa/accelerationReduction;
+    const double velocityTerm = oneSecondSa/velocityReduction;
+
+    if(period*plateau <= velocityTerm)
+        return plateau;
+
+    if(period <= displacementPeriod)
+        return velocityTerm/period;
+
+    return velocityTerm*displacementPeriod/(period*period);
+}
+
+}
+
+
+CapacitySpectrumMethod::CapacitySpectrumMethod()
+{
+
+}
+
+
+double CapacitySpectrumMethod::getCapacityAcceleration(const CapacityCurveParameters& building, const double displacement)
+{
+    if(building.yieldDisplacement <= 0.0)
+        return 0.0;
+
+    return getCapacity(getCapacityCurve(building), displacement);
+}
+
+
+double CapacitySpectrumMethod::getDemandAcceleration(const double shortPeriodSa, const double oneSecondSa, const double period, const double damping) const
+{
+    const double displacementPeriod = std::pow(10.0, (magnitude - 5.0)/2.0);
+
+    return getDemand(shortPeriodSa, oneSecondSa, displacementPeriod, period, std::min(damping, maxDamping));
+}
+
+
+int CapacitySpectrumMethod::computePerformancePoints(const QVector<CapacityCurveParameters>& buildings, const QVector<int>& siteIndices, const QVector<double>& shortPeriodSa, const QVector<double>& oneSecondSa, const int numRealizations, QVector<PerformancePoint>& points, QString& err) const
+{
+    points.clear();
+
+    if(buildings.size() != siteIndices.size())
+    {
+        err = "Error, a site index must be given for each building in the capacity spectrum method";
+        return -1;
+    }
+
+    if(numRealizations <= 0 || shortPeriodSa.size() != oneSecondSa.size() || shortPeriodSa.size() % numRealizations != 0)
+    {
+        err = "Error, the short period and 1 s spectral accelerations must be given for each site in each realization";
+        return -1;
+    }
+
+    const int numSites = shortPeriodSa.size()/numRealizations;
+    const int numBuildings = buildings.size();
+
+    std::vector<CapacityCurve> curves;
+    curves.reserve(numBuildings);
+
+    for(int i = 0; i<numBuildings; ++i)
+    {
+        const auto& building = buildings.at(i);
+
+        if(building.yieldDisplacement <= 0.0 || building.yieldAcceleration <= 0.0)
+        {
+            err = "Error, the yield displacement and acceleration of building "+QString::number(i)+" must be greater than zero";
+            return -1;
+        }
+
+        if(building.elasticDamping <= 0.0 || building.kappa < 0.0)
+        {
+            err = "Error, the elastic damping of building "+QString::number(i)+" must be greater than zero and its degradation factor cannot be negative";
+            return -1;
+        }
+
+        if(siteIndices.at(i) < 0 || siteIndices.at(i) >= numSites)
+        {
+            err = "Error, the site index "+QString::number(siteIndices.at(i))+" of building "+QString::number(i)+" is out of range";
+            return -1;
+        }
+
+        curves.push_back(getCapacityCurve(building));
+    }
+
+    points.resize(numRealizations*numBuildings);
+
+    if(numBuildings == 0)
+        return 0;
+
+    const double displacementPeriod = std::pow(10.0, (magnitude - 5.0)/2.0);
+
+    auto getDamping = [&](const CapacityCurve& curve, const double displacement, const double acceleration)
+    {
+        double damping = curve.elasticDamping;
+
+        // Hazus hysteretic damping, 63.7*kappa*(Ay*D - Dy*A)/(A*D) in percent
+        if(displacement > curve.yieldDisplacement && acceleration > 0.0)
+            damping += curve.kappa*200.0/M_PI*(curve.yieldAcceleration*displacement - curve.yieldDisplacement*acceleration)/(acceleration*displacement);
+
+        return std::min(damping, maxDamping);
+    };
+
+    // Difference between the capacity and the demand at the secant period through a point on the capacity curve, negative while the demand exceeds the capacity
+    auto getExcess = [&](const CapacityCurve& curve, const double sas, const double sa1, const double displacement)
+    {
+        const double acceleration = getCapacity(curve, displacement);
+        const double period = 2.0*M_PI*std::sqrt(displacement/(gravity*acceleration));
+
+        return acceleration - getDemand(sas, sa1, displacementPeriod, period, getDamping(curve, displacement, acceleration));
+    };
+
+    struct Job
+    {
+        int realization = 0;
+        int firstBuilding = 0;
+        int numBuildings = 0;
+    };
+
+    const int blockSize = 1024;
+
+    std::vector<Job> jobs;
+    jobs.reserve(numRealizations*(numBuildings/blockSize + 1));
+
+    for(int r = 0; r<numRealizations; ++r)
+        for(int firstBuilding = 0; firstBuilding<numBuildings; firstBuilding += blockSize)
+            jobs.push_back({r, firstBuilding, std::min(blockSize, numBuildings - firstBuilding)});
+
+    const int* sitePtr = siteIndices.constData();
+    const double* sasPtr = shortPeriodSa.constData();
+    const double* sa1Ptr = oneSecondSa.constData();
+    PerformancePoint* pointPtr = points.data();
+
+    auto evaluateBlock = [&](const Job& job)
+    {
+        const int rowOffset = job.realization*numSites;
+
+        std::vector<double> lower(job.numBuildings, 0.0), upper(job.numBuildings, 0.0);
+        std::vector<double> sas(job.numBuildings, 0.0), sa1(job.numBuildings, 0.0);
+        std::vector<char> converged(job.numBuildings, 1);
+
+        // Bracket the performance point of each building, the buildings that stay elastic or are overwhelmed by the demand get an empty bracket
+        for(int j = 0; j<job.numBuildings; ++j)
+        {
+            const int i = job.firstBuilding + j;
+            const auto& curve = curves[i];
+
+            sas[j] = std::max(0.0, sasPtr[rowOffset + sitePtr[i]]);
+            sa1[j] = std::max(0.0, sa1Ptr[rowOffset + sitePtr[i]]);
+
+            if(sas[j] <= 0.0)
+                continue;
+
+            const double elasticPeriod = 2.0*M_PI*std::sqrt(curve.yieldDisplacement/(gravity*curve.yieldAcceleration));
+            const double elasticDemand = getDemand(sas[j], sa1[j], displacementPeriod, elasticPeriod, std::min(curve.elasticDamping, maxDamping));
+
+            if(elasticDemand <= curve.yieldAcceleration)
+            {
+                lower[j] = upper[j] = elasticDemand/curve.stiffness;
+                continue;
+            }
+
+            const double maxDisplacement = maxDisplacementRatio*curve.ultimateDisplacement;
+
+            double bracketLower = curve.yieldDisplacement;
+            double bracketUpper = std::min(std::max(curve.ultimateDisplacement, 2.0*curve.yieldDisplacement), maxDisplacement);
+
+            while(getExcess(curve, sas[j], sa1[j], bracketUpper) < 0.0)
+            {
+                if(bracketUpper >= maxDisplacement)
+                {
+                    bracketLower = maxDisplacement;
+                    converged[j] = 0;
+                    break;
+                }
+
+                bracketLower = bracketUpper;
+                bracketUpper = std::min(2.0*bracketUpper, maxDisplacement);
+            }
+
+            lower[j] = bracketLower;
+            upper[j] = bracketUpper;
+        }
+
+        // The bisection steps are taken by all of the buildings in the block together, an empty bracket stays where it is
+        for(int n = 0; n<numIterations; ++n)
+        {
+            for(int j = 0; j<job.numBuildings; ++j)
+            {
+                const double middle = 0.5*(lower[j] + upper[j]);
+
+                if(getExcess(curves[job.firstBuilding + j], sas[j], sa1[j], middle) < 0.0)
+                    lower[j] = middle;
+                else
+                    upper[j] = middle;
+            }
+        }
+
+        for(int j = 0; j<job.numBuildings; ++j)
+        {
+            const int i = job.firstBuilding + j;
+            const auto& curve = curves[i];
+            const auto& building = buildings.at(i);
+
+            auto& point = pointPtr[job.realization*numBuildings + i];
+
+            point.spectralDisplacement = converged[j] ? 0.5*(lower[j] + upper[j]) : lower[j];
+            point.spectralAcceleration = getCapacity(curve, point.spectralDisplacement);
+            point.effectiveDamping = getDamping(curve, point.spectralDisplacement, point.spectralAcceleration);
+            point.converged = converged[j];
+
+            const double modeHeight = building.roofHeight*building.pushoverModeHeightRatio;
+            point.driftRatio = modeHeight > 0.0 ? point.spectralDisplacement/modeHeight : 0.0;
+        }
+    };
+
+    QtConcurrent::blockingMap(jobs, evaluateBlock);
+
+    return 0;
+}
+
+
+double CapacitySpectrumMethod::getHazusElasticDamping(const QString& structureType)
+{
+    // Elastic damping of the model building types in the Hazus earthquake model technical manual
+    static const QList<QPair<QString, double>> elasticDamping = {
+        {"PC1", 7.0}, {"PC2", 7.0}, {"RM1", 7.0}, {"RM2", 7.0}, {"URM", 10.0},
+        {"W1", 15.0}, {"W2", 15.0},
+        {"S1", 5.0}, {"S2", 5.0}, {"S3", 5.0}, {"S4", 7.0}, {"S5", 7.0},
+        {"C1", 7.0}, {"C2", 7.0}, {"C3", 7.0},
+        {"MH", 5.0}};
+
+    const QString type = structureType.trimmed().toUpper();
+
+    // The structure type may end with its height class
+    for(auto&& it : elasticDamping)
+    {
+        if(type == it.first || (type.startsWith(it.first) && type.size() == it.first.size() + 1))
+            return it.second;
+    }
+
+    return 5.0;
+}
+
+
+QVector<PerformancePoint> CapacitySpectrumMethod::getExpectedPerformancePoints(const QVector<PerformancePoint>& points, const int numBuildings)
+{
+    QVector<PerformancePoint> expected;
+
+    if(numBuildings <= 0 || points.isEmpty() || points.size() % numBuildings != 0)
+        return expected;
+
+    const int numRealizations = points.size()/numBuildings;
+
+    expected.resize(numBuildings);
+
+    for(int i = 0; i<numBuildings; ++i)
+    {
+        auto& mean = expected[i];
+        mean.effectiveDamping = 0.0;
+
+        for(int r = 0; r<numRealizations; ++r)
+        {
+            const auto& point = points.at(r*numBuildings + i);
+
+            mean.spectralDisplacement += point.spectralDisplacement;
+            mean.spectralAcceleration += point.spectralAcceleration;
+            mean.effectiveDamping += point.effectiveDamping;
+            mean.driftRatio += point.driftRatio;
+            mean.converged = mean.converged && point.converged;
+        }
+
+        mean.spectralDisplacement /= numRealizations;
+        mean.spectralAcceleration /= numRealizations;
+        mean.effectiveDamping /= numRealizations;
+        mean.driftRatio /= numRealizations;
+    }
+
+    return expected;
+}
+
+
+void CapacitySpectrumMethod::setMagnitude(const double value)
+{
+    magnitude = value;
+}
+
+
+double CapacitySpectrumMethod::getMagnitude(void) const
+{
+    return magnitude;
+}
+
+
+void CapacitySpectrumMethod::setMaxDamping(const double value)
+{
+    maxDamping = value;
+}
+
+
+void CapacitySpectrumMethod::setMaxDisplacementRatio(const double value)
+{
+    maxDisplacementRatio = value;
+}
+
+
+void CapacitySpectrumMethod::setNumIterations(const int value)
+{
+    numIterations = value;
+}
@@ -0,0 +1,129 @@
+#ifndef CAPACITYSPECTRUMMETHOD_H
+#define CAPACITYSPECTRUMMETHOD_H
+/* *****************************************************************************
+Copyright (c) 2016-2021, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+// Written by: Stevan Gavrilovic
+
+#include <QString>
+#include <QVector>
+
+// Hazus capacity curve and damping parameters of a building, the displacements are in inches and the accelerations in g
+struct CapacityCurveParameters
+{
+    double yieldDisplacement = 0.0;
+    double yieldAcceleration = 0.0;
+    double ultimateDisplacement = 0.0;
+    double ultimateAcceleration = 0.0;
+
+    // Elastic damping in percent of critical
+    double elasticDamping = 5.0;
+
+    // Degradation factor that scales the hysteretic damping
+    double kappa = 1.0;
+
+    // Height of the roof in inches and the fraction of it at the displacement of the pushover mode, used to convert the spectral displacement to a drift ratio
+    double roofHeight = 0.0;
+    double pushoverModeHeightRatio = 0.75;
+};
+
+
+struct PerformancePoint
+{
+    // Spectral displacement in inches and spectral acceleration in g
+    double spectralDisplacement = 0.0;
+    double spectralAcceleration = 0.0;
+
+    // Effective damping in percent of critical
+    double effectiveDamping = 0.0;
+
+    // Average drift ratio of the building, zero if the roof height is not given
+    double driftRatio = 0.0;
+
+    // False if the demand exceeds the capacity up to the largest displacement that is searched
+    bool converged = true;
+};
+
+
+// Capacity spectrum method of Hazus with the elliptic capacity curve of Cao and Peterson (2006)
+// The demand spectrum has the standard Hazus shape, anchored at the short period and 1 s spectral accelerations, and is reduced for the effective damping of the building
+// The effective damping is the elastic damping plus the degraded hysteretic damping of a loop that unloads with the elastic stiffness
+// The performance points of a block of buildings are found together by bisection, and the blocks and realizations are evaluated on the thread pool
+class CapacitySpectrumMethod
+{
+public:
+    CapacitySpectrumMethod();
+
+    // Spectral acceleration on the capacity curve at a spectral displacement
+    static double getCapacityAcceleration(const CapacityCurveParameters& building, const double displacement);
+
+    // Spectral acceleration of the demand spectrum at a period in s for an effective damping in percent
+    double getDemandAcceleration(const double shortPeriodSa, const double oneSecondSa, const double period, const double damping) const;
+
+    // Finds the performance point of each building for each realization of the spectral accelerations at the sites
+    // The spectral accelerations are row-major with a row for each realization and a column for each site, the site of each building is given by its index
+    // The performance points are row-major with a row for each realization and a column for each building
+    int computePerformancePoints(const QVector<CapacityCurveParameters>& buildings, const QVector<int>& siteIndices, const QVector<double>& shortPeriodSa, const QVector<double>& oneSecondSa, const int numRealizations, QVector<PerformancePoint>& points, QString& err) const;
+
+    // Elastic damping in percent of the Hazus model building type, the structure type can also carry its height class, e.g., C1M
+    // Returns 5% for the types that are not in the Hazus table
+    static double getHazusElasticDamping(const QString& structureType);
+
+    // Mean performance point of each building over the realizations, a building is only converged if it converged in all of them
+    static QVector<PerformancePoint> getExpectedPerformancePoints(const QVector<PerformancePoint>& points, const int numBuildings);
+
+    // Moment magnitude of the earthquake, which sets the start of the constant displacement region of the demand spectrum
+    void setMagnitude(const double value);
+    double getMagnitude(void) const;
+
+    // Largest effective damping in percent, above it the Hazus reduction factors are no longer meaningful
+    void setMaxDamping(const double value);
+
+    // Largest displacement that is searched for the performance point as a multiple of the ultimate displacement
+    void setMaxDisplacementRatio(const double value);
+
+    // Number of bisection steps, each one halves the bracket around the performance point
+    void setNumIterations(const int value);
+
+private:
+
+    double magnitude = 7.0;
+    double maxDamping = 50.0;
+    double maxDisplacementRatio = 8.0;
+    int numIterations = 40;
+};
+
+#endif // CAPACITYSPECTRUMMETHOD_H
@@ -41,6 +41,11 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 
 #include <qgsfeature.h>
 #include <qgsfeaturerequest.h>
+#include <qgsvectordataprovider.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
 
 ComponentDatabase::ComponentDatabase(QString type) : offset(0), componentType(type)
 {
@@ -48,6 +53,12 @@ ComponentDatabase::ComponentDatabase(QString type) : offset(0), componentType(ty
 }
 
 
+ComponentDatabase::~ComponentDatabase()
+{
+    this->disconnectMainLayer();
+}
+
+
 bool ComponentDatabase::isEmpty(void)
 {
     if(mainLayer == nullptr)
@@ -62,8 +73,10 @@ bool ComponentDatabase::isEmpty(void)
 
 void ComponentDatabase::clear(void)
 {
+    this->disconnectMainLayer();
+    this->invalidateAttributeCache();
     mainLayer = nullptr;
-    selectedFeaturesSet.clear();
+    selectedFeatures.clear();
     offset = 0;
     selectedLayer = nullptr;
 }
@@ -110,7 +123,12 @@ void ComponentDatabase::commitChanges(void)
 
 void ComponentDatabase::setMainLayer(QgsVectorLayer *value)
 {
+    this->disconnectMainLayer();
+    this->invalidateAttributeCache();
+
     mainLayer = value;
+
+    this->connectMainLayer();
 }
 
 
@@ -120,39 +138,63 @@ void ComponentDatabase::setSelectedLayer(QgsVectorLayer *value)
 }
 
 
-bool ComponentDatabase::addFeaturesToSelectedLayer(const std::set<int> ids)
+bool ComponentDatabase::addFeaturesToSelectedLayer(const IDRangeSet& ids)
 {
-    if(!selectedFeaturesSet.isEmpty())
+    if(!selectedFeatures.isEmpty())
     {
-        selectedFeaturesSet.clear();
+        selectedFeatures.clear();
         this->clearSelectedLayer();
     }
 
-    selectedFeaturesSet.reserve(ids.size());
+    selectedFeatures = ids.shifted(offset);
 
-    for(auto&& id : ids)
-        selectedFeaturesSet.insert(id+offset);
+    auto featList = this->getMainLayerFeatures(selectedFeatures);
 
-    auto featIt = mainLayer->getFeatures(selectedFeaturesSet);
+    if(featList.size() != selectedFeatures.size())
+        return false;
+
+    auto res = selectedLayer->dataProvider()->addFeatures(featList, QgsFeatureSink::FastInsert);
 
+    selectedLayer->updateExtents();
+
+    return res;
+}
+
+
+QgsFeatureList ComponentDatabase::getMainLayerFeatures(const IDRangeSet& fids)
+{
     QgsFeatureList featList;
-    featList.reserve(ids.size());
+
+    if(fids.isEmpty() || mainLayer == nullptr)
+        return featList;
+
+    featList.reserve(fids.size());
+
+    // When most of the layer is requested, scan the layer and test each id against the ranges instead of expanding the ranges into a set of ids
+    const bool scanLayer = fids.size()*8 >= mainLayer->featureCount();
+
+    QgsFeatureRequest featRequest;
+
+    if(!scanLayer)
+        featRequest.setFilterFids(fids.toSet());
+
+    auto featIt = mainLayer->getFeatures(featRequest);
 
     QgsFeature feat;
     while (featIt.nextFeature(feat))
     {
-        auto id = feat.id();
+        if(scanLayer && !fids.contains(feat.id()))
+            continue;
+
         featList.push_back(feat);
     }
 
-    if(featList.size() != ids.size())
-        return false;
-
-    auto res = selectedLayer->dataProvider()->addFeatures(featList, QgsFeatureSink::FastInsert);
+    auto lessThan = [](const QgsFeature& a, const QgsFeature& b) { return a.id() < b.id(); };
 
-    selectedLayer->updateExtents();
+    if(!std::is_sorted(featList.begin(), featList.end(), lessThan))
+        std::sort(featList.begin(), featList.end(), lessThan);
 
-    return res;
+    return featList;
 }
 
 
@@ -160,7 +202,7 @@ bool ComponentDatabase::addFeatureToSelectedLayer(const int id)
 {
     auto fid = id+offset;
 
-    if(selectedFeaturesSet.contains(fid))
+    if(selectedFeatures.contains(fid))
         return true;
 
     auto feature = this->getFeature(fid);
@@ -188,18 +230,237 @@ bool ComponentDatabase::addFeatureToSelectedLayer(QgsFeature& feature)
         return false;
     }
 
-    selectedFeaturesSet.insert(fid);
+    selectedFeatures.insert(fid);
 
     return true;
 }
 
 
+IDRangeSet ComponentDatabase::getSelectedComponentIDs(void) const
+{
+    return selectedFeatures.shifted(-offset);
+}
+
+
+QString ComponentDatabase::getComponentType(void) const
+{
+    return componentType;
+}
+
+
 void ComponentDatabase::setOffset(int value)
 {
     offset = value;
 }
 
 
+void ComponentDatabase::connectMainLayer(void)
+{
+    if(mainLayer == nullptr)
+        return;
+
+    // Any edit of the main layer invalidates the cached attribute columns
+    auto invalidate = [this]() { this->invalidateAttributeCache(); };
+
+    mainLayerConnections.append(QObject::connect(mainLayer, &QgsVectorLayer::attributeValueChanged, invalidate));
+    mainLayerConnections.append(QObject::connect(mainLayer, &QgsVectorLayer::featureAdded, invalidate));
+    mainLayerConnections.append(QObject::connect(mainLayer, &QgsVectorLayer::featureDeleted, invalidate));
+    mainLayerConnections.append(QObject::connect(mainLayer, &QgsVectorLayer::updatedFields, invalidate));
+    mainLayerConnections.append(QObject::connect(mainLayer, &QgsMapLayer::dataChanged, invalidate));
+    mainLayerConnections.append(QObject::connect(mainLayer, &QObject::destroyed, [this]() {
+        mainLayerConnections.clear();
+        this->invalidateAttributeCache();
+        mainLayer = nullptr;
+    }));
+
+    if(auto provider = mainLayer->dataProvider())
+        mainLayerConnections.append(QObject::connect(provider, &QgsDataProvider::dataChanged, invalidate));
+}
+
+
+void ComponentDatabase::disconnectMainLayer(void)
+{
+    for(auto&& it : mainLayerConnections)
+        QObject::disconnect(it);
+
+    mainLayerConnections.clear();
+}
+
+
+void ComponentDatabase::invalidateAttributeCache(void)
+{
+    attributeCache.clear();
+    cacheFirstFid = 0;
+    cacheSize = 0;
+    cacheFeatureCount = -1;
+}
+
+
+bool ComponentDatabase::cacheAttributeColumns(const QStringList& attributes, QString& error)
+{
+    if(mainLayer == nullptr)
+    {
+        error = "Error, the "+componentType+" database is empty";
+        return false;
+    }
+
+    // Edits made directly through the provider do not always emit a signal
+    if(cacheFeatureCount != mainLayer->featureCount())
+        this->invalidateAttributeCache();
+
+    auto fields = mainLayer->fields();
+
+    QStringList missingAttributes;
+    QgsAttributeList fieldIndexes;
+
+    for(auto&& attribute : attributes)
+    {
+        if(attributeCache.contains(attribute) || missingAttributes.contains(attribute))
+            continue;
+
+        auto index = fields.lookupField(attribute);
+
+        if(index == -1)
+        {
+            error = "Error, could not find the attribute "+attribute+" in the "+componentType+" database";
+            return false;
+        }
+
+        missingAttributes.append(attribute);
+        fieldIndexes.append(index);
+    }
+
+    if(missingAttributes.isEmpty())
+        return true;
+
+    // Only fetch the attributes that are needed, without the geometry
+    QgsFeatureRequest featRequest;
+    featRequest.setFlags(QgsFeatureRequest::NoGeometry);
+    featRequest.setSubsetOfAttributes(fieldIndexes);
+
+    const auto numAttributes = fieldIndexes.size();
+    const auto numFeatures = mainLayer->featureCount();
+
+    QVector<qint64> fids;
+    QVector<double> featValues;
+
+    fids.reserve(numFeatures);
+    featValues.reserve(numFeatures*numAttributes);
+
+    const double nanVal = std::numeric_limits<double>::quiet_NaN();
+
+    auto featIt = mainLayer->getFeatures(featRequest);
+
+    QgsFeature feat;
+    while (featIt.nextFeature(feat))
+    {
+        fids.push_back(feat.id());
+
+        for(auto&& index : fieldIndexes)
+        {
+            auto var = feat.attribute(index);
+
+            bool OK = false;
+            auto val = var.isNull() ? nanVal : var.toDouble(&OK);
+
+            featValues.push_back(OK ? val : nanVal);
+        }
+    }
+
+    // The first fill sets the range of feature ids that the columns cover
+    if(attributeCache.isEmpty())
+    {
+        if(fids.isEmpty())
+        {
+            cacheFirstFid = 0;
+            cacheSize = 0;
+        }
+        else
+        {
+            auto minMax = std::minmax_element(fids.begin(), fids.end());
+            cacheFirstFid = *minMax.first;
+            cacheSize = static_cast<int>(*minMax.second - *minMax.first + 1);
+        }
+
+        cacheFeatureCount = numFeatures;
+    }
+
+    QVector<QVector<double>> columns(numAttributes, QVector<double>(cacheSize, nanVal));
+
+    for(int i = 0; i<fids.size(); ++i)
+    {
+        auto index = fids.at(i) - cacheFirstFid;
+
+        if(index < 0 || index >= cacheSize)
+        {
+            error = "Error, the features of the "+componentType+" database changed while fetching the attributes";
+            this->invalidateAttributeCache();
+            return false;
+        }
+
+        for(int j = 0; j<numAttributes; ++j)
+            columns[j][index] = featValues.at(i*numAttributes+j);
+    }
+
+    for(int j = 0; j<numAttributes; ++j)
+        attributeCache.insert(missingAttributes.at(j), columns.at(j));
+
+    return true;
+}
+
+
+bool ComponentDatabase::getAttributeValues(const QStringList& attributes, const QVector<qint64>& ids, QVector<double>& values, QString& error, const double defaultVal)
+{
+    values.clear();
+
+    if(!this->cacheAttributeColumns(attributes, error))
+        return false;
+
+    QVector<const QVector<double>*> columns;
+    for(auto&& attribute : attributes)
+        columns.append(&attributeCache.constFind(attribute).value());
+
+    const auto numAttributes = columns.size();
+
+    values.resize(ids.size()*numAttributes);
+
+    for(int i = 0; i<ids.size(); ++i)
+    {
+        auto index = ids.at(i) + offset - cacheFirstFid;
+
+        for(int j = 0; j<numAttributes; ++j)
+        {
+            auto val = (index >= 0 && index < cacheSize) ? columns.at(j)->at(index) : defaultVal;
+
+            values[i*numAttributes+j] = std::isnan(val) ? defaultVal : val;
+        }
+    }
+
+    return true;
+}
+
+
+bool ComponentDatabase::getAllAttributeValues(const QStringList& attributes, QVector<qint64>& ids, QVector<double>& values, QString& error, const double defaultVal)
+{
+    ids.clear();
+
+    if(mainLayer == nullptr)
+    {
+        error = "Error, the "+componentType+" database is empty";
+        return false;
+    }
+
+    auto fids = mainLayer->allFeatureIds().values();
+    std::sort(fids.begin(), fids.end());
+
+    ids.reserve(fids.size());
+    for(auto&& fid : fids)
+        ids.push_back(fid - offset);
+
+    return this->getAttributeValues(attributes, ids, values, error, defaultVal);
+}
+
+
 bool ComponentDatabase::removeFeaturesFromSelectedLayer(QgsFeatureIds& featureIds)
 {
     auto res = selectedLayer->dataProvider()->deleteFeatures(featureIds);
@@ -224,7 +485,7 @@ bool ComponentDatabase::addNewComponentAttributes(const QStringList& fieldNames,
         return false;
     }
 
-    auto numSelectedFeatures = selectedFeaturesSet.size();
+    auto numSelectedFeatures = selectedFeatures.size();
 
     auto numFeatSelLayer = selectedLayer->featureCount();
 
@@ -258,43 +519,27 @@ bool ComponentDatabase::addNewComponentAttributes(const QStringList& fieldNames,
         existingFields.append(QgsField(fieldNames[i], firstRow.at(i).type()));
 
 
-    QgsFeatureRequest featRequest (selectedFeaturesSet);
-
-    // All this just to get the feature request to return everything with ascending ids
-    QgsFeatureRequest::OrderByClause orderByClause(QString("id"),true);
-    QList<QgsFeatureRequest::OrderByClause> obcList = {orderByClause};
-    QgsFeatureRequest::OrderBy orderBy(obcList);
-    featRequest.setOrderBy(orderBy);
+    // The features are returned with ascending ids
+    auto featList = this->getMainLayerFeatures(selectedFeatures);
 
-    auto featIt = mainLayer->getFeatures(featRequest);
-
-    QgsFeatureList featList;
-    featList.reserve(values.size());
+    if(values.size() != featList.size())
+    {
+        error = "Error, inconsist sizes of values to update and number of updated features. Please contact developers. Could not add fields to "+selectedLayer->name();
+        return false;
+    }
 
-    int count = 0;
-    QgsFeature feat;
-    while (featIt.nextFeature(feat))
+    for(int i = 0; i<featList.size(); ++i)
     {
+        auto& feat = featList[i];
+
         auto existingAtrb = feat.attributes();
 
-        // auto id = feat.id();
         feat.setFields(existingFields, true);
 
-        auto newAtrb = values[count];
-
-        existingAtrb.append(newAtrb);
+        existingAtrb.append(values.at(i));
 
         // The number of provided attributes need to exactly match the number of the feature's fields.
         feat.setAttributes(existingAtrb);
-
-        featList.push_back(feat);
-        ++count;
-    }
-
-    if(values.size() != featList.size())
-    {
-        error = "Error, inconsist sizes of values to update and number of updated features. Please contact developers. Could not add fields to "+selectedLayer->name();
-        return false;
     }
 
     auto res = selectedLayer->dataProvider()->truncate();
@@ -338,7 +583,7 @@ bool ComponentDatabase::updateComponentAttributes(const QString& fieldName, cons
         return false;
     }
 
-    auto numSelectedFeatures = selectedFeaturesSet.size();
+    auto numSelectedFeatures = selectedFeatures.size();
 
     auto numFeatSelLayer = selectedLayer->featureCount();
 
@@ -356,31 +601,8 @@ bool ComponentDatabase::updateComponentAttributes(const QString& fieldName, cons
         return false;
     }
 
-    QgsFeatureRequest featRequest (selectedFeaturesSet);
-
-    // All this just to get the feature request to return everything with ascending ids
-    QgsFeatureRequest::OrderByClause orderByClause(QString("id"),true);
-    QList<QgsFeatureRequest::OrderByClause> obcList = {orderByClause};
-    QgsFeatureRequest::OrderBy orderBy(obcList);
-    featRequest.setOrderBy(orderBy);
-
-    auto featIt = mainLayer->getFeatures(featRequest);
-
-    QgsFeatureList featList;
-    featList.reserve(values.size());
-
-    int count = 0;
-    QgsFeature feat;
-    while (featIt.nextFeature(feat))
-    {
-        // auto id = feat.id();
-        auto attrb = values[count];
-
-        feat.setAttribute(field,attrb);
-
-        featList.push_back(feat);
-        ++count;
-    }
+    // The features are returned with ascending ids
+    auto featList = this->getMainLayerFeatures(selectedFeatures);
 
     if(values.size() != featList.size())
     {
@@ -388,6 +610,9 @@ bool ComponentDatabase::updateComponentAttributes(const QString& fieldName, cons
         return false;
     }
 
+    for(int i = 0; i<featList.size(); ++i)
+        featList[i].setAttribute(field,values.at(i));
+
     auto res = selectedLayer->dataProvider()->truncate();
 
     if(!res)
@@ -410,6 +635,91 @@ bool ComponentDatabase::updateComponentAttributes(const QString& fieldName, cons
 }
 
 
+bool ComponentDatabase::setAttributeValuesByKey(const QString& keyField, const QString& fieldName, const QHash<qint64, double>& values, QString& error, const QVariant defaultVal)
+{
+    if(mainLayer == nullptr)
+    {
+        error = "Error, the main layer is not set. Could not batch update field: "+fieldName;
+        return false;
+    }
+
+    auto updateLayer = [&](QgsVectorLayer* layer) -> bool
+    {
+        auto pr = layer->dataProvider();
+
+        auto keyIndex = pr->fieldNameIndex(keyField);
+
+        if(keyIndex == -1)
+        {
+            error = "Error, failed to find the field "+keyField+" in the layer "+layer->name();
+            return false;
+        }
+
+        auto fieldIndex = pr->fieldNameIndex(fieldName);
+
+        if(fieldIndex == -1)
+        {
+            if(!pr->addAttributes({QgsField(fieldName, QVariant::Double)}))
+            {
+                error = "Error adding the field "+fieldName+" to the layer "+layer->name();
+                return false;
+            }
+
+            layer->updateFields();
+
+            fieldIndex = pr->fieldNameIndex(fieldName);
+        }
+
+        QgsFeatureRequest featRequest;
+        featRequest.setFlags(QgsFeatureRequest::NoGeometry);
+        featRequest.setSubsetOfAttributes(QgsAttributeList({keyIndex}));
+
+        QgsChangedAttributesMap changedAttributes;
+
+        auto featIt = layer->getFeatures(featRequest);
+
+        QgsFeature feat;
+        while (featIt.nextFeature(feat))
+        {
+            bool OK = false;
+            auto key = feat.attribute(keyIndex).toLongLong(&OK);
+
+            QgsAttributeMap attributeMap;
+
+            if(OK && values.contains(key))
+                attributeMap.insert(fieldIndex, values.value(key));
+            else
+                attributeMap.insert(fieldIndex, defaultVal);
+
+            changedAttributes.insert(feat.id(), attributeMap);
+        }
+
+        if(!pr->changeAttributeValues(changedAttributes))
+        {
+            error = "Error, failed to update the field "+fieldName+" in the layer "+layer->name();
+            return false;
+        }
+
+        layer->triggerRepaint();
+
+        return true;
+    };
+
+    if(!updateLayer(mainLayer))
+        return false;
+
+    this->invalidateAttributeCache();
+
+    if(selectedLayer != nullptr && selectedLayer->featureCount() != 0)
+    {
+        if(!updateLayer(selectedLayer))
+            return false;
+    }
+
+    return true;
+}
+
+
 bool ComponentDatabase::updateComponentAttribute(const qint64 id, const QString& attribute, const QVariant& value)
 {
 
@@ -426,13 +736,15 @@ bool ComponentDatabase::updateComponentAttribute(const qint64 id, const QString&
 
     mainLayer->commitChanges(true);
 
+    this->invalidateAttributeCache();
+
     if(!res)
         return res;
 
     // Update the selected layer if there is one...
     if(selectedLayer != nullptr)
     {
-        auto fidSel = selectedFeaturesSet.values().indexOf(id);
+        auto fidSel = selectedFeatures.indexOf(fid);
 
         // Still return true if feature is not in the set
         if(fidSel == -1)
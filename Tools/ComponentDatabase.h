@@ -38,6 +38,9 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 
 // Written by: Stevan Gavrilovic
 
+#include "IDRangeSet.h"
+
+#include <QHash>
 #include <QMap>
 #include <QVariant>
 
@@ -45,8 +48,6 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 #include <qgsattributes.h>
 #include <qgsvectorlayer.h>
 
-#include <set>
-
 class ProgramOutputDialog;
 
 class QgsFeature;
@@ -55,6 +56,7 @@ class ComponentDatabase
 {
 public:
     ComponentDatabase(QString type);
+    ~ComponentDatabase();
 
     bool isEmpty(void);
 
@@ -63,7 +65,7 @@ public:
     void startEditing(void);
 
     // Fast, use for batch feature addition
-    bool addFeaturesToSelectedLayer(const std::set<int> ids);
+    bool addFeaturesToSelectedLayer(const IDRangeSet& ids);
 
     // Slow, only use for adding indvidual features when needed
     bool addFeatureToSelectedLayer(const int id);
@@ -77,12 +79,27 @@ public:
     // Fast, use for batch updates
     bool updateComponentAttributes(const QString& fieldName, const QVector<QVariant>& values, QString& error);
 
+    // Fast, use for batch updates of results that are keyed by a field of the components, e.g., the "ID" of the nodes of a network
+    // Sets the numeric field on the main and selected layers in a single provider call per layer, the field is added if it does not exist. Components without a value are set to the default value
+    bool setAttributeValuesByKey(const QString& keyField, const QString& fieldName, const QHash<qint64, double>& values, QString& error, const QVariant defaultVal = QVariant());
+
     // The field names passed as a vector and values passed as a matrix where each row is a component and each column is the fied value
     // The number of provided attributes need to exactly match the number of the feature's fields.
     bool addNewComponentAttributes(const QStringList& fieldNames, const QVector<QgsAttributes>& values, QString& error);
 
+    // Slow, only use for sparse lookups
     QVariant getAttributeValue(const qint64 id, const QString& attribute, const QVariant defaultVal = QVariant());
 
+    // Fast, use for batch lookups
+    // Returns the numeric attributes of the components as a contiguous row-major array, i.e., values[i*attributes.size()+j] is attribute j of component ids[i]
+    // Missing or non-numeric values are set to the default value. The attribute columns are fetched from the main layer in a single iteration and cached until the layer is edited
+    bool getAttributeValues(const QStringList& attributes, const QVector<qint64>& ids, QVector<double>& values, QString& error, const double defaultVal = 0.0);
+
+    // Same as above for all of the components in the main layer, the ids of the components are returned in ascending order
+    bool getAllAttributeValues(const QStringList& attributes, QVector<qint64>& ids, QVector<double>& values, QString& error, const double defaultVal = 0.0);
+
+    void invalidateAttributeCache(void);
+
     void commitChanges(void);
 
     void setMainLayer(QgsVectorLayer *value);
@@ -95,6 +112,11 @@ public:
 
     QgsVectorLayer *getMainLayer() const;
 
+    // IDs of the components that are selected for analysis
+    IDRangeSet getSelectedComponentIDs(void) const;
+
+    QString getComponentType(void) const;
+
     void setOffset(int value);
 
 private:
@@ -102,8 +124,17 @@ private:
 
     bool addFeatureToSelectedLayer(QgsFeature& feature);
 
-    // Selected feature set
-    QSet<long long> selectedFeaturesSet;
+    // Returns the features of the main layer with the given feature ids in ascending order of the ids
+    QgsFeatureList getMainLayerFeatures(const IDRangeSet& fids);
+
+    // Fills the cache with the columns of the attributes that are not already cached
+    bool cacheAttributeColumns(const QStringList& attributes, QString& error);
+
+    void connectMainLayer(void);
+    void disconnectMainLayer(void);
+
+    // Feature ids of the selected features in the main layer
+    IDRangeSet selectedFeatures;
 
     // Set of layers that this component may have features in
     QgsVectorLayer* mainLayer = nullptr;
@@ -112,6 +143,14 @@ private:
     int offset;
 
     QString componentType;
+
+    // Cached attribute columns of the main layer, indexed by the feature id minus cacheFirstFid. Missing values are NaN
+    QHash<QString, QVector<double>> attributeCache;
+    qint64 cacheFirstFid = 0;
+    int cacheSize = 0;
+    long long cacheFeatureCount = -1;
+
+    QVector<QMetaObject::Connection> mainLayerConnections;
 };
 
 #endif // ComponentDATABASE_H
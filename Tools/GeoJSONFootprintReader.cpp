@@ -0,0 +1,639 @@
+/* *****************************************************************************
+Copyright (c) 2016-2021, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+// Written by: Stevan Gavrilovic
+
+#include "GeoJSONFootprintReader.h"
+
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonParseError>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace {
+
+// Size of the blocks that the file is read in
+const qint64 blockSize = 1 << 20;
+
+bool isWhitespace(const char c)
+{
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+
+double getSquaredSegmentDistance(const QPointF& p, const QPointF& a, const QPointF& b)
+{
+    const double dx = b.x() - a.x();
+    const double dy = b.y() - a.y();
+
+    const double lengthSquared = dx*dx + dy*dy;
+
+    double t = 0.0;
+    if(lengthSquared > 0.0)
+        t = std::min(1.0, std::max(0.0, ((p.x() - a.x())*dx + (p.y() - a.y())*dy)/lengthSquared));
+
+    const double ex = a.x() + t*dx - p.x();
+    const double ey = a.y() + t*dy - p.y();
+
+    return ex*ex + ey*ey;
+}
+
+
+QPolygonF getRing(const QJsonArray& coordinates)
+{
+    QPolygonF ring;
+    ring.reserve(coordinates.size());
+
+    for(auto&& it : coordinates)
+    {
+        auto point = it.toArray();
+
+        if(point.size() >= 2)
+            ring.append(QPointF(point.at(0).toDouble(), point.at(1).toDouble()));
+    }
+
+    return ring;
+}
+
+
+QVector<QPolygonF> getPolygon(const QJsonArray& coordinates)
+{
+    QVector<QPolygonF> polygon;
+    polygon.reserve(coordinates.size());
+
+    for(auto&& it : coordinates)
+    {
+        auto ring = getRing(it.toArray());
+
+        if(ring.size() >= 4)
+            polygon.append(ring);
+    }
+
+    return polygon;
+}
+
+}
+
+
+GeoJSONFootprintReader::GeoJSONFootprintReader()
+{
+
+}
+
+
+GeoJSONFootprintReader::~GeoJSONFootprintReader()
+{
+    this->close();
+}
+
+
+int GeoJSONFootprintReader::open(const QString& pathToFile, QString& err)
+{
+    this->close();
+
+    extent = QRectF();
+    numFeaturesRead = 0;
+    numFeaturesSkipped = 0;
+    numVerticesRead = 0;
+
+    file.setFileName(pathToFile);
+
+    if(!file.open(QIODevice::ReadOnly))
+    {
+        err = "Could not open the footprint file " + pathToFile;
+        return -1;
+    }
+
+    if(this->nextToken() != '{')
+    {
+        err = "The footprint file " + pathToFile + " is not a GeoJSON object";
+        this->close();
+        return -1;
+    }
+
+    // Skip the members of the collection until the features array
+    while(true)
+    {
+        auto c = this->nextToken();
+
+        if(c == ',')
+            continue;
+
+        if(c != '"')
+            break;
+
+        QByteArray key;
+        bool escaped = false;
+        while(this->fillBuffer())
+        {
+            c = buffer.at(bufferPos++);
+
+            if(!escaped && c == '"')
+                break;
+
+            escaped = !escaped && c == '\\';
+            key.append(c);
+        }
+
+        if(this->nextToken() != ':')
+            break;
+
+        c = this->nextToken();
+
+        if(key == "features")
+        {
+            if(c != '[')
+                break;
+
+            inFeatures = true;
+            return 0;
+        }
+
+        if(c == '{' || c == '[' || c == '"')
+        {
+            if(!this->readObject())
+                break;
+        }
+        else
+        {
+            // Numbers, booleans, and null run until the next separator
+            while(this->fillBuffer() && buffer.at(bufferPos) != ',' && buffer.at(bufferPos) != '}')
+                ++bufferPos;
+        }
+    }
+
+    err = "Could not find the features of the footprint file " + pathToFile;
+    this->close();
+
+    return -1;
+}
+
+
+void GeoJSONFootprintReader::close(void)
+{
+    if(file.isOpen())
+        file.close();
+
+    buffer.clear();
+    featureText.clear();
+    bufferPos = 0;
+    inFeatures = false;
+}
+
+
+bool GeoJSONFootprintReader::fillBuffer(void)
+{
+    if(bufferPos < buffer.size())
+        return true;
+
+    buffer = file.read(blockSize);
+    bufferPos = 0;
+
+    return !buffer.isEmpty();
+}
+
+
+char GeoJSONFootprintReader::nextToken(void)
+{
+    while(this->fillBuffer())
+    {
+        const char c = buffer.at(bufferPos++);
+
+        if(!isWhitespace(c))
+            return c;
+    }
+
+    return 0;
+}
+
+
+bool GeoJSONFootprintReader::readObject(void)
+{
+    // The opening byte has already been read
+    const char opening = buffer.at(bufferPos - 1);
+
+    featureText.clear();
+    featureText.append(opening);
+
+    int depth = opening == '"' ? 0 : 1;
+    bool inString = opening == '"';
+    bool escaped = false;
+
+    while(this->fillBuffer())
+    {
+        // Scan the rest of the block and copy the scanned part in one go
+        const int start = bufferPos;
+        const int end = buffer.size();
+        const char* data = buffer.constData();
+
+        int i = start;
+        bool done = false;
+
+        for(; i<end && !done; ++i)
+        {
+            const char c = data[i];
+
+            if(inString)
+            {
+                if(escaped)
+                    escaped = false;
+                else if(c == '\\')
+                    escaped = true;
+                else if(c == '"')
+                {
+                    inString = false;
+                    done = depth == 0;
+                }
+            }
+            else if(c == '"')
+                inString = true;
+            else if(c == '{' || c == '[')
+                ++depth;
+            else if(c == '}' || c == ']')
+                done = --depth == 0;
+        }
+
+        featureText.append(data + start, i - start);
+        bufferPos = i;
+
+        if(done)
+            return true;
+    }
+
+    return false;
+}
+
+
+int GeoJSONFootprintReader::readChunk(const int maxFeatures, QVector<BuildingFootprint>& footprints, QString& err)
+{
+    footprints.clear();
+
+    while(inFeatures && footprints.size() < maxFeatures)
+    {
+        auto c = this->nextToken();
+
+        if(c == ',')
+            continue;
+
+        if(c == ']')
+        {
+            inFeatures = false;
+            break;
+        }
+
+        if(c != '{' || !this->readObject())
+        {
+            err = "The features of the footprint file " + file.fileName() + " are not valid GeoJSON";
+            inFeatures = false;
+            return -1;
+        }
+
+        QJsonParseError parseError;
+        auto doc = QJsonDocument::fromJson(featureText, &parseError);
+
+        if(parseError.error != QJsonParseError::NoError)
+        {
+            err = "Could not parse feature " + QString::number(numFeaturesRead + numFeaturesSkipped) + " of the footprint file " + file.fileName() + ": " + parseError.errorString();
+            inFeatures = false;
+            return -1;
+        }
+
+        BuildingFootprint footprint;
+        if(this->parseFootprint(doc.object(), footprint) != 0)
+        {
+            ++numFeaturesSkipped;
+            continue;
+        }
+
+        if(numFeaturesRead == 0)
+            extent = footprint.boundingBox;
+        else
+            extent = QRectF(QPointF(std::min(extent.left(), footprint.boundingBox.left()), std::min(extent.top(), footprint.boundingBox.top())),
+                            QPointF(std::max(extent.right(), footprint.boundingBox.right()), std::max(extent.bottom(), footprint.boundingBox.bottom())));
+
+        ++numFeaturesRead;
+        numVerticesRead += footprint.numVertices;
+
+        footprints.append(footprint);
+    }
+
+    featureText.clear();
+
+    return footprints.size();
+}
+
+
+int GeoJSONFootprintReader::parseFootprint(const QJsonObject& feature, BuildingFootprint& footprint)
+{
+    auto geometry = feature["geometry"].toObject();
+    auto type = geometry["type"].toString();
+    auto coordinates = geometry["coordinates"].toArray();
+
+    if(type == "Polygon")
+    {
+        footprint.polygons.append(getPolygon(coordinates));
+    }
+    else if(type == "MultiPolygon")
+    {
+        for(auto&& it : coordinates)
+            footprint.polygons.append(getPolygon(it.toArray()));
+    }
+    else
+        return 1;
+
+    footprint.polygons.erase(std::remove_if(footprint.polygons.begin(), footprint.polygons.end(), [](const QVector<QPolygonF>& polygon) { return polygon.isEmpty(); }), footprint.polygons.end());
+
+    if(footprint.polygons.isEmpty())
+        return 1;
+
+    footprint.properties = feature["properties"].toObject();
+
+    // The coordinates are taken relative to the first vertex so that the small areas of the footprints are not lost to round off
+    const QPointF origin = footprint.polygons.first().first().first();
+
+    double minX = origin.x(), maxX = origin.x(), minY = origin.y(), maxY = origin.y();
+    double area = 0.0, momentX = 0.0, momentY = 0.0;
+    double sumX = 0.0, sumY = 0.0;
+    int numOuterVertices = 0;
+
+    for(auto&& polygon : footprint.polygons)
+    {
+        for(int r = 0; r<polygon.size(); ++r)
+        {
+            const auto& ring = polygon.at(r);
+
+            double ringArea = 0.0, ringMomentX = 0.0, ringMomentY = 0.0;
+
+            for(int i = 0; i<ring.size(); ++i)
+            {
+                const auto& p = ring.at(i);
+
+                minX = std::min(minX, p.x());
+                maxX = std::max(maxX, p.x());
+                minY = std::min(minY, p.y());
+                maxY = std::max(maxY, p.y());
+
+                if(r == 0)
+                {
+                    sumX += p.x() - origin.x();
+                    sumY += p.y() - origin.y();
+                    ++numOuterVertices;
+                }
+
+                const auto& q = ring.at((i + 1) % ring.size());
+
+                const double x0 = p.x() - origin.x(), y0 = p.y() - origin.y();
+                const double x1 = q.x() - origin.x(), y1 = q.y() - origin.y();
+                const double cross = x0*y1 - x1*y0;
+
+                ringArea += cross;
+                ringMomentX += (x0 + x1)*cross;
+                ringMomentY += (y0 + y1)*cross;
+            }
+
+            // Outer rings add to the area and holes remove from it, whatever their orientation
+            const double sign = (r == 0 ? 1.0 : -1.0)*(ringArea < 0.0 ? -1.0 : 1.0);
+
+            area += sign*0.5*ringArea;
+            momentX += sign*ringMomentX/6.0;
+            momentY += sign*ringMomentY/6.0;
+
+            footprint.numVertices += ring.size();
+        }
+    }
+
+    if(std::fabs(area) > 0.0)
+        footprint.centroid = QPointF(origin.x() + momentX/area, origin.y() + momentY/area);
+    else
+        footprint.centroid = QPointF(origin.x() + sumX/numOuterVertices, origin.y() + sumY/numOuterVertices);
+
+    footprint.boundingBox = QRectF(QPointF(minX, minY), QPointF(maxX, maxY));
+
+    for(auto&& tolerance : tolerances)
+    {
+        FootprintPolygons simplified;
+        simplified.reserve(footprint.polygons.size());
+
+        for(auto&& polygon : footprint.polygons)
+        {
+            QVector<QPolygonF> simplifiedPolygon;
+            simplifiedPolygon.reserve(polygon.size());
+
+            for(auto&& ring : polygon)
+                simplifiedPolygon.append(simplifyRing(ring, tolerance));
+
+            simplified.append(simplifiedPolygon);
+        }
+
+        footprint.simplifiedPolygons.append(simplified);
+    }
+
+    return 0;
+}
+
+
+QPolygonF GeoJSONFootprintReader::simplifyRing(const QPolygonF& ring, const double tolerance)
+{
+    const int numPoints = ring.size();
+
+    if(numPoints <= 4 || tolerance <= 0.0)
+        return ring;
+
+    const double toleranceSquared = tolerance*tolerance;
+
+    // The ring is split at the vertex farthest from the first one, and each half is simplified as a line
+    int farthest = 0;
+    double maxDistance = -1.0;
+    for(int i = 1; i<numPoints; ++i)
+    {
+        const double dx = ring.at(i).x() - ring.at(0).x();
+        const double dy = ring.at(i).y() - ring.at(0).y();
+        const double distance = dx*dx + dy*dy;
+
+        if(distance > maxDistance)
+        {
+            maxDistance = distance;
+            farthest = i;
+        }
+    }
+
+    std::vector<char> keep(numPoints, 0);
+    keep[0] = keep[farthest] = keep[numPoints-1] = 1;
+
+    std::vector<std::pair<int, int>> segments = {{0, farthest}, {farthest, numPoints-1}};
+
+    while(!segments.empty())
+    {
+        const auto segment = segments.back();
+        segments.pop_back();
+
+        int index = -1;
+        double maxSegmentDistance = toleranceSquared;
+
+        for(int i = segment.first + 1; i<segment.second; ++i)
+        {
+            const double distance = getSquaredSegmentDistance(ring.at(i), ring.at(segment.first), ring.at(segment.second));
+
+            if(distance > maxSegmentDistance)
+            {
+                maxSegmentDistance = distance;
+                index = i;
+            }
+        }
+
+        if(index != -1)
+        {
+            keep[index] = 1;
+            segments.push_back({segment.first, index});
+            segments.push_back({index, segment.second});
+        }
+    }
+
+    QPolygonF simplified;
+    for(int i = 0; i<numPoints; ++i)
+    {
+        if(keep[i])
+            simplified.append(ring.at(i));
+    }
+
+    if(simplified.size() < 4)
+        return ring;
+
+    return simplified;
+}
+
+
+void GeoJSONFootprintReader::setSimplificationTolerances(const QVector<double>& values)
+{
+    tolerances = values;
+}
+
+
+QRectF GeoJSONFootprintReader::getExtent(void) const
+{
+    return extent;
+}
+
+
+int GeoJSONFootprintReader::getNumFeaturesRead(void) const
+{
+    return numFeaturesRead;
+}
+
+
+int GeoJSONFootprintReader::getNumFeaturesSkipped(void) const
+{
+    return numFeaturesSkipped;
+}
+
+
+qint64 GeoJSONFootprintReader::getNumVerticesRead(void) const
+{
+    return numVerticesRead;
+}
+
+
+int GeoJSONFootprintReader::writeSyntheticFootprints(const QString& pathToFile, const int numFootprints, const int verticesPerEdge, const QRectF& region, QString& err)
+{
+    QFile outFile(pathToFile);
+
+    if(!outFile.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        err = "Could not open the file " + pathToFile + " for writing";
+        return -1;
+    }
+
+    // The footprints are laid out on a grid over the region, each one is a rectangle in its cell with its edges split into wavy segments
+    const int numColumns = std::max(1, static_cast<int>(std::ceil(std::sqrt(static_cast<double>(numFootprints)))));
+    const double cellWidth = region.width()/numColumns;
+    const double cellHeight = region.height()/numColumns;
+    const int numSegments = std::max(1, verticesPerEdge);
+
+    // Waviness of the edges relative to the size of the cell, small enough to be removed by a coarse simplification
+    const double waviness = 0.002;
+
+    outFile.write("{\"type\":\"FeatureCollection\",\"features\":[\n");
+
+    for(int n = 0; n<numFootprints; ++n)
+    {
+        const double left = region.left() + (n % numColumns + 0.2)*cellWidth;
+        const double bottom = region.top() + (n / numColumns + 0.2)*cellHeight;
+        const double width = 0.6*cellWidth;
+        const double height = 0.6*cellHeight;
+
+        const QPointF corners[5] = {{left, bottom}, {left + width, bottom}, {left + width, bottom + height}, {left, bottom + height}, {left, bottom}};
+
+        QByteArray text = n == 0 ? "" : ",\n";
+        text += "{\"type\":\"Feature\",\"properties\":{\"id\":" + QByteArray::number(n) + "},\"geometry\":{\"type\":\"Polygon\",\"coordinates\":[[";
+
+        for(int edge = 0; edge<4; ++edge)
+        {
+            for(int s = 0; s<numSegments; ++s)
+            {
+                const double t = static_cast<double>(s)/numSegments;
+                const double wave = s == 0 ? 0.0 : waviness*std::sin(7.0*n + 3.0*s);
+
+                // Offset the points along the normal of the edge
+                const double dx = corners[edge+1].x() - corners[edge].x();
+                const double dy = corners[edge+1].y() - corners[edge].y();
+
+                const double x = corners[edge].x() + t*dx - wave*dy;
+                const double y = corners[edge].y() + t*dy + wave*dx;
+
+                text += "[" + QByteArray::number(x, 'f', 8) + "," + QByteArray::number(y, 'f', 8) + "],";
+            }
+        }
+
+        text += "[" + QByteArray::number(corners[0].x(), 'f', 8) + "," + QByteArray::number(corners[0].y(), 'f', 8) + "]]]}}";
+
+        outFile.write(text);
+    }
+
+    outFile.write("\n]}\n");
+
+    if(outFile.error() != QFileDevice::NoError)
+    {
+        err = "Error writing the synthetic footprints to " + pathToFile;
+        return -1;
+    }
+
+    outFile.close();
+
+    return 0;
+}
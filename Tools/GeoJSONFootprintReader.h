@@ -0,0 +1,134 @@
+#ifndef GEOJSONFOOTPRINTREADER_H
+#define GEOJSONFOOTPRINTREADER_H
+/* *****************************************************************************
+Copyright (c) 2016-2021, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+// Written by: Stevan Gavrilovic
+
+#include <QByteArray>
+#include <QFile>
+#include <QJsonObject>
+#include <QPolygonF>
+#include <QRectF>
+#include <QString>
+#include <QVector>
+
+// Polygons of a footprint, each polygon is a list of rings where the first ring is the outer boundary and the rest are holes
+// The x coordinate is the longitude and the y coordinate the latitude
+typedef QVector<QVector<QPolygonF>> FootprintPolygons;
+
+struct BuildingFootprint
+{
+    QJsonObject properties;
+
+    FootprintPolygons polygons;
+
+    // Simplified polygons, one for each of the simplification tolerances of the reader
+    QVector<FootprintPolygons> simplifiedPolygons;
+
+    // Area weighted centroid and bounding box of the outer rings, less the holes
+    QPointF centroid;
+    QRectF boundingBox;
+
+    int numVertices = 0;
+};
+
+
+// Reads the polygon features of a GeoJSON feature collection a chunk at a time, so that the footprints of a whole county never have to be in memory at once
+// The file is read in blocks and split into features while it is read, only the text of the current feature is parsed
+// Features with geometries other than polygons and multipolygons are counted and skipped
+class GeoJSONFootprintReader
+{
+public:
+    GeoJSONFootprintReader();
+    ~GeoJSONFootprintReader();
+
+    // Opens the file and moves to the start of the features array
+    int open(const QString& pathToFile, QString& err);
+
+    void close(void);
+
+    // Reads up to maxFeatures footprints, returns the number read or -1 on an error, zero means that all of the features were read
+    int readChunk(const int maxFeatures, QVector<BuildingFootprint>& footprints, QString& err);
+
+    // Tolerances in degrees of the simplified polygons, one set of simplified polygons is kept for each tolerance
+    void setSimplificationTolerances(const QVector<double>& values);
+
+    // Bounding box of the footprints read so far, kept after the reader is closed
+    QRectF getExtent(void) const;
+
+    int getNumFeaturesRead(void) const;
+    int getNumFeaturesSkipped(void) const;
+    qint64 getNumVerticesRead(void) const;
+
+    // Douglas-Peucker simplification of a closed ring, the ring is kept as is if simplifying it would leave less than a triangle
+    static QPolygonF simplifyRing(const QPolygonF& ring, const double tolerance);
+
+    // Writes a feature collection of rectangular footprints with extra vertices along their edges, for testing the reader without downloading footprints
+    static int writeSyntheticFootprints(const QString& pathToFile, const int numFootprints, const int verticesPerEdge, const QRectF& region, QString& err);
+
+private:
+
+    // Next byte of the file that is not whitespace, zero at the end of the file
+    char nextToken(void);
+
+    // Copies the text of the object, array, or string that starts with the byte that was just read to the feature buffer
+    bool readObject(void);
+
+    bool fillBuffer(void);
+
+    // Returns 1 if the feature is not a footprint
+    int parseFootprint(const QJsonObject& feature, BuildingFootprint& footprint);
+
+    QFile file;
+
+    QByteArray buffer;
+    int bufferPos = 0;
+
+    QByteArray featureText;
+
+    bool inFeatures = false;
+
+    QVector<double> tolerances;
+
+    QRectF extent;
+
+    int numFeaturesRead = 0;
+    int numFeaturesSkipped = 0;
+    qint64 numVerticesRead = 0;
+};
+
+#endif // GEOJSONFOOTPRINTREADER_H
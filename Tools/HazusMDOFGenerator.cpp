@@ -0,0 +1,848 @@
+/* *****************************************************************************
+Copyright (c) 2016-2021, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+// Written by: Stevan Gavrilovic
+
+#include "HazusMDOFGenerator.h"
+
+#include <QFile>
+#include <QMap>
+#include <QRegExp>
+#include <QTextStream>
+#include <QtConcurrent/QtConcurrent>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace {
+
+const double gravity = 9.81;
+const double inchToMeter = 0.0254;
+const double footToMeter = 0.3048;
+
+// Random stream of the splitmix64 generator, small enough to have one for each building
+class BuildingRandomStream
+{
+public:
+    BuildingRandomStream(const int seed, const int building)
+    {
+        state = (static_cast<uint64_t>(static_cast<uint32_t>(seed)) << 32) ^ static_cast<uint64_t>(static_cast<uint32_t>(building));
+        this->next();
+    }
+
+    // Pair of independent standard normal numbers from the Box-Muller transform
+    void normalPair(double& z1, double& z2)
+    {
+        const double u1 = 1.0 - this->uniform();
+        const double u2 = this->uniform();
+
+        const double r = std::sqrt(-2.0*std::log(u1));
+
+        z1 = r*std::cos(2.0*M_PI*u2);
+        z2 = r*std::sin(2.0*M_PI*u2);
+    }
+
+private:
+
+    // Uniform random number in [0, 1)
+    double uniform(void)
+    {
+        return (this->next() >> 11)*(1.0/9007199254740992.0);
+    }
+
+    uint64_t next(void)
+    {
+        uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30))*0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27))*0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    uint64_t state = 0;
+};
+
+
+QString getClassKey(const QString& structureType, const QString& heightClass, const QString& designLevel)
+{
+    return structureType.trimmed().toUpper() + "|" + heightClass.trimmed().toUpper() + "|" + designLevel.trimmed().toUpper();
+}
+
+
+// Design level named in the title of a table, empty if there is none
+QString getTitleDesignLevel(const QString& title)
+{
+    QRegExp levelExp("\\b(high|moderate|low|pre)[- ]?code\\b", Qt::CaseInsensitive);
+
+    if(levelExp.indexIn(title) == -1)
+        return QString();
+
+    const QString level = levelExp.cap(1).toLower();
+
+    if(level == "high")
+        return "High-Code";
+    else if(level == "moderate")
+        return "Moderate-Code";
+    else if(level == "low")
+        return "Low-Code";
+
+    return "Pre-Code";
+}
+
+}
+
+
+HazusMDOFGenerator::HazusMDOFGenerator()
+{
+
+}
+
+
+int HazusMDOFGenerator::readHazusData(const QString& pathToFile, QString& err)
+{
+    QFile file(pathToFile);
+    if(!file.open(QIODevice::ReadOnly | QIODevice::Text))
+    {
+        err = "Error, could not open the Hazus data file " + pathToFile;
+        return -1;
+    }
+
+    QTextStream in(&file);
+
+    QStringList lines;
+    while(!in.atEnd())
+        lines.append(in.readLine().trimmed());
+
+    // The table of R2D starts with a heading row that names the structure type column
+    for(auto&& line : lines)
+    {
+        if(line.isEmpty() || line.startsWith('#') || line.startsWith('%'))
+            continue;
+
+        if(line.split(QRegExp("[\\s,]+"), QString::SkipEmptyParts).first().toLower() == "structuretype")
+            return this->readHazusTable(lines, err);
+
+        break;
+    }
+
+    if(this->readBackendHazusData(lines, err) != 0)
+    {
+        err = "Error, could not read the Hazus data file " + pathToFile + ": " + err;
+        return -1;
+    }
+
+    return 0;
+}
+
+
+int HazusMDOFGenerator::readHazusTable(const QStringList& lines, QString& err)
+{
+    QStringList headings;
+    QVector<HazusBuildingClass> classes;
+
+    int typeIndex = -1, heightIndex = -1, minIndex = -1, maxIndex = -1, dyIndex = -1, ayIndex = -1, periodIndex = -1, dampingIndex = -1;
+
+    int lineNumber = 0;
+    for(auto&& line : lines)
+    {
+        ++lineNumber;
+
+        if(line.isEmpty() || line.startsWith('#') || line.startsWith('%'))
+            continue;
+
+        QStringList parts = line.split(QRegExp("[\\s,]+"), QString::SkipEmptyParts);
+
+        if(headings.isEmpty())
+        {
+            for(auto&& it : parts)
+                headings.append(it.toLower());
+
+            typeIndex = headings.indexOf("structuretype");
+            heightIndex = headings.indexOf("heightclass");
+            minIndex = headings.indexOf("minstories");
+            maxIndex = headings.indexOf("maxstories");
+            dyIndex = headings.indexOf("dy");
+            ayIndex = headings.indexOf("ay");
+            periodIndex = headings.indexOf("te");
+            dampingIndex = headings.indexOf("damping");
+
+            if(typeIndex == -1 || heightIndex == -1 || minIndex == -1 || maxIndex == -1 || (periodIndex == -1 && (dyIndex == -1 || ayIndex == -1)))
+            {
+                err = "Error, the Hazus data file needs a heading row with the StructureType, HeightClass, MinStories, MaxStories columns and either the Te column or the Dy and Ay columns";
+                return -1;
+            }
+
+            continue;
+        }
+
+        if(parts.size() != headings.size())
+        {
+            err = "Error, line " + QString::number(lineNumber) + " of the Hazus data file has " + QString::number(parts.size()) + " columns instead of " + QString::number(headings.size());
+            return -1;
+        }
+
+        HazusBuildingClass buildingClass;
+        buildingClass.structureType = parts.at(typeIndex);
+
+        // A dash stands for a structure type without height classes
+        buildingClass.heightClass = parts.at(heightIndex) == "-" ? QString() : parts.at(heightIndex);
+
+        bool OK1, OK2, OK3 = true, OK4 = true, OK5 = true;
+        buildingClass.minStories = parts.at(minIndex).toInt(&OK1);
+        buildingClass.maxStories = parts.at(maxIndex).toInt(&OK2);
+
+        if(periodIndex != -1)
+        {
+            buildingClass.elasticPeriod = parts.at(periodIndex).toDouble(&OK3);
+        }
+        else
+        {
+            buildingClass.yieldDisplacement = parts.at(dyIndex).toDouble(&OK3);
+            buildingClass.yieldAcceleration = parts.at(ayIndex).toDouble(&OK4);
+        }
+
+        if(dampingIndex != -1)
+            buildingClass.dampingRatio = 0.01*parts.at(dampingIndex).toDouble(&OK5);
+
+        if(!OK1 || !OK2 || !OK3 || !OK4 || !OK5)
+        {
+            err = "Error, line " + QString::number(lineNumber) + " of the Hazus data file has a value that is not a number";
+            return -1;
+        }
+
+        const bool validPeriod = periodIndex != -1 ? buildingClass.elasticPeriod > 0.0 : buildingClass.yieldDisplacement > 0.0 && buildingClass.yieldAcceleration > 0.0;
+
+        if(!validPeriod || buildingClass.minStories > buildingClass.maxStories)
+        {
+            err = "Error, line " + QString::number(lineNumber) + " of the Hazus data file has a period or yield point that is not positive or an empty range of stories";
+            return -1;
+        }
+
+        classes.append(buildingClass);
+    }
+
+    if(classes.isEmpty())
+    {
+        err = "Error, the Hazus data file does not have any building classes";
+        return -1;
+    }
+
+    this->setBuildingClasses(classes);
+
+    return 0;
+}
+
+
+int HazusMDOFGenerator::readBackendHazusData(const QStringList& lines, QString& err)
+{
+    // Label of a model building type, the structure type followed by its height class
+    const QRegExp labelExp("^(W1|W2|S1|S2|S3|S4|S5|C1|C2|C3|PC1|PC2|RM1|RM2|URM|MH)(L|M|H)?$", Qt::CaseInsensitive);
+    const QRegExp rangeExp("^(\\d+)(-(\\d+)|\\+)$");
+
+    enum class Table {Unknown, Types, Periods, Capacity, Damping};
+
+    struct TypeData
+    {
+        QString structureType;
+        QString heightClass;
+
+        bool hasStories = false;
+        int minStories = 1;
+        int maxStories = 1;
+        int typicalStories = 0;
+        double typicalHeight = 0.0;
+
+        double elasticPeriod = 0.0;
+        double modalWeightFactor = 1.0;
+        double modalHeightFactor = 1.0;
+
+        double dampingRatio = 0.05;
+
+        // Yield and ultimate displacement and acceleration of each design level
+        QMap<QString, QVector<double>> capacityPoints;
+    };
+
+    // Types in the order of the file
+    QStringList labels;
+    QHash<QString, TypeData> types;
+
+    Table table = Table::Unknown;
+    QString designLevel;
+
+    for(auto&& line : lines)
+    {
+        if(line.isEmpty())
+            continue;
+
+        QString text = line;
+        while(text.startsWith('#') || text.startsWith('%'))
+            text.remove(0, 1);
+
+        QStringList parts = text.split(QRegExp("[\\s,]+"), QString::SkipEmptyParts);
+
+        if(parts.isEmpty())
+            continue;
+
+        // The label is the first or, after the number of the row, the second entry of a row
+        int labelIndex = -1;
+        for(int i = 0; i<std::min(2, parts.size()); ++i)
+        {
+            if(labelExp.exactMatch(parts.at(i)))
+            {
+                labelIndex = i;
+                break;
+            }
+        }
+
+        // Any other line is the title or the column headings of a table
+        if(labelIndex == -1 || line.startsWith('#') || line.startsWith('%'))
+        {
+            const QString title = text.toLower();
+
+            if(title.contains("table"))
+            {
+                // The title of the periods also names the yield overstrength, so it is checked first
+                if(title.contains("period"))
+                    table = Table::Periods;
+                else if(title.contains("yield") || title.contains("capacity curve"))
+                    table = Table::Capacity;
+                else if(title.contains("damping"))
+                    table = Table::Damping;
+                else if(title.contains("model) types") || title.contains("structure types") || title.contains("stories"))
+                    table = Table::Types;
+                else
+                    table = Table::Unknown;
+
+                designLevel = getTitleDesignLevel(title);
+            }
+
+            continue;
+        }
+
+        if(table == Table::Unknown)
+            continue;
+
+        labelExp.exactMatch(parts.at(labelIndex));
+
+        const QString label = parts.at(labelIndex).toUpper();
+
+        if(!types.contains(label))
+        {
+            labels.append(label);
+            types[label].structureType = labelExp.cap(1).toUpper();
+            types[label].heightClass = labelExp.cap(2).toUpper();
+        }
+
+        TypeData& type = types[label];
+
+        int firstValue = labelIndex + 1;
+        bool hasRange = false;
+        int minStories = 1, maxStories = 1;
+
+        // The description of a type can hold numbers, so only the numbers after its range of stories are read
+        if(table == Table::Types)
+        {
+            for(int i = parts.size() - 1; i>labelIndex && !hasRange; --i)
+            {
+                const QString& part = parts.at(i);
+
+                if(rangeExp.exactMatch(part))
+                {
+                    hasRange = true;
+                    minStories = rangeExp.cap(1).toInt();
+                    maxStories = rangeExp.cap(3).isEmpty() ? 150 : rangeExp.cap(3).toInt();
+                    firstValue = i + 1;
+                }
+                else if(part.toLower() == "all")
+                {
+                    hasRange = true;
+                    minStories = 1;
+                    maxStories = 150;
+                    firstValue = i + 1;
+                }
+            }
+        }
+
+        // The numbers of the row, the descriptions between them are skipped
+        QVector<double> values;
+        for(int i = firstValue; i<parts.size(); ++i)
+        {
+            bool OK;
+            auto value = parts.at(i).toDouble(&OK);
+
+            if(OK)
+                values.append(value);
+        }
+
+        if(table == Table::Types)
+        {
+            // The range of stories is either a range such as 4-7 or two numbers, followed by the typical number of stories and the typical height in ft
+            if(!hasRange && values.size() >= 4)
+            {
+                hasRange = true;
+                values = values.mid(values.size() - 4);
+                minStories = static_cast<int>(values.at(0));
+                maxStories = static_cast<int>(values.at(1));
+                values.remove(0, 2);
+            }
+
+            if(!hasRange || values.size() < 2 || minStories > maxStories || values.at(0) < 1.0 || values.at(1) <= 0.0)
+            {
+                err = "the row of " + label + " in the table of the model building types needs the range of stories, the typical number of stories, and the typical height";
+                return -1;
+            }
+
+            type.hasStories = true;
+            type.minStories = minStories;
+            type.maxStories = maxStories;
+            type.typicalStories = static_cast<int>(values.at(0));
+            type.typicalHeight = values.at(1)*footToMeter;
+        }
+        else if(table == Table::Periods)
+        {
+            // The elastic period is followed by the modal factors of the weight and the height
+            if(values.size() < 3 || values.at(0) <= 0.0 || values.at(1) <= 0.0 || values.at(2) <= 0.0)
+            {
+                err = "the row of " + label + " in the table of the periods needs a positive period and modal factors";
+                return -1;
+            }
+
+            type.elasticPeriod = values.at(0);
+            type.modalWeightFactor = values.at(1);
+            type.modalHeightFactor = values.at(2);
+        }
+        else if(table == Table::Capacity)
+        {
+            // The yield displacement in inches and acceleration in g come before the ultimate point
+            if(values.size() < 2 || values.at(0) <= 0.0 || values.at(1) <= 0.0)
+            {
+                err = "the row of " + label + " in the table of the capacity curves needs a positive yield point";
+                return -1;
+            }
+
+            // The ultimate point is zero if the table only has the yield point
+            QVector<double> point = values.mid(0, 4);
+            point.resize(4);
+
+            type.capacityPoints.insert(designLevel, point);
+        }
+        else if(table == Table::Damping)
+        {
+            if(values.isEmpty() || values.at(0) <= 0.0)
+            {
+                err = "the row of " + label + " in the table of the damping needs a positive damping ratio";
+                return -1;
+            }
+
+            type.dampingRatio = 0.01*values.at(0);
+        }
+    }
+
+    QVector<HazusBuildingClass> classes;
+
+    for(auto&& label : labels)
+    {
+        const TypeData& type = types.value(label);
+
+        // The types without stories or without a period or capacity curve cannot have a model
+        if(!type.hasStories || (type.capacityPoints.isEmpty() && type.elasticPeriod <= 0.0))
+            continue;
+
+        HazusBuildingClass buildingClass;
+        buildingClass.structureType = type.structureType;
+        buildingClass.heightClass = type.heightClass;
+        buildingClass.minStories = type.minStories;
+        buildingClass.maxStories = type.maxStories;
+        buildingClass.typicalStories = type.typicalStories;
+        buildingClass.typicalHeight = type.typicalHeight;
+        buildingClass.elasticPeriod = type.elasticPeriod;
+        buildingClass.modalWeightFactor = type.modalWeightFactor;
+        buildingClass.modalHeightFactor = type.modalHeightFactor;
+        buildingClass.dampingRatio = type.dampingRatio;
+
+        if(type.capacityPoints.isEmpty())
+        {
+            classes.append(buildingClass);
+            continue;
+        }
+
+        for(auto it = type.capacityPoints.constBegin(); it != type.capacityPoints.constEnd(); ++it)
+        {
+            buildingClass.designLevel = it.key();
+            buildingClass.yieldDisplacement = it.value().at(0);
+            buildingClass.yieldAcceleration = it.value().at(1);
+            buildingClass.ultimateDisplacement = it.value().at(2);
+            buildingClass.ultimateAcceleration = it.value().at(3);
+
+            classes.append(buildingClass);
+        }
+    }
+
+    if(classes.isEmpty())
+    {
+        err = "there is no model building type with its stories and either its period or its capacity curve";
+        return -1;
+    }
+
+    this->setBuildingClasses(classes);
+
+    return 0;
+}
+
+
+void HazusMDOFGenerator::setBuildingClasses(const QVector<HazusBuildingClass>& values)
+{
+    buildingClasses = values;
+
+    classIndices.clear();
+    typeClasses.clear();
+
+    for(int i = 0; i<buildingClasses.size(); ++i)
+    {
+        const auto& buildingClass = buildingClasses.at(i);
+
+        classIndices.insert(getClassKey(buildingClass.structureType, buildingClass.heightClass, buildingClass.designLevel), i);
+        typeClasses[buildingClass.structureType.trimmed().toUpper()].append(i);
+    }
+}
+
+
+int HazusMDOFGenerator::getNumBuildingClasses(void) const
+{
+    return buildingClasses.size();
+}
+
+
+HazusBuildingClass HazusMDOFGenerator::getBuildingClass(const int i) const
+{
+    return buildingClasses.at(i);
+}
+
+
+int HazusMDOFGenerator::findBuildingClass(const QString& structureType, const int numStories, const QString& designLevel) const
+{
+    const QString type = structureType.trimmed().toUpper();
+    const QString level = designLevel.trimmed().toUpper();
+
+    auto it = typeClasses.constFind(type);
+    if(it != typeClasses.constEnd())
+    {
+        // Pick the height class that holds the number of stories, or the one that is the fewest stories away, and then the class of the design level
+        int bestClass = -1;
+        int bestDistance = 0;
+        bool bestLevel = false;
+
+        for(auto&& index : it.value())
+        {
+            const auto& buildingClass = buildingClasses.at(index);
+
+            const int distance = std::max(buildingClass.minStories - numStories, 0) + std::max(numStories - buildingClass.maxStories, 0);
+            const bool sameLevel = buildingClass.designLevel.toUpper() == level;
+
+            if(bestClass == -1 || distance < bestDistance || (distance == bestDistance && sameLevel && !bestLevel))
+            {
+                bestClass = index;
+                bestDistance = distance;
+                bestLevel = sameLevel;
+            }
+        }
+
+        return bestClass;
+    }
+
+    // The structure type may end with its height class
+    if(type.size() > 1)
+    {
+        const QString baseType = type.left(type.size() - 1);
+        const QString heightClass = type.right(1);
+
+        auto index = classIndices.value(getClassKey(baseType, heightClass, level), -1);
+        if(index != -1)
+            return index;
+
+        // Any design level of the height class if the one asked for is not in the table
+        for(auto&& typeIndex : typeClasses.value(baseType))
+        {
+            if(buildingClasses.at(typeIndex).heightClass.toUpper() == heightClass)
+                return typeIndex;
+        }
+    }
+
+    return -1;
+}
+
+
+QString HazusMDOFGenerator::getDesignLevel(const int yearBuilt)
+{
+    if(yearBuilt > 1975)
+        return "High-Code";
+    else if(yearBuilt > 1940)
+        return "Moderate-Code";
+    else if(yearBuilt > 0)
+        return "Pre-Code";
+
+    return QString();
+}
+
+
+void HazusMDOFGenerator::computePeriods(const int numStories, const double* storyMass, const double* storyStiffness, const int numModes, double* periods)
+{
+    const int numPeriods = std::min(numModes, numStories);
+
+    for(int i = 0; i<numModes; ++i)
+        periods[i] = 0.0;
+
+    if(numPeriods <= 0)
+        return;
+
+    // Diagonal and off-diagonal of M^-1/2 K M^-1/2, story i connects floor i to the floor below it
+    std::vector<double> diagonal(numStories);
+    std::vector<double> offDiagonalSquared(numStories, 0.0);
+
+    double upperBound = 0.0;
+
+    for(int i = 0; i<numStories; ++i)
+    {
+        const double stiffnessAbove = i + 1 < numStories ? storyStiffness[i + 1] : 0.0;
+
+        diagonal[i] = (storyStiffness[i] + stiffnessAbove)/storyMass[i];
+
+        if(i + 1 < numStories)
+            offDiagonalSquared[i] = stiffnessAbove*stiffnessAbove/(storyMass[i]*storyMass[i + 1]);
+
+        // Gershgorin bound on the largest eigenvalue
+        const double radius = std::sqrt(offDiagonalSquared[i]) + (i > 0 ? std::sqrt(offDiagonalSquared[i - 1]) : 0.0);
+        upperBound = std::max(upperBound, diagonal[i] + radius);
+    }
+
+    // Number of eigenvalues less than x from the signs of the Sturm sequence
+    auto countEigenvalues = [&](const double x)
+    {
+        int count = 0;
+        double q = 1.0;
+
+        for(int i = 0; i<numStories; ++i)
+        {
+            q = diagonal[i] - x - (i > 0 ? offDiagonalSquared[i - 1]/q : 0.0);
+
+            if(q == 0.0)
+                q = -1.0e-300;
+
+            if(q < 0.0)
+                ++count;
+        }
+
+        return count;
+    };
+
+    for(int mode = 0; mode<numPeriods; ++mode)
+    {
+        double lower = 0.0;
+        double upper = upperBound;
+
+        for(int iteration = 0; iteration<100 && upper - lower > 1.0e-14*upper; ++iteration)
+        {
+            const double middle = 0.5*(lower + upper);
+
+            if(countEigenvalues(middle) > mode)
+                upper = middle;
+            else
+                lower = middle;
+        }
+
+        const double eigenvalue = 0.5*(lower + upper);
+
+        periods[mode] = eigenvalue > 0.0 ? 2.0*M_PI/std::sqrt(eigenvalue) : 0.0;
+    }
+}
+
+
+int HazusMDOFGenerator::generateModels(const QVector<MDOFBuilding>& buildings, const int numModes, const int seed, MDOFModels& models, QString& err) const
+{
+    models = MDOFModels();
+
+    if(buildingClasses.isEmpty())
+    {
+        err = "Error, the Hazus data must be read before the models are generated";
+        return -1;
+    }
+
+    if(numModes < 1)
+    {
+        err = "Error, at least one mode is needed for the natural periods";
+        return -1;
+    }
+
+    const int numBuildings = buildings.size();
+
+    // Look up the classes and lay out the stories of the buildings before the blocks are filled in
+    models.numModes = numModes;
+    models.buildingClass.fill(-1, numBuildings);
+    models.firstStory.fill(0, numBuildings + 1);
+
+    for(int i = 0; i<numBuildings; ++i)
+    {
+        const auto& building = buildings.at(i);
+
+        if(building.numStories < 1 || building.planArea <= 0.0)
+        {
+            err = "Error, building " + QString::number(i) + " needs at least one story and a positive plan area";
+            models = MDOFModels();
+            return -1;
+        }
+
+        models.buildingClass[i] = this->findBuildingClass(building.structureType, building.numStories, getDesignLevel(building.yearBuilt));
+        models.firstStory[i + 1] = models.firstStory[i] + (models.buildingClass[i] != -1 ? building.numStories : 0);
+    }
+
+    const int numStories = models.firstStory.last();
+
+    models.storyMass.fill(0.0, numStories);
+    models.storyStiffness.fill(0.0, numStories);
+    models.dampingRatio.fill(0.0, numBuildings);
+    models.periods.fill(0.0, numBuildings*numModes);
+
+    struct Job
+    {
+        int firstBuilding = 0;
+        int numBuildings = 0;
+    };
+
+    const int blockSize = 4096;
+
+    std::vector<Job> jobs;
+    jobs.reserve(numBuildings/blockSize + 1);
+
+    for(int firstBuilding = 0; firstBuilding<numBuildings; firstBuilding += blockSize)
+        jobs.push_back({firstBuilding, std::min(blockSize, numBuildings - firstBuilding)});
+
+    const int* classPtr = models.buildingClass.constData();
+    const int* storyPtr = models.firstStory.constData();
+    double* massPtr = models.storyMass.data();
+    double* stiffnessPtr = models.storyStiffness.data();
+    double* dampingPtr = models.dampingRatio.data();
+    double* periodPtr = models.periods.data();
+
+    auto evaluateBlock = [&](const Job& job)
+    {
+        const int end = job.firstBuilding + job.numBuildings;
+
+        for(int i = job.firstBuilding; i<end; ++i)
+        {
+            if(classPtr[i] == -1)
+                continue;
+
+            const auto& buildingClass = buildingClasses.at(classPtr[i]);
+            const int n = storyPtr[i + 1] - storyPtr[i];
+
+            const double mass = buildings.at(i).planArea*floorMassDensity;
+
+            double z1, z2;
+            BuildingRandomStream stream(seed, i);
+            stream.normalPair(z1, z2);
+
+            const double stiffnessFactor = std::max(1.0 + stdStiffness*z1, 0.1);
+
+            const double height = storyHeight > 0.0 ? storyHeight : (buildingClass.typicalStories > 0 ? buildingClass.typicalHeight/buildingClass.typicalStories : 0.0);
+
+            if(buildingClass.yieldDisplacement > 0.0 && buildingClass.yieldAcceleration > 0.0 && buildingClass.typicalHeight > 0.0 && height > 0.0)
+            {
+                // Drift ratio at yield of the pushover mode of the class, which every story of the building reaches at its yield shear
+                const double yieldDrift = buildingClass.yieldDisplacement*inchToMeter/(buildingClass.modalHeightFactor*buildingClass.typicalHeight);
+
+                // Yield base shear of the capacity curve, distributed over the stories by an inverted triangular load
+                const double baseShear = buildingClass.yieldAcceleration*buildingClass.modalWeightFactor*n*mass*gravity;
+
+                for(int j = 0; j<n; ++j)
+                {
+                    const double storyShear = baseShear*(1.0 - j*(j + 1.0)/(n*(n + 1.0)));
+
+                    massPtr[storyPtr[i] + j] = mass;
+                    stiffnessPtr[storyPtr[i] + j] = storyShear/(yieldDrift*height)*stiffnessFactor;
+                }
+            }
+            else
+            {
+                // Elastic period of the table, or of the yield point of the capacity curve
+                const double elasticPeriod = buildingClass.elasticPeriod > 0.0 ? buildingClass.elasticPeriod : 2.0*M_PI*std::sqrt(buildingClass.yieldDisplacement*inchToMeter/(buildingClass.yieldAcceleration*gravity));
+
+                // Uniform shear building, the first circular frequency is 2*sqrt(k/m)*sin(pi/(2*(2n+1)))
+                const double frequencyRatio = (2.0*M_PI/elasticPeriod)/(2.0*std::sin(M_PI/(2.0*(2.0*n + 1.0))));
+
+                const double stiffness = mass*frequencyRatio*frequencyRatio*stiffnessFactor;
+
+                for(int j = storyPtr[i]; j<storyPtr[i + 1]; ++j)
+                {
+                    massPtr[j] = mass;
+                    stiffnessPtr[j] = stiffness;
+                }
+            }
+
+            dampingPtr[i] = buildingClass.dampingRatio*std::max(1.0 + stdDamping*z2, 0.1);
+
+            computePeriods(n, massPtr + storyPtr[i], stiffnessPtr + storyPtr[i], numModes, periodPtr + i*numModes);
+        }
+    };
+
+    QtConcurrent::blockingMap(jobs, evaluateBlock);
+
+    return 0;
+}
+
+
+void HazusMDOFGenerator::setStdStiffness(const double value)
+{
+    stdStiffness = std::max(value, 0.0);
+}
+
+
+void HazusMDOFGenerator::setStdDamping(const double value)
+{
+    stdDamping = std::max(value, 0.0);
+}
+
+
+void HazusMDOFGenerator::setFloorMassDensity(const double value)
+{
+    floorMassDensity = value;
+}
+
+
+void HazusMDOFGenerator::setStoryHeight(const double value)
+{
+    storyHeight = value;
+}
@@ -0,0 +1,184 @@
+#ifndef HAZUSMDOFGENERATOR_H
+#define HAZUSMDOFGENERATOR_H
+/* *****************************************************************************
+Copyright (c) 2016-2021, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+// Written by: Stevan Gavrilovic
+
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+// Row of the Hazus lookup table for a structure type and height class
+struct HazusBuildingClass
+{
+    QString structureType;
+    QString heightClass;
+
+    // Seismic design level of the capacity curve, e.g., High-Code, empty if the table has a single design level
+    QString designLevel;
+
+    // Range of the number of stories in the height class
+    int minStories = 1;
+    int maxStories = 1;
+
+    // Typical number of stories and roof height in m of the class, zero if they are not in the table
+    int typicalStories = 0;
+    double typicalHeight = 0.0;
+
+    // Fractions of the weight and of the roof height that the pushover mode acts at, alpha1 and alpha2 of Hazus
+    double modalWeightFactor = 1.0;
+    double modalHeightFactor = 1.0;
+
+    // Yield point of the capacity curve, the displacement is in inches and the acceleration in g
+    double yieldDisplacement = 0.0;
+    double yieldAcceleration = 0.0;
+
+    // Ultimate point of the capacity curve in the same units, zero if it is not in the table
+    double ultimateDisplacement = 0.0;
+    double ultimateAcceleration = 0.0;
+
+    // Elastic period in s, if it is zero the period of the yield point of the capacity curve is used
+    double elasticPeriod = 0.0;
+
+    // Elastic damping ratio
+    double dampingRatio = 0.05;
+};
+
+
+// Building of the inventory that a model is generated for
+struct MDOFBuilding
+{
+    QString structureType;
+    int numStories = 1;
+
+    // Plan area in m2
+    double planArea = 0.0;
+
+    // Year of construction that picks the design level of the capacity curve, zero if it is not known
+    int yearBuilt = 0;
+};
+
+
+// Shear models of a set of buildings in structure of arrays form, the stories of building i are firstStory[i] to firstStory[i+1]-1
+struct MDOFModels
+{
+    QVector<int> firstStory;
+
+    // Mass in kg and stiffness in N/m of each story
+    QVector<double> storyMass;
+    QVector<double> storyStiffness;
+
+    // Damping ratio of each building
+    QVector<double> dampingRatio;
+
+    // Natural periods in s of each building, row-major with a row for each building and a column for each mode, the modes past the number of stories are zero
+    QVector<double> periods;
+    int numModes = 0;
+
+    // Row of the lookup table that each building was generated from, -1 if there is no row for the building and it has no model
+    QVector<int> buildingClass;
+};
+
+
+// Generates the multi-degree-of-freedom shear models of the MDOF-LU backend application for many buildings at once
+// The Hazus data file is parsed once into a lookup table keyed by the structure type and height class
+// Each building gets a uniform story mass from its plan area, and story stiffnesses that reach the yield base shear of its Hazus capacity curve at the yield drift of the class over the story height
+// The tables that only have elastic periods give a uniform story stiffness that matches the period instead
+// The stiffness and damping of each building are perturbed by normal random factors with the standard deviations of the MDOF-LU application, the factors only depend on the seed and the index of the building
+class HazusMDOFGenerator
+{
+public:
+    HazusMDOFGenerator();
+
+    // Reads the HazusData.txt file of the MDOF-LU backend, or a table with a heading row that names its columns
+    // The table needs the StructureType, HeightClass, MinStories, MaxStories columns with either the Te column of the elastic periods or the Dy and Ay columns of the yield points, the Damping column in percent is optional
+    // R2D ships such a table of the Hazus elastic periods in Databases/HazusMDOF
+    int readHazusData(const QString& pathToFile, QString& err);
+
+    void setBuildingClasses(const QVector<HazusBuildingClass>& values);
+
+    int getNumBuildingClasses(void) const;
+    HazusBuildingClass getBuildingClass(const int i) const;
+
+    // Row of the lookup table for a structure type and number of stories, the structure type can also carry its height class, e.g., S1M
+    // Buildings with more or fewer stories than any height class of their type use the closest class, returns -1 if the structure type is not in the table
+    // The classes of the design level are preferred if the table has design levels
+    int findBuildingClass(const QString& structureType, const int numStories, const QString& designLevel = QString()) const;
+
+    // Design level of the Hazus capacity curves for the year of construction, High-Code after 1975, Moderate-Code after 1940, and Pre-Code otherwise
+    static QString getDesignLevel(const int yearBuilt);
+
+    // Generates the models of the buildings, the buildings are split into blocks that are evaluated on the thread pool
+    int generateModels(const QVector<MDOFBuilding>& buildings, const int numModes, const int seed, MDOFModels& models, QString& err) const;
+
+    // Eigenvalues of the shear model of a building, found by bisection on the Sturm sequence of its tridiagonal mass-normalized stiffness matrix
+    // Returns the periods of the first numModes modes from the longest
+    static void computePeriods(const int numStories, const double* storyMass, const double* storyStiffness, const int numModes, double* periods);
+
+    // Standard deviations of the normal random factors on the stiffness and damping
+    void setStdStiffness(const double value);
+    void setStdDamping(const double value);
+
+    // Mass of the floors in kg per m2 of plan area
+    void setFloorMassDensity(const double value);
+
+    // Story height in m, if it is not positive the typical story height of the class is used
+    void setStoryHeight(const double value);
+
+private:
+
+    // Reads the table with a heading row of column names
+    int readHazusTable(const QStringList& lines, QString& err);
+
+    // Reads the tables of the Hazus technical manual in the HazusData.txt file of the backend, each table starts with a title line and has a row for each model building type
+    // The title of a table tells what it holds: the typical stories and height of the types, the elastic periods and modal factors, the yield points of the capacity curves of a design level, or the elastic damping
+    int readBackendHazusData(const QStringList& lines, QString& err);
+
+    QVector<HazusBuildingClass> buildingClasses;
+
+    // Rows of the lookup table keyed by the structure type and height class, and the rows of each structure type
+    QHash<QString, int> classIndices;
+    QHash<QString, QVector<int>> typeClasses;
+
+    double stdStiffness = 0.1;
+    double stdDamping = 0.1;
+    double floorMassDensity = 1000.0;
+    double storyHeight = 0.0;
+};
+
+#endif // HAZUSMDOFGENERATOR_H
@@ -0,0 +1,318 @@
+/* *****************************************************************************
+Copyright (c) 2016-2021, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+// Written by: Stevan Gavrilovic
+
+#include "HollandWindField.h"
+
+#include <QtConcurrent/QtConcurrent>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace {
+
+const double earthRadius = 6371.0;
+const double kmPerDegree = earthRadius*M_PI/180.0;
+const double earthRotationRate = 7.2921e-5;
+
+}
+
+
+HollandWindField::HollandWindField()
+{
+
+}
+
+
+QVector<HurricaneTrackPoint> HollandWindField::createLinearTrack(const HurricaneTrackPoint& landfall, const double hoursBeforeLandfall, const double hoursAfterLandfall, const double timeStepMinutes)
+{
+    QVector<HurricaneTrackPoint> track;
+
+    if(timeStepMinutes <= 0.0 || hoursBeforeLandfall < 0.0 || hoursAfterLandfall < 0.0)
+        return track;
+
+    const double dt = timeStepMinutes/60.0;
+
+    const int numBefore = static_cast<int>(std::floor(hoursBeforeLandfall/dt));
+    const int numAfter = static_cast<int>(std::floor(hoursAfterLandfall/dt));
+
+    track.reserve(numBefore+numAfter+1);
+
+    const double headingRad = landfall.heading*M_PI/180.0;
+    const double cosLat = std::cos(landfall.latitude*M_PI/180.0);
+
+    // Decay rate of the pressure deficit over land per hour
+    const double decayRate = 0.006 + 0.00046*landfall.pressureDeficit;
+
+    for(int i = -numBefore; i<=numAfter; ++i)
+    {
+        const double hours = i*dt;
+
+        // Distance from the landfall point in km along the track
+        const double distance = landfall.translationSpeed*hours*3.6;
+
+        auto point = landfall;
+        point.latitude += distance*std::cos(headingRad)/kmPerDegree;
+        point.longitude += distance*std::sin(headingRad)/(kmPerDegree*cosLat);
+
+        if(hours > 0.0)
+            point.pressureDeficit *= std::exp(-decayRate*hours);
+
+        track.append(point);
+    }
+
+    return track;
+}
+
+
+double HollandWindField::getHollandB(const double radiusMaxWinds, const double latitude)
+{
+    auto B = 1.881 - 0.00557*radiusMaxWinds - 0.01295*std::fabs(latitude);
+
+    return std::min(std::max(B, 0.8), 2.5);
+}
+
+
+double HollandWindField::getGradientWindSpeed(const HurricaneTrackPoint& point, const double distance) const
+{
+    if(distance <= 0.0 || point.radiusMaxWinds <= 0.0 || point.pressureDeficit <= 0.0)
+        return 0.0;
+
+    const double B = getHollandB(point.radiusMaxWinds, point.latitude);
+    const double f = 2.0*earthRotationRate*std::fabs(std::sin(point.latitude*M_PI/180.0));
+
+    const double x = std::pow(point.radiusMaxWinds/distance, B);
+    const double fr = 0.5*f*distance*1000.0;
+
+    return std::sqrt(B/airDensity*x*point.pressureDeficit*100.0*std::exp(-x) + fr*fr) - fr;
+}
+
+
+int HollandWindField::computePeakGusts(const QVector<HurricaneTrackPoint>& track, const QVector<double>& latitudes, const QVector<double>& longitudes, QVector<double>& peakGusts, QString& err) const
+{
+    peakGusts.clear();
+
+    if(track.isEmpty())
+    {
+        err = "Error, the storm track is empty";
+        return -1;
+    }
+
+    if(latitudes.size() != longitudes.size())
+    {
+        err = "Error, the number of site latitudes and longitudes must be equal";
+        return -1;
+    }
+
+    for(auto&& it : track)
+    {
+        if(it.radiusMaxWinds <= 0.0)
+        {
+            err = "Error, the radius of maximum winds must be greater than zero";
+            return -1;
+        }
+    }
+
+    // The parameters of the profile that are shared by all of the sites at a time step
+    struct StepData
+    {
+        double latitude = 0.0;
+        double longitude = 0.0;
+        double cosLat = 0.0;
+
+        double B = 0.0;
+        double pressureTerm = 0.0;
+        double halfCoriolis = 0.0;
+        double radiusMaxWinds = 0.0;
+
+        // +1 for counter-clockwise rotation in the northern hemisphere and -1 in the southern hemisphere
+        double rotation = 1.0;
+
+        // Translation velocity scaled by the inverse of the gradient wind at the radius of maximum winds
+        double translationEast = 0.0;
+        double translationNorth = 0.0;
+    };
+
+    std::vector<StepData> steps;
+    steps.reserve(track.size());
+
+    for(auto&& it : track)
+    {
+        if(it.pressureDeficit <= 0.0)
+            continue;
+
+        StepData step;
+        step.latitude = it.latitude;
+        step.longitude = it.longitude;
+        step.cosLat = std::cos(it.latitude*M_PI/180.0);
+        step.B = getHollandB(it.radiusMaxWinds, it.latitude);
+        step.pressureTerm = step.B/airDensity*it.pressureDeficit*100.0;
+        step.halfCoriolis = earthRotationRate*std::fabs(std::sin(it.latitude*M_PI/180.0));
+        step.radiusMaxWinds = it.radiusMaxWinds;
+        step.rotation = it.latitude >= 0.0 ? 1.0 : -1.0;
+
+        const double maxGradientWind = this->getGradientWindSpeed(it, it.radiusMaxWinds);
+        const double headingRad = it.heading*M_PI/180.0;
+
+        if(maxGradientWind > 0.0)
+        {
+            step.translationEast = translationFactor*it.translationSpeed*std::sin(headingRad)/maxGradientWind;
+            step.translationNorth = translationFactor*it.translationSpeed*std::cos(headingRad)/maxGradientWind;
+        }
+
+        steps.push_back(step);
+    }
+
+    const int numSites = latitudes.size();
+
+    peakGusts.fill(0.0, numSites);
+
+    if(numSites == 0 || steps.empty())
+        return 0;
+
+    const double cosInflow = std::cos(inflowAngle*M_PI/180.0);
+    const double sinInflow = std::sin(inflowAngle*M_PI/180.0);
+
+    struct Job
+    {
+        int firstSite = 0;
+        int numSites = 0;
+    };
+
+    const int blockSize = 2048;
+
+    std::vector<Job> jobs;
+    jobs.reserve(numSites/blockSize + 1);
+
+    for(int firstSite = 0; firstSite<numSites; firstSite += blockSize)
+        jobs.push_back({firstSite, std::min(blockSize, numSites - firstSite)});
+
+    const double* latPtr = latitudes.constData();
+    const double* lonPtr = longitudes.constData();
+    double* peakPtr = peakGusts.data();
+
+    auto evaluateBlock = [&](const Job& job)
+    {
+        const int end = job.firstSite + job.numSites;
+
+        for(auto&& step : steps)
+        {
+            for(int i = job.firstSite; i<end; ++i)
+            {
+                double dLon = lonPtr[i] - step.longitude;
+
+                if(dLon > 180.0)
+                    dLon -= 360.0;
+                else if(dLon < -180.0)
+                    dLon += 360.0;
+
+                // Local east and north offsets from the center in km
+                const double dx = dLon*kmPerDegree*step.cosLat;
+                const double dy = (latPtr[i] - step.latitude)*kmPerDegree;
+
+                const double r = std::max(std::sqrt(dx*dx + dy*dy), 0.1);
+
+                const double x = std::exp(step.B*std::log(step.radiusMaxWinds/r));
+                const double fr = step.halfCoriolis*r*1000.0;
+
+                const double gradientWind = std::sqrt(step.pressureTerm*x*std::exp(-x) + fr*fr) - fr;
+
+                // Unit vector away from the center and the tangential direction of the rotation
+                const double ux = dx/r;
+                const double uy = dy/r;
+                const double tx = -step.rotation*uy;
+                const double ty = step.rotation*ux;
+
+                const double surfaceWind = boundaryLayerFactor*gradientWind;
+
+                const double windEast = surfaceWind*(cosInflow*tx - sinInflow*ux) + gradientWind*step.translationEast;
+                const double windNorth = surfaceWind*(cosInflow*ty - sinInflow*uy) + gradientWind*step.translationNorth;
+
+                const double gust = gustFactor*std::sqrt(windEast*windEast + windNorth*windNorth);
+
+                peakPtr[i] = std::max(peakPtr[i], gust);
+            }
+        }
+    };
+
+    QtConcurrent::blockingMap(jobs, evaluateBlock);
+
+    return 0;
+}
+
+
+void HollandWindField::setAmbientPressure(const double value)
+{
+    ambientPressure = value;
+}
+
+
+double HollandWindField::getAmbientPressure(void) const
+{
+    return ambientPressure;
+}
+
+
+void HollandWindField::setAirDensity(const double value)
+{
+    airDensity = value;
+}
+
+
+void HollandWindField::setBoundaryLayerFactor(const double value)
+{
+    boundaryLayerFactor = value;
+}
+
+
+void HollandWindField::setGustFactor(const double value)
+{
+    gustFactor = value;
+}
+
+
+void HollandWindField::setTranslationFactor(const double value)
+{
+    translationFactor = value;
+}
+
+
+void HollandWindField::setInflowAngle(const double value)
+{
+    inflowAngle = value;
+}
@@ -0,0 +1,115 @@
+#ifndef HOLLANDWINDFIELD_H
+#define HOLLANDWINDFIELD_H
+/* *****************************************************************************
+Copyright (c) 2016-2021, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+// Written by: Stevan Gavrilovic
+
+#include <QString>
+#include <QVector>
+
+// State of the storm at a time step of the track
+struct HurricaneTrackPoint
+{
+    double latitude = 0.0;
+    double longitude = 0.0;
+
+    // Difference between the ambient and the central pressure in mb
+    double pressureDeficit = 0.0;
+
+    // Radius of maximum winds in km
+    double radiusMaxWinds = 0.0;
+
+    // Direction of motion in degrees clockwise from north
+    double heading = 0.0;
+
+    // Translation speed in m/s
+    double translationSpeed = 0.0;
+};
+
+
+// Parametric hurricane wind field with the pressure profile of Holland (1980)
+// The gradient wind is reduced to the surface with a constant boundary layer factor, turned inwards by the inflow angle,
+// and combined with a fraction of the translation velocity that tapers with the gradient wind away from the eye
+// The peak gust at each site is the largest gust over the time steps of the track, the sites are evaluated in blocks on the thread pool
+class HollandWindField
+{
+public:
+    HollandWindField();
+
+    // Straight track through the landfall point with a constant heading and speed, the pressure deficit is held constant
+    // before landfall and decays after landfall with the filling model of Vickery and Twisdale (1995)
+    static QVector<HurricaneTrackPoint> createLinearTrack(const HurricaneTrackPoint& landfall, const double hoursBeforeLandfall, const double hoursAfterLandfall, const double timeStepMinutes);
+
+    // Holland B parameter from the regression of Vickery and Wadhera (2008) on the radius of maximum winds in km and the latitude
+    static double getHollandB(const double radiusMaxWinds, const double latitude);
+
+    // Gradient wind speed in m/s at a distance in km from the center of the storm
+    double getGradientWindSpeed(const HurricaneTrackPoint& point, const double distance) const;
+
+    // Computes the peak gust in m/s at each site, the sites are given in degrees
+    int computePeakGusts(const QVector<HurricaneTrackPoint>& track, const QVector<double>& latitudes, const QVector<double>& longitudes, QVector<double>& peakGusts, QString& err) const;
+
+    // Ambient pressure in mb
+    void setAmbientPressure(const double value);
+    double getAmbientPressure(void) const;
+
+    // Density of air in kg/m^3
+    void setAirDensity(const double value);
+
+    // Ratio of the mean surface wind to the gradient wind
+    void setBoundaryLayerFactor(const double value);
+
+    // Ratio of the peak gust to the mean surface wind
+    void setGustFactor(const double value);
+
+    // Fraction of the translation speed that is added to the wind at the radius of maximum winds
+    void setTranslationFactor(const double value);
+
+    // Inflow angle of the surface wind in degrees
+    void setInflowAngle(const double value);
+
+private:
+
+    double ambientPressure = 1013.0;
+    double airDensity = 1.15;
+    double boundaryLayerFactor = 0.8;
+    double gustFactor = 1.25;
+    double translationFactor = 0.5;
+    double inflowAngle = 20.0;
+};
+
+#endif // HOLLANDWINDFIELD_H
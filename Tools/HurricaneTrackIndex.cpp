@@ -0,0 +1,692 @@
+/* *****************************************************************************
+Copyright (c) 2016-2021, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+// Written by: Stevan Gavrilovic
+
+#include "HurricaneTrackIndex.h"
+#include "CSVReaderWriter.h"
+
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace
+{
+const char indexMagic[8] = {'R','2','D','T','R','A','C','K'};
+const quint32 indexVersion = 1;
+const quint32 byteOrderMark = 0x01020304;
+
+quint64 alignTo8(quint64 val)
+{
+    return (val + 7) & ~quint64(7);
+}
+}
+
+
+struct HurricaneTrackIndex::IndexHeader
+{
+    char magic[8];
+    quint32 version;
+    quint32 byteOrder;
+    quint64 csvSize;
+    qint64 csvModified;
+    quint64 numStorms;
+    quint64 numPoints;
+    quint64 stormsOffset;
+    quint64 latOffset;
+    quint64 lonOffset;
+    quint64 windOffset;
+    quint64 presOffset;
+    quint64 stringsOffset;
+    quint64 stringsSize;
+    quint32 labelsString;
+    quint32 padding;
+};
+
+
+struct HurricaneTrackIndex::StormRecord
+{
+    // Byte range of the rows of the storm in the csv file
+    quint64 csvOffset;
+    quint64 csvLength;
+
+    // Index of the first track point in the point columns
+    quint64 firstPoint;
+    quint32 numPoints;
+
+    qint32 season;
+
+    // Offsets into the string pool
+    quint32 sidString;
+    quint32 nameString;
+    quint32 basinString;
+
+    // Index of the track point at first landfall, -1 if the storm does not make landfall
+    qint32 landfallPoint;
+
+    float minLon;
+    float minLat;
+    float maxLon;
+    float maxLat;
+};
+
+
+HurricaneTrackIndex::HurricaneTrackIndex()
+{
+
+}
+
+
+HurricaneTrackIndex::~HurricaneTrackIndex()
+{
+    this->close();
+}
+
+
+QString HurricaneTrackIndex::indexPathFor(const QString& csvFile)
+{
+    QFileInfo csvInfo(csvFile);
+
+    auto fileName = csvInfo.completeBaseName() + ".r2dtracks";
+
+    if(QFileInfo(csvInfo.absolutePath()).isWritable())
+        return csvInfo.absolutePath() + QDir::separator() + fileName;
+
+    // Fall back on the cache directory, with a hash of the csv path so that different files with the same name do not clash
+    auto cacheDir = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+    QDir().mkpath(cacheDir);
+
+    fileName = csvInfo.completeBaseName() + "_" + QString::number(qHash(csvInfo.absoluteFilePath()),16) + ".r2dtracks";
+
+    return cacheDir + QDir::separator() + fileName;
+}
+
+
+bool HurricaneTrackIndex::isIndexCurrent(const QString& csvFile, const QString& indexFile)
+{
+    QFileInfo csvInfo(csvFile);
+    QFile file(indexFile);
+
+    if(!csvInfo.exists() || !file.open(QIODevice::ReadOnly))
+        return false;
+
+    IndexHeader header;
+    if(file.read(reinterpret_cast<char*>(&header), sizeof(IndexHeader)) != sizeof(IndexHeader))
+        return false;
+
+    if(std::memcmp(header.magic, indexMagic, sizeof(indexMagic)) != 0 || header.version != indexVersion || header.byteOrder != byteOrderMark)
+        return false;
+
+    return header.csvSize == static_cast<quint64>(csvInfo.size()) && header.csvModified == csvInfo.lastModified().toMSecsSinceEpoch();
+}
+
+
+int HurricaneTrackIndex::buildIndex(const QString& csvFile, const QString& indexFile, QString& err, const std::function<void(int)>& progress)
+{
+    QFile csv(csvFile);
+
+    if (!csv.open(QIODevice::ReadOnly))
+    {
+        err = "Cannot find the file: " + csvFile + "\nCheck your directory and try again.";
+        return -1;
+    }
+
+    CSVReaderWriter csvTool;
+
+    auto headerLine = QString::fromUtf8(csv.readLine()).trimmed();
+    auto headerData = csvTool.parseLineCSV(headerLine);
+
+    // The second row contains the units
+    csv.readLine();
+
+    const auto numCol = headerData.size();
+
+    auto indexSID = headerData.indexOf("SID");
+    auto indexSeason = headerData.indexOf("SEASON");
+    auto indexName = headerData.indexOf("NAME");
+    auto indexLat = headerData.indexOf("LAT");
+    auto indexLon = headerData.indexOf("LON");
+    auto indexLandfall = headerData.indexOf("DIST2LAND");
+    auto indexBasin = headerData.indexOf("BASIN");
+    auto indexUSAWind = headerData.indexOf("USA_WIND");
+    auto indexWMOWind = headerData.indexOf("WMO_WIND");
+    auto indexUSAPress = headerData.indexOf("USA_PRES");
+    auto indexWMOPress = headerData.indexOf("WMO_PRES");
+
+    if(indexSID == -1 || indexSeason == -1 || indexName == -1 || indexLat == -1 || indexLon == -1 || indexLandfall == -1)
+    {
+        err = "Could not find the required column indexes in the data file";
+        return -1;
+    }
+
+    QByteArray stringPool;
+    auto addString = [&stringPool](const QString& str)
+    {
+        auto offset = static_cast<quint32>(stringPool.size());
+        stringPool.append(str.toUtf8());
+        stringPool.append('\0');
+        return offset;
+    };
+
+    const auto labelsString = addString(headerLine);
+
+    QVector<StormRecord> storms;
+    QVector<float> latitudes, longitudes, windSpeeds, pressures;
+
+    const float nanVal = std::numeric_limits<float>::quiet_NaN();
+
+    auto toFloat = [&nanVal](const QString& str)
+    {
+        bool OK = false;
+        auto val = str.toFloat(&OK);
+        return OK ? val : nanVal;
+    };
+
+    // Use the USA value by default and fall back on the WMO value
+    auto firstValid = [&](const QStringList& row, int first, int second)
+    {
+        auto val = first != -1 ? toFloat(row.at(first)) : nanVal;
+        if((std::isnan(val) || val == 0.0f) && second != -1)
+            val = toFloat(row.at(second));
+        return val;
+    };
+
+    const auto csvSize = csv.size();
+    int lastProgress = -1;
+
+    QString SID;
+    StormRecord* storm = nullptr;
+    qint64 rowEnd = csv.pos();
+
+    while (!csv.atEnd())
+    {
+        const auto rowStart = csv.pos();
+        auto line = csv.readLine();
+        rowEnd = csv.pos();
+
+        if(line.trimmed().isEmpty())
+            continue;
+
+        auto row = csvTool.parseLineCSV(QString::fromUtf8(line));
+
+        if(row.size() != numCol)
+        {
+            err = "Error, inconsistency in the data in the row and number of columns";
+            return -1;
+        }
+
+        auto currSID = row.at(indexSID);
+
+        // The rows of a storm are contiguous, start a new storm when the SID changes
+        if(storm == nullptr || SID.compare(currSID) != 0)
+        {
+            if(storm != nullptr)
+                storm->csvLength = rowStart - storm->csvOffset;
+
+            SID = currSID;
+
+            StormRecord newStorm;
+            newStorm.csvOffset = rowStart;
+            newStorm.csvLength = 0;
+            newStorm.firstPoint = latitudes.size();
+            newStorm.numPoints = 0;
+            newStorm.season = row.at(indexSeason).toInt();
+            newStorm.sidString = addString(currSID);
+            newStorm.nameString = addString(row.at(indexName));
+            newStorm.basinString = addString(indexBasin != -1 ? row.at(indexBasin) : QString());
+            newStorm.landfallPoint = -1;
+            newStorm.minLon = std::numeric_limits<float>::max();
+            newStorm.minLat = std::numeric_limits<float>::max();
+            newStorm.maxLon = std::numeric_limits<float>::lowest();
+            newStorm.maxLat = std::numeric_limits<float>::lowest();
+
+            storms.push_back(newStorm);
+            storm = &storms.last();
+        }
+
+        auto lat = toFloat(row.at(indexLat));
+        auto lon = toFloat(row.at(indexLon));
+
+        latitudes.push_back(lat);
+        longitudes.push_back(lon);
+        windSpeeds.push_back(firstValid(row, indexUSAWind, indexWMOWind));
+        pressures.push_back(firstValid(row, indexUSAPress, indexWMOPress));
+
+        if(!std::isnan(lat) && !std::isnan(lon))
+        {
+            storm->minLon = std::min(storm->minLon, lon);
+            storm->minLat = std::min(storm->minLat, lat);
+            storm->maxLon = std::max(storm->maxLon, lon);
+            storm->maxLat = std::max(storm->maxLat, lat);
+        }
+
+        // If the distance to land is 0, then this is the first landfall
+        if(storm->landfallPoint == -1 && row.at(indexLandfall).compare("0") == 0)
+            storm->landfallPoint = storm->numPoints;
+
+        ++storm->numPoints;
+
+        if(progress && csvSize > 0)
+        {
+            auto percent = static_cast<int>(100*rowEnd/csvSize);
+            if(percent != lastProgress)
+            {
+                lastProgress = percent;
+                progress(percent);
+            }
+        }
+    }
+
+    if(storm != nullptr)
+        storm->csvLength = rowEnd - storm->csvOffset;
+
+    if(storms.isEmpty())
+    {
+        err = "Hurricane data is empty";
+        return -1;
+    }
+
+    // Lay out the sections of the file
+    const quint64 numStorms = storms.size();
+    const quint64 numPoints = latitudes.size();
+    const quint64 columnSize = alignTo8(numPoints*sizeof(float));
+
+    IndexHeader header;
+    std::memset(&header, 0, sizeof(IndexHeader));
+    std::memcpy(header.magic, indexMagic, sizeof(indexMagic));
+    header.version = indexVersion;
+    header.byteOrder = byteOrderMark;
+    header.csvSize = csvSize;
+    header.csvModified = QFileInfo(csvFile).lastModified().toMSecsSinceEpoch();
+    header.numStorms = numStorms;
+    header.numPoints = numPoints;
+    header.stormsOffset = alignTo8(sizeof(IndexHeader));
+    header.latOffset = header.stormsOffset + alignTo8(numStorms*sizeof(StormRecord));
+    header.lonOffset = header.latOffset + columnSize;
+    header.windOffset = header.lonOffset + columnSize;
+    header.presOffset = header.windOffset + columnSize;
+    header.stringsOffset = header.presOffset + columnSize;
+    header.stringsSize = stringPool.size();
+    header.labelsString = labelsString;
+
+    QSaveFile file(indexFile);
+
+    if (!file.open(QIODevice::WriteOnly))
+    {
+        err = "Cannot create the file: " + indexFile + "\n" +"Check your directory and try again.";
+        return -1;
+    }
+
+    auto writeSection = [&file](quint64 offset, const char* data, quint64 size)
+    {
+        // Pad up to the start of the section
+        if(static_cast<quint64>(file.pos()) < offset)
+            file.write(QByteArray(static_cast<int>(offset - file.pos()), '\0'));
+
+        return file.write(data, size) == static_cast<qint64>(size);
+    };
+
+    bool OK = writeSection(0, reinterpret_cast<const char*>(&header), sizeof(IndexHeader));
+    OK = OK && writeSection(header.stormsOffset, reinterpret_cast<const char*>(storms.constData()), numStorms*sizeof(StormRecord));
+    OK = OK && writeSection(header.latOffset, reinterpret_cast<const char*>(latitudes.constData()), numPoints*sizeof(float));
+    OK = OK && writeSection(header.lonOffset, reinterpret_cast<const char*>(longitudes.constData()), numPoints*sizeof(float));
+    OK = OK && writeSection(header.windOffset, reinterpret_cast<const char*>(windSpeeds.constData()), numPoints*sizeof(float));
+    OK = OK && writeSection(header.presOffset, reinterpret_cast<const char*>(pressures.constData()), numPoints*sizeof(float));
+    OK = OK && writeSection(header.stringsOffset, stringPool.constData(), stringPool.size());
+
+    if(!OK || !file.commit())
+    {
+        err = "Error writing the hurricane track index file " + indexFile;
+        return -1;
+    }
+
+    return 0;
+}
+
+
+int HurricaneTrackIndex::open(const QString& csvFile, QString& err, const std::function<void(int)>& progress)
+{
+    this->close();
+
+    auto indexPath = indexPathFor(csvFile);
+
+    if(!isIndexCurrent(csvFile, indexPath))
+    {
+        auto res = buildIndex(csvFile, indexPath, err, progress);
+
+        if(res != 0)
+            return res;
+    }
+
+    indexFile.setFileName(indexPath);
+
+    if(!indexFile.open(QIODevice::ReadOnly))
+    {
+        err = "Cannot open the hurricane track index file " + indexPath;
+        return -1;
+    }
+
+    mappedSize = indexFile.size();
+    mappedData = indexFile.map(0, mappedSize);
+
+    if(mappedData == nullptr || mappedSize < static_cast<qint64>(sizeof(IndexHeader)))
+    {
+        err = "Failed to map the hurricane track index file " + indexPath;
+        this->close();
+        return -1;
+    }
+
+    // Check that all of the sections are inside of the file
+    auto head = this->header();
+    const quint64 columnSize = head->numPoints*sizeof(float);
+
+    if(head->stormsOffset + head->numStorms*sizeof(StormRecord) > static_cast<quint64>(mappedSize) ||
+            head->presOffset + columnSize > static_cast<quint64>(mappedSize) ||
+            head->stringsOffset + head->stringsSize > static_cast<quint64>(mappedSize))
+    {
+        err = "The hurricane track index file " + indexPath + " is corrupt, delete it to rebuild the index";
+        this->close();
+        return -1;
+    }
+
+    csvFilePath = csvFile;
+
+    CSVReaderWriter csvTool;
+    parameterLabels = csvTool.parseLineCSV(this->poolString(head->labelsString));
+
+    const auto nStorms = this->numStorms();
+    stormsBySID.reserve(nStorms);
+
+    for(int i = 0; i<nStorms; ++i)
+        stormsBySID.insert(this->getSID(i), i);
+
+    return 0;
+}
+
+
+void HurricaneTrackIndex::close(void)
+{
+    if(mappedData != nullptr)
+        indexFile.unmap(mappedData);
+
+    mappedData = nullptr;
+    mappedSize = 0;
+
+    if(indexFile.isOpen())
+        indexFile.close();
+
+    csvFilePath.clear();
+    parameterLabels.clear();
+    stormsBySID.clear();
+}
+
+
+bool HurricaneTrackIndex::isOpen(void) const
+{
+    return mappedData != nullptr;
+}
+
+
+int HurricaneTrackIndex::numStorms(void) const
+{
+    return this->isOpen() ? static_cast<int>(this->header()->numStorms) : 0;
+}
+
+
+qint64 HurricaneTrackIndex::numTrackPoints(void) const
+{
+    return this->isOpen() ? static_cast<qint64>(this->header()->numPoints) : 0;
+}
+
+
+int HurricaneTrackIndex::findStorm(const QString& SID) const
+{
+    return stormsBySID.value(SID, -1);
+}
+
+
+QString HurricaneTrackIndex::getSID(int storm) const
+{
+    return this->poolString(this->stormRecord(storm)->sidString);
+}
+
+
+QString HurricaneTrackIndex::getName(int storm) const
+{
+    return this->poolString(this->stormRecord(storm)->nameString);
+}
+
+
+QString HurricaneTrackIndex::getBasin(int storm) const
+{
+    return this->poolString(this->stormRecord(storm)->basinString);
+}
+
+
+int HurricaneTrackIndex::getSeason(int storm) const
+{
+    return this->stormRecord(storm)->season;
+}
+
+
+int HurricaneTrackIndex::getNumTrackPoints(int storm) const
+{
+    return static_cast<int>(this->stormRecord(storm)->numPoints);
+}
+
+
+const float* HurricaneTrackIndex::getLatitudes(int storm) const
+{
+    return this->column(this->header()->latOffset, storm);
+}
+
+
+const float* HurricaneTrackIndex::getLongitudes(int storm) const
+{
+    return this->column(this->header()->lonOffset, storm);
+}
+
+
+const float* HurricaneTrackIndex::getWindSpeeds(int storm) const
+{
+    return this->column(this->header()->windOffset, storm);
+}
+
+
+const float* HurricaneTrackIndex::getPressures(int storm) const
+{
+    return this->column(this->header()->presOffset, storm);
+}
+
+
+void HurricaneTrackIndex::getBoundingBox(int storm, double& minLon, double& minLat, double& maxLon, double& maxLat) const
+{
+    auto record = this->stormRecord(storm);
+
+    minLon = record->minLon;
+    minLat = record->minLat;
+    maxLon = record->maxLon;
+    maxLat = record->maxLat;
+}
+
+
+QVector<int> HurricaneTrackIndex::queryStorms(const HurricaneTrackFilter& filter) const
+{
+    QVector<int> storms;
+
+    const auto nStorms = this->numStorms();
+
+    for(int i = 0; i<nStorms; ++i)
+    {
+        auto record = this->stormRecord(i);
+
+        if(filter.minSeason >= 0 && record->season < filter.minSeason)
+            continue;
+
+        if(filter.maxSeason >= 0 && record->season > filter.maxSeason)
+            continue;
+
+        if(!filter.basins.isEmpty() && !filter.basins.contains(this->getBasin(i)))
+            continue;
+
+        if(filter.useBoundingBox)
+        {
+            // Check the bounding box of the storm first, then the track points
+            if(record->maxLon < filter.minLon || record->minLon > filter.maxLon || record->maxLat < filter.minLat || record->minLat > filter.maxLat)
+                continue;
+
+            auto lats = this->getLatitudes(i);
+            auto lons = this->getLongitudes(i);
+
+            bool inside = false;
+            for(quint32 j = 0; j<record->numPoints && !inside; ++j)
+                inside = lons[j] >= filter.minLon && lons[j] <= filter.maxLon && lats[j] >= filter.minLat && lats[j] <= filter.maxLat;
+
+            if(!inside)
+                continue;
+        }
+
+        storms.push_back(i);
+    }
+
+    return storms;
+}
+
+
+int HurricaneTrackIndex::loadHurricane(int storm, HurricaneObject& hurricane, QString& err) const
+{
+    if(!this->isOpen() || storm < 0 || storm >= this->numStorms())
+    {
+        err = "The storm " + QString::number(storm) + " is not in the hurricane track index";
+        return -1;
+    }
+
+    auto record = this->stormRecord(storm);
+
+    QFile csv(csvFilePath);
+
+    if (!csv.open(QIODevice::ReadOnly) || !csv.seek(record->csvOffset))
+    {
+        err = "Cannot find the file: " + csvFilePath + "\nCheck your directory and try again.";
+        return -1;
+    }
+
+    auto rows = csv.read(record->csvLength).split('\n');
+
+    hurricane.clear();
+    hurricane.parameterLabels = parameterLabels;
+
+    auto indexLandfall = parameterLabels.indexOf("DIST2LAND");
+    auto indexSeason = parameterLabels.indexOf("SEASON");
+
+    CSVReaderWriter csvTool;
+
+    for(auto&& it : rows)
+    {
+        if(it.trimmed().isEmpty())
+            continue;
+
+        auto row = csvTool.parseLineCSV(QString::fromUtf8(it));
+
+        if(row.size() != parameterLabels.size())
+        {
+            err = "Error, inconsistency in the data in the row and number of columns";
+            return -1;
+        }
+
+        hurricane.push_back(row);
+    }
+
+    if(hurricane.size() != static_cast<int>(record->numPoints))
+    {
+        err = "The hurricane track index is out of date with the file " + csvFilePath;
+        return -1;
+    }
+
+    if(record->landfallPoint != -1 && indexLandfall != -1)
+    {
+        hurricane.indexLandfall = record->landfallPoint;
+        hurricane.landfallData = hurricane[record->landfallPoint];
+    }
+
+    hurricane.name = this->getName(storm);
+    hurricane.SID = this->getSID(storm);
+    hurricane.season = indexSeason != -1 ? hurricane.front().at(indexSeason) : QString::number(record->season);
+
+    return 0;
+}
+
+
+QStringList HurricaneTrackIndex::getParameterLabels(void) const
+{
+    return parameterLabels;
+}
+
+
+const HurricaneTrackIndex::IndexHeader* HurricaneTrackIndex::header(void) const
+{
+    return reinterpret_cast<const IndexHeader*>(mappedData);
+}
+
+
+const HurricaneTrackIndex::StormRecord* HurricaneTrackIndex::stormRecord(int storm) const
+{
+    return reinterpret_cast<const StormRecord*>(mappedData + this->header()->stormsOffset) + storm;
+}
+
+
+const float* HurricaneTrackIndex::column(quint64 offset, int storm) const
+{
+    return reinterpret_cast<const float*>(mappedData + offset) + this->stormRecord(storm)->firstPoint;
+}
+
+
+QString HurricaneTrackIndex::poolString(quint32 offset) const
+{
+    auto head = this->header();
+
+    if(offset >= head->stringsSize)
+        return QString();
+
+    return QString::fromUtf8(reinterpret_cast<const char*>(mappedData + head->stringsOffset + offset));
+}
@@ -0,0 +1,142 @@
+#ifndef HURRICANETRACKINDEX_H
+#define HURRICANETRACKINDEX_H
+/* *****************************************************************************
+Copyright (c) 2016-2021, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+// Written by: Stevan Gavrilovic
+
+#include "HurricaneObject.h"
+
+#include <QFile>
+#include <QHash>
+#include <QString>
+#include <QStringList>
+
+#include <functional>
+
+// Filter for querying the storms in the index, a negative season or an empty basin list is not used in the query
+struct HurricaneTrackFilter
+{
+    int minSeason = -1;
+    int maxSeason = -1;
+
+    // IBTrACS basin codes, e.g., NA, EP, WP
+    QStringList basins;
+
+    // Storms with at least one track point inside of the box
+    bool useBoundingBox = false;
+    double minLon = 0.0;
+    double minLat = 0.0;
+    double maxLon = 0.0;
+    double maxLat = 0.0;
+};
+
+
+// Compact binary columnar index of an IBTrACS csv file
+// The index is created once from the csv file and memory-mapped on subsequent loads. It holds, for every storm, the byte range of its rows in the csv file,
+// its SID, name, season, basin and bounding box, and typed columns of the latitude, longitude, wind speed and pressure of all track points
+// The full rows of a storm, i.e., the HurricaneObject, are only parsed from the csv file when the storm is requested
+class HurricaneTrackIndex
+{
+public:
+    HurricaneTrackIndex();
+    ~HurricaneTrackIndex();
+
+    // The index file is saved next to the csv file, or in the cache directory if the csv directory is not writable
+    static QString indexPathFor(const QString& csvFile);
+
+    // Checks that the index exists and was created from the current version of the csv file
+    static bool isIndexCurrent(const QString& csvFile, const QString& indexFile);
+
+    // Converts the IBTrACS csv file into the binary index. The progress function, if given, is called with the percentage of the csv file that is read
+    static int buildIndex(const QString& csvFile, const QString& indexFile, QString& err, const std::function<void(int)>& progress = nullptr);
+
+    // Memory-maps the index of the csv file, building the index first if it does not exist or is out of date
+    int open(const QString& csvFile, QString& err, const std::function<void(int)>& progress = nullptr);
+
+    void close(void);
+
+    bool isOpen(void) const;
+
+    int numStorms(void) const;
+
+    qint64 numTrackPoints(void) const;
+
+    // Returns the index of the storm with the given SID, or -1 if it is not found
+    int findStorm(const QString& SID) const;
+
+    QString getSID(int storm) const;
+    QString getName(int storm) const;
+    QString getBasin(int storm) const;
+    int getSeason(int storm) const;
+
+    // Track point columns of the storm, missing values are NaN
+    int getNumTrackPoints(int storm) const;
+    const float* getLatitudes(int storm) const;
+    const float* getLongitudes(int storm) const;
+    const float* getWindSpeeds(int storm) const;
+    const float* getPressures(int storm) const;
+
+    void getBoundingBox(int storm, double& minLon, double& minLat, double& maxLon, double& maxLat) const;
+
+    // Returns the storms that pass the filter, in the order that they appear in the csv file
+    QVector<int> queryStorms(const HurricaneTrackFilter& filter) const;
+
+    // Parses the full rows of the storm from the csv file
+    int loadHurricane(int storm, HurricaneObject& hurricane, QString& err) const;
+
+    QStringList getParameterLabels(void) const;
+
+private:
+
+    struct IndexHeader;
+    struct StormRecord;
+
+    const IndexHeader* header(void) const;
+    const StormRecord* stormRecord(int storm) const;
+    const float* column(quint64 offset, int storm) const;
+    QString poolString(quint32 offset) const;
+
+    QFile indexFile;
+    QString csvFilePath;
+    uchar* mappedData = nullptr;
+    qint64 mappedSize = 0;
+
+    QStringList parameterLabels;
+    QHash<QString, int> stormsBySID;
+};
+
+#endif // HURRICANETRACKINDEX_H
@@ -0,0 +1,226 @@
+/* *****************************************************************************
+Copyright (c) 2016-2021, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+// Written by: Stevan Gavrilovic
+
+#include "IDHashJoin.h"
+
+#include <cstdint>
+
+namespace {
+
+// Fibonacci hashing, the top bits of the product are the slot
+inline size_t getSlot(const qint64 id, const int numBits)
+{
+    return static_cast<size_t>((static_cast<uint64_t>(id)*0x9E3779B97F4A7C15ULL) >> (64 - numBits));
+}
+
+}
+
+
+IDHashJoin::IDHashJoin()
+{
+
+}
+
+
+int IDHashJoin::getNumBits(const int numKeys)
+{
+    // Keep the table at most half full
+    int bits = 4;
+    while((static_cast<qint64>(1) << bits) < 2*static_cast<qint64>(numKeys))
+        ++bits;
+
+    return bits;
+}
+
+
+int IDHashJoin::setSiteIDs(const QVector<qint64>& ids, QVector<int>& duplicateSites, QString& err)
+{
+    duplicateSites.clear();
+
+    if(ids.isEmpty())
+    {
+        err = "Error, the event grid does not have any sites";
+        return -1;
+    }
+
+    numSites = ids.size();
+    numBits = getNumBits(numSites);
+
+    const size_t mask = (static_cast<size_t>(1) << numBits) - 1;
+
+    slotIDs.assign(mask + 1, 0);
+    slotRows.assign(mask + 1, -1);
+
+    for(int row = 0; row<numSites; ++row)
+    {
+        const qint64 id = ids.at(row);
+
+        size_t slot = getSlot(id, numBits);
+
+        // Linear probing up to an empty slot or the slot of the same ID
+        while(slotRows[slot] != -1 && slotIDs[slot] != id)
+            slot = (slot + 1) & mask;
+
+        if(slotRows[slot] != -1)
+        {
+            duplicateSites.append(row);
+            continue;
+        }
+
+        slotIDs[slot] = id;
+        slotRows[slot] = row;
+    }
+
+    return 0;
+}
+
+
+int IDHashJoin::getNumSites(void) const
+{
+    return numSites;
+}
+
+
+int IDHashJoin::findSite(const qint64 id) const
+{
+    if(numBits == 0)
+        return -1;
+
+    const size_t mask = (static_cast<size_t>(1) << numBits) - 1;
+
+    size_t slot = getSlot(id, numBits);
+
+    while(slotRows[slot] != -1)
+    {
+        if(slotIDs[slot] == id)
+            return slotRows[slot];
+
+        slot = (slot + 1) & mask;
+    }
+
+    return -1;
+}
+
+
+int IDHashJoin::join(const QVector<qint64>& assetIDs, IDJoinResult& result, QString& err) const
+{
+    result = IDJoinResult();
+
+    if(numBits == 0)
+    {
+        err = "Error, the site IDs must be set before the assets are joined to them";
+        return -1;
+    }
+
+    const int numAssets = assetIDs.size();
+
+    result.siteRows.fill(-1, numAssets);
+
+    // Set of the asset IDs seen so far, for finding the duplicated assets in the same pass
+    const int assetBits = getNumBits(numAssets);
+    const size_t assetMask = (static_cast<size_t>(1) << assetBits) - 1;
+
+    std::vector<qint64> assetSlotIDs(assetMask + 1, 0);
+    std::vector<char> assetSlotUsed(assetMask + 1, 0);
+
+    int* rowPtr = result.siteRows.data();
+
+    for(int i = 0; i<numAssets; ++i)
+    {
+        const qint64 id = assetIDs.at(i);
+
+        size_t assetSlot = getSlot(id, assetBits);
+        while(assetSlotUsed[assetSlot] && assetSlotIDs[assetSlot] != id)
+            assetSlot = (assetSlot + 1) & assetMask;
+
+        if(assetSlotUsed[assetSlot])
+        {
+            result.duplicateAssets.append(i);
+        }
+        else
+        {
+            assetSlotUsed[assetSlot] = 1;
+            assetSlotIDs[assetSlot] = id;
+        }
+
+        rowPtr[i] = this->findSite(id);
+
+        if(rowPtr[i] == -1)
+            result.unmatchedAssets.append(i);
+        else
+            ++result.numMatched;
+    }
+
+    return 0;
+}
+
+
+bool IDHashJoin::parseID(const QString& text, qint64& id)
+{
+    const QString cell = text.trimmed();
+
+    bool OK = false;
+    id = cell.toLongLong(&OK);
+
+    if(OK)
+        return true;
+
+    // Drop the extension of a file name and read the digits before it
+    int end = cell.size();
+
+    const int dot = cell.lastIndexOf('.');
+    if(dot > cell.lastIndexOf('/') && dot > cell.lastIndexOf('\\'))
+    {
+        // A number with a fraction is not an ID
+        if(dot + 1 < cell.size() && cell.at(dot + 1).isDigit())
+            return false;
+
+        end = dot;
+    }
+
+    int begin = end;
+    while(begin > 0 && cell.at(begin - 1).isDigit())
+        --begin;
+
+    if(begin == end || end - begin > 18)
+        return false;
+
+    id = cell.mid(begin, end - begin).toLongLong(&OK);
+
+    return OK;
+}
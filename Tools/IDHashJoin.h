@@ -0,0 +1,91 @@
+#ifndef IDHASHJOIN_H
+#define IDHASHJOIN_H
+/* *****************************************************************************
+Copyright (c) 2016-2021, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+// Written by: Stevan Gavrilovic
+
+#include <QString>
+#include <QVector>
+
+#include <vector>
+
+struct IDJoinResult
+{
+    // Row of the site table that each asset is mapped to, -1 if there is no site with the ID of the asset
+    QVector<int> siteRows;
+
+    // Indices of the assets without a site, and of the assets with an ID that an earlier asset already has
+    QVector<int> unmatchedAssets;
+    QVector<int> duplicateAssets;
+
+    int numMatched = 0;
+};
+
+
+// Joins the assets of an analysis to the sites of an event grid by their integer IDs
+// The site IDs are put in an open addressing hash table once, after which each join is a single pass over the asset IDs
+class IDHashJoin
+{
+public:
+    IDHashJoin();
+
+    // Builds the hash table of the site IDs, the first site is kept if an ID is duplicated and the rows of the later sites with the ID are returned
+    int setSiteIDs(const QVector<qint64>& ids, QVector<int>& duplicateSites, QString& err);
+
+    int getNumSites(void) const;
+
+    // Row of the site with the ID, -1 if there is none
+    int findSite(const qint64 id) const;
+
+    int join(const QVector<qint64>& assetIDs, IDJoinResult& result, QString& err) const;
+
+    // Integer ID in a text cell, either the whole cell or the digits at the end of a file name, e.g., 12 in site12.csv
+    static bool parseID(const QString& text, qint64& id);
+
+private:
+
+    static int getNumBits(const int numKeys);
+
+    // Slots of the hash table, a slot with the row -1 is empty
+    std::vector<qint64> slotIDs;
+    std::vector<int> slotRows;
+
+    int numBits = 0;
+    int numSites = 0;
+};
+
+#endif // IDHASHJOIN_H
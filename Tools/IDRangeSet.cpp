@@ -0,0 +1,448 @@
+/* *****************************************************************************
+Copyright (c) 2016-2021, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+// Written by: Stevan Gavrilovic
+
+#include "IDRangeSet.h"
+
+#include <QStringList>
+
+#include <algorithm>
+
+IDRangeSet::IDRangeSet()
+{
+    cumulativeCounts.append(0);
+}
+
+
+IDRangeSet IDRangeSet::fromIDs(QVector<qint64> ids)
+{
+    std::sort(ids.begin(), ids.end());
+
+    IDRangeSet set;
+
+    for(auto&& id : ids)
+        set.appendRange(id, id);
+
+    set.updateCounts();
+
+    return set;
+}
+
+
+int IDRangeSet::fromString(const QString& str, QString& err)
+{
+    this->clear();
+
+    auto inputText = str;
+
+    // Remove any white space from the string
+    inputText.remove(QChar(' '));
+
+    if(inputText.isEmpty())
+        return 0;
+
+    QVector<Range> parsedRanges;
+
+    auto subStrings = inputText.split(QChar(','), Qt::SkipEmptyParts);
+
+    parsedRanges.reserve(subStrings.size());
+
+    for(auto&& subStr : subStrings)
+    {
+        // Handle the case where there is a range of IDs separated by a '-'
+        auto pos = subStr.indexOf(QChar('-'));
+
+        bool OK1 = false;
+        bool OK2 = false;
+
+        qint64 IDStart = 0;
+        qint64 IDEnd = 0;
+
+        if(pos != -1)
+        {
+            IDStart = subStr.leftRef(pos).toLongLong(&OK1);
+            IDEnd = subStr.midRef(pos+1).toLongLong(&OK2);
+        }
+        else
+        {
+            IDStart = subStr.toLongLong(&OK1);
+            IDEnd = IDStart;
+            OK2 = true;
+        }
+
+        if(!OK1 || !OK2)
+        {
+            err = "Error, could not convert '"+subStr+"' to an ID or a range of IDs";
+            this->clear();
+            return -1;
+        }
+
+        // Make sure that the end integer is greater than the first
+        if(IDStart > IDEnd)
+        {
+            err = "Error in the range of IDs "+subStr+", the end of the range must be greater than the start";
+            this->clear();
+            return -1;
+        }
+
+        parsedRanges.append({IDStart, IDEnd});
+    }
+
+    std::sort(parsedRanges.begin(), parsedRanges.end(), [](const Range& a, const Range& b){ return a.first < b.first; });
+
+    for(auto&& it : parsedRanges)
+        this->appendRange(it.first, it.last);
+
+    this->updateCounts();
+
+    return 0;
+}
+
+
+QString IDRangeSet::toString(void) const
+{
+    QStringList stringList;
+    stringList.reserve(ranges.size());
+
+    for(auto&& it : ranges)
+    {
+        if(it.first == it.last)
+            stringList.append(QString::number(it.first));
+        else
+            stringList.append(QString::number(it.first)+"-"+QString::number(it.last));
+    }
+
+    return stringList.join(QChar(','));
+}
+
+
+void IDRangeSet::insert(const qint64 id)
+{
+    this->insertRange(id, id);
+}
+
+
+void IDRangeSet::insertRange(const qint64 first, const qint64 last)
+{
+    if(first > last)
+        return;
+
+    // Appending in ascending order is the common case when building a selection
+    if(ranges.isEmpty() || first >= ranges.last().first)
+    {
+        this->appendRange(first, last);
+        this->updateCounts();
+        return;
+    }
+
+    IDRangeSet other;
+    other.appendRange(first, last);
+    other.updateCounts();
+
+    *this = this->united(other);
+}
+
+
+void IDRangeSet::clear(void)
+{
+    ranges.clear();
+    cumulativeCounts.clear();
+    cumulativeCounts.append(0);
+}
+
+
+bool IDRangeSet::isEmpty(void) const
+{
+    return ranges.isEmpty();
+}
+
+
+qint64 IDRangeSet::size(void) const
+{
+    return cumulativeCounts.last();
+}
+
+
+int IDRangeSet::numRanges(void) const
+{
+    return ranges.size();
+}
+
+
+const QVector<IDRangeSet::Range>& IDRangeSet::getRanges(void) const
+{
+    return ranges;
+}
+
+
+bool IDRangeSet::contains(const qint64 id) const
+{
+    return this->indexOf(id) != -1;
+}
+
+
+qint64 IDRangeSet::indexOf(const qint64 id) const
+{
+    // The first range that starts after the ID, the ID can only be in the range before it
+    auto it = std::upper_bound(ranges.cbegin(), ranges.cend(), id, [](const qint64 val, const Range& range){ return val < range.first; });
+
+    if(it == ranges.cbegin())
+        return -1;
+
+    --it;
+
+    if(id > it->last)
+        return -1;
+
+    auto rangeIndex = std::distance(ranges.cbegin(), it);
+
+    return cumulativeCounts.at(rangeIndex) + (id - it->first);
+}
+
+
+qint64 IDRangeSet::first(void) const
+{
+    return ranges.first().first;
+}
+
+
+qint64 IDRangeSet::last(void) const
+{
+    return ranges.last().last;
+}
+
+
+IDRangeSet IDRangeSet::united(const IDRangeSet& other) const
+{
+    IDRangeSet result;
+    result.ranges.reserve(ranges.size() + other.ranges.size());
+
+    int i = 0;
+    int j = 0;
+
+    while(i < ranges.size() || j < other.ranges.size())
+    {
+        // Take the range that starts first
+        if(j == other.ranges.size() || (i < ranges.size() && ranges.at(i).first <= other.ranges.at(j).first))
+        {
+            result.appendRange(ranges.at(i).first, ranges.at(i).last);
+            ++i;
+        }
+        else
+        {
+            result.appendRange(other.ranges.at(j).first, other.ranges.at(j).last);
+            ++j;
+        }
+    }
+
+    result.updateCounts();
+
+    return result;
+}
+
+
+IDRangeSet IDRangeSet::intersected(const IDRangeSet& other) const
+{
+    IDRangeSet result;
+
+    int i = 0;
+    int j = 0;
+
+    while(i < ranges.size() && j < other.ranges.size())
+    {
+        auto a = ranges.at(i);
+        auto b = other.ranges.at(j);
+
+        auto first = std::max(a.first, b.first);
+        auto last = std::min(a.last, b.last);
+
+        if(first <= last)
+            result.ranges.append({first, last});
+
+        // Advance past the range that ends first
+        if(a.last < b.last)
+            ++i;
+        else
+            ++j;
+    }
+
+    result.updateCounts();
+
+    return result;
+}
+
+
+IDRangeSet IDRangeSet::subtracted(const IDRangeSet& other) const
+{
+    IDRangeSet result;
+
+    int j = 0;
+
+    for(auto&& range : ranges)
+    {
+        auto first = range.first;
+
+        // Skip the ranges that end before this range
+        while(j < other.ranges.size() && other.ranges.at(j).last < first)
+            ++j;
+
+        // Cut out the ranges that overlap this range
+        int k = j;
+        while(k < other.ranges.size() && other.ranges.at(k).first <= range.last)
+        {
+            auto cut = other.ranges.at(k);
+
+            if(cut.first > first)
+                result.ranges.append({first, cut.first-1});
+
+            first = std::max(first, cut.last+1);
+
+            if(cut.last >= range.last)
+                break;
+
+            ++k;
+        }
+
+        if(first <= range.last)
+            result.ranges.append({first, range.last});
+
+        j = k;
+    }
+
+    result.updateCounts();
+
+    return result;
+}
+
+
+IDRangeSet IDRangeSet::shifted(const qint64 offset) const
+{
+    IDRangeSet result = *this;
+
+    for(auto&& it : result.ranges)
+    {
+        it.first += offset;
+        it.last += offset;
+    }
+
+    return result;
+}
+
+
+QSet<qint64> IDRangeSet::toSet(void) const
+{
+    QSet<qint64> set;
+    set.reserve(this->size());
+
+    for(auto&& it : ranges)
+        for(auto id = it.first; id <= it.last; ++id)
+            set.insert(id);
+
+    return set;
+}
+
+
+QVector<qint64> IDRangeSet::toVector(void) const
+{
+    QVector<qint64> vec;
+    vec.reserve(this->size());
+
+    for(auto&& it : ranges)
+        for(auto id = it.first; id <= it.last; ++id)
+            vec.append(id);
+
+    return vec;
+}
+
+
+IDRangeSet::const_iterator IDRangeSet::begin(void) const
+{
+    if(ranges.isEmpty())
+        return this->end();
+
+    return const_iterator(&ranges, 0, ranges.first().first);
+}
+
+
+IDRangeSet::const_iterator IDRangeSet::end(void) const
+{
+    return const_iterator(&ranges, ranges.size(), 0);
+}
+
+
+bool IDRangeSet::operator==(const IDRangeSet& other) const
+{
+    if(ranges.size() != other.ranges.size())
+        return false;
+
+    for(int i = 0; i<ranges.size(); ++i)
+    {
+        if(ranges.at(i).first != other.ranges.at(i).first || ranges.at(i).last != other.ranges.at(i).last)
+            return false;
+    }
+
+    return true;
+}
+
+
+bool IDRangeSet::operator!=(const IDRangeSet& other) const
+{
+    return !(*this == other);
+}
+
+
+void IDRangeSet::appendRange(const qint64 first, const qint64 last)
+{
+    // Merge with the last range if they overlap or are adjacent
+    if(!ranges.isEmpty() && first <= ranges.last().last + 1)
+    {
+        ranges.last().last = std::max(ranges.last().last, last);
+        return;
+    }
+
+    ranges.append({first, last});
+}
+
+
+void IDRangeSet::updateCounts(void)
+{
+    cumulativeCounts.resize(ranges.size()+1);
+    cumulativeCounts[0] = 0;
+
+    for(int i = 0; i<ranges.size(); ++i)
+        cumulativeCounts[i+1] = cumulativeCounts.at(i) + (ranges.at(i).last - ranges.at(i).first + 1);
+}
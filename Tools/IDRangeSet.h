@@ -0,0 +1,164 @@
+#ifndef IDRANGESET_H
+#define IDRANGESET_H
+/* *****************************************************************************
+Copyright (c) 2016-2021, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+// Written by: Stevan Gavrilovic
+
+#include <QSet>
+#include <QString>
+#include <QVector>
+
+#include <iterator>
+
+// A set of integer IDs stored as sorted, disjoint and non-adjacent closed ranges, e.g., the selection "1-1000,2005,3000-9000" is stored as three ranges
+// Membership and rank lookups are O(log n) in the number of ranges, and union, intersection and difference are linear merges of the ranges,
+// so the size of a selection does not depend on the number of IDs it contains
+class IDRangeSet
+{
+public:
+
+    struct Range
+    {
+        qint64 first;
+        qint64 last;
+    };
+
+    // Iterates over the individual IDs in ascending order
+    class const_iterator
+    {
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef qint64 value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const qint64* pointer;
+        typedef const qint64& reference;
+
+        const_iterator(const QVector<Range>* ranges, int rangeIndex, qint64 id) : ranges(ranges), rangeIndex(rangeIndex), id(id) {}
+
+        const qint64& operator*() const { return id; }
+
+        const_iterator& operator++()
+        {
+            if(id < ranges->at(rangeIndex).last)
+            {
+                ++id;
+            }
+            else
+            {
+                ++rangeIndex;
+                id = rangeIndex < ranges->size() ? ranges->at(rangeIndex).first : 0;
+            }
+
+            return *this;
+        }
+
+        bool operator==(const const_iterator& other) const { return rangeIndex == other.rangeIndex && id == other.id; }
+        bool operator!=(const const_iterator& other) const { return !(*this == other); }
+
+    private:
+        const QVector<Range>* ranges;
+        int rangeIndex;
+        qint64 id;
+    };
+
+    IDRangeSet();
+
+    // Builds the set from IDs in any order, duplicates are ignored
+    static IDRangeSet fromIDs(QVector<qint64> ids);
+
+    // Parses a selection string in the form "1,3,5-10,12", white space is ignored and the ranges may overlap or be given in any order
+    int fromString(const QString& str, QString& err);
+
+    // Returns the selection string in the form "1,3,5-10,12"
+    QString toString(void) const;
+
+    void insert(const qint64 id);
+
+    void insertRange(const qint64 first, const qint64 last);
+
+    void clear(void);
+
+    bool isEmpty(void) const;
+
+    // The number of IDs in the set
+    qint64 size(void) const;
+
+    int numRanges(void) const;
+
+    const QVector<Range>& getRanges(void) const;
+
+    bool contains(const qint64 id) const;
+
+    // Returns the position of the ID in the ascending order of the IDs in the set, or -1 if the ID is not in the set
+    qint64 indexOf(const qint64 id) const;
+
+    // The smallest and largest ID, the set must not be empty
+    qint64 first(void) const;
+    qint64 last(void) const;
+
+    IDRangeSet united(const IDRangeSet& other) const;
+    IDRangeSet intersected(const IDRangeSet& other) const;
+    IDRangeSet subtracted(const IDRangeSet& other) const;
+
+    // Returns a copy with the offset added to each ID, e.g., to convert the component IDs to feature IDs
+    IDRangeSet shifted(const qint64 offset) const;
+
+    // Expands the set, only use when an API needs the explicit IDs
+    QSet<qint64> toSet(void) const;
+    QVector<qint64> toVector(void) const;
+
+    const_iterator begin(void) const;
+    const_iterator end(void) const;
+
+    bool operator==(const IDRangeSet& other) const;
+    bool operator!=(const IDRangeSet& other) const;
+
+private:
+
+    // Appends a range that is at or after the last range, merging it with the last range if they overlap or are adjacent
+    void appendRange(const qint64 first, const qint64 last);
+
+    // Recomputes the cumulative sizes of the ranges after they change
+    void updateCounts(void);
+
+    QVector<Range> ranges;
+
+    // The number of IDs in the ranges before each range, plus the total at the end
+    QVector<qint64> cumulativeCounts;
+};
+
+#endif // IDRANGESET_H
@@ -0,0 +1,423 @@
+/* *****************************************************************************
+Copyright (c) 2016-2021, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+// Written by: Stevan Gavrilovic
+
+#include "LayerClassifier.h"
+
+#include <QElapsedTimer>
+#include <QtConcurrent/QtConcurrent>
+
+#include <qgsfeatureiterator.h>
+#include <qgsfeaturerequest.h>
+#include <qgsvectorlayer.h>
+#include <qgsvectorlayerfeatureiterator.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+// Rows of a chunk that are sketched together on a thread
+const int blockSize = 4096;
+
+// Least time in ms between two updates of the sketches while the layer is read
+const qint64 updateInterval = 250;
+
+}
+
+
+LayerClassifier::LayerClassifier(QObject* parent) : QObject(parent)
+{
+
+}
+
+
+LayerClassifier::~LayerClassifier()
+{
+    this->cancel();
+}
+
+
+int LayerClassifier::classifyLayer(QgsVectorLayer* layer, QString& err)
+{
+    this->cancel();
+
+    if(layer == nullptr)
+    {
+        err = "Error, no layer was given to classify";
+        return -1;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(sketchMutex);
+
+        attributes.clear();
+        fieldIndices.clear();
+        sketches.clear();
+        numFeatures = 0;
+        finished = false;
+
+        auto fields = layer->fields();
+        for(int i = 0; i<fields.size(); ++i)
+        {
+            if(!fields.at(i).isNumeric())
+                continue;
+
+            attributes.append(fields.at(i).name());
+            fieldIndices.append(i);
+        }
+
+        sketches.resize(attributes.size());
+    }
+
+    if(attributes.isEmpty())
+    {
+        err = "The layer "+layer->name()+" does not have any numeric attributes to classify";
+        return -1;
+    }
+
+    // The feature source is a copy of the state of the layer that can be read on another thread, it has to be made on the thread of the layer
+    std::shared_ptr<QgsVectorLayerFeatureSource> source(new QgsVectorLayerFeatureSource(layer));
+
+    cancelled = false;
+    worker = QtConcurrent::run([this, source]()
+    {
+        this->sketchFeatures(source);
+    });
+
+    return 0;
+}
+
+
+void LayerClassifier::cancel(void)
+{
+    cancelled = true;
+    worker.waitForFinished();
+}
+
+
+QStringList LayerClassifier::getAttributes(void) const
+{
+    std::lock_guard<std::mutex> lock(sketchMutex);
+    return attributes;
+}
+
+
+qint64 LayerClassifier::getNumFeatures(void) const
+{
+    std::lock_guard<std::mutex> lock(sketchMutex);
+    return numFeatures;
+}
+
+
+bool LayerClassifier::isFinished(void) const
+{
+    std::lock_guard<std::mutex> lock(sketchMutex);
+    return finished;
+}
+
+
+void LayerClassifier::setChunkSize(const int value)
+{
+    chunkSize = std::max(value, blockSize);
+}
+
+
+void LayerClassifier::sketchFeatures(std::shared_ptr<QgsVectorLayerFeatureSource> source)
+{
+    const int numAttributes = fieldIndices.size();
+
+    QgsFeatureRequest request;
+    request.setFlags(QgsFeatureRequest::NoGeometry);
+    request.setSubsetOfAttributes(QgsAttributeList(fieldIndices.toList()));
+
+    QgsFeatureIterator featIt = source->getFeatures(request);
+    QgsFeature feature;
+
+    std::vector<double> values;
+    values.reserve(static_cast<size_t>(chunkSize)*numAttributes);
+
+    QElapsedTimer timer;
+    timer.start();
+
+    bool moreFeatures = true;
+
+    while(moreFeatures && !cancelled)
+    {
+        // Only the attribute values are copied out on this thread, the sketching of the chunk is spread over the pool
+        values.clear();
+        int numRows = 0;
+
+        while(numRows < chunkSize && (moreFeatures = featIt.nextFeature(feature)))
+        {
+            const auto& attrs = feature.attributes();
+
+            for(auto&& index : fieldIndices)
+            {
+                bool OK = false;
+                const double value = index < attrs.size() && !attrs.at(index).isNull() ? attrs.at(index).toDouble(&OK) : 0.0;
+
+                values.push_back(OK && std::isfinite(value) ? value : std::numeric_limits<double>::quiet_NaN());
+            }
+
+            ++numRows;
+
+            if(cancelled)
+                return;
+        }
+
+        if(numRows == 0)
+            break;
+
+        this->sketchChunk(values, numRows);
+
+        if(moreFeatures && timer.elapsed() > updateInterval)
+        {
+            emit sketchesUpdated(this->getNumFeatures(), false);
+            timer.restart();
+        }
+    }
+
+    if(cancelled)
+        return;
+
+    qint64 total = 0;
+    {
+        std::lock_guard<std::mutex> lock(sketchMutex);
+        finished = true;
+        total = numFeatures;
+    }
+
+    emit sketchesUpdated(total, true);
+}
+
+
+void LayerClassifier::sketchChunk(const std::vector<double>& values, const int numRows)
+{
+    const int numAttributes = fieldIndices.size();
+
+    struct Job
+    {
+        int firstRow = 0;
+        int lastRow = 0;
+        std::vector<QuantileSketch> sketches;
+    };
+
+    std::vector<Job> jobs;
+    for(int first = 0; first<numRows; first += blockSize)
+    {
+        Job job;
+        job.firstRow = first;
+        job.lastRow = std::min(first + blockSize, numRows);
+        jobs.push_back(job);
+    }
+
+    auto evaluateBlock = [&](Job& job)
+    {
+        job.sketches.resize(numAttributes);
+
+        for(int i = job.firstRow; i<job.lastRow; ++i)
+        {
+            const double* row = values.data() + static_cast<size_t>(i)*numAttributes;
+
+            for(int j = 0; j<numAttributes; ++j)
+                job.sketches[j].add(row[j]);
+        }
+    };
+
+    QtConcurrent::blockingMap(jobs, evaluateBlock);
+
+    // Sketches of the same k merge in any order, so the blocks are merged in the order of the rows
+    std::lock_guard<std::mutex> lock(sketchMutex);
+
+    for(auto&& job : jobs)
+        for(int j = 0; j<numAttributes; ++j)
+            sketches[j].merge(job.sketches[j]);
+
+    numFeatures += numRows;
+}
+
+
+int LayerClassifier::getBreaks(const QString& attribute, const int numClasses, const Method method, QVector<double>& breaks, QString& err) const
+{
+    breaks.clear();
+
+    if(numClasses < 1)
+    {
+        err = "Error, the number of classes must be at least one";
+        return -1;
+    }
+
+    // Copy the sketch so that the breaks are found while the worker keeps adding to it
+    QuantileSketch sketch;
+    {
+        std::lock_guard<std::mutex> lock(sketchMutex);
+
+        auto index = attributes.indexOf(attribute);
+        if(index == -1)
+        {
+            err = "Error, the attribute "+attribute+" is not a numeric attribute of the layer";
+            return -1;
+        }
+
+        sketch = sketches[index];
+    }
+
+    if(sketch.isEmpty())
+        return 0;
+
+    if(method == Method::NaturalBreaks)
+        breaks = getNaturalBreaks(sketch, numClasses);
+    else
+        breaks = getQuantileBreaks(sketch, numClasses);
+
+    return 0;
+}
+
+
+QVector<double> LayerClassifier::getQuantileBreaks(const QuantileSketch& sketch, const int numClasses)
+{
+    QVector<double> breaks;
+
+    if(sketch.isEmpty() || numClasses < 1)
+        return breaks;
+
+    QVector<double> qs;
+    for(int i = 1; i<numClasses; ++i)
+        qs.append(static_cast<double>(i)/numClasses);
+
+    auto values = sketch.quantiles(qs);
+
+    breaks.append(sketch.min());
+    for(auto&& it : values)
+        if(it > breaks.last())
+            breaks.append(it);
+
+    if(sketch.max() > breaks.last() || breaks.size() == 1)
+        breaks.append(sketch.max());
+
+    return breaks;
+}
+
+
+QVector<double> LayerClassifier::getNaturalBreaks(const QuantileSketch& sketch, const int numClasses, const int numSamples)
+{
+    QVector<double> breaks;
+
+    if(sketch.isEmpty() || numClasses < 1)
+        return breaks;
+
+    // Each sample stands for the same share of the values, so the sum of squared deviations of the samples follows that of the values
+    const int m = static_cast<int>(std::max<qint64>(std::min<qint64>(numSamples, sketch.count()), 1));
+
+    QVector<double> qs(m);
+    for(int i = 0; i<m; ++i)
+        qs[i] = (i + 0.5)/m;
+
+    auto samples = sketch.quantiles(qs);
+    std::sort(samples.begin(), samples.end());
+
+    const int k = std::min(numClasses, m);
+
+    // Prefix sums of the samples and their squares give the sum of squared deviations of any run of samples
+    std::vector<double> sum(m + 1, 0.0);
+    std::vector<double> sumSq(m + 1, 0.0);
+    for(int i = 0; i<m; ++i)
+    {
+        sum[i + 1] = sum[i] + samples[i];
+        sumSq[i + 1] = sumSq[i] + samples[i]*samples[i];
+    }
+
+    auto getDeviation = [&](const int first, const int last)
+    {
+        const double n = last - first;
+        const double s = sum[last] - sum[first];
+        return std::max(sumSq[last] - sumSq[first] - s*s/n, 0.0);
+    };
+
+    // cost[c][i] is the least total deviation of the first i samples in c+1 classes, and start[c][i] is the first sample of the last of those classes
+    const double infinity = std::numeric_limits<double>::infinity();
+
+    std::vector<std::vector<double>> cost(k, std::vector<double>(m + 1, infinity));
+    std::vector<std::vector<int>> start(k, std::vector<int>(m + 1, 0));
+
+    for(int i = 1; i<=m; ++i)
+        cost[0][i] = getDeviation(0, i);
+
+    for(int c = 1; c<k; ++c)
+    {
+        for(int i = c + 1; i<=m; ++i)
+        {
+            for(int j = c; j<i; ++j)
+            {
+                const double value = cost[c - 1][j] + getDeviation(j, i);
+
+                if(value < cost[c][i])
+                {
+                    cost[c][i] = value;
+                    start[c][i] = j;
+                }
+            }
+        }
+    }
+
+    // Walk back from the last class to find the first sample of each class
+    std::vector<int> firstSamples(k, 0);
+    int last = m;
+    for(int c = k - 1; c>0; --c)
+    {
+        firstSamples[c] = start[c][last];
+        last = firstSamples[c];
+    }
+
+    // A break lies halfway between the last sample of a class and the first sample of the next one
+    breaks.append(sketch.min());
+    for(int c = 1; c<k; ++c)
+    {
+        const int first = firstSamples[c];
+        const double value = 0.5*(samples[first - 1] + samples[first]);
+
+        if(value > breaks.last())
+            breaks.append(value);
+    }
+
+    if(sketch.max() > breaks.last() || breaks.size() == 1)
+        breaks.append(sketch.max());
+
+    return breaks;
+}
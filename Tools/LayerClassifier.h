@@ -0,0 +1,123 @@
+#ifndef LAYERCLASSIFIER_H
+#define LAYERCLASSIFIER_H
+/* *****************************************************************************
+Copyright (c) 2016-2021, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+// Written by: Stevan Gavrilovic
+
+#include "QuantileSketch.h"
+
+#include <QFuture>
+#include <QObject>
+#include <QStringList>
+#include <QVector>
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+class QgsVectorLayer;
+class QgsVectorLayerFeatureSource;
+
+// Finds the class breaks of the numeric attributes of a vector layer on the thread pool, so that large hazard layers can be classified without blocking the GUI thread
+// The features are read a chunk at a time, the rows of each chunk are split into blocks that are sketched in parallel and merged into a quantile sketch for each attribute
+// The sketches are kept, so the breaks for another attribute or number of classes are found without reading the layer again
+class LayerClassifier : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum class Method
+    {
+        Quantile,
+        NaturalBreaks
+    };
+
+    explicit LayerClassifier(QObject* parent = nullptr);
+    ~LayerClassifier();
+
+    // Starts sketching the numeric attributes of the layer in the background, a classification that is still running is cancelled first
+    int classifyLayer(QgsVectorLayer* layer, QString& err);
+
+    // Stops the classification and waits for the worker to return, the sketches of the features read so far are kept
+    void cancel(void);
+
+    // Numeric attributes of the layer being classified
+    QStringList getAttributes(void) const;
+
+    qint64 getNumFeatures(void) const;
+
+    bool isFinished(void) const;
+
+    // Breaks of the classes of the attribute, from its minimum to its maximum, there are fewer than numClasses+1 breaks if some of them coincide
+    int getBreaks(const QString& attribute, const int numClasses, const Method method, QVector<double>& breaks, QString& err) const;
+
+    static QVector<double> getQuantileBreaks(const QuantileSketch& sketch, const int numClasses);
+
+    // Jenks natural breaks of the values at evenly spaced quantiles of the sketch, found with the dynamic program of Fisher (1958)
+    static QVector<double> getNaturalBreaks(const QuantileSketch& sketch, const int numClasses, const int numSamples = 512);
+
+    void setChunkSize(const int value);
+
+signals:
+
+    // Emitted from the worker thread as the sketches grow and once more when the whole layer is sketched
+    void sketchesUpdated(qint64 numFeatures, bool finished);
+
+private:
+
+    void sketchFeatures(std::shared_ptr<QgsVectorLayerFeatureSource> source);
+
+    // Adds the values of the attributes of a chunk of rows to the sketches, the rows are row-major with a column for each attribute and NaN for a missing value
+    void sketchChunk(const std::vector<double>& values, const int numRows);
+
+    QStringList attributes;
+    QVector<int> fieldIndices;
+
+    std::vector<QuantileSketch> sketches;
+    qint64 numFeatures = 0;
+    bool finished = false;
+
+    mutable std::mutex sketchMutex;
+
+    std::atomic<bool> cancelled{false};
+    QFuture<void> worker;
+
+    int chunkSize = 65536;
+};
+
+#endif // LAYERCLASSIFIER_H
@@ -0,0 +1,358 @@
+/* *****************************************************************************
+Copyright (c) 2016-2021, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+// Written by: Stevan Gavrilovic
+
+#include "NearestNeighbourMapper.h"
+
+#include <QtConcurrent/QtConcurrent>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+
+namespace {
+
+// Subtrees with fewer stations than this are searched by a linear scan
+const int leafSize = 8;
+
+// Distances below this are clamped so that an asset on top of a station gets a finite, dominant weight
+const double minDistance = 1.0e-10;
+
+const double earthRadiusKm = 6371.0;
+
+// Random stream of the splitmix64 generator, small enough to have one for each asset
+class AssetRandomStream
+{
+public:
+    AssetRandomStream(const int seed, const int asset)
+    {
+        state = (static_cast<uint64_t>(static_cast<uint32_t>(seed)) << 32) ^ static_cast<uint64_t>(static_cast<uint32_t>(asset));
+        this->next();
+    }
+
+    // Uniform random number in [0, 1)
+    double uniform(void)
+    {
+        return (this->next() >> 11)*(1.0/9007199254740992.0);
+    }
+
+private:
+
+    uint64_t next(void)
+    {
+        uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30))*0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27))*0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    uint64_t state = 0;
+};
+
+
+double getGreatCircleDistance(const double lat1, const double lon1, const double lat2, const double lon2)
+{
+    const double toRad = M_PI/180.0;
+
+    const double sinLat = std::sin(0.5*(lat2 - lat1)*toRad);
+    const double sinLon = std::sin(0.5*(lon2 - lon1)*toRad);
+
+    const double a = sinLat*sinLat + std::cos(lat1*toRad)*std::cos(lat2*toRad)*sinLon*sinLon;
+
+    return 2.0*earthRadiusKm*std::asin(std::min(1.0, std::sqrt(a)));
+}
+
+}
+
+
+NearestNeighbourMapper::NearestNeighbourMapper()
+{
+
+}
+
+
+int NearestNeighbourMapper::setStations(const QVector<double>& latitudes, const QVector<double>& longitudes, QString& err)
+{
+    nodeX.clear();
+    nodeY.clear();
+    nodeStation.clear();
+    nodeAxis.clear();
+
+    if(latitudes.size() != longitudes.size())
+    {
+        err = "Error, the number of station latitudes and longitudes must be equal";
+        return -1;
+    }
+
+    if(latitudes.isEmpty())
+    {
+        err = "Error, at least one station is needed for the nearest neighbour mapping";
+        return -1;
+    }
+
+    const int numStations = latitudes.size();
+
+    nodeX.assign(longitudes.begin(), longitudes.end());
+    nodeY.assign(latitudes.begin(), latitudes.end());
+    nodeStation.resize(numStations);
+    nodeAxis.assign(numStations, 0);
+
+    std::iota(nodeStation.begin(), nodeStation.end(), 0);
+
+    this->buildTree(0, numStations);
+
+    return 0;
+}
+
+
+int NearestNeighbourMapper::getNumStations(void) const
+{
+    return static_cast<int>(nodeStation.size());
+}
+
+
+void NearestNeighbourMapper::buildTree(const int first, const int last)
+{
+    if(last - first <= leafSize)
+        return;
+
+    // Split along the axis with the larger spread
+    double minX = nodeX[first], maxX = nodeX[first], minY = nodeY[first], maxY = nodeY[first];
+    for(int i = first + 1; i<last; ++i)
+    {
+        minX = std::min(minX, nodeX[i]);
+        maxX = std::max(maxX, nodeX[i]);
+        minY = std::min(minY, nodeY[i]);
+        maxY = std::max(maxY, nodeY[i]);
+    }
+
+    const char axis = (maxY - minY) > (maxX - minX) ? 1 : 0;
+    const std::vector<double>& key = axis == 0 ? nodeX : nodeY;
+
+    // Sort a permutation of the nodes by the key and apply it to all of the node arrays
+    const int middle = first + (last - first)/2;
+
+    std::vector<int> order(last - first);
+    std::iota(order.begin(), order.end(), first);
+    std::nth_element(order.begin(), order.begin() + (middle - first), order.end(), [&key](const int a, const int b) { return key[a] < key[b]; });
+
+    std::vector<double> x(order.size()), y(order.size());
+    std::vector<int> station(order.size());
+    for(size_t i = 0; i<order.size(); ++i)
+    {
+        x[i] = nodeX[order[i]];
+        y[i] = nodeY[order[i]];
+        station[i] = nodeStation[order[i]];
+    }
+
+    std::copy(x.begin(), x.end(), nodeX.begin() + first);
+    std::copy(y.begin(), y.end(), nodeY.begin() + first);
+    std::copy(station.begin(), station.end(), nodeStation.begin() + first);
+
+    nodeAxis[middle] = axis;
+
+    this->buildTree(first, middle);
+    this->buildTree(middle + 1, last);
+}
+
+
+void NearestNeighbourMapper::searchTree(const int first, const int last, const double x, const double y, const int k, int* bestIndices, double* bestDistances, int& numFound) const
+{
+    // The distances are squared while searching
+    auto consider = [&](const int node)
+    {
+        const double dx = nodeX[node] - x;
+        const double dy = nodeY[node] - y;
+        const double distance = dx*dx + dy*dy;
+
+        if(numFound == k && distance >= bestDistances[k-1])
+            return;
+
+        int pos = numFound < k ? numFound++ : k - 1;
+
+        while(pos > 0 && bestDistances[pos-1] > distance)
+        {
+            bestDistances[pos] = bestDistances[pos-1];
+            bestIndices[pos] = bestIndices[pos-1];
+            --pos;
+        }
+
+        bestDistances[pos] = distance;
+        bestIndices[pos] = node;
+    };
+
+    if(last - first <= leafSize)
+    {
+        for(int i = first; i<last; ++i)
+            consider(i);
+
+        return;
+    }
+
+    const int middle = first + (last - first)/2;
+
+    const double offset = nodeAxis[middle] == 0 ? x - nodeX[middle] : y - nodeY[middle];
+
+    // Search the side of the split that holds the point first, the other side only if it can hold a closer station
+    if(offset < 0.0)
+        this->searchTree(first, middle, x, y, k, bestIndices, bestDistances, numFound);
+    else
+        this->searchTree(middle + 1, last, x, y, k, bestIndices, bestDistances, numFound);
+
+    consider(middle);
+
+    if(numFound < k || offset*offset < bestDistances[k-1])
+    {
+        if(offset < 0.0)
+            this->searchTree(middle + 1, last, x, y, k, bestIndices, bestDistances, numFound);
+        else
+            this->searchTree(first, middle, x, y, k, bestIndices, bestDistances, numFound);
+    }
+}
+
+
+void NearestNeighbourMapper::findNearest(const double latitude, const double longitude, const int k, QVector<int>& indices, QVector<double>& distances) const
+{
+    indices.clear();
+    distances.clear();
+
+    const int numNearest = std::min(k, this->getNumStations());
+
+    if(numNearest <= 0)
+        return;
+
+    std::vector<int> nodes(numNearest);
+    std::vector<double> squaredDistances(numNearest);
+    int numFound = 0;
+
+    this->searchTree(0, this->getNumStations(), longitude, latitude, numNearest, nodes.data(), squaredDistances.data(), numFound);
+
+    for(int i = 0; i<numFound; ++i)
+    {
+        indices.append(nodeStation[nodes[i]]);
+        distances.append(std::sqrt(squaredDistances[i]));
+    }
+}
+
+
+int NearestNeighbourMapper::computeMapping(const QVector<double>& latitudes, const QVector<double>& longitudes, const int numNeighbours, const int numSamples, const int seed, QVector<int>& samples, QVector<double>& nearestDistances, QString& err) const
+{
+    samples.clear();
+    nearestDistances.clear();
+
+    if(nodeStation.empty())
+    {
+        err = "Error, the stations must be set before the nearest neighbour mapping";
+        return -1;
+    }
+
+    if(latitudes.size() != longitudes.size())
+    {
+        err = "Error, the number of asset latitudes and longitudes must be equal";
+        return -1;
+    }
+
+    if(numNeighbours < 1 || numSamples < 1)
+    {
+        err = "Error, the number of neighbours and samples must be at least one";
+        return -1;
+    }
+
+    const int numAssets = latitudes.size();
+    const int k = std::min(numNeighbours, this->getNumStations());
+
+    samples.fill(0, numAssets*numSamples);
+    nearestDistances.fill(0.0, numAssets);
+
+    struct Job
+    {
+        int firstAsset = 0;
+        int numAssets = 0;
+    };
+
+    const int blockSize = 4096;
+
+    std::vector<Job> jobs;
+    jobs.reserve(numAssets/blockSize + 1);
+
+    for(int firstAsset = 0; firstAsset<numAssets; firstAsset += blockSize)
+        jobs.push_back({firstAsset, std::min(blockSize, numAssets - firstAsset)});
+
+    const double* latPtr = latitudes.constData();
+    const double* lonPtr = longitudes.constData();
+    int* samplePtr = samples.data();
+    double* distancePtr = nearestDistances.data();
+
+    auto evaluateBlock = [&](const Job& job)
+    {
+        std::vector<int> nodes(k);
+        std::vector<double> squaredDistances(k);
+        std::vector<double> cumulativeWeights(k);
+
+        const int end = job.firstAsset + job.numAssets;
+
+        for(int i = job.firstAsset; i<end; ++i)
+        {
+            int numFound = 0;
+            this->searchTree(0, this->getNumStations(), lonPtr[i], latPtr[i], k, nodes.data(), squaredDistances.data(), numFound);
+
+            double totalWeight = 0.0;
+            for(int j = 0; j<numFound; ++j)
+            {
+                totalWeight += 1.0/std::max(std::sqrt(squaredDistances[j]), minDistance);
+                cumulativeWeights[j] = totalWeight;
+            }
+
+            AssetRandomStream stream(seed, i);
+
+            for(int s = 0; s<numSamples; ++s)
+            {
+                const double u = stream.uniform()*totalWeight;
+                const int j = std::min(static_cast<int>(std::upper_bound(cumulativeWeights.begin(), cumulativeWeights.begin() + numFound, u) - cumulativeWeights.begin()), numFound - 1);
+
+                samplePtr[i*numSamples + s] = nodeStation[nodes[j]];
+            }
+
+            distancePtr[i] = getGreatCircleDistance(latPtr[i], lonPtr[i], nodeY[nodes[0]], nodeX[nodes[0]]);
+        }
+    };
+
+    QtConcurrent::blockingMap(jobs, evaluateBlock);
+
+    return 0;
+}
@@ -0,0 +1,83 @@
+#ifndef NEARESTNEIGHBOURMAPPER_H
+#define NEARESTNEIGHBOURMAPPER_H
+/* *****************************************************************************
+Copyright (c) 2016-2021, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+// Written by: Stevan Gavrilovic
+
+#include <QString>
+#include <QVector>
+
+#include <vector>
+
+// Maps assets to the stations of a hazard with the nearest neighbour method of the NearestNeighborEvents backend application
+// The stations are held in a KD-tree over their longitude and latitude, and the neighbours are found with the same planar distance in degrees as the backend
+// Each sample of an asset is drawn from its neighbours with weights that are inversely proportional to their distance
+// The samples of each asset come from a random stream that only depends on the seed and the index of the asset, so the mapping does not depend on how the assets are split between threads
+class NearestNeighbourMapper
+{
+public:
+    NearestNeighbourMapper();
+
+    // Builds the KD-tree over the station coordinates in degrees
+    int setStations(const QVector<double>& latitudes, const QVector<double>& longitudes, QString& err);
+
+    int getNumStations(void) const;
+
+    // Indices of the k nearest stations to a point sorted from the nearest, and their planar distances in degrees
+    void findNearest(const double latitude, const double longitude, const int k, QVector<int>& indices, QVector<double>& distances) const;
+
+    // Finds the neighbours of each asset and draws the samples from them, blocks of assets are evaluated on the thread pool
+    // The samples are the station indices of each asset in a row-major table with a row for each asset, the nearest distances are the great circle distances in km to the nearest station
+    int computeMapping(const QVector<double>& latitudes, const QVector<double>& longitudes, const int numNeighbours, const int numSamples, const int seed, QVector<int>& samples, QVector<double>& nearestDistances, QString& err) const;
+
+private:
+
+    // Finds the k nearest stations in the subtree of the nodes between first and last, the best list is kept sorted from the nearest
+    void searchTree(const int first, const int last, const double x, const double y, const int k, int* bestIndices, double* bestDistances, int& numFound) const;
+
+    void buildTree(const int first, const int last);
+
+    // Station coordinates in the order of the nodes of the tree, the node of a subtree is at its midpoint
+    std::vector<double> nodeX;
+    std::vector<double> nodeY;
+    std::vector<int> nodeStation;
+
+    // Splitting axis of each node, 0 for the longitude and 1 for the latitude
+    std::vector<char> nodeAxis;
+};
+
+#endif // NEARESTNEIGHBOURMAPPER_H
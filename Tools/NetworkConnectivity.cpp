@@ -0,0 +1,468 @@
+/* *****************************************************************************
+Copyright (c) 2016-2021, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+// Written by: Stevan Gavrilovic
+
+#include "NetworkConnectivity.h"
+
+#include <QThread>
+#include <QtConcurrent/QtConcurrent>
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+
+namespace
+{
+int findRoot(std::vector<int>& parent, int x)
+{
+    // Path halving
+    while(parent[x] != x)
+    {
+        parent[x] = parent[parent[x]];
+        x = parent[x];
+    }
+
+    return x;
+}
+
+
+void unite(std::vector<int>& parent, std::vector<int>& size, int a, int b)
+{
+    a = findRoot(parent, a);
+    b = findRoot(parent, b);
+
+    if(a == b)
+        return;
+
+    // Union by size
+    if(size[a] < size[b])
+        std::swap(a,b);
+
+    parent[b] = a;
+    size[a] += size[b];
+}
+}
+
+
+NetworkConnectivity::NetworkConnectivity()
+{
+
+}
+
+
+int NetworkConnectivity::buildGraph(const QVector<qint64>& nodeIDs, const QVector<qint64>& edgeStartNodes, const QVector<qint64>& edgeEndNodes, QString& err)
+{
+    this->clear();
+
+    if(edgeStartNodes.size() != edgeEndNodes.size())
+    {
+        err = "Error, the number of start nodes and end nodes of the edges must be the same";
+        return -1;
+    }
+
+    const int nNodes = nodeIDs.size();
+
+    nodeIndexes.reserve(nNodes);
+    for(int i = 0; i<nNodes; ++i)
+    {
+        if(nodeIndexes.contains(nodeIDs.at(i)))
+        {
+            err = "Error, the node ID "+QString::number(nodeIDs.at(i))+" is not unique";
+            this->clear();
+            return -1;
+        }
+
+        nodeIndexes.insert(nodeIDs.at(i), i);
+    }
+
+    this->nodeIDs = nodeIDs;
+
+    const int nEdges = edgeStartNodes.size();
+
+    QVector<int> startIndexes(nEdges);
+    QVector<int> endIndexes(nEdges);
+
+    // Count the degree of each node
+    QVector<int> degree(nNodes, 0);
+    for(int i = 0; i<nEdges; ++i)
+    {
+        auto startIndex = nodeIndexes.value(edgeStartNodes.at(i), -1);
+        auto endIndex = nodeIndexes.value(edgeEndNodes.at(i), -1);
+
+        if(startIndex == -1 || endIndex == -1)
+        {
+            err = "Error, could not find the node with ID "+QString::number(startIndex == -1 ? edgeStartNodes.at(i) : edgeEndNodes.at(i))+" of edge "+QString::number(i)+" in the nodes";
+            this->clear();
+            return -1;
+        }
+
+        startIndexes[i] = startIndex;
+        endIndexes[i] = endIndex;
+
+        ++degree[startIndex];
+        ++degree[endIndex];
+    }
+
+    rowOffsets.resize(nNodes+1);
+    rowOffsets[0] = 0;
+    for(int i = 0; i<nNodes; ++i)
+        rowOffsets[i+1] = rowOffsets[i] + degree.at(i);
+
+    adjacentNodes.resize(rowOffsets.last());
+    adjacentEdges.resize(rowOffsets.last());
+
+    // Each edge is stored in the rows of both of its nodes
+    QVector<int> fill = rowOffsets;
+    for(int i = 0; i<nEdges; ++i)
+    {
+        auto a = startIndexes.at(i);
+        auto b = endIndexes.at(i);
+
+        adjacentNodes[fill[a]] = b;
+        adjacentEdges[fill[a]++] = i;
+
+        adjacentNodes[fill[b]] = a;
+        adjacentEdges[fill[b]++] = i;
+    }
+
+    edgeCount = nEdges;
+
+    return 0;
+}
+
+
+void NetworkConnectivity::clear(void)
+{
+    nodeIDs.clear();
+    nodeIndexes.clear();
+    rowOffsets.clear();
+    adjacentNodes.clear();
+    adjacentEdges.clear();
+    edgeCount = 0;
+    sourceNodes.clear();
+    sinkNodes.clear();
+    realizationCount = 0;
+    connectedCounts.clear();
+    connectedSinkFractions.clear();
+}
+
+
+int NetworkConnectivity::setSourceNodes(const QVector<qint64>& nodeIDs, QString& err)
+{
+    sourceNodes.clear();
+
+    for(auto&& it : nodeIDs)
+    {
+        auto index = this->getNodeIndex(it);
+
+        if(index == -1)
+        {
+            err = "Error, could not find the source node with ID "+QString::number(it);
+            sourceNodes.clear();
+            return -1;
+        }
+
+        sourceNodes.append(index);
+    }
+
+    return 0;
+}
+
+
+int NetworkConnectivity::setSinkNodes(const QVector<qint64>& nodeIDs, QString& err)
+{
+    sinkNodes.clear();
+
+    for(auto&& it : nodeIDs)
+    {
+        auto index = this->getNodeIndex(it);
+
+        if(index == -1)
+        {
+            err = "Error, could not find the sink node with ID "+QString::number(it);
+            sinkNodes.clear();
+            return -1;
+        }
+
+        sinkNodes.append(index);
+    }
+
+    return 0;
+}
+
+
+int NetworkConnectivity::sampleEdgeFailures(const QVector<double>& edgeFailureProbabilities, const int numRealizations, const quint64 seed, QString& err)
+{
+    if(edgeFailureProbabilities.size() != edgeCount)
+    {
+        err = "Error, the number of failure probabilities ("+QString::number(edgeFailureProbabilities.size())+") must be equal to the number of edges ("+QString::number(edgeCount)+")";
+        return -1;
+    }
+
+    auto generator = [&](int realization, std::vector<char>& failedEdges)
+    {
+        // Seed each realization on its own so that the results do not depend on how the realizations are split between the threads
+        std::mt19937_64 rng(seed + 0x9E3779B97F4A7C15ULL*static_cast<quint64>(realization+1));
+        std::uniform_real_distribution<double> uniform(0.0, 1.0);
+
+        for(int i = 0; i<edgeCount; ++i)
+            failedEdges[i] = uniform(rng) < edgeFailureProbabilities.at(i) ? 1 : 0;
+    };
+
+    return this->evaluate(numRealizations, generator, err);
+}
+
+
+int NetworkConnectivity::evaluateRealizations(const QVector<QVector<int>>& failedEdges, QString& err)
+{
+    for(int i = 0; i<failedEdges.size(); ++i)
+    {
+        for(auto&& edge : failedEdges.at(i))
+        {
+            if(edge < 0 || edge >= edgeCount)
+            {
+                err = "Error, the edge index "+QString::number(edge)+" in realization "+QString::number(i)+" is not in the network";
+                return -1;
+            }
+        }
+    }
+
+    auto generator = [&](int realization, std::vector<char>& failed)
+    {
+        for(auto&& edge : failedEdges.at(realization))
+            failed[edge] = 1;
+    };
+
+    return this->evaluate(failedEdges.size(), generator, err);
+}
+
+
+int NetworkConnectivity::evaluate(const int numRealizations, const FailureGenerator& generator, QString& err)
+{
+    realizationCount = 0;
+    connectedCounts.clear();
+    connectedSinkFractions.clear();
+
+    const int nNodes = nodeIDs.size();
+
+    if(nNodes == 0)
+    {
+        err = "Error, the network graph is empty";
+        return -1;
+    }
+
+    if(sourceNodes.isEmpty())
+    {
+        err = "Error, the network does not have any source nodes";
+        return -1;
+    }
+
+    if(numRealizations <= 0)
+    {
+        err = "Error, the number of realizations must be greater than zero";
+        return -1;
+    }
+
+    // By default all of the nodes that are not sources are sinks
+    auto sinks = sinkNodes;
+    if(sinks.isEmpty())
+    {
+        std::vector<char> isSource(nNodes, 0);
+        for(auto&& it : sourceNodes)
+            isSource[it] = 1;
+
+        for(int i = 0; i<nNodes; ++i)
+            if(!isSource[i])
+                sinks.append(i);
+    }
+
+    // Each chunk is a contiguous range of realizations with its own scratch buffers
+    struct Chunk
+    {
+        int firstRealization = 0;
+        int lastRealization = 0;
+
+        std::vector<int> parent;
+        std::vector<int> size;
+        std::vector<char> failedEdges;
+        std::vector<char> sourceRoot;
+
+        std::vector<qint64> counts;
+        std::vector<double> sinkFractions;
+    };
+
+    const int numChunks = std::min(numRealizations, std::max(1,QThread::idealThreadCount())*4);
+
+    std::vector<Chunk> chunks(numChunks);
+    for(int i = 0; i<numChunks; ++i)
+    {
+        chunks[i].firstRealization = static_cast<int>(static_cast<qint64>(numRealizations)*i/numChunks);
+        chunks[i].lastRealization = static_cast<int>(static_cast<qint64>(numRealizations)*(i+1)/numChunks);
+    }
+
+    QtConcurrent::blockingMap(chunks, [&](Chunk& chunk)
+    {
+        chunk.parent.resize(nNodes);
+        chunk.size.resize(nNodes);
+        chunk.failedEdges.resize(edgeCount);
+        chunk.sourceRoot.resize(nNodes);
+        chunk.counts.assign(nNodes, 0);
+        chunk.sinkFractions.reserve(chunk.lastRealization - chunk.firstRealization);
+
+        for(int r = chunk.firstRealization; r<chunk.lastRealization; ++r)
+        {
+            std::fill(chunk.failedEdges.begin(), chunk.failedEdges.end(), 0);
+            generator(r, chunk.failedEdges);
+
+            std::iota(chunk.parent.begin(), chunk.parent.end(), 0);
+            std::fill(chunk.size.begin(), chunk.size.end(), 1);
+
+            // Join the nodes across the edges that survive, each edge is in the CSR rows of both of its nodes so only visit it from the lower node index
+            for(int u = 0; u<nNodes; ++u)
+            {
+                for(int k = rowOffsets.at(u); k<rowOffsets.at(u+1); ++k)
+                {
+                    auto v = adjacentNodes.at(k);
+
+                    if(v <= u || chunk.failedEdges[adjacentEdges.at(k)])
+                        continue;
+
+                    unite(chunk.parent, chunk.size, u, v);
+                }
+            }
+
+            std::fill(chunk.sourceRoot.begin(), chunk.sourceRoot.end(), 0);
+            for(auto&& it : sourceNodes)
+                chunk.sourceRoot[findRoot(chunk.parent, it)] = 1;
+
+            for(int n = 0; n<nNodes; ++n)
+                if(chunk.sourceRoot[findRoot(chunk.parent, n)])
+                    ++chunk.counts[n];
+
+            int numConnectedSinks = 0;
+            for(auto&& it : sinks)
+                if(chunk.sourceRoot[findRoot(chunk.parent, it)])
+                    ++numConnectedSinks;
+
+            chunk.sinkFractions.push_back(sinks.isEmpty() ? 1.0 : static_cast<double>(numConnectedSinks)/sinks.size());
+        }
+    });
+
+    connectedCounts.fill(0, nNodes);
+    connectedSinkFractions.reserve(numRealizations);
+
+    for(auto&& chunk : chunks)
+    {
+        for(int n = 0; n<nNodes; ++n)
+            connectedCounts[n] += chunk.counts[n];
+
+        for(auto&& it : chunk.sinkFractions)
+            connectedSinkFractions.append(it);
+    }
+
+    realizationCount = numRealizations;
+
+    return 0;
+}
+
+
+int NetworkConnectivity::numNodes(void) const
+{
+    return nodeIDs.size();
+}
+
+
+int NetworkConnectivity::numEdges(void) const
+{
+    return edgeCount;
+}
+
+
+QVector<qint64> NetworkConnectivity::getNodeIDs(void) const
+{
+    return nodeIDs;
+}
+
+
+int NetworkConnectivity::getNodeIndex(const qint64 nodeID) const
+{
+    return nodeIndexes.value(nodeID, -1);
+}
+
+
+QVector<int> NetworkConnectivity::getNeighbours(const int nodeIndex) const
+{
+    if(nodeIndex < 0 || nodeIndex >= nodeIDs.size())
+        return QVector<int>();
+
+    return adjacentNodes.mid(rowOffsets.at(nodeIndex), rowOffsets.at(nodeIndex+1) - rowOffsets.at(nodeIndex));
+}
+
+
+int NetworkConnectivity::numRealizations(void) const
+{
+    return realizationCount;
+}
+
+
+QVector<double> NetworkConnectivity::getNodeConnectivityProbabilities(void) const
+{
+    QVector<double> probabilities(connectedCounts.size(), 0.0);
+
+    if(realizationCount == 0)
+        return probabilities;
+
+    for(int i = 0; i<probabilities.size(); ++i)
+        probabilities[i] = static_cast<double>(connectedCounts.at(i))/realizationCount;
+
+    return probabilities;
+}
+
+
+QVector<double> NetworkConnectivity::getConnectedSinkFractions(void) const
+{
+    return connectedSinkFractions;
+}
+
+
+double NetworkConnectivity::getMeanConnectedSinkFraction(void) const
+{
+    if(connectedSinkFractions.isEmpty())
+        return 0.0;
+
+    return std::accumulate(connectedSinkFractions.begin(), connectedSinkFractions.end(), 0.0)/connectedSinkFractions.size();
+}
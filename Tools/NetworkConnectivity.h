@@ -0,0 +1,120 @@
+#ifndef NETWORKCONNECTIVITY_H
+#define NETWORKCONNECTIVITY_H
+/* *****************************************************************************
+Copyright (c) 2016-2021, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+// Written by: Stevan Gavrilovic
+
+#include <QHash>
+#include <QString>
+#include <QVector>
+
+#include <functional>
+#include <vector>
+
+// Source-to-sink connectivity of a network, e.g., a water, gas or transportation network, over many realizations of edge failures
+// The graph is stored once as a compressed sparse row (CSR) adjacency. The realizations are evaluated in parallel with a union-find over the edges that survive,
+// where each worker reuses its own scratch buffers for all of the realizations that it evaluates
+class NetworkConnectivity
+{
+public:
+    NetworkConnectivity();
+
+    // Builds the graph from the node ids and the start and end node ids of each edge, e.g., the node1/node2 columns of a pipe table
+    // The edges are indexed in the order that they are given
+    int buildGraph(const QVector<qint64>& nodeIDs, const QVector<qint64>& edgeStartNodes, const QVector<qint64>& edgeEndNodes, QString& err);
+
+    void clear(void);
+
+    // The nodes that supply the network, e.g., reservoirs and tanks
+    int setSourceNodes(const QVector<qint64>& nodeIDs, QString& err);
+
+    // The nodes that demand service, by default all of the nodes that are not sources
+    int setSinkNodes(const QVector<qint64>& nodeIDs, QString& err);
+
+    // Samples the realizations assuming that the edges fail independently with the given probabilities, the realizations are reproducible for a given seed
+    int sampleEdgeFailures(const QVector<double>& edgeFailureProbabilities, const int numRealizations, const quint64 seed, QString& err);
+
+    // Evaluates the given realizations, each item is the list of the indexes of the edges that failed in that realization
+    int evaluateRealizations(const QVector<QVector<int>>& failedEdges, QString& err);
+
+    int numNodes(void) const;
+
+    int numEdges(void) const;
+
+    QVector<qint64> getNodeIDs(void) const;
+
+    // Returns the index of the node in the graph, or -1 if the node is not in the graph
+    int getNodeIndex(const qint64 nodeID) const;
+
+    // The neighbouring node indexes of a node from the CSR adjacency
+    QVector<int> getNeighbours(const int nodeIndex) const;
+
+    int numRealizations(void) const;
+
+    // The fraction of the realizations in which each node is connected to at least one source, in the order of the node indexes
+    QVector<double> getNodeConnectivityProbabilities(void) const;
+
+    // The fraction of the sink nodes that are connected to a source in each realization
+    QVector<double> getConnectedSinkFractions(void) const;
+
+    double getMeanConnectedSinkFraction(void) const;
+
+private:
+
+    // Flags the edges that fail in the given realization, the flags are zeroed before the call
+    typedef std::function<void(int realization, std::vector<char>& failedEdges)> FailureGenerator;
+
+    int evaluate(const int numRealizations, const FailureGenerator& generator, QString& err);
+
+    QVector<qint64> nodeIDs;
+    QHash<qint64, int> nodeIndexes;
+
+    // CSR adjacency, the neighbours of node i are adjacentNodes[rowOffsets[i]] ... adjacentNodes[rowOffsets[i+1]-1], connected through the edges in adjacentEdges
+    QVector<int> rowOffsets;
+    QVector<int> adjacentNodes;
+    QVector<int> adjacentEdges;
+    int edgeCount = 0;
+
+    QVector<int> sourceNodes;
+    QVector<int> sinkNodes;
+
+    int realizationCount = 0;
+    QVector<qint64> connectedCounts;
+    QVector<double> connectedSinkFractions;
+};
+
+#endif // NETWORKCONNECTIVITY_H
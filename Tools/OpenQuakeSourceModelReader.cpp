@@ -0,0 +1,420 @@
+/* *****************************************************************************
+Copyright (c) 2016-2021, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+// Written by: Stevan Gavrilovic
+
+#include "OpenQuakeSourceModelReader.h"
+
+#include <QFile>
+#include <QHash>
+#include <QRegularExpression>
+#include <QXmlStreamReader>
+#include <QXmlStreamWriter>
+
+#include <limits>
+
+namespace
+{
+// Sources are elements that end in "Source" and have an id, e.g., pointSource, multiPointSource, kiteFaultSource
+bool isSourceElement(const QXmlStreamReader& xml)
+{
+    return xml.name().endsWith(QLatin1String("Source")) && xml.attributes().hasAttribute("id");
+}
+
+double toDouble(const QString& str)
+{
+    bool OK = false;
+    auto val = str.trimmed().toDouble(&OK);
+    return OK ? val : std::numeric_limits<double>::quiet_NaN();
+}
+}
+
+
+OpenQuakeSource::OpenQuakeSource()
+{
+    const double nanVal = std::numeric_limits<double>::quiet_NaN();
+
+    ruptAspectRatio = nanVal;
+    upperSeismoDepth = nanVal;
+    lowerSeismoDepth = nanVal;
+    dip = nanVal;
+    rake = nanVal;
+    aValue = nanVal;
+    bValue = nanVal;
+    minMag = nanVal;
+    maxMag = nanVal;
+}
+
+
+QString OpenQuakeSource::typeName(void) const
+{
+    switch(type)
+    {
+    case PointSource:
+        return "pointSource";
+    case AreaSource:
+        return "areaSource";
+    case SimpleFaultSource:
+        return "simpleFaultSource";
+    case ComplexFaultSource:
+        return "complexFaultSource";
+    case CharacteristicFaultSource:
+        return "characteristicFaultSource";
+    }
+
+    return QString();
+}
+
+
+int OpenQuakeSource::getCoordinates(QVector<double>& lonLat, QString& err) const
+{
+    lonLat.clear();
+
+    static const QRegularExpression whitespace("\\s+");
+
+    auto values = posList.splitRef(whitespace, Qt::SkipEmptyParts);
+
+    if(values.size() < 2 || dimension < 2)
+    {
+        err = "Could not get geometry for source "+id;
+        return -1;
+    }
+
+    lonLat.reserve(2*(values.size()/dimension));
+
+    for(int i = 0; i+1<values.size(); i+=dimension)
+    {
+        // First number is lon, second is lat
+        bool OK = true;
+
+        auto longitude = values.at(i).toDouble(&OK);
+
+        if(!OK)
+        {
+            err = "Error converting longitude to double for source "+id;
+            return -1;
+        }
+
+        auto latitude = values.at(i+1).toDouble(&OK);
+
+        if(!OK)
+        {
+            err = "Error converting latitude to double for source "+id;
+            return -1;
+        }
+
+        if(longitude == 0.0 || latitude == 0.0)
+            continue;
+
+        lonLat.append(longitude);
+        lonLat.append(latitude);
+    }
+
+    return 0;
+}
+
+
+OpenQuakeSourceModelReader::OpenQuakeSourceModelReader()
+{
+
+}
+
+
+int OpenQuakeSourceModelReader::readSourceModel(const QString& filePath, QVector<OpenQuakeSource>& sources, QString& err, const std::function<void(int)>& progress)
+{
+    sources.clear();
+    sourceModelName.clear();
+    numSourcesInModel = 0;
+    unsupportedSourceTypes.clear();
+
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        err = "Error while loading file "+filePath;
+        return -1;
+    }
+
+    const QHash<QString, OpenQuakeSource::SourceType> supportedTypes = {{"pointSource", OpenQuakeSource::PointSource},
+                                                                        {"areaSource", OpenQuakeSource::AreaSource},
+                                                                        {"simpleFaultSource", OpenQuakeSource::SimpleFaultSource},
+                                                                        {"complexFaultSource", OpenQuakeSource::ComplexFaultSource},
+                                                                        {"characteristicFaultSource", OpenQuakeSource::CharacteristicFaultSource}};
+
+    const auto fileSize = file.size();
+    int lastProgress = -1;
+
+    bool foundSourceModel = false;
+
+    // The source that is currently being read
+    OpenQuakeSource source;
+    bool inSource = false;
+    bool inComplexGeometry = false;
+
+    QXmlStreamReader xml(&file);
+
+    while (!xml.atEnd())
+    {
+        auto token = xml.readNext();
+
+        if(token == QXmlStreamReader::EndElement)
+        {
+            if(!inSource)
+                continue;
+
+            auto name = xml.name();
+
+            if(name == QLatin1String("complexFaultGeometry"))
+            {
+                inComplexGeometry = false;
+            }
+            else if(name == source.typeName())
+            {
+                sources.push_back(source);
+                inSource = false;
+
+                if(progress && fileSize > 0 && sources.size() % 1000 == 0)
+                {
+                    auto percent = static_cast<int>(100*file.pos()/fileSize);
+                    if(percent != lastProgress)
+                    {
+                        lastProgress = percent;
+                        progress(percent);
+                    }
+                }
+            }
+
+            continue;
+        }
+
+        if(token != QXmlStreamReader::StartElement)
+            continue;
+
+        auto name = xml.name().toString();
+
+        if(!inSource)
+        {
+            if(name == "sourceModel")
+            {
+                foundSourceModel = true;
+                sourceModelName = xml.attributes().value("name").toString();
+                continue;
+            }
+
+            if(!foundSourceModel || !isSourceElement(xml))
+                continue;
+
+            ++numSourcesInModel;
+
+            auto typeIt = supportedTypes.constFind(name);
+
+            if(typeIt == supportedTypes.constEnd())
+            {
+                if(!unsupportedSourceTypes.contains(name))
+                    unsupportedSourceTypes.append(name);
+
+                xml.skipCurrentElement();
+                continue;
+            }
+
+            auto attributes = xml.attributes();
+
+            source = OpenQuakeSource();
+            source.type = typeIt.value();
+            source.id = attributes.value("id").toString();
+            source.name = attributes.value("name").toString();
+            source.tectonicRegion = attributes.value("tectonicRegion").toString();
+
+            inSource = true;
+            inComplexGeometry = false;
+
+            continue;
+        }
+
+        // Child elements of the current source
+        if(name == "magScaleRel")
+        {
+            source.magScaleRel = xml.readElementText().trimmed();
+        }
+        else if(name == "ruptAspectRatio")
+        {
+            source.ruptAspectRatio = toDouble(xml.readElementText());
+        }
+        else if(name == "upperSeismoDepth")
+        {
+            source.upperSeismoDepth = toDouble(xml.readElementText());
+        }
+        else if(name == "lowerSeismoDepth")
+        {
+            source.lowerSeismoDepth = toDouble(xml.readElementText());
+        }
+        else if(name == "dip")
+        {
+            source.dip = toDouble(xml.readElementText());
+        }
+        else if(name == "rake")
+        {
+            source.rake = toDouble(xml.readElementText());
+        }
+        else if(name == "truncGutenbergRichterMFD")
+        {
+            auto attributes = xml.attributes();
+            source.aValue = toDouble(attributes.value("aValue").toString());
+            source.bValue = toDouble(attributes.value("bValue").toString());
+            source.minMag = toDouble(attributes.value("minMag").toString());
+            source.maxMag = toDouble(attributes.value("maxMag").toString());
+        }
+        else if(name == "incrementalMFD")
+        {
+            source.minMag = toDouble(xml.attributes().value("minMag").toString());
+        }
+        else if(name == "complexFaultGeometry")
+        {
+            inComplexGeometry = true;
+        }
+        else if(name == "faultBottomEdge" || name == "intermediateEdge" || name == "interior")
+        {
+            // Only the top edge of complex faults and the exterior ring of areas are visualized
+            xml.skipCurrentElement();
+        }
+        else if(name == "pos" || name == "posList")
+        {
+            auto srsDimension = xml.attributes().value("srsDimension").toInt();
+
+            auto text = xml.readElementText();
+
+            if(source.posList.isEmpty())
+            {
+                source.posList = text;
+                source.dimension = srsDimension > 0 ? srsDimension : (inComplexGeometry ? 3 : 2);
+            }
+        }
+    }
+
+    if (xml.hasError())
+    {
+        err = "Error parsing the file "+filePath+": "+xml.errorString()+" at line "+QString::number(xml.lineNumber());
+        return -1;
+    }
+
+    if(!foundSourceModel)
+    {
+        err = "Could not find sourceModel tag in .xml file";
+        return -1;
+    }
+
+    if(progress)
+        progress(100);
+
+    return 0;
+}
+
+
+int OpenQuakeSourceModelReader::writeSelectedSources(const QString& inputFile, const QString& outputFile, const QSet<QString>& ids, QString& err)
+{
+    QFile inFile(inputFile);
+    if (!inFile.open(QIODevice::ReadOnly))
+    {
+        err = "Error while loading file "+inputFile;
+        return -1;
+    }
+
+    QFile outFile(outputFile);
+    if(!outFile.open(QIODevice::WriteOnly | QIODevice::Text))
+    {
+        err = "Failed to open file for writing.";
+        return -1;
+    }
+
+    QXmlStreamReader xml(&inFile);
+    QXmlStreamWriter writer(&outFile);
+    writer.setAutoFormatting(true);
+
+    int numWritten = 0;
+
+    while (!xml.atEnd())
+    {
+        auto token = xml.readNext();
+
+        if(token == QXmlStreamReader::StartElement && isSourceElement(xml))
+        {
+            if(!ids.contains(xml.attributes().value("id").toString()))
+            {
+                xml.skipCurrentElement();
+                continue;
+            }
+
+            ++numWritten;
+        }
+
+        // The writer formats the output, drop the whitespace of the input
+        if(token == QXmlStreamReader::Characters && xml.isWhitespace())
+            continue;
+
+        writer.writeCurrentToken(xml);
+    }
+
+    if (xml.hasError())
+    {
+        err = "Error parsing the file "+inputFile+": "+xml.errorString()+" at line "+QString::number(xml.lineNumber());
+        return -1;
+    }
+
+    if(numWritten != ids.size())
+    {
+        err = "Failed to find all of the selected nodes. Export failed!";
+        return -1;
+    }
+
+    return 0;
+}
+
+
+QString OpenQuakeSourceModelReader::getSourceModelName(void) const
+{
+    return sourceModelName;
+}
+
+
+int OpenQuakeSourceModelReader::getNumSourcesInModel(void) const
+{
+    return numSourcesInModel;
+}
+
+
+QStringList OpenQuakeSourceModelReader::getUnsupportedSourceTypes(void) const
+{
+    return unsupportedSourceTypes;
+}
@@ -0,0 +1,118 @@
+#ifndef OPENQUAKESOURCEMODELREADER_H
+#define OPENQUAKESOURCEMODELREADER_H
+/* *****************************************************************************
+Copyright (c) 2016-2021, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+// Written by: Stevan Gavrilovic
+
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+#include <functional>
+
+// A seismic source of an OpenQuake source model
+// The numeric parameters are NaN if they are not given for the source
+struct OpenQuakeSource
+{
+    enum SourceType {PointSource, AreaSource, SimpleFaultSource, ComplexFaultSource, CharacteristicFaultSource};
+
+    SourceType type = PointSource;
+
+    QString id;
+    QString name;
+    QString tectonicRegion;
+    QString magScaleRel;
+
+    double ruptAspectRatio;
+    double upperSeismoDepth;
+    double lowerSeismoDepth;
+    double dip;
+    double rake;
+
+    // Truncated Gutenberg-Richter parameters, or the minimum magnitude of an incremental MFD
+    double aValue;
+    double bValue;
+    double minMag;
+    double maxMag;
+
+    // Raw gml:pos or gml:posList text of the geometry, i.e., the point, the trace of a simple fault, the top edge of a complex fault, or the exterior ring of an area
+    // It is kept as text so that the coordinates can be parsed on worker threads
+    QString posList;
+
+    // Number of values per coordinate in the pos list, i.e., 3 for the edges of complex faults that include the depth
+    int dimension = 2;
+
+    OpenQuakeSource();
+
+    QString typeName(void) const;
+
+    // Parses the pos list into a flat vector of lon/lat pairs, coordinates with a zero lon or lat are skipped
+    int getCoordinates(QVector<double>& lonLat, QString& err) const;
+};
+
+
+// Streaming reader of OpenQuake NRML source model files
+// The file is read in a single pass with a QXmlStreamReader, so memory does not scale with the size of a DOM of the whole model
+class OpenQuakeSourceModelReader
+{
+public:
+    OpenQuakeSourceModelReader();
+
+    // Reads the point, area, simple fault, complex fault and characteristic fault sources in the file
+    // The progress function, if given, is called with the percentage of the file that is read
+    int readSourceModel(const QString& filePath, QVector<OpenQuakeSource>& sources, QString& err, const std::function<void(int)>& progress = nullptr);
+
+    // Writes a copy of the source model that only contains the sources with the given ids, all other elements are kept as is
+    int writeSelectedSources(const QString& inputFile, const QString& outputFile, const QSet<QString>& ids, QString& err);
+
+    QString getSourceModelName(void) const;
+
+    // Number of sources in the last model that was read, including the sources of types that are not supported
+    int getNumSourcesInModel(void) const;
+
+    // The source types in the last model that were not read
+    QStringList getUnsupportedSourceTypes(void) const;
+
+private:
+
+    QString sourceModelName;
+    int numSourcesInModel = 0;
+    QStringList unsupportedSourceTypes;
+};
+
+#endif // OPENQUAKESOURCEMODELREADER_H
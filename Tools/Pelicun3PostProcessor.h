@@ -47,7 +47,6 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 #include <QJsonArray>
 
 #include <memory>
-#include <set>
 
 class REmpiricalProbabilityDistribution;
 class VisualizationWidget;
@@ -113,7 +112,7 @@ public:
         return val;
     }
 
-    void processResultsSubset(const std::set<int>& selectedComponentIDs);
+    void processResultsSubset(const IDRangeSet& selectedComponentIDs);
 
     void setCurrentlyViewable(bool status);
 
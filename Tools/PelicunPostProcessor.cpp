@@ -56,6 +56,7 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 #include <QComboBox>
 #include <QDir>
 #include <QDockWidget>
+#include <QFileDialog>
 #include <QFileInfo>
 #include <QFontMetrics>
 #include <QGraphicsLayout>
@@ -64,6 +65,7 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 #include <QHeaderView>
 #include <QLabel>
 #include <QLineSeries>
+#include <QMenu>
 #include <QMenuBar>
 #include <QPixmap>
 #include <QPrinter>
@@ -197,6 +199,29 @@ PelicunPostProcessor::PelicunPostProcessor(QWidget *parent, VisualizationWidget*
 
     pelicunResultsTableWidget->setItemDelegate(new DoubleDelegate(this,3));
 
+    // Right-click menu to export the table, the rows are streamed from the table into the file
+    pelicunResultsTableWidget->setContextMenuPolicy(Qt::CustomContextMenu);
+    connect(pelicunResultsTableWidget, &QWidget::customContextMenuRequested, this, [this](const QPoint& pos)
+    {
+        QMenu tableMenu;
+        auto exportAction = tableMenu.addAction("Export Table to CSV");
+
+        if(tableMenu.exec(pelicunResultsTableWidget->viewport()->mapToGlobal(pos)) != exportAction)
+            return;
+
+        auto pathToFile = QFileDialog::getSaveFileName(this, tr("Export Table to CSV"), QString(), tr("CSV Files (*.csv)"));
+
+        if(pathToFile.isEmpty())
+            return;
+
+        QString err;
+        TablePrinter tablePrinter;
+        if(tablePrinter.exportToCSV(pelicunResultsTableWidget, pathToFile, err) != 0)
+            ProgramOutputDialog::getInstance()->appendErrorMessage(err);
+        else
+            ProgramOutputDialog::getInstance()->appendText("Exported the table to "+pathToFile);
+    });
+
     // Combo box to select how to sort the table
     QHBoxLayout *comboLayout = new QHBoxLayout();
 
@@ -471,17 +496,25 @@ int PelicunPostProcessor::processDVResults(const QVector<QStringList>& DVResults
     // Vector to hold the attributes
     QVector< QgsAttributes > fieldAttributes(DVResults.size()-numHeaderRows, QgsAttributes(numHeaderColumns));
 
+    // Fetch the replacement costs of all of the buildings in one pass over the database
+    QVector<qint64> buildingIDs;
+    buildingIDs.reserve(DVResults.size()-numHeaderRows);
+
+    for(int i = numHeaderRows; i<DVResults.size(); ++i)
+        buildingIDs.push_back(objectToInt(DVResults.at(i).at(0)));
+
+    // Defaults to 1.0 if no replacement cost is given, i.e., it assumes the repair cost is the loss ratio
+    QVector<double> replacementCosts;
+    QString errMsg;
+    if(!theBuildingDB->getAttributeValues({"ReplacementCost"}, buildingIDs, replacementCosts, errMsg, 1.0))
+        replacementCosts.fill(1.0, buildingIDs.size());
+
     // 4 rows of headers in the results file
     for(int i = numHeaderRows, count = 0; i<DVResults.size(); ++i, ++count)
     {
         auto inputRow = DVResults.at(i);
 
-        auto buildingID = objectToInt(inputRow.at(0));
-
-        // Defaults to 1.0 if no replacement cost is given, i.e., it assumes the repair cost is the loss ratio
-        auto replacementCostVar = theBuildingDB->getAttributeValue(buildingID,"ReplacementCost",QVariant(1.0));
-
-        auto replacementCost = replacementCostVar.toDouble();
+        auto replacementCost = replacementCosts.at(count);
 
         // This assumes that the output from pelicun will not change
         auto IDStr = inputRow.at(0);                                // ID
@@ -602,7 +635,7 @@ int PelicunPostProcessor::processDVResults(const QVector<QStringList>& DVResults
     // Starting editing
     theBuildingDB->startEditing();
 
-    QString errMsg;
+    errMsg.clear();
     auto res = theBuildingDB->addNewComponentAttributes(headerStrings,fieldAttributes,errMsg);
     if(!res)
         throw errMsg;
@@ -848,10 +881,10 @@ int PelicunPostProcessor::printToPDF(const QString& outputPath)
 }
 
 
-void PelicunPostProcessor::processResultsSubset(const std::set<int>& selectedComponentIDs)
+void PelicunPostProcessor::processResultsSubset(const IDRangeSet& selectedComponentIDs)
 {
 
-    if(selectedComponentIDs.empty())
+    if(selectedComponentIDs.isEmpty())
         return;
 
     if(DVdata.size() < numHeaderRows)
@@ -870,37 +903,34 @@ void PelicunPostProcessor::processResultsSubset(const std::set<int>& selectedCom
 
     auto lastID = objectToInt(DVdata.last().at(0));
 
+    // Check that the IDs fall within the bounds of the data
+    if(selectedComponentIDs.first()<firstID || selectedComponentIDs.last()>lastID)
+    {
+        auto id = selectedComponentIDs.first()<firstID ? selectedComponentIDs.first() : selectedComponentIDs.last();
+        QString msg = "ID " + QString::number(id) + " is out of bounds of the results";
+        throw msg;
+    }
+
     QVector<QStringList> DVsubset(&DVdata[0],&DVdata[numHeaderRows]);
 
-    for(auto&& id : selectedComponentIDs)
+    // Single pass over the results, each row is kept if its ID is in the selection
+    IDRangeSet foundIDs;
+    for(int i = numHeaderRows; i<DVdata.size(); ++i)
     {
-        // Check that the ID falls within the bounds of the data
-        if(id<firstID || id>lastID)
-        {
-            QString msg = "ID " + QString::number(id) + " is out of bounds of the results";
-            throw msg;
-        }
+        auto buildingID = objectToInt(DVdata.at(i).at(0));
 
-        auto found = false;
-        for(int i = numHeaderRows; i<DVdata.size(); ++i)
+        if(selectedComponentIDs.contains(buildingID) && !foundIDs.contains(buildingID))
         {
-            auto inputRow = DVdata.at(i);
-
-            auto buildingID = objectToInt(inputRow.at(0));
-
-            if(id == buildingID)
-            {
-                DVsubset << inputRow;
-                found = true;
-                break;
-            }
+            DVsubset << DVdata.at(i);
+            foundIDs.insert(buildingID);
         }
+    }
 
-        if(!found)
-        {
-            QString msg = "ID " + QString::number(id) + " cannot be found in the results";
-            throw msg;
-        }
+    if(foundIDs.size() != selectedComponentIDs.size())
+    {
+        auto missingIDs = selectedComponentIDs.subtracted(foundIDs);
+        QString msg = "ID " + QString::number(missingIDs.first()) + " cannot be found in the results";
+        throw msg;
     }
 
     this->processDVResults(DVsubset);
@@ -915,14 +945,13 @@ int PelicunPostProcessor::assemblePDF(QImage screenShot)
     printer.setPaperSize(QPrinter::Letter);
     printer.setPageMargins(25.4, 25.4, 25.4, 25.4, QPrinter::Millimeter);
     printer.setFullPage(true);
-    qreal leftMargin, topMargin;
-    printer.getPageMargins(&leftMargin,&topMargin,nullptr,nullptr,QPrinter::Point);
     printer.setOutputFileName(outputFilePath);
 
     // Create a new document
     QTextDocument* document = new QTextDocument();
     QTextCursor cursor(document);
-    document->setDocumentMargin(25.4);
+    // The margins of the page are left by laying the document out in the paint rectangle of the page
+    document->setDocumentMargin(0.0);
     document->setDefaultFont(QFont("Helvetica"));
 
     // Define font styles
@@ -1109,8 +1138,8 @@ int PelicunPostProcessor::assemblePDF(QImage screenShot)
 
     cursor.insertText("\n\n",normalFormat);
 
-    // Ratio of the page width that is printable
-    auto useablePageWidth = printer.pageRect(QPrinter::Point).width()-(1.5*leftMargin);
+    // Width of the page inside the margins
+    auto useablePageWidth = printer.pageLayout().paintRect(QPageLayout::Point).width();
 
     QRect viewPortRect(0, mapViewMainWidget->height() - mapViewSubWidget->height(), mapViewSubWidget->width(), mapViewSubWidget->height());
     QImage cropped = screenShot.copy(viewPortRect);
@@ -1194,19 +1223,44 @@ int PelicunPostProcessor::assemblePDF(QImage screenShot)
         cursor.insertText("\nRelative frequency diagram of expected losses.\n",captionFormat);
     }
 
-    cursor.insertText("Individual Asset Results - Sorted According to the " + sortComboBox->currentText() + "\n",boldFormat);
+    // The tables are streamed onto the pages after the document, instead of being added to the document, so that large tables do not exhaust the memory
+    QPainter painter;
+    if(!painter.begin(&printer))
+    {
+        ProgramOutputDialog::getInstance()->appendErrorMessage("Error, could not create the file "+outputFilePath);
+        return -1;
+    }
+
+    // With a full page the origin of the painter is the corner of the paper, so the paint rectangle of the layout is inside the margins
+    auto pageRect = QRectF(printer.pageLayout().paintRectPixels(printer.resolution()));
 
+    QString err;
     TablePrinter prettyTablePrinter;
-    prettyTablePrinter.printToTable(&cursor, pelicunResultsTableWidget,"Asset Results");
+
+    if(prettyTablePrinter.printTextDocument(&painter, &printer, pageRect, document, err) != 0)
+    {
+        ProgramOutputDialog::getInstance()->appendErrorMessage(err);
+        return -1;
+    }
+
+    if(prettyTablePrinter.printTable(&painter, &printer, pageRect, pelicunResultsTableWidget, "Individual Asset Results - Sorted According to the " + sortComboBox->currentText(), err) != 0)
+    {
+        ProgramOutputDialog::getInstance()->appendErrorMessage(err);
+        return -1;
+    }
 
     if(!IMdata.isEmpty())
     {
-        cursor.insertText("Individual Site Responses\n",boldFormat);
-        TablePrinter prettyTablePrinter;
-        prettyTablePrinter.printToTable(&cursor, siteResponseTableWidget,"Site Response Results");
+        printer.newPage();
+
+        if(prettyTablePrinter.printTable(&painter, &printer, pageRect, siteResponseTableWidget, "Individual Site Responses", err) != 0)
+        {
+            ProgramOutputDialog::getInstance()->appendErrorMessage(err);
+            return -1;
+        }
     }
 
-    document->print(&printer);
+    painter.end();
 
     return 0;
 }
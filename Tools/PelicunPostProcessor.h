@@ -46,7 +46,6 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 #include <QMainWindow>
 
 #include <memory>
-#include <set>
 
 class REmpiricalProbabilityDistribution;
 class VisualizationWidget;
@@ -113,7 +112,7 @@ public:
         return val;
     }
 
-    void processResultsSubset(const std::set<int>& selectedComponentIDs);
+    void processResultsSubset(const IDRangeSet& selectedComponentIDs);
 
     void setCurrentlyViewable(bool status);
 
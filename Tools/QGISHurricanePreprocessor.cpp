@@ -37,7 +37,6 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 // Written by: Stevan Gavrilovic
 
 #include "QGISHurricanePreprocessor.h"
-#include "CSVReaderWriter.h"
 #include "QGISVisualizationWidget.h"
 
 #include <qgsfield.h>
@@ -51,6 +50,8 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 #include <QProgressBar>
 #include <QList>
 
+#include <cmath>
+
 QGISHurricanePreprocessor::QGISHurricanePreprocessor(QProgressBar* pBar, QGISVisualizationWidget* visWidget, QObject* parent) : theProgressBar(pBar), theVisualizationWidget(visWidget), theParent(parent)
 {
     allHurricanesLayer = nullptr;
@@ -61,114 +62,46 @@ QGISHurricanePreprocessor::QGISHurricanePreprocessor(QProgressBar* pBar, QGISVis
 }
 
 
-QgsVectorLayer* QGISHurricanePreprocessor::loadHurricaneDatabaseData(const QString &eventFile, QString &err)
+QgsVectorLayer* QGISHurricanePreprocessor::loadHurricaneDatabaseData(const QString &eventFile, QString &err, const HurricaneTrackFilter& filter)
 {
-    CSVReaderWriter csvTool;
-
-    QVector<QStringList> data = csvTool.parseCSVFile(eventFile, err);
+    this->clear();
 
-    if(!err.isEmpty())
-    {
-        return nullptr;
-    }
+    theProgressBar->setMinimum(0);
+    theProgressBar->setMaximum(100);
+    theProgressBar->reset();
+    QApplication::processEvents();
 
-    if(data.empty())
+    // Converting the csv file into the index is only done on the first load, after that the index is memory-mapped
+    auto progress = [this](int percent)
     {
-        err = "Hurricane data is empty";
-        return nullptr;
-    }
-
-    // Get the header information to populate the fields
-    auto headerData = data.at(0);
-
-    auto numCol = headerData.size();
-
-    // Pop off the first two rows that contain the header and units information
-    data.pop_front();
-    data.pop_front();
-
-
-    // Split the hurricanes up as they come in one long list
-    QVectorIterator<QStringList> i(data);
-    QString SID;
+        theProgressBar->setValue(percent);
+        QApplication::processEvents();
+    };
 
-    HurricaneObject hurricane;
-    hurricane.parameterLabels = headerData;
+    trackIndex = std::make_unique<HurricaneTrackIndex>();
 
-    auto indexLandfall = headerData.indexOf("DIST2LAND");
-    auto indexSID = headerData.indexOf("SID");
+    auto res = trackIndex->open(eventFile, err, progress);
 
-    if(indexLandfall == -1 || indexSID == -1)
+    if(res != 0)
     {
-        err = "Could not find the required column indexes in the data file";
+        trackIndex.reset();
         return nullptr;
     }
 
-    // While iterating through the hurricane points, save the data at first landfall
-    bool landfallFound = false;
-    while (i.hasNext())
-    {
-        auto row = i.next();
-
-        if(row.size() != numCol)
-        {
-            err = "Error, inconsistency in the data in the row and number of columns";
-            return nullptr;
-        }
-
-        // Not all hurricanes will make landfall
-        if(!landfallFound)
-        {
-            auto distToLand = row.at(indexLandfall);
-
-            // If the distance to land is 0, then this is the first landfall
-            if(distToLand.compare("0") == 0)
-            {
-                landfallFound = true;
-                hurricane.landfallData = row;
-                hurricane.indexLandfall = hurricane.size();
-            }
-        }
-
-        auto currSID = row.at(indexSID);
+    auto storms = trackIndex->queryStorms(filter);
 
-        if(SID.compare(currSID) != 0)
-        {
-            if(!hurricane.empty())
-            {
-                hurricanes.push_back(hurricane);
-                hurricane.clear();
-                landfallFound = false;
-            }
-
-            SID = currSID;
-        }
+    auto numHurricanes = storms.size();
 
-        hurricane.push_back(row);
+    if(numHurricanes == 0)
+    {
+        err = "No hurricanes in the data file match the filter";
+        return nullptr;
     }
 
-    // Push back the last hurricane
-    if(!hurricane.empty())
-        hurricanes.push_back(hurricane);
-
-    auto numHurricanes = hurricanes.size();
-
-    theProgressBar->setMinimum(0);
     theProgressBar->setMaximum(numHurricanes);
     theProgressBar->reset();
     QApplication::processEvents();
 
-    // Name and storm ID
-    auto indexName = headerData.indexOf("NAME");
-    auto indexSeason = headerData.indexOf("SEASON");
-
-    // Check that the indexes are found
-    if(indexName == -1 || indexSID == -1 || indexSeason == -1)
-    {
-        err = "Error adding a vector layer";
-        return nullptr;
-    }
-
     // Create the hurricane track fields
     QList<QgsField> attrib;
     attrib.append(QgsField("NAME", QVariant::String));
@@ -185,21 +118,25 @@ QgsVectorLayer* QGISHurricanePreprocessor::loadHurricaneDatabaseData(const QStri
 
     featList.reserve(numHurricanes);
 
+    // Tolerance in degrees of the simplified tracks, about 10 km
+    const double trackTolerance = 0.1;
+
+    int numSkipped = 0;
+
     for(int i = 0; i<numHurricanes; ++i)
     {
-        theProgressBar->setValue(i);
-        QApplication::processEvents();
-
-        // Get the hurricane
-        HurricaneObject& hurricane = hurricanes[i];
+        // Only pump the event loop every so often, the tracks are built from the index columns and are quick to create
+        if(i % 500 == 0)
+        {
+            theProgressBar->setValue(i);
+            QApplication::processEvents();
+        }
 
-        auto name = hurricane.front().at(indexName);
-        auto SID = hurricane.front().at(indexSID);
-        auto season = hurricane.front().at(indexSeason);
+        auto storm = storms.at(i);
 
-        hurricane.name = name;
-        hurricane.SID = SID;
-        hurricane.season = season;
+        auto name = trackIndex->getName(storm);
+        auto SID = trackIndex->getSID(storm);
+        auto season = QString::number(trackIndex->getSeason(storm));
         auto nameID = name+"-"+season;
 
         // Create a unique ID for this track
@@ -215,10 +152,14 @@ QgsVectorLayer* QGISHurricanePreprocessor::loadHurricaneDatabaseData(const QStri
 
         QgsFeature feature;
 
-        auto polyline = this->getTrackGeometry(&hurricane, err);
+        auto polyline = this->getSimplifiedTrackGeometry(storm, trackTolerance);
 
+        // Storms without a valid track are left out instead of stopping the load
         if(polyline.isEmpty() || polyline.isNull())
-            return nullptr;
+        {
+            ++numSkipped;
+            continue;
+        }
 
         feature.setGeometry(polyline);
 
@@ -227,6 +168,17 @@ QgsVectorLayer* QGISHurricanePreprocessor::loadHurricaneDatabaseData(const QStri
         featList.push_back(feature);
     }
 
+    theProgressBar->setValue(numHurricanes);
+
+    if(featList.isEmpty())
+    {
+        err = "None of the hurricanes that match the filter have a valid track";
+        return nullptr;
+    }
+
+    if(numSkipped != 0)
+        err = "Skipped " + QString::number(numSkipped) + " hurricanes without a valid track";
+
     // Create the buildings group layer that will hold the sublayers
     allHurricanesLayer = theVisualizationWidget->addVectorLayer("linestring","All Hurricanes");
 
@@ -238,8 +190,8 @@ QgsVectorLayer* QGISHurricanePreprocessor::loadHurricaneDatabaseData(const QStri
 
     auto pr = allHurricanesLayer->dataProvider();
 
-    auto res = pr->addAttributes(attrib);
-    if(!res)
+    auto resAttrb = pr->addAttributes(attrib);
+    if(!resAttrb)
     {
         err = "Error adding attributes";
         theVisualizationWidget->removeLayer(allHurricanesLayer);
@@ -267,6 +219,7 @@ QgsVectorLayer* QGISHurricanePreprocessor::loadHurricaneDatabaseData(const QStri
 void QGISHurricanePreprocessor::clear(void)
 {
     hurricanes.clear();
+    trackIndex.reset();
     allHurricanesLayer = nullptr;
 }
 
@@ -518,13 +471,37 @@ QgsVectorLayer* QGISHurricanePreprocessor::createLandfallVisualization(const dou
 
 HurricaneObject* QGISHurricanePreprocessor::getHurricane(const QString& SID)
 {
-    for(auto&& it : hurricanes)
+    auto it = hurricanes.find(SID);
+
+    if(it != hurricanes.end())
+        return &it.value();
+
+    if(trackIndex == nullptr)
+        return nullptr;
+
+    auto storm = trackIndex->findStorm(SID);
+
+    if(storm == -1)
+        return nullptr;
+
+    HurricaneObject hurricane;
+
+    QString err;
+    if(trackIndex->loadHurricane(storm, hurricane, err) != 0)
     {
-        if(SID.compare(it.SID) == 0)
-            return &it;
+        qDebug()<<err;
+        return nullptr;
     }
 
-    return nullptr;
+    it = hurricanes.insert(SID, hurricane);
+
+    return &it.value();
+}
+
+
+HurricaneTrackIndex* QGISHurricanePreprocessor::getTrackIndex(void) const
+{
+    return trackIndex.get();
 }
 
 
@@ -595,3 +572,46 @@ QgsGeometry QGISHurricanePreprocessor::getTrackGeometry(HurricaneObject* hurrica
 
     return geom;
 }
+
+
+QgsGeometry QGISHurricanePreprocessor::getSimplifiedTrackGeometry(const int storm, const double tolerance)
+{
+    auto numPnts = trackIndex->getNumTrackPoints(storm);
+    auto lats = trackIndex->getLatitudes(storm);
+    auto lons = trackIndex->getLongitudes(storm);
+
+    const double tolSquared = tolerance*tolerance;
+
+    // Each item in the columns is a point on the hurricane track
+    QgsPolylineXY polyLine;
+
+    QgsPointXY lastPoint;
+    int lastIndex = -1;
+
+    for(int j = 0; j<numPnts; ++j)
+    {
+        auto latitude = lats[j];
+        auto longitude = lons[j];
+
+        // Missing values are NaN in the index
+        if(std::isnan(latitude) || std::isnan(longitude) || latitude == 0.0f || longitude == 0.0f)
+            continue;
+
+        QgsPointXY point(longitude,latitude);
+
+        if(polyLine.isEmpty() || point.sqrDist(polyLine.back()) >= tolSquared)
+            polyLine.push_back(point);
+
+        lastPoint = point;
+        lastIndex = j;
+    }
+
+    // Always end the track at its last point
+    if(lastIndex != -1 && !(polyLine.back() == lastPoint))
+        polyLine.push_back(lastPoint);
+
+    if(polyLine.size() < 2)
+        return QgsGeometry();
+
+    return QgsGeometry::fromPolylineXY(polyLine);
+}
@@ -39,6 +39,7 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 // Written by: Stevan Gavrilovic
 
 #include "HurricaneObject.h"
+#include "HurricaneTrackIndex.h"
 
 class QGISVisualizationWidget;
 
@@ -46,11 +47,14 @@ class QGISVisualizationWidget;
 
 class QgsVectorLayer;
 
+#include <QMap>
 #include <QString>
 #include <QStringList>
 #include <QVector>
 #include <QVariant>
 
+#include <memory>
+
 class QObject;
 class QProgressBar;
 
@@ -59,13 +63,17 @@ class QGISHurricanePreprocessor
 public:
     QGISHurricanePreprocessor(QProgressBar* pBar, QGISVisualizationWidget* visWidget, QObject* parent);
 
-    QgsVectorLayer* loadHurricaneDatabaseData(const QString &eventFile, QString &err);
+    // Loads the tracks of the storms in an IBTrACS csv file that pass the filter, the csv file is converted into a binary index on the first load
+    QgsVectorLayer* loadHurricaneDatabaseData(const QString &eventFile, QString &err, const HurricaneTrackFilter& filter = HurricaneTrackFilter());
 
     void clear(void);
 
-    // Gets the hurricane of the given storm id
+    // Gets the hurricane of the given storm id, the full track data is read from the csv file the first time that a storm is requested
     HurricaneObject* getHurricane(const QString& SID);
 
+    // Returns the index of the loaded database, or nullptr if no database is loaded
+    HurricaneTrackIndex* getTrackIndex(void) const;
+
     QgsVectorLayer *getAllHurricanesLayer() const;
 
    // Creates a hurricane visualization of the track and track points if desired
@@ -81,11 +89,19 @@ public:
 private:
 
     QgsGeometry getTrackGeometry(HurricaneObject* hurricane, QString& err);
+
+    // Creates a simplified track geometry from the lat/lon columns of the index for the layer of all storms
+    // Points closer than the tolerance in degrees to the last kept point are dropped and missing points are skipped, the full track is only built when a storm is selected
+    QgsGeometry getSimplifiedTrackGeometry(const int storm, const double tolerance);
+
     QgsVectorLayer* allHurricanesLayer;
     QProgressBar* theProgressBar;
     QGISVisualizationWidget* theVisualizationWidget;
     QObject* theParent;
-    QVector<HurricaneObject> hurricanes;
+    std::unique_ptr<HurricaneTrackIndex> trackIndex;
+
+    // The hurricanes that were requested so far, keyed by their SID
+    QMap<QString, HurricaneObject> hurricanes;
 };
 
 #endif // QGISHurricanePreprocessor_H
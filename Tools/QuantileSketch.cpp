@@ -0,0 +1,293 @@
+/* *****************************************************************************
+Copyright (c) 2016-2021, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+// Written by: Stevan Gavrilovic
+
+#include "QuantileSketch.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+QuantileSketch::QuantileSketch(int k) : k(std::max(k,8))
+{
+    levels.resize(1);
+}
+
+
+void QuantileSketch::add(const double& value)
+{
+    if(std::isnan(value))
+        return;
+
+    if(n == 0)
+    {
+        minVal = value;
+        maxVal = value;
+    }
+    else
+    {
+        minVal = std::min(minVal,value);
+        maxVal = std::max(maxVal,value);
+    }
+
+    ++n;
+
+    levels[0].push_back(value);
+
+    if(static_cast<int>(levels[0].size()) >= capacity(0))
+        this->compress();
+}
+
+
+void QuantileSketch::merge(const QuantileSketch& other)
+{
+    if(other.n == 0)
+        return;
+
+    if(n == 0)
+    {
+        minVal = other.minVal;
+        maxVal = other.maxVal;
+    }
+    else
+    {
+        minVal = std::min(minVal,other.minVal);
+        maxVal = std::max(maxVal,other.maxVal);
+    }
+
+    n += other.n;
+
+    if(levels.size() < other.levels.size())
+        levels.resize(other.levels.size());
+
+    for(size_t i = 0; i<other.levels.size(); ++i)
+        levels[i].insert(levels[i].end(), other.levels[i].begin(), other.levels[i].end());
+
+    this->compress();
+}
+
+
+double QuantileSketch::quantile(const double& q) const
+{
+    return this->quantiles(QVector<double>{q}).first();
+}
+
+
+QVector<double> QuantileSketch::quantiles(const QVector<double>& qs) const
+{
+    QVector<double> vals(qs.size(), std::numeric_limits<double>::quiet_NaN());
+
+    if(n == 0)
+        return vals;
+
+    std::vector<std::pair<double,qint64>> samples;
+    this->getWeightedSamples(samples);
+
+    qint64 totalWeight = 0;
+    for(auto&& it : samples)
+        totalWeight += it.second;
+
+    for(int j = 0; j<qs.size(); ++j)
+    {
+        auto q = qs.at(j);
+
+        if(q <= 0.0)
+        {
+            vals[j] = minVal;
+            continue;
+        }
+
+        if(q >= 1.0)
+        {
+            vals[j] = maxVal;
+            continue;
+        }
+
+        const double target = q*totalWeight;
+
+        qint64 cumWeight = 0;
+        for(auto&& it : samples)
+        {
+            cumWeight += it.second;
+            if(cumWeight >= target)
+            {
+                vals[j] = it.first;
+                break;
+            }
+        }
+    }
+
+    return vals;
+}
+
+
+double QuantileSketch::rank(const double& value) const
+{
+    if(n == 0)
+        return 0.0;
+
+    qint64 weightBelow = 0;
+    qint64 totalWeight = 0;
+    for(size_t i = 0; i<levels.size(); ++i)
+    {
+        const qint64 weight = qint64(1) << i;
+        for(auto&& it : levels[i])
+        {
+            totalWeight += weight;
+            if(it <= value)
+                weightBelow += weight;
+        }
+    }
+
+    return static_cast<double>(weightBelow)/totalWeight;
+}
+
+
+qint64 QuantileSketch::count(void) const
+{
+    return n;
+}
+
+
+double QuantileSketch::min(void) const
+{
+    return minVal;
+}
+
+
+double QuantileSketch::max(void) const
+{
+    return maxVal;
+}
+
+
+bool QuantileSketch::isEmpty(void) const
+{
+    return n == 0;
+}
+
+
+void QuantileSketch::clear(void)
+{
+    n = 0;
+    minVal = 0.0;
+    maxVal = 0.0;
+    levels.clear();
+    levels.resize(1);
+}
+
+
+int QuantileSketch::getK(void) const
+{
+    return k;
+}
+
+
+int QuantileSketch::capacity(const int& level) const
+{
+    // The top level has a capacity of k, and each level below it has 2/3 of the capacity of the level above it
+    const int depth = static_cast<int>(levels.size()) - level - 1;
+
+    return std::max(2, static_cast<int>(std::ceil(k*std::pow(2.0/3.0,depth))));
+}
+
+
+int QuantileSketch::retainedSize(void) const
+{
+    int size = 0;
+    for(auto&& it : levels)
+        size += static_cast<int>(it.size());
+
+    return size;
+}
+
+
+void QuantileSketch::compress(void)
+{
+    for(size_t h = 0; h<levels.size(); ++h)
+    {
+        if(static_cast<int>(levels[h].size()) < capacity(static_cast<int>(h)))
+            continue;
+
+        if(h+1 == levels.size())
+            levels.emplace_back();
+
+        auto& level = levels[h];
+        auto& nextLevel = levels[h+1];
+
+        std::sort(level.begin(), level.end());
+
+        // Keep one item at this level if the number of items is odd, so that the total weight is preserved
+        double leftover = 0.0;
+        bool hasLeftover = level.size() % 2 == 1;
+        if(hasLeftover)
+        {
+            leftover = level.back();
+            level.pop_back();
+        }
+
+        // Xorshift to choose whether the even or odd items are promoted
+        rngState ^= rngState << 13;
+        rngState ^= rngState >> 17;
+        rngState ^= rngState << 5;
+        const size_t offset = rngState & 1;
+
+        for(size_t i = offset; i<level.size(); i += 2)
+            nextLevel.push_back(level[i]);
+
+        level.clear();
+
+        if(hasLeftover)
+            level.push_back(leftover);
+    }
+}
+
+
+void QuantileSketch::getWeightedSamples(std::vector<std::pair<double,qint64>>& samples) const
+{
+    samples.clear();
+    samples.reserve(this->retainedSize());
+
+    for(size_t i = 0; i<levels.size(); ++i)
+    {
+        const qint64 weight = qint64(1) << i;
+        for(auto&& it : levels[i])
+            samples.push_back(std::make_pair(it,weight));
+    }
+
+    std::sort(samples.begin(), samples.end());
+}
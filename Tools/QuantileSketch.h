@@ -0,0 +1,104 @@
+#ifndef QUANTILESKETCH_H
+#define QUANTILESKETCH_H
+/* *****************************************************************************
+Copyright (c) 2016-2021, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+// Written by: Stevan Gavrilovic
+
+#include <QVector>
+
+#include <vector>
+
+// Mergeable streaming quantile sketch, after Karnin, Lang and Liberty (2016), "Optimal Quantile Approximation in Streams"
+// Keeps a hierarchy of compactors whose capacities shrink geometrically towards the lower levels, so that the memory is bounded by roughly 3k values regardless of the number of samples
+// The sketch is exact until more than k values are added. Sketches with the same k can be merged, e.g., when the samples are processed in parallel chunks
+class QuantileSketch
+{
+public:
+    explicit QuantileSketch(int k = 200);
+
+    void add(const double& value);
+
+    // Adds all of the values of the other sketch to this sketch
+    void merge(const QuantileSketch& other);
+
+    // Returns the approximate value at the quantile q, where q is in the range [0,1]
+    double quantile(const double& q) const;
+
+    // Returns the values at many quantiles with a single pass over the sketch
+    QVector<double> quantiles(const QVector<double>& qs) const;
+
+    // Returns the approximate rank of the value normalized to the range [0,1], i.e., the fraction of samples that are less than or equal to the value
+    double rank(const double& value) const;
+
+    qint64 count(void) const;
+
+    double min(void) const;
+
+    double max(void) const;
+
+    bool isEmpty(void) const;
+
+    void clear(void);
+
+    int getK(void) const;
+
+private:
+
+    void compress(void);
+
+    int capacity(const int& level) const;
+
+    int retainedSize(void) const;
+
+    // Samples sorted by value with their weights
+    void getWeightedSamples(std::vector<std::pair<double,qint64>>& samples) const;
+
+    int k;
+
+    qint64 n = 0;
+
+    double minVal = 0.0;
+    double maxVal = 0.0;
+
+    // Level i holds samples with a weight of 2^i
+    std::vector<std::vector<double>> levels;
+
+    // Deterministic random state so that the sketch is reproducible
+    quint32 rngState = 2463534242;
+};
+
+#endif // QUANTILESKETCH_H
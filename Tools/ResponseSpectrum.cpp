@@ -0,0 +1,173 @@
+/* *****************************************************************************
+Copyright (c) 2016-2021, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+// Written by: Stevan Gavrilovic
+
+#include "ResponseSpectrum.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+ResponseSpectrum::ResponseSpectrum()
+{
+
+}
+
+
+int ResponseSpectrum::compute(const QVector<double>& acceleration, const double dT, const QVector<double>& periods, const QVector<double>& dampingRatios, QVector<double>& spectralAccelerations, QString& err)
+{
+    spectralAccelerations.clear();
+
+    if(dT <= 0.0)
+    {
+        err = "Error, the time step of the record must be greater than zero to compute the response spectrum";
+        return -1;
+    }
+
+    if(acceleration.size() < 2)
+    {
+        err = "Error, the record needs at least two points to compute the response spectrum";
+        return -1;
+    }
+
+    for(auto&& it : dampingRatios)
+    {
+        if(it < 0.0 || it >= 1.0)
+        {
+            err = "Error, the damping ratio "+QString::number(it)+" must be in the range [0, 1) to compute the response spectrum";
+            return -1;
+        }
+    }
+
+    const int numPeriods = periods.size();
+    const int numOscillators = numPeriods*dampingRatios.size();
+
+    spectralAccelerations.fill(0.0, numOscillators);
+
+    double pga = 0.0;
+    for(auto&& it : acceleration)
+        pga = std::max(pga, std::fabs(it));
+
+    // Coefficients of the recursion for each oscillator, [u, v]_{i+1} = A [u, v]_i + B [a_i, a_{i+1}]
+    // The oscillators are stored as structures of arrays so that the loop over them in each time step can be vectorized
+    std::vector<double> a11(numOscillators, 0.0), a12(numOscillators, 0.0), a21(numOscillators, 0.0), a22(numOscillators, 0.0);
+    std::vector<double> b11(numOscillators, 0.0), b12(numOscillators, 0.0), b21(numOscillators, 0.0), b22(numOscillators, 0.0);
+    std::vector<double> omegaSquared(numOscillators, 0.0);
+
+    for(int i = 0; i<dampingRatios.size(); ++i)
+    {
+        const double zeta = dampingRatios.at(i);
+
+        for(int j = 0; j<numPeriods; ++j)
+        {
+            const auto k = i*numPeriods + j;
+
+            const double period = periods.at(j);
+
+            // The coefficients stay zero for a period of zero, the peak ground acceleration is set below
+            if(period <= 0.0)
+                continue;
+
+            const double w = 2.0*M_PI/period;
+            const double sqrtTerm = std::sqrt(1.0 - zeta*zeta);
+            const double wd = w*sqrtTerm;
+
+            const double E = std::exp(-zeta*w*dT);
+            const double S = std::sin(wd*dT);
+            const double C = std::cos(wd*dT);
+
+            const double w2 = w*w;
+            const double w3 = w2*w;
+
+            const double t1 = (2.0*zeta*zeta - 1.0)/(w2*dT);
+            const double t2 = 2.0*zeta/(w3*dT);
+
+            a11[k] = E*(zeta/sqrtTerm*S + C);
+            a12[k] = E*S/wd;
+            a21[k] = -w/sqrtTerm*E*S;
+            a22[k] = E*(C - zeta/sqrtTerm*S);
+
+            b11[k] = E*((t1 + zeta/w)*S/wd + (t2 + 1.0/w2)*C) - t2;
+            b12[k] = -E*(t1*S/wd + t2*C) - 1.0/w2 + t2;
+            b21[k] = E*((t1 + zeta/w)*(C - zeta/sqrtTerm*S) - (t2 + 1.0/w2)*(wd*S + zeta*w*C)) + 1.0/(w2*dT);
+            b22[k] = -E*(t1*(C - zeta/sqrtTerm*S) - t2*(wd*S + zeta*w*C)) - 1.0/(w2*dT);
+
+            omegaSquared[k] = w2;
+        }
+    }
+
+    std::vector<double> u(numOscillators, 0.0), v(numOscillators, 0.0), peak(numOscillators, 0.0);
+
+    double* const uPtr = u.data();
+    double* const vPtr = v.data();
+    double* const peakPtr = peak.data();
+
+    const int numSteps = acceleration.size() - 1;
+    for(int n = 0; n<numSteps; ++n)
+    {
+        const double ag0 = acceleration.at(n);
+        const double ag1 = acceleration.at(n+1);
+
+        for(int k = 0; k<numOscillators; ++k)
+        {
+            const double uNext = a11[k]*uPtr[k] + a12[k]*vPtr[k] + b11[k]*ag0 + b12[k]*ag1;
+            const double vNext = a21[k]*uPtr[k] + a22[k]*vPtr[k] + b21[k]*ag0 + b22[k]*ag1;
+
+            uPtr[k] = uNext;
+            vPtr[k] = vNext;
+            peakPtr[k] = std::max(peakPtr[k], std::fabs(uNext));
+        }
+    }
+
+    for(int i = 0; i<dampingRatios.size(); ++i)
+    {
+        for(int j = 0; j<numPeriods; ++j)
+        {
+            const auto k = i*numPeriods + j;
+
+            spectralAccelerations[k] = periods.at(j) <= 0.0 ? pga : omegaSquared[k]*peak[k];
+        }
+    }
+
+    return 0;
+}
+
+
+QVector<double> ResponseSpectrum::getDefaultPeriods(void)
+{
+    return {0.01, 0.02, 0.03, 0.05, 0.075, 0.1, 0.15, 0.2, 0.25, 0.3, 0.4, 0.5, 0.75, 1.0, 1.5, 2.0, 3.0, 4.0, 5.0, 7.5, 10.0};
+}
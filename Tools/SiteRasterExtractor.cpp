@@ -0,0 +1,470 @@
+/* *****************************************************************************
+Copyright (c) 2016-2021, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+// Written by: Stevan Gavrilovic
+
+#include "SiteRasterExtractor.h"
+#include "CSVReaderWriter.h"
+
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QHash>
+#include <QtConcurrent/QtConcurrent>
+
+#include <qgscoordinatereferencesystem.h>
+#include <qgscoordinatetransform.h>
+#include <qgscsexception.h>
+#include <qgsproject.h>
+#include <qgsproviderregistry.h>
+#include <qgsrasterblock.h>
+#include <qgsrasterdataprovider.h>
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+
+SiteRasterExtractor::SiteRasterExtractor()
+{
+
+}
+
+
+void SiteRasterExtractor::addBinding(const SiteRasterBinding& binding)
+{
+    bindings.push_back(binding);
+}
+
+
+void SiteRasterExtractor::clearBindings(void)
+{
+    bindings.clear();
+}
+
+
+QVector<SiteRasterBinding> SiteRasterExtractor::getBindings() const
+{
+    return bindings;
+}
+
+
+void SiteRasterExtractor::setTileSize(int value)
+{
+    if(value > 0)
+        tileSize = value;
+}
+
+
+void SiteRasterExtractor::setSiteCrs(const QString& authId)
+{
+    siteCrsAuthId = authId;
+}
+
+
+QStringList SiteRasterExtractor::getLog() const
+{
+    return log;
+}
+
+
+int SiteRasterExtractor::extract(const QString& siteFile, const QString& outputFile, QString& err)
+{
+    log.clear();
+
+    QElapsedTimer timer;
+    timer.start();
+
+    CSVReaderWriter csvTool;
+
+    auto data = csvTool.parseCSVFile(siteFile, err);
+
+    if(!err.isEmpty())
+        return -1;
+
+    if(data.size() < 2)
+    {
+        err = "The site file " + siteFile + " does not contain any sites";
+        return -1;
+    }
+
+    auto header = data.first();
+
+    auto latIndex = header.indexOf("Latitude");
+    auto lonIndex = header.indexOf("Longitude");
+
+    if(latIndex == -1 || lonIndex == -1)
+    {
+        err = "The site file " + siteFile + " must contain the columns 'Latitude' and 'Longitude'";
+        return -1;
+    }
+
+    auto numSites = data.size()-1;
+
+    QVector<double> latitudes(numSites);
+    QVector<double> longitudes(numSites);
+
+    for(int i = 0; i<numSites; ++i)
+    {
+        const auto& row = data.at(i+1);
+
+        if(row.size() != header.size())
+        {
+            err = "Inconsistent number of columns in row " + QString::number(i+2) + " of the site file " + siteFile;
+            return -1;
+        }
+
+        bool OK1, OK2;
+        latitudes[i] = row.at(latIndex).toDouble(&OK1);
+        longitudes[i] = row.at(lonIndex).toDouble(&OK2);
+
+        if(!OK1 || !OK2)
+        {
+            err = "Could not read the latitude and longitude in row " + QString::number(i+2) + " of the site file " + siteFile;
+            return -1;
+        }
+    }
+
+    auto readMsg = "Read " + QString::number(numSites) + " sites from " + QFileInfo(siteFile).fileName() + " in " + QString::number(timer.restart()) + " ms";
+
+    QVector<QVector<double>> values;
+    auto res = this->sample(longitudes, latitudes, values, err);
+
+    if(res != 0)
+        return res;
+
+    log.prepend(readMsg);
+
+    timer.restart();
+
+    // Add or overwrite the parameter columns
+    for(int j = 0; j<bindings.size(); ++j)
+    {
+        const auto& colName = bindings.at(j).columnName;
+        const auto& colVals = values.at(j);
+
+        auto colIndex = header.indexOf(colName);
+
+        if(colIndex == -1)
+        {
+            header.append(colName);
+            data.first().append(colName);
+
+            for(int i = 0; i<numSites; ++i)
+                data[i+1].append(QString::number(colVals.at(i)));
+        }
+        else
+        {
+            for(int i = 0; i<numSites; ++i)
+                data[i+1][colIndex] = QString::number(colVals.at(i));
+        }
+    }
+
+    res = csvTool.saveCSVFile(data, outputFile, err);
+
+    if(res != 0)
+        return res;
+
+    log.append("Wrote the site file " + QFileInfo(outputFile).fileName() + " in " + QString::number(timer.elapsed()) + " ms");
+
+    return 0;
+}
+
+
+int SiteRasterExtractor::sample(const QVector<double>& longitudes, const QVector<double>& latitudes, QVector<QVector<double>>& values, QString& err)
+{
+    log.clear();
+
+    if(longitudes.size() != latitudes.size())
+    {
+        err = "The number of longitudes and latitudes are not equal";
+        return -1;
+    }
+
+    if(bindings.empty())
+    {
+        err = "No rasters were provided to sample";
+        return -1;
+    }
+
+    QgsCoordinateReferenceSystem siteCrs(siteCrsAuthId);
+
+    if(!siteCrs.isValid())
+    {
+        err = "The site coordinate reference system " + siteCrsAuthId + " is not valid";
+        return -1;
+    }
+
+    QElapsedTimer timer;
+
+    // One job per raster, each worker opens a data provider of its own so that the rasters can be read at the same time
+    // The providers that are opened here only check the rasters and find their CRS, they are not used off of this thread
+    struct RasterJob
+    {
+        SiteRasterBinding binding;
+        QString crsKey;
+        QVector<double> values;
+        QString err;
+        qint64 elapsed = 0;
+        int numTiles = 0;
+    };
+
+    std::vector<RasterJob> jobs(bindings.size());
+
+    // Site coordinates transformed to the CRS of the rasters, keyed by the CRS so that the sites are transformed once per CRS
+    QHash<QString, QPair<QVector<double>,QVector<double>>> transformedSites;
+
+    for(int j = 0; j<bindings.size(); ++j)
+    {
+        auto& job = jobs[j];
+        job.binding = bindings.at(j);
+
+        if(!QFileInfo::exists(job.binding.rasterPath))
+        {
+            err = "The raster file " + job.binding.rasterPath + " for the column " + job.binding.columnName + " does not exist";
+            return -1;
+        }
+
+        QgsDataProvider::ProviderOptions options;
+        auto provider = dynamic_cast<QgsRasterDataProvider*>(QgsProviderRegistry::instance()->createProvider("gdal", job.binding.rasterPath, options));
+
+        if(provider == nullptr || !provider->isValid())
+        {
+            delete provider;
+            err = "Failed to open the raster file " + job.binding.rasterPath;
+            return -1;
+        }
+
+        std::unique_ptr<QgsRasterDataProvider> checkProvider(provider);
+
+        if(job.binding.band < 1 || job.binding.band > provider->bandCount())
+        {
+            err = "Error, the band number given " + QString::number(job.binding.band) + " for the column " + job.binding.columnName + " is not in the range of the bands in the raster: 1 to " + QString::number(provider->bandCount());
+            return -1;
+        }
+
+        // A raster without a CRS is assumed to be in the CRS of the sites
+        auto rasterCrs = provider->crs().isValid() ? provider->crs() : siteCrs;
+
+        checkProvider.reset();
+
+        job.crsKey = rasterCrs.toWkt();
+
+        if(transformedSites.contains(job.crsKey))
+            continue;
+
+        timer.start();
+
+        QVector<double> x, y;
+        auto res = this->transformSites(rasterCrs, longitudes, latitudes, x, y, err);
+
+        if(res != 0)
+            return res;
+
+        transformedSites.insert(job.crsKey, qMakePair(x,y));
+
+        log.append("Transformed " + QString::number(x.size()) + " sites to " + rasterCrs.userFriendlyIdentifier() + " in " + QString::number(timer.elapsed()) + " ms");
+    }
+
+    const auto& sites = transformedSites;
+
+    QtConcurrent::blockingMap(jobs, [this, &sites](RasterJob& job)
+    {
+        QElapsedTimer jobTimer;
+        jobTimer.start();
+
+        const auto& coords = *sites.constFind(job.crsKey);
+
+        QgsDataProvider::ProviderOptions workerOptions;
+        std::unique_ptr<QgsRasterDataProvider> provider(dynamic_cast<QgsRasterDataProvider*>(QgsProviderRegistry::instance()->createProvider("gdal", job.binding.rasterPath, workerOptions)));
+
+        if(provider == nullptr || !provider->isValid())
+        {
+            job.err = "Failed to open the raster file " + job.binding.rasterPath;
+            return;
+        }
+
+        this->sampleRaster(provider.get(), job.binding, coords.first, coords.second, job.values, job.numTiles, job.err);
+
+        job.elapsed = jobTimer.elapsed();
+    });
+
+    values.clear();
+    values.reserve(bindings.size());
+
+    for(auto&& job : jobs)
+    {
+        if(!job.err.isEmpty())
+        {
+            err = job.err;
+            return -1;
+        }
+
+        // Sites outside of the raster or on a no-data pixel are reported rather than silently given a value
+        auto numMissing = std::count_if(job.values.begin(), job.values.end(), [](const double val) { return std::isnan(val); });
+
+        log.append("Sampled " + QFileInfo(job.binding.rasterPath).fileName() + " (band " + QString::number(job.binding.band) + ") into column " + job.binding.columnName + ": "
+                   + QString::number(job.values.size()) + " sites, " + QString::number(job.numTiles) + " tiles read in " + QString::number(job.elapsed) + " ms"
+                   + (numMissing > 0 ? ", " + QString::number(numMissing) + " sites without a value" : QString()));
+
+        values.push_back(job.values);
+    }
+
+    return 0;
+}
+
+
+int SiteRasterExtractor::transformSites(const QgsCoordinateReferenceSystem& destCrs, const QVector<double>& longitudes, const QVector<double>& latitudes, QVector<double>& x, QVector<double>& y, QString& err)
+{
+    x = longitudes;
+    y = latitudes;
+
+    QgsCoordinateReferenceSystem siteCrs(siteCrsAuthId);
+
+    if(siteCrs == destCrs)
+        return 0;
+
+    QVector<double> z(x.size(), 0.0);
+
+    QgsCoordinateTransform transform(siteCrs, destCrs, QgsProject::instance()->transformContext());
+
+    try
+    {
+        transform.transformCoords(x.size(), x.data(), y.data(), z.data());
+    }
+    catch (QgsCsException &e)
+    {
+        err = "Error transforming the site coordinates to " + destCrs.userFriendlyIdentifier() + ": " + e.what();
+        return -1;
+    }
+
+    return 0;
+}
+
+
+int SiteRasterExtractor::sampleRaster(QgsRasterDataProvider* provider, const SiteRasterBinding& binding, const QVector<double>& x, const QVector<double>& y, QVector<double>& values, int& numTiles, QString& err)
+{
+    const auto numSites = x.size();
+
+    values.fill(binding.noDataValue, numSites);
+    numTiles = 0;
+
+    const auto extent = provider->extent();
+    const int xSize = provider->xSize();
+    const int ySize = provider->ySize();
+
+    if(xSize <= 0 || ySize <= 0)
+    {
+        err = "The raster " + binding.rasterPath + " has no pixels";
+        return -1;
+    }
+
+    const double xRes = extent.width()/xSize;
+    const double yRes = extent.height()/ySize;
+
+    const int numTilesX = (xSize + tileSize - 1)/tileSize;
+
+    // Pixel of each site, and the tile that the pixel falls into
+    QVector<int> pixelRow(numSites), pixelCol(numSites);
+    std::vector<std::pair<qint64,int>> tileOfSite;
+    tileOfSite.reserve(numSites);
+
+    for(int i = 0; i<numSites; ++i)
+    {
+        // Check the pixel coordinates before the cast to int, a NaN or out of range value cannot be cast
+        const double colPos = std::floor((x.at(i) - extent.xMinimum())/xRes);
+        const double rowPos = std::floor((extent.yMaximum() - y.at(i))/yRes);
+
+        // Site is outside of the raster
+        if(std::isnan(colPos) || std::isnan(rowPos) || colPos < 0.0 || colPos >= xSize || rowPos < 0.0 || rowPos >= ySize)
+            continue;
+
+        const int col = static_cast<int>(colPos);
+        const int row = static_cast<int>(rowPos);
+
+        pixelRow[i] = row;
+        pixelCol[i] = col;
+
+        qint64 tileId = static_cast<qint64>(row/tileSize)*numTilesX + col/tileSize;
+        tileOfSite.push_back(std::make_pair(tileId,i));
+    }
+
+    // Group the sites by tile so that each tile is read only once
+    std::sort(tileOfSite.begin(), tileOfSite.end());
+
+    size_t start = 0;
+    while(start < tileOfSite.size())
+    {
+        auto tileId = tileOfSite[start].first;
+
+        size_t end = start;
+        while(end < tileOfSite.size() && tileOfSite[end].first == tileId)
+            ++end;
+
+        const int row0 = static_cast<int>(tileId/numTilesX)*tileSize;
+        const int col0 = static_cast<int>(tileId%numTilesX)*tileSize;
+        const int width = std::min(tileSize, xSize - col0);
+        const int height = std::min(tileSize, ySize - row0);
+
+        QgsRectangle tileExtent(extent.xMinimum() + col0*xRes, extent.yMaximum() - (row0+height)*yRes,
+                                extent.xMinimum() + (col0+width)*xRes, extent.yMaximum() - row0*yRes);
+
+        std::unique_ptr<QgsRasterBlock> block(provider->block(binding.band, tileExtent, width, height));
+
+        ++numTiles;
+
+        if(block == nullptr || !block->isValid())
+        {
+            err = "Failed to read a block of the raster " + binding.rasterPath;
+            return -1;
+        }
+
+        for(size_t k = start; k<end; ++k)
+        {
+            auto i = tileOfSite[k].second;
+
+            auto r = pixelRow.at(i) - row0;
+            auto c = pixelCol.at(i) - col0;
+
+            if(block->isNoData(r,c))
+                continue;
+
+            values[i] = block->value(r,c);
+        }
+
+        start = end;
+    }
+
+    return 0;
+}
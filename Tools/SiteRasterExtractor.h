@@ -0,0 +1,110 @@
+#ifndef SITERASTEREXTRACTOR_H
+#define SITERASTEREXTRACTOR_H
+/* *****************************************************************************
+Copyright (c) 2016-2021, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+// Written by: Stevan Gavrilovic
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+#include <limits>
+
+class QgsCoordinateReferenceSystem;
+class QgsRasterDataProvider;
+
+// Binds a column of the site file to a band of a raster file
+// Note that band numbers start from 1 and not 0!
+struct SiteRasterBinding
+{
+    QString columnName;
+    QString rasterPath;
+    int band = 1;
+
+    // Value given to sites that fall outside of the raster or on a no-data pixel, NaN unless the user gives one
+    double noDataValue = std::numeric_limits<double>::quiet_NaN();
+};
+
+
+// Samples several rasters at the sites of a site file (nearest pixel) and writes the enriched site file
+// Site coordinates are reprojected once per raster CRS, and each raster is read block-by-block in tiles instead of one provider call per site
+// The rasters are processed in parallel, each on its own data provider
+class SiteRasterExtractor
+{
+public:
+    SiteRasterExtractor();
+
+    void addBinding(const SiteRasterBinding& binding);
+
+    void clearBindings(void);
+
+    QVector<SiteRasterBinding> getBindings() const;
+
+    // Size of the raster tiles in pixels, i.e., tileSize x tileSize pixels are read from the provider at a time
+    void setTileSize(int value);
+
+    // The coordinate reference system of the site latitude and longitude, by default EPSG:4326
+    void setSiteCrs(const QString& authId);
+
+    // Reads the site file, samples all of the rasters and writes the enriched site file to outputFile
+    // Existing columns with the same name as a binding are overwritten, otherwise a new column is appended
+    // Returns 0 on success and -1 on failure, with the error message in err
+    int extract(const QString& siteFile, const QString& outputFile, QString& err);
+
+    // Samples all of the rasters at the given coordinates, returns one vector of values per binding in the order the bindings were added
+    int sample(const QVector<double>& longitudes, const QVector<double>& latitudes, QVector<QVector<double>>& values, QString& err);
+
+    // Timing and status messages from the last call to extract or sample, one line per raster
+    QStringList getLog() const;
+
+private:
+
+    // Nearest pixel sampling of one band, the coordinates must already be in the CRS of the raster
+    int sampleRaster(QgsRasterDataProvider* provider, const SiteRasterBinding& binding, const QVector<double>& x, const QVector<double>& y, QVector<double>& values, int& numTiles, QString& err);
+
+    int transformSites(const QgsCoordinateReferenceSystem& destCrs, const QVector<double>& longitudes, const QVector<double>& latitudes, QVector<double>& x, QVector<double>& y, QString& err);
+
+    QVector<SiteRasterBinding> bindings;
+
+    QStringList log;
+
+    QString siteCrsAuthId = "EPSG:4326";
+
+    int tileSize = 512;
+};
+
+#endif // SITERASTEREXTRACTOR_H
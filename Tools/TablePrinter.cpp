@@ -38,10 +38,21 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 
 #include "TablePrinter.h"
 
+#include <QAbstractTextDocumentLayout>
+#include <QFile>
+#include <QFontMetricsF>
+#include <QGuiApplication>
+#include <QHeaderView>
+#include <QPagedPaintDevice>
+#include <QPainter>
+#include <QPdfWriter>
+#include <QScreen>
 #include <QTableView>
 #include <QTextCursor>
 #include <QTextStream>
 
+#include <algorithm>
+
 TablePrinter::TablePrinter()
 {
 
@@ -89,3 +100,412 @@ void TablePrinter::printToTable(QTextCursor* cursor, QTableView* tableView, cons
     cursor->insertHtml(strStream);
 
 }
+
+
+int TablePrinter::printTable(QPainter* painter, QPagedPaintDevice* device, const QRectF& pageRect, QTableView* tableView, const QString& title, QString& err)
+{
+    if(painter == nullptr || !painter->isActive() || device == nullptr)
+    {
+        err = "Error, the painter must be active on the device to print the table";
+        return -1;
+    }
+
+    auto model = tableView->model();
+
+    if(model == nullptr)
+    {
+        err = "Error, the table does not have a model to print";
+        return -1;
+    }
+
+    auto columns = this->getVisibleColumns(tableView);
+
+    if(columns.isEmpty())
+    {
+        err = "Error, the table does not have any visible columns to print";
+        return -1;
+    }
+
+    const int numColumns = columns.size();
+
+    QFont bodyFont = painter->font();
+    bodyFont.setPointSize(fontPointSize);
+
+    QFont headerFont = bodyFont;
+    headerFont.setBold(true);
+
+    QFont titleFont = bodyFont;
+    titleFont.setPointSize(fontPointSize + 4);
+    titleFont.setBold(true);
+
+    // Measure in the units of the device
+    QFontMetricsF bodyMetrics(bodyFont, device);
+    QFontMetricsF headerMetrics(headerFont, device);
+    QFontMetricsF titleMetrics(titleFont, device);
+
+    const qreal padding = bodyMetrics.averageCharWidth();
+    const qreal rowHeight = bodyMetrics.height() + 0.5*padding;
+    const qreal headerHeight = headerMetrics.height() + 0.5*padding;
+
+    if(pageRect.height() < 2.0*headerHeight + rowHeight)
+    {
+        err = "Error, the page is too small to print the table";
+        return -1;
+    }
+
+    QStringList headers;
+    headers.reserve(numColumns);
+    for(auto&& column : columns)
+        headers.append(model->headerData(column, Qt::Horizontal).toString().simplified());
+
+    QVector<QString> cells;
+
+    // The column widths are computed once from the headers and the first chunk of rows
+    while(model->rowCount() < chunkSize && model->canFetchMore(QModelIndex()))
+        model->fetchMore(QModelIndex());
+
+    auto numRead = this->readRows(model, columns, 0, chunkSize, cells);
+
+    QVector<qreal> columnWidths(numColumns, 0.0);
+    for(int j = 0; j<numColumns; ++j)
+        columnWidths[j] = headerMetrics.horizontalAdvance(headers.at(j));
+
+    for(int i = 0; i<numRead; ++i)
+        for(int j = 0; j<numColumns; ++j)
+            columnWidths[j] = std::max(columnWidths.at(j), bodyMetrics.horizontalAdvance(cells.at(i*numColumns + j)));
+
+    qreal totalWidth = 0.0;
+    for(auto&& it : columnWidths)
+    {
+        it += 2.0*padding;
+        totalWidth += it;
+    }
+
+    // Shrink the columns to the width of the page, the text that does not fit is elided
+    if(totalWidth > pageRect.width())
+    {
+        const auto scale = pageRect.width()/totalWidth;
+
+        for(auto&& it : columnWidths)
+            it *= scale;
+
+        totalWidth = pageRect.width();
+    }
+
+    QVector<qreal> columnPositions(numColumns+1, pageRect.left());
+    for(int j = 0; j<numColumns; ++j)
+        columnPositions[j+1] = columnPositions.at(j) + columnWidths.at(j);
+
+    painter->save();
+
+    qreal y = pageRect.top();
+    qreal pageTableTop = y;
+
+    auto drawGridLines = [&](const qreal bottom)
+    {
+        for(auto&& x : columnPositions)
+            painter->drawLine(QPointF(x, pageTableTop), QPointF(x, bottom));
+    };
+
+    auto drawHeader = [&]()
+    {
+        pageTableTop = y;
+
+        painter->setFont(headerFont);
+        painter->fillRect(QRectF(pageRect.left(), y, totalWidth, headerHeight), QColor(240,240,240));
+
+        for(int j = 0; j<numColumns; ++j)
+        {
+            QRectF cellRect(columnPositions.at(j) + padding, y, columnWidths.at(j) - 2.0*padding, headerHeight);
+            painter->drawText(cellRect, Qt::AlignLeft | Qt::AlignVCenter, headerMetrics.elidedText(headers.at(j), Qt::ElideRight, cellRect.width()));
+        }
+
+        painter->drawLine(QPointF(pageRect.left(), y), QPointF(pageRect.left() + totalWidth, y));
+
+        y += headerHeight;
+
+        painter->drawLine(QPointF(pageRect.left(), y), QPointF(pageRect.left() + totalWidth, y));
+
+        painter->setFont(bodyFont);
+    };
+
+    if(!title.isEmpty())
+    {
+        painter->setFont(titleFont);
+        painter->drawText(QRectF(pageRect.left(), y, pageRect.width(), titleMetrics.height()), Qt::AlignLeft | Qt::AlignVCenter, title);
+        y += 1.5*titleMetrics.height();
+    }
+
+    drawHeader();
+
+    int firstRow = 0;
+
+    while(numRead > 0)
+    {
+        for(int i = 0; i<numRead; ++i)
+        {
+            if(y + rowHeight > pageRect.bottom())
+            {
+                drawGridLines(y);
+
+                if(!device->newPage())
+                {
+                    painter->restore();
+                    err = "Error, could not create a new page while printing the table";
+                    return -1;
+                }
+
+                y = pageRect.top();
+
+                drawHeader();
+            }
+
+            for(int j = 0; j<numColumns; ++j)
+            {
+                QRectF cellRect(columnPositions.at(j) + padding, y, columnWidths.at(j) - 2.0*padding, rowHeight);
+                painter->drawText(cellRect, Qt::AlignLeft | Qt::AlignVCenter, bodyMetrics.elidedText(cells.at(i*numColumns + j), Qt::ElideRight, cellRect.width()));
+            }
+
+            y += rowHeight;
+
+            painter->drawLine(QPointF(pageRect.left(), y), QPointF(pageRect.left() + totalWidth, y));
+        }
+
+        firstRow += numRead;
+
+        while(model->rowCount() < firstRow + chunkSize && model->canFetchMore(QModelIndex()))
+            model->fetchMore(QModelIndex());
+
+        numRead = this->readRows(model, columns, firstRow, chunkSize, cells);
+    }
+
+    drawGridLines(y);
+
+    painter->restore();
+
+    return 0;
+}
+
+
+int TablePrinter::printTextDocument(QPainter* painter, QPagedPaintDevice* device, const QRectF& pageRect, QTextDocument* document, QString& err)
+{
+    if(painter == nullptr || !painter->isActive() || device == nullptr)
+    {
+        err = "Error, the painter must be active on the device to print the document";
+        return -1;
+    }
+
+    // The document is laid out at the resolution of the screen and scaled to the resolution of the device, as in QTextDocument::print
+    qreal screenDpiX = 96.0;
+    qreal screenDpiY = 96.0;
+
+    if(auto screen = QGuiApplication::primaryScreen())
+    {
+        screenDpiX = screen->logicalDotsPerInchX();
+        screenDpiY = screen->logicalDotsPerInchY();
+    }
+
+    const qreal scaleX = device->logicalDpiX()/screenDpiX;
+    const qreal scaleY = device->logicalDpiY()/screenDpiY;
+
+    const QSizeF bodySize(pageRect.width()/scaleX, pageRect.height()/scaleY);
+
+    document->setPageSize(bodySize);
+
+    const auto numPages = document->pageCount();
+
+    for(int page = 0; page<numPages; ++page)
+    {
+        const QRectF view(0.0, page*bodySize.height(), bodySize.width(), bodySize.height());
+
+        painter->save();
+        painter->translate(pageRect.topLeft());
+        painter->scale(scaleX, scaleY);
+        painter->translate(0.0, -view.top());
+        painter->setClipRect(view);
+
+        QAbstractTextDocumentLayout::PaintContext context;
+        context.clip = view;
+        document->documentLayout()->draw(painter, context);
+
+        painter->restore();
+
+        if(!device->newPage())
+        {
+            err = "Error, could not create a new page while printing the document";
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+
+int TablePrinter::exportToPDF(QTableView* tableView, const QString& pathToFile, const QString& title, QString& err)
+{
+    QPdfWriter writer(pathToFile);
+    writer.setPageSize(QPageSize(QPageSize::Letter));
+    writer.setPageMargins(QMarginsF(25.4, 25.4, 25.4, 25.4), QPageLayout::Millimeter);
+    writer.setTitle(title);
+
+    QPainter painter;
+    if(!painter.begin(&writer))
+    {
+        err = "Error, could not create the file: " + pathToFile;
+        return -1;
+    }
+
+    // The origin of the painter is at the corner of the margins
+    QRectF pageRect(0.0, 0.0, writer.width(), writer.height());
+
+    auto res = this->printTable(&painter, &writer, pageRect, tableView, title, err);
+
+    painter.end();
+
+    return res;
+}
+
+
+int TablePrinter::exportToCSV(QTableView* tableView, const QString& pathToFile, QString& err)
+{
+    auto model = tableView->model();
+
+    if(model == nullptr)
+    {
+        err = "Error, the table does not have a model to export";
+        return -1;
+    }
+
+    auto columns = this->getVisibleColumns(tableView);
+
+    if(columns.isEmpty())
+    {
+        err = "Error, the table does not have any visible columns to export";
+        return -1;
+    }
+
+    QFile file(pathToFile);
+
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text))
+    {
+        err = "Cannot create the file: " + pathToFile + "\n" +"Check your directory and try again.";
+        return -1;
+    }
+
+    QTextStream csvFileOut(&file);
+
+    // Handle the case where there are commas or quotes within a cell
+    auto writeCell = [&csvFileOut](const QString& in)
+    {
+        if(in.contains(',') || in.contains('"') || in.contains('\n'))
+        {
+            auto newStr = in;
+            csvFileOut << "\"" << newStr.replace("\"","\"\"") << "\"";
+        }
+        else
+            csvFileOut << in;
+    };
+
+    const int numColumns = columns.size();
+
+    for(int j = 0; j<numColumns; ++j)
+    {
+        writeCell(model->headerData(columns.at(j), Qt::Horizontal).toString());
+        csvFileOut << (j != numColumns-1 ? "," : "\n");
+    }
+
+    QVector<QString> cells;
+
+    int firstRow = 0;
+
+    while(true)
+    {
+        while(model->rowCount() < firstRow + chunkSize && model->canFetchMore(QModelIndex()))
+            model->fetchMore(QModelIndex());
+
+        auto numRead = this->readRows(model, columns, firstRow, chunkSize, cells);
+
+        if(numRead == 0)
+            break;
+
+        for(int i = 0; i<numRead; ++i)
+        {
+            for(int j = 0; j<numColumns; ++j)
+            {
+                writeCell(cells.at(i*numColumns + j));
+                csvFileOut << (j != numColumns-1 ? "," : "\n");
+            }
+        }
+
+        firstRow += numRead;
+    }
+
+    csvFileOut.flush();
+
+    if(csvFileOut.status() != QTextStream::Ok)
+    {
+        err = "Error writing to the file: " + pathToFile;
+        return -1;
+    }
+
+    return 0;
+}
+
+
+void TablePrinter::setFontPointSize(const int value)
+{
+    fontPointSize = value;
+}
+
+
+void TablePrinter::setChunkSize(const int value)
+{
+    chunkSize = std::max(1, value);
+}
+
+
+QVector<int> TablePrinter::getVisibleColumns(QTableView* tableView) const
+{
+    QVector<int> columns;
+
+    auto model = tableView->model();
+
+    if(model == nullptr)
+        return columns;
+
+    const int columnCount = model->columnCount();
+
+    // Follow the order of the header in case the user moved the columns
+    auto header = tableView->horizontalHeader();
+
+    for(int visualIndex = 0; visualIndex < columnCount; ++visualIndex)
+    {
+        auto column = header ? header->logicalIndex(visualIndex) : visualIndex;
+
+        if(column < 0 || tableView->isColumnHidden(column))
+            continue;
+
+        columns.append(column);
+    }
+
+    return columns;
+}
+
+
+int TablePrinter::readRows(QAbstractItemModel* model, const QVector<int>& columns, const int firstRow, const int numRows, QVector<QString>& cells) const
+{
+    const int numAvailable = std::max(0, std::min(numRows, model->rowCount() - firstRow));
+
+    const int numColumns = columns.size();
+
+    // The buffer is reused between chunks, so it only grows to the size of one chunk
+    cells.resize(numAvailable*numColumns);
+
+    for(int i = 0; i<numAvailable; ++i)
+    {
+        for(int j = 0; j<numColumns; ++j)
+            cells[i*numColumns + j] = model->data(model->index(firstRow + i, columns.at(j))).toString().simplified();
+    }
+
+    return numAvailable;
+}
@@ -39,7 +39,12 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 // Written by: Stevan Gavrilovic
 
 #include <QTextDocument>
+#include <QRectF>
+#include <QVector>
 
+class QAbstractItemModel;
+class QPagedPaintDevice;
+class QPainter;
 class QTableView;
 
 class TablePrinter
@@ -47,8 +52,36 @@ class TablePrinter
 public:
     TablePrinter();
 
+    // Inserts the whole table as html into the document, only suitable for small tables
     void printToTable(QTextCursor* cursor, QTableView* tableView, const QString& strTitle);
 
+    // Streams the rows of the table from the model onto the pages of the device in chunks, so that the memory use does not grow with the number of rows
+    // The painter must be active on the device, and the page rectangle is in device coordinates. Drawing starts at the top of the current page
+    int printTable(QPainter* painter, QPagedPaintDevice* device, const QRectF& pageRect, QTableView* tableView, const QString& title, QString& err);
+
+    // Draws the pages of a text document at the resolution of the device, followed by a new page so that a table can be printed after it
+    int printTextDocument(QPainter* painter, QPagedPaintDevice* device, const QRectF& pageRect, QTextDocument* document, QString& err);
+
+    // Writes the table to a pdf file with the streaming renderer
+    int exportToPDF(QTableView* tableView, const QString& pathToFile, const QString& title, QString& err);
+
+    // Writes the visible columns of the table to a csv file, reading the rows from the model in the same chunks as the renderer
+    int exportToCSV(QTableView* tableView, const QString& pathToFile, QString& err);
+
+    void setFontPointSize(const int value);
+
+    void setChunkSize(const int value);
+
+private:
+
+    // The visible columns in the order that they appear in the view
+    QVector<int> getVisibleColumns(QTableView* tableView) const;
+
+    // Reads the display text of a block of rows into cells, row-major with one entry for each visible column. Returns the number of rows that were read
+    int readRows(QAbstractItemModel* model, const QVector<int>& columns, const int firstRow, const int numRows, QVector<QString>& cells) const;
+
+    int fontPointSize = 7;
+    int chunkSize = 1024;
 };
 
 #endif // TABLEPRINTER_H
@@ -0,0 +1,397 @@
+/* *****************************************************************************
+Copyright (c) 2016-2021, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+// Written by: Stevan Gavrilovic
+
+#include "TimeSeriesAggregator.h"
+
+#include <QFileInfo>
+#include <QThread>
+#include <QtConcurrent/QtConcurrent>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+TimeSeriesAggregator::TimeSeriesAggregator(double startTime, double timeStep, int sketchSize) : startTime(startTime), timeStep(timeStep > 0.0 ? timeStep : 1.0), sketchSize(sketchSize)
+{
+
+}
+
+
+int TimeSeriesAggregator::aggregateRealizations(const QStringList& sources, const RealizationReader& reader, double startTime, double timeStep,
+                                                QMap<QString, TimeSeriesAggregator>& result, QString& err, int numSampledRealizations,
+                                                QStringList* skippedSources)
+{
+    result.clear();
+
+    if(skippedSources != nullptr)
+        skippedSources->clear();
+
+    if(sources.isEmpty())
+    {
+        err = "No realizations were given to aggregate";
+        return -1;
+    }
+
+    // Each chunk of sources is aggregated on its own and the chunks are merged at the end
+    struct Chunk
+    {
+        QStringList sources;
+        QMap<QString, TimeSeriesAggregator> aggregators;
+        QString err;
+        QStringList skipped;
+    };
+
+    const int numChunks = std::min(static_cast<int>(sources.size()), std::max(1,QThread::idealThreadCount())*4);
+
+    std::vector<Chunk> chunks(numChunks);
+    for(int i = 0; i<sources.size(); ++i)
+        chunks[i % numChunks].sources.append(sources.at(i));
+
+    QtConcurrent::blockingMap(chunks, [&](Chunk& chunk)
+    {
+        for(auto&& source : chunk.sources)
+        {
+            QMap<QString, RealizationSeries> series;
+            QString readErr;
+
+            if(reader(source, series, readErr) != 0)
+            {
+                if(readErr.isEmpty())
+                    readErr = "Failed to read the realization " + source;
+
+                if(skippedSources == nullptr)
+                {
+                    chunk.err = readErr;
+                    return;
+                }
+
+                chunk.skipped.append(source + ": " + readErr);
+                continue;
+            }
+
+            auto name = QFileInfo(source).fileName();
+
+            for(auto it = series.constBegin(); it != series.constEnd(); ++it)
+            {
+                auto aggIt = chunk.aggregators.find(it.key());
+
+                if(aggIt == chunk.aggregators.end())
+                {
+                    aggIt = chunk.aggregators.insert(it.key(), TimeSeriesAggregator(startTime, timeStep));
+                    aggIt->setNumSampledRealizations(numSampledRealizations);
+                }
+
+                aggIt->addRealization(name, it.value());
+            }
+        }
+    });
+
+    for(auto&& chunk : chunks)
+    {
+        if(!chunk.err.isEmpty())
+        {
+            err = chunk.err;
+            return -1;
+        }
+
+        if(skippedSources != nullptr)
+            skippedSources->append(chunk.skipped);
+
+        for(auto it = chunk.aggregators.constBegin(); it != chunk.aggregators.constEnd(); ++it)
+        {
+            auto resIt = result.find(it.key());
+
+            if(resIt == result.end())
+                result.insert(it.key(), it.value());
+            else
+                resIt->merge(it.value());
+        }
+    }
+
+    if(skippedSources != nullptr && skippedSources->size() == sources.size())
+    {
+        err = "None of the realizations could be read, the first error was " + skippedSources->first();
+        return -1;
+    }
+
+    return 0;
+}
+
+
+double TimeSeriesAggregator::suggestTimeStep(const QVector<double>& times, int maxSteps)
+{
+    if(times.size() < 2)
+        return 1.0;
+
+    auto sortedTimes = times;
+    std::sort(sortedTimes.begin(), sortedTimes.end());
+
+    double minStep = std::numeric_limits<double>::max();
+    for(int i = 1; i<sortedTimes.size(); ++i)
+    {
+        auto step = sortedTimes.at(i) - sortedTimes.at(i-1);
+        if(step > 0.0)
+            minStep = std::min(minStep, step);
+    }
+
+    if(minStep == std::numeric_limits<double>::max())
+        return 1.0;
+
+    const double range = sortedTimes.last() - sortedTimes.first();
+
+    if(maxSteps > 0 && range/minStep > maxSteps)
+        return range/maxSteps;
+
+    return minStep;
+}
+
+
+void TimeSeriesAggregator::addRealization(const QString& name, const RealizationSeries& series)
+{
+    if(series.time.isEmpty() || series.time.size() != series.values.size())
+        return;
+
+    // The number of time steps needed to cover this realization
+    const int numSteps = std::max(1, static_cast<int>(std::floor((series.time.last() - startTime)/timeStep + 1e-9)) + 1);
+
+    this->extendTo(numSteps);
+
+    auto vals = this->resample(series);
+
+    for(int i = 0; i<vals.size(); ++i)
+    {
+        sums[i] += vals.at(i);
+        sketches[i].add(vals.at(i));
+    }
+
+    ++realizationCount;
+
+    if(numSampled <= 0)
+        return;
+
+    auto key = qHash(name);
+
+    if(sampledRealizations.size() < numSampled)
+    {
+        sampledRealizations.insert(key, qMakePair(name, vals));
+    }
+    else if(key < sampledRealizations.lastKey())
+    {
+        sampledRealizations.erase(std::prev(sampledRealizations.end()));
+        sampledRealizations.insert(key, qMakePair(name, vals));
+    }
+}
+
+
+void TimeSeriesAggregator::merge(const TimeSeriesAggregator& other)
+{
+    if(other.realizationCount == 0)
+        return;
+
+    this->extendTo(other.numTimeSteps());
+
+    // Realizations of the other aggregator hold their last value beyond its time axis
+    const int otherSteps = other.numTimeSteps();
+    for(int i = 0; i<sketches.size(); ++i)
+    {
+        const int j = std::min(i, otherSteps-1);
+        sums[i] += other.sums.at(j);
+        sketches[i].merge(other.sketches.at(j));
+    }
+
+    realizationCount += other.realizationCount;
+
+    // Shorter realizations are extended to the time axis when they are returned
+    for(auto it = other.sampledRealizations.constBegin(); it != other.sampledRealizations.constEnd(); ++it)
+        sampledRealizations.insert(it.key(), it.value());
+
+    while(sampledRealizations.size() > numSampled)
+        sampledRealizations.erase(std::prev(sampledRealizations.end()));
+}
+
+
+void TimeSeriesAggregator::setNumSampledRealizations(int value)
+{
+    numSampled = std::max(0,value);
+}
+
+
+int TimeSeriesAggregator::numRealizations(void) const
+{
+    return realizationCount;
+}
+
+
+int TimeSeriesAggregator::numTimeSteps(void) const
+{
+    return sketches.size();
+}
+
+
+QVector<double> TimeSeriesAggregator::getTimeAxis(void) const
+{
+    QVector<double> time(sketches.size());
+
+    for(int i = 0; i<time.size(); ++i)
+        time[i] = startTime + i*timeStep;
+
+    return time;
+}
+
+
+QVector<double> TimeSeriesAggregator::getMean(void) const
+{
+    QVector<double> mean(sums.size(), 0.0);
+
+    if(realizationCount == 0)
+        return mean;
+
+    for(int i = 0; i<mean.size(); ++i)
+        mean[i] = sums.at(i)/realizationCount;
+
+    return mean;
+}
+
+
+QVector<double> TimeSeriesAggregator::getPercentile(double p) const
+{
+    QVector<double> vals(sketches.size());
+
+    for(int i = 0; i<vals.size(); ++i)
+        vals[i] = sketches.at(i).quantile(p);
+
+    return vals;
+}
+
+
+QVector<double> TimeSeriesAggregator::getMin(void) const
+{
+    return this->getPercentile(0.0);
+}
+
+
+QVector<double> TimeSeriesAggregator::getMax(void) const
+{
+    return this->getPercentile(1.0);
+}
+
+
+QMap<QString, QVector<double>> TimeSeriesAggregator::getSampledRealizations(void) const
+{
+    QMap<QString, QVector<double>> realizations;
+
+    for(auto&& it : sampledRealizations)
+    {
+        auto vals = it.second;
+
+        // Hold the last value until the end of the time axis
+        if(!vals.isEmpty() && vals.size() < sketches.size())
+        {
+            const auto lastVal = vals.last();
+            vals.resize(sketches.size());
+            std::fill(vals.begin() + it.second.size(), vals.end(), lastVal);
+        }
+
+        realizations.insert(it.first, vals);
+    }
+
+    return realizations;
+}
+
+
+void TimeSeriesAggregator::extendTo(int numSteps)
+{
+    const int oldSteps = sketches.size();
+
+    if(numSteps <= oldSteps)
+        return;
+
+    sums.resize(numSteps);
+    sketches.resize(numSteps);
+
+    for(int i = oldSteps; i<numSteps; ++i)
+    {
+        if(oldSteps == 0)
+        {
+            sums[i] = 0.0;
+            sketches[i] = QuantileSketch(sketchSize);
+        }
+        else
+        {
+            sums[i] = sums.at(oldSteps-1);
+            sketches[i] = sketches.at(oldSteps-1);
+        }
+    }
+}
+
+
+QVector<double> TimeSeriesAggregator::resample(const RealizationSeries& series) const
+{
+    const auto& t = series.time;
+    const auto& v = series.values;
+
+    QVector<double> vals(sketches.size());
+
+    int j = 0;
+    for(int i = 0; i<vals.size(); ++i)
+    {
+        const double time = startTime + i*timeStep;
+
+        if(time <= t.first())
+        {
+            vals[i] = v.first();
+            continue;
+        }
+
+        if(time >= t.last())
+        {
+            vals[i] = v.last();
+            continue;
+        }
+
+        while(j+1 < t.size() && t.at(j+1) < time)
+            ++j;
+
+        const double dt = t.at(j+1) - t.at(j);
+        const double w = dt > 0.0 ? (time - t.at(j))/dt : 1.0;
+
+        vals[i] = (1.0-w)*v.at(j) + w*v.at(j+1);
+    }
+
+    return vals;
+}
@@ -0,0 +1,126 @@
+#ifndef TIMESERIESAGGREGATOR_H
+#define TIMESERIESAGGREGATOR_H
+/* *****************************************************************************
+Copyright (c) 2016-2021, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+// Written by: Stevan Gavrilovic
+
+#include "QuantileSketch.h"
+
+#include <QMap>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+#include <functional>
+
+// A time series of one realization, the times must be in ascending order
+struct RealizationSeries
+{
+    QVector<double> time;
+    QVector<double> values;
+};
+
+
+// Aggregates the time series of many realizations into mean and percentile curves without keeping every series in memory
+// Each realization is resampled onto a uniform time axis t_i = startTime + i*timeStep, with linear interpolation between the points of the realization and its first/last value held outside of them
+// A quantile sketch is kept per time step so that the aggregators of realizations processed in parallel can be merged
+// A few realizations are retained for plotting; they are chosen by a hash of the realization name so that the choice does not depend on the order in which the realizations are processed
+class TimeSeriesAggregator
+{
+public:
+    TimeSeriesAggregator(double startTime = 0.0, double timeStep = 1.0, int sketchSize = 128);
+
+    // Reads the series of one realization from a source, e.g., a file or a directory, and returns them keyed by the series name
+    // The reader is called from worker threads and must not touch the GUI
+    typedef std::function<int(const QString& source, QMap<QString, RealizationSeries>& series, QString& err)> RealizationReader;
+
+    // Reads the sources in parallel chunks and returns one aggregator per series name
+    // The name of each realization is the file name of the source
+    // If skippedSources is given, a source that cannot be read is left out and reported in it with its error, and the call only fails if no source could be read
+    static int aggregateRealizations(const QStringList& sources, const RealizationReader& reader, double startTime, double timeStep,
+                                     QMap<QString, TimeSeriesAggregator>& result, QString& err, int numSampledRealizations = 5,
+                                     QStringList* skippedSources = nullptr);
+
+    // Returns a time step for a uniform time axis that resolves the given times, limited to maxSteps steps
+    static double suggestTimeStep(const QVector<double>& times, int maxSteps = 2000);
+
+    void addRealization(const QString& name, const RealizationSeries& series);
+
+    void merge(const TimeSeriesAggregator& other);
+
+    void setNumSampledRealizations(int value);
+
+    int numRealizations(void) const;
+
+    int numTimeSteps(void) const;
+
+    QVector<double> getTimeAxis(void) const;
+
+    QVector<double> getMean(void) const;
+
+    // p is in the range [0,1], e.g., 0.95 for the 95th percentile
+    QVector<double> getPercentile(double p) const;
+
+    QVector<double> getMin(void) const;
+
+    QVector<double> getMax(void) const;
+
+    // The realizations retained for plotting, resampled onto the time axis
+    QMap<QString, QVector<double>> getSampledRealizations(void) const;
+
+private:
+
+    // Extends the time axis to numSteps steps, realizations that ended before hold their last value
+    void extendTo(int numSteps);
+
+    QVector<double> resample(const RealizationSeries& series) const;
+
+    double startTime;
+    double timeStep;
+    int sketchSize;
+
+    int realizationCount = 0;
+    int numSampled = 5;
+
+    QVector<double> sums;
+    QVector<QuantileSketch> sketches;
+
+    // Keyed by the hash of the realization name, holds the name and the resampled values
+    QMap<uint, QPair<QString, QVector<double>>> sampledRealizations;
+};
+
+#endif // TIMESERIESAGGREGATOR_H
@@ -0,0 +1,423 @@
+/* *****************************************************************************
+Copyright (c) 2016-2021, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+// Written by: Stevan Gavrilovic
+
+#include "TrafficAssignment.h"
+
+#include <QThread>
+#include <QtConcurrent/QtConcurrent>
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <queue>
+
+namespace {
+
+const double infinity = std::numeric_limits<double>::infinity();
+
+// Trips of a scenario that leave from the same origin, the trips are origin-sorted indices of the trip list
+struct OriginTrips
+{
+    int origin = 0;
+    int first = 0;
+    int last = 0;
+};
+
+}
+
+
+TrafficAssignment::TrafficAssignment()
+{
+
+}
+
+
+int TrafficAssignment::setNetwork(const int numNodes, const QVector<RoadLink>& links, QString& err)
+{
+    this->numNodes = 0;
+    rowStart.clear();
+    linkOrder.clear();
+    linkEnd.clear();
+    roadLinks.clear();
+
+    if(numNodes < 1)
+    {
+        err = "Error, the road network needs at least one node";
+        return -1;
+    }
+
+    for(int i = 0; i<links.size(); ++i)
+    {
+        const auto& link = links.at(i);
+
+        if(link.startNode < 0 || link.startNode >= numNodes || link.endNode < 0 || link.endNode >= numNodes)
+        {
+            err = "Error, link "+QString::number(i)+" of the road network connects to a node that does not exist";
+            return -1;
+        }
+
+        if(!(link.freeFlowTime >= 0.0) || !(link.capacity >= 0.0))
+        {
+            err = "Error, link "+QString::number(i)+" of the road network has a negative or invalid travel time or capacity";
+            return -1;
+        }
+    }
+
+    this->numNodes = numNodes;
+    roadLinks = links;
+
+    // Count the outgoing links of each node and turn the counts into the row offsets
+    rowStart.assign(numNodes + 1, 0);
+    for(const auto& link : links)
+        ++rowStart[link.startNode + 1];
+
+    for(int i = 0; i<numNodes; ++i)
+        rowStart[i + 1] += rowStart[i];
+
+    linkOrder.resize(links.size());
+    linkEnd.resize(links.size());
+
+    std::vector<int> next(rowStart.begin(), rowStart.end() - 1);
+    for(int i = 0; i<links.size(); ++i)
+    {
+        const int pos = next[links.at(i).startNode]++;
+        linkOrder[pos] = i;
+        linkEnd[pos] = links.at(i).endNode;
+    }
+
+    return 0;
+}
+
+
+int TrafficAssignment::getNumLinks(void) const
+{
+    return roadLinks.size();
+}
+
+
+RoadLink TrafficAssignment::getLink(const int i) const
+{
+    return roadLinks.at(i);
+}
+
+
+void TrafficAssignment::setBPRParameters(const double alphaValue, const double betaValue)
+{
+    alpha = alphaValue;
+    beta = betaValue;
+}
+
+
+void TrafficAssignment::setIncrements(const QVector<double>& values)
+{
+    double total = 0.0;
+    for(auto&& it : values)
+        total += std::max(it, 0.0);
+
+    if(total <= 0.0)
+        return;
+
+    increments.clear();
+    for(auto&& it : values)
+        increments.append(std::max(it, 0.0)/total);
+}
+
+
+double TrafficAssignment::getLinkTravelTime(const double freeFlowTime, const double volume, const double capacity) const
+{
+    if(capacity <= 0.0)
+        return infinity;
+
+    return freeFlowTime*(1.0 + alpha*std::pow(volume/capacity, beta));
+}
+
+
+void TrafficAssignment::findShortestPaths(const int origin, const std::vector<double>& linkTimes, std::vector<double>& arrivalTimes, std::vector<int>& predecessorLinks) const
+{
+    arrivalTimes.assign(numNodes, infinity);
+    predecessorLinks.assign(numNodes, -1);
+
+    typedef std::pair<double, int> HeapEntry;
+
+    // Nodes are pushed again when their time improves, entries with an outdated time are skipped when they are popped
+    std::priority_queue<HeapEntry, std::vector<HeapEntry>, std::greater<HeapEntry>> heap;
+
+    arrivalTimes[origin] = 0.0;
+    heap.push(HeapEntry(0.0, origin));
+
+    while(!heap.empty())
+    {
+        const HeapEntry top = heap.top();
+        heap.pop();
+
+        const int node = top.second;
+
+        if(top.first > arrivalTimes[node])
+            continue;
+
+        for(int pos = rowStart[node]; pos<rowStart[node + 1]; ++pos)
+        {
+            const int link = linkOrder[pos];
+            const double time = top.first + linkTimes[link];
+
+            if(time < arrivalTimes[linkEnd[pos]])
+            {
+                arrivalTimes[linkEnd[pos]] = time;
+                predecessorLinks[linkEnd[pos]] = link;
+                heap.push(HeapEntry(time, linkEnd[pos]));
+            }
+        }
+    }
+}
+
+
+void TrafficAssignment::assignScenario(const Scenario& scenario, const QVector<RoadTrip>& trips, const bool parallelOrigins) const
+{
+    const int numLinks = roadLinks.size();
+
+    std::vector<double> capacities(numLinks);
+    std::vector<double> linkTimes(numLinks);
+    std::vector<double> volumes(numLinks, 0.0);
+
+    for(int i = 0; i<numLinks; ++i)
+    {
+        capacities[i] = roadLinks.at(i).capacity*(scenario.capacityFactors ? std::max(scenario.capacityFactors[i], 0.0) : 1.0);
+        linkTimes[i] = this->getLinkTravelTime(roadLinks.at(i).freeFlowTime, 0.0, capacities[i]);
+    }
+
+    // Group the trips by their origin so that one shortest path tree serves all of the trips from an origin
+    std::vector<int> tripOrder(*scenario.trips);
+    std::stable_sort(tripOrder.begin(), tripOrder.end(), [&trips](const int a, const int b) { return trips.at(a).origin < trips.at(b).origin; });
+
+    std::vector<OriginTrips> origins;
+    for(int i = 0; i<static_cast<int>(tripOrder.size()); ++i)
+    {
+        const int origin = trips.at(tripOrder[i]).origin;
+
+        if(origins.empty() || origins.back().origin != origin)
+            origins.push_back({origin, i, i});
+
+        origins.back().last = i + 1;
+    }
+
+    // Blocks of origins, each block adds the volume of its trips to its own copy of the link volumes
+    struct Job
+    {
+        int firstOrigin = 0;
+        int lastOrigin = 0;
+        std::vector<double> volumes;
+    };
+
+    const int numOrigins = static_cast<int>(origins.size());
+    const int numBlocks = parallelOrigins ? std::min(numOrigins, 4*std::max(QThread::idealThreadCount(), 1)) : 1;
+
+    std::vector<Job> jobs(std::max(numBlocks, 1));
+    for(int i = 0; i<static_cast<int>(jobs.size()); ++i)
+    {
+        jobs[i].firstOrigin = static_cast<int>((static_cast<qint64>(numOrigins)*i)/jobs.size());
+        jobs[i].lastOrigin = static_cast<int>((static_cast<qint64>(numOrigins)*(i + 1))/jobs.size());
+    }
+
+    auto runJobs = [&](const std::function<void(Job&)>& evaluateBlock)
+    {
+        if(jobs.size() > 1)
+            QtConcurrent::blockingMap(jobs, evaluateBlock);
+        else
+            evaluateBlock(jobs.front());
+    };
+
+    for(auto&& fraction : increments)
+    {
+        if(fraction <= 0.0)
+            continue;
+
+        auto evaluateBlock = [&](Job& job)
+        {
+            job.volumes.assign(numLinks, 0.0);
+
+            std::vector<double> arrivalTimes;
+            std::vector<int> predecessorLinks;
+
+            for(int i = job.firstOrigin; i<job.lastOrigin; ++i)
+            {
+                const auto& origin = origins[i];
+
+                this->findShortestPaths(origin.origin, linkTimes, arrivalTimes, predecessorLinks);
+
+                for(int j = origin.first; j<origin.last; ++j)
+                {
+                    int node = trips.at(tripOrder[j]).destination;
+
+                    if(arrivalTimes[node] == infinity)
+                        continue;
+
+                    while(node != origin.origin)
+                    {
+                        const int link = predecessorLinks[node];
+                        job.volumes[link] += fraction;
+                        node = roadLinks.at(link).startNode;
+                    }
+                }
+            }
+        };
+
+        runJobs(evaluateBlock);
+
+        for(auto&& job : jobs)
+            for(int i = 0; i<numLinks; ++i)
+                volumes[i] += job.volumes[i];
+
+        for(int i = 0; i<numLinks; ++i)
+            linkTimes[i] = this->getLinkTravelTime(roadLinks.at(i).freeFlowTime, volumes[i], capacities[i]);
+    }
+
+    // The travel time of a trip is that of its shortest path for the link costs of the fully loaded network
+    auto evaluateTimes = [&](Job& job)
+    {
+        job.volumes.clear();
+
+        std::vector<double> arrivalTimes;
+        std::vector<int> predecessorLinks;
+
+        for(int i = job.firstOrigin; i<job.lastOrigin; ++i)
+        {
+            const auto& origin = origins[i];
+
+            this->findShortestPaths(origin.origin, linkTimes, arrivalTimes, predecessorLinks);
+
+            for(int j = origin.first; j<origin.last; ++j)
+                scenario.travelTimes[tripOrder[j]] = arrivalTimes[trips.at(tripOrder[j]).destination];
+        }
+    };
+
+    runJobs(evaluateTimes);
+
+    std::copy(volumes.begin(), volumes.end(), scenario.linkVolumes);
+}
+
+
+int TrafficAssignment::assign(const QVector<RoadTrip>& trips, const QVector<double>& capacityFactors, QVector<double>& linkVolumes, QVector<double>& travelTimes, int& firstHour, int& numHours, QString& err) const
+{
+    linkVolumes.clear();
+    travelTimes.clear();
+    firstHour = 0;
+    numHours = 0;
+
+    if(numNodes == 0)
+    {
+        err = "Error, the road network must be set before the traffic assignment";
+        return -1;
+    }
+
+    const int numLinks = roadLinks.size();
+    const int numTrips = trips.size();
+
+    if(numLinks == 0 || capacityFactors.size() % numLinks != 0)
+    {
+        err = "Error, the number of link capacity factors must be a multiple of the number of links in the road network";
+        return -1;
+    }
+
+    const int numRealizations = capacityFactors.isEmpty() ? 1 : capacityFactors.size()/numLinks;
+
+    if(numTrips == 0)
+        return 0;
+
+    int lastHour = trips.first().hour;
+    firstHour = lastHour;
+
+    for(int i = 0; i<numTrips; ++i)
+    {
+        const auto& trip = trips.at(i);
+
+        if(trip.origin < 0 || trip.origin >= numNodes || trip.destination < 0 || trip.destination >= numNodes)
+        {
+            err = "Error, trip "+QString::number(i)+" starts or ends at a node that is not in the road network";
+            return -1;
+        }
+
+        firstHour = std::min(firstHour, trip.hour);
+        lastHour = std::max(lastHour, trip.hour);
+    }
+
+    numHours = lastHour - firstHour + 1;
+
+    std::vector<std::vector<int>> tripsByHour(numHours);
+    for(int i = 0; i<numTrips; ++i)
+        tripsByHour[trips.at(i).hour - firstHour].push_back(i);
+
+    linkVolumes.fill(0.0, numRealizations*numHours*numLinks);
+    travelTimes.fill(infinity, numRealizations*numTrips);
+
+    std::vector<Scenario> scenarios;
+
+    for(int r = 0; r<numRealizations; ++r)
+    {
+        for(int h = 0; h<numHours; ++h)
+        {
+            if(tripsByHour[h].empty())
+                continue;
+
+            Scenario scenario;
+            scenario.capacityFactors = capacityFactors.isEmpty() ? nullptr : capacityFactors.constData() + r*numLinks;
+            scenario.trips = &tripsByHour[h];
+            scenario.linkVolumes = linkVolumes.data() + (r*numHours + h)*numLinks;
+            scenario.travelTimes = travelTimes.data() + r*numTrips;
+
+            scenarios.push_back(scenario);
+        }
+    }
+
+    // A lone scenario is split over its origins, otherwise each scenario is evaluated on a thread of its own
+    if(scenarios.size() == 1)
+    {
+        this->assignScenario(scenarios.front(), trips, true);
+    }
+    else
+    {
+        auto evaluateScenario = [&](const Scenario& scenario)
+        {
+            this->assignScenario(scenario, trips, false);
+        };
+
+        QtConcurrent::blockingMap(scenarios, evaluateScenario);
+    }
+
+    return 0;
+}
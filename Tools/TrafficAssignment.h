@@ -0,0 +1,130 @@
+#ifndef TRAFFICASSIGNMENT_H
+#define TRAFFICASSIGNMENT_H
+/* *****************************************************************************
+Copyright (c) 2016-2021, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+// Written by: Stevan Gavrilovic
+
+#include <QString>
+#include <QVector>
+
+#include <vector>
+
+// Directed road link between two nodes of the network, the nodes are given by their index
+struct RoadLink
+{
+    int startNode = 0;
+    int endNode = 0;
+
+    // Travel time in s at free flow
+    double freeFlowTime = 0.0;
+
+    // Capacity in vehicles per hour
+    double capacity = 0.0;
+};
+
+
+// Trip between two nodes of the network in an hour of the day, trips without an hour are all put in hour zero
+struct RoadTrip
+{
+    int origin = 0;
+    int destination = 0;
+    int hour = 0;
+};
+
+
+// Incremental traffic assignment with BPR link costs, the trips of each hour are assigned to the network on their own so that the hours form a quasi-dynamic sequence of static assignments
+// The demand of an hour is loaded in increments, each increment takes the shortest paths for the link costs after the previous increments
+// Shortest paths are found with Dijkstra's algorithm on a compressed sparse row graph with a binary heap, one tree is grown for each origin in an increment
+// Damage realizations scale the capacities of the links, a link with zero capacity is closed
+// The realizations and hours are evaluated in parallel, and a single hour of a single realization is evaluated in parallel over its origins
+class TrafficAssignment
+{
+public:
+    TrafficAssignment();
+
+    int setNetwork(const int numNodes, const QVector<RoadLink>& links, QString& err);
+
+    // Assigns the trips for each realization of the link capacity factors, the factors are row-major with a row for each realization and a column for each link
+    // An empty set of factors is a single realization with the full capacities
+    // The link volumes in vehicles per hour are row-major with a row for each realization and hour, and a column for each link, the hours run from the first to the last hour of the trips
+    // The travel times in s are row-major with a row for each realization and a column for each trip, a trip that cannot reach its destination has an infinite time
+    // The first hour of the trips and the number of hours are returned with the results, the rows of the link volumes start at the first hour
+    int assign(const QVector<RoadTrip>& trips, const QVector<double>& capacityFactors, QVector<double>& linkVolumes, QVector<double>& travelTimes, int& firstHour, int& numHours, QString& err) const;
+
+    // Travel time in s of a link for a volume and capacity in vehicles per hour
+    double getLinkTravelTime(const double freeFlowTime, const double volume, const double capacity) const;
+
+    int getNumLinks(void) const;
+    RoadLink getLink(const int i) const;
+
+    // Parameters of the BPR function, t = t0*(1 + alpha*(v/c)^beta)
+    void setBPRParameters(const double alphaValue, const double betaValue);
+
+    // Fractions of the demand that are loaded in each increment, they are scaled to add up to one
+    void setIncrements(const QVector<double>& values);
+
+private:
+
+    // Link volumes and trip times of the trips of one hour for one realization
+    struct Scenario
+    {
+        const double* capacityFactors = nullptr;
+        const std::vector<int>* trips = nullptr;
+        double* linkVolumes = nullptr;
+        double* travelTimes = nullptr;
+    };
+
+    void assignScenario(const Scenario& scenario, const QVector<RoadTrip>& trips, const bool parallelOrigins) const;
+
+    // Grows the shortest path tree from an origin, returns the arrival times and the link that each node is reached by
+    void findShortestPaths(const int origin, const std::vector<double>& linkTimes, std::vector<double>& arrivalTimes, std::vector<int>& predecessorLinks) const;
+
+    int numNodes = 0;
+
+    // Outgoing links of each node, the links of node i are linkOrder[rowStart[i]] to linkOrder[rowStart[i+1]-1]
+    std::vector<int> rowStart;
+    std::vector<int> linkOrder;
+    std::vector<int> linkEnd;
+
+    QVector<RoadLink> roadLinks;
+
+    double alpha = 0.15;
+    double beta = 4.0;
+    QVector<double> increments = {0.4, 0.3, 0.2, 0.1};
+};
+
+#endif // TRAFFICASSIGNMENT_H
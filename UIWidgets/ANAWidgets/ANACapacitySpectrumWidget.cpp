@@ -42,10 +42,18 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 #include "SimCenterAppSelection.h"
 #include "NoArgSimCenterApp.h"
 #include "CapacitySpectrumWidgets/HAZUSDemandWidget.h"
+#include "CapacitySpectrumMethod.h"
+#include "ComponentDatabaseManager.h"
+#include "HazusMDOFGenerator.h"
+#include "SimCenterPreferences.h"
+
+#include <qgsvectorlayer.h>
 
 #include <QCheckBox>
 #include <QComboBox>
+#include <QDoubleValidator>
 #include <QFileDialog>
+#include <QDir>
 #include <QFileInfo>
 #include <QPushButton>
 #include <QGridLayout>
@@ -58,6 +66,8 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 #include <QHBoxLayout>
 #include <QJsonArray>
 
+#include <algorithm>
+
 ANACapacitySpectrumWidget::ANACapacitySpectrumWidget(QWidget *parent): SimCenterAppWidget(parent)
 {
     QVBoxLayout* layout = new QVBoxLayout(this);
@@ -73,7 +83,7 @@ ANACapacitySpectrumWidget::ANACapacitySpectrumWidget(QWidget *parent): SimCenter
 
 //    QGridLayout* gridLayout = new QGridLayout(DemandGroupBox);
     DemandSelection = new SimCenterAppSelection ("Demand Spectrum Model", "DemandModel", this);
-    HAZUSDemandWidget* hazusDemand = new HAZUSDemandWidget(this);
+    hazusDemand = new HAZUSDemandWidget(this);
     DemandSelection->addComponent(QString("HAZUS"), QString("HAZUS"), hazusDemand);
     DemandAppNameToDisplayText = new QMap<QString, QString>();
     DemandAppNameToDisplayText->insert("HAZUS", "HAZUS");
@@ -94,7 +104,60 @@ ANACapacitySpectrumWidget::ANACapacitySpectrumWidget(QWidget *parent): SimCenter
     layout->addWidget(CapacitySelection);
     layout->addWidget(DampingSelection);
 
-    layout->setStretch(3,1);
+    // Preview of the performance point of a single building with the selected models
+    QGroupBox* previewGroupBox = new QGroupBox("Performance Point Preview", this);
+    QGridLayout* previewLayout = new QGridLayout(previewGroupBox);
+
+    auto addInput = [&](const QString& labelText, const QString& value, const int row, const int col)
+    {
+        QLineEdit* lineEdit = new QLineEdit(value, this);
+        lineEdit->setValidator(new QDoubleValidator(0.0, 1.0e6, 6, lineEdit));
+
+        previewLayout->addWidget(new QLabel(labelText, this), row, col);
+        previewLayout->addWidget(lineEdit, row, col + 1);
+
+        return lineEdit;
+    };
+
+    // The elastic damping follows the Hazus table for the structure type
+    structureTypeComboBox = new QComboBox(this);
+    structureTypeComboBox->addItems({"W1", "W2", "S1", "S2", "S3", "S4", "S5", "C1", "C2", "C3", "PC1", "PC2", "RM1", "RM2", "URM", "MH"});
+    previewLayout->addWidget(new QLabel("Structure type", this), 3, 2);
+    previewLayout->addWidget(structureTypeComboBox, 3, 3);
+
+    // Defaults are the moderate code capacity curve of a W1 building from Hazus
+    yieldDisplacementLineEdit = addInput("Yield displacement Dy (in)", "0.48", 0, 0);
+    yieldAccelerationLineEdit = addInput("Yield acceleration Ay (g)", "0.2", 0, 2);
+    ultimateDisplacementLineEdit = addInput("Ultimate displacement Du (in)", "11.51", 1, 0);
+    ultimateAccelerationLineEdit = addInput("Ultimate acceleration Au (g)", "0.6", 1, 2);
+    elasticDampingLineEdit = addInput("Elastic damping (%)", QString::number(CapacitySpectrumMethod::getHazusElasticDamping("W1")), 2, 0);
+    kappaLineEdit = addInput("Degradation factor kappa", "1.0", 2, 2);
+    roofHeightLineEdit = addInput("Roof height (in)", "168", 3, 0);
+    shortPeriodSaLineEdit = addInput("Site Sa(0.3 s) (g)", "1.0", 4, 0);
+    oneSecondSaLineEdit = addInput("Site Sa(1.0 s) (g)", "0.5", 4, 2);
+
+    connect(structureTypeComboBox, &QComboBox::currentTextChanged, this, [this](const QString& type)
+    {
+        elasticDampingLineEdit->setText(QString::number(CapacitySpectrumMethod::getHazusElasticDamping(type)));
+    });
+
+    QPushButton* previewButton = new QPushButton("Preview Performance Point", this);
+    connect(previewButton, &QPushButton::clicked, this, &ANACapacitySpectrumWidget::previewSingleBuilding);
+
+    QPushButton* previewSelectedButton = new QPushButton("Preview Selected Buildings", this);
+    previewSelectedButton->setToolTip("Performance points of the selected buildings of the inventory, with the Hazus capacity curves of their structure types and design levels and the spectral accelerations above at every site");
+    connect(previewSelectedButton, &QPushButton::clicked, this, &ANACapacitySpectrumWidget::previewSelectedBuildings);
+
+    previewResultLabel = new QLabel(this);
+    previewResultLabel->setWordWrap(true);
+
+    previewLayout->addWidget(previewButton, 5, 0);
+    previewLayout->addWidget(previewSelectedButton, 5, 1);
+    previewLayout->addWidget(previewResultLabel, 6, 0, 1, 4);
+
+    layout->addWidget(previewGroupBox);
+
+    layout->setStretch(4,1);
 
     this->clear();
 
@@ -191,6 +254,218 @@ void ANACapacitySpectrumWidget::clear(void)
 
 
 
+int ANACapacitySpectrumWidget::previewPerformancePoints(const QVector<CapacityCurveParameters>& buildings, const QVector<int>& siteIndices, const QVector<double>& shortPeriodSa, const QVector<double>& oneSecondSa, const int numRealizations, QVector<PerformancePoint>& expectedPoints, QString& err)
+{
+    expectedPoints.clear();
+
+    if(DemandSelection->getCurrentSelectionName() != "HAZUS" ||
+            CapacitySelection->getCurrentSelectionName() != "HAZUS_cao_peterson_2006" ||
+            DampingSelection->getCurrentSelectionName() != "HAZUS_cao_peterson_2006")
+    {
+        err = "Error, the preview of the capacity spectrum method is only available for the HAZUS demand and the Cao and Peterson (2006) capacity and damping models";
+        return -1;
+    }
+
+    CapacitySpectrumMethod capacitySpectrum;
+    capacitySpectrum.setMagnitude(hazusDemand->getMagnitude());
+
+    QVector<PerformancePoint> points;
+    auto res = capacitySpectrum.computePerformancePoints(buildings, siteIndices, shortPeriodSa, oneSecondSa, numRealizations, points, err);
+
+    if(res != 0)
+        return res;
+
+    expectedPoints = CapacitySpectrumMethod::getExpectedPerformancePoints(points, buildings.size());
+
+    return 0;
+}
+
+
+void ANACapacitySpectrumWidget::previewSingleBuilding(void)
+{
+    previewResultLabel->clear();
+
+    CapacityCurveParameters building;
+    building.yieldDisplacement = yieldDisplacementLineEdit->text().toDouble();
+    building.yieldAcceleration = yieldAccelerationLineEdit->text().toDouble();
+    building.ultimateDisplacement = ultimateDisplacementLineEdit->text().toDouble();
+    building.ultimateAcceleration = ultimateAccelerationLineEdit->text().toDouble();
+    building.elasticDamping = elasticDampingLineEdit->text().toDouble();
+    building.kappa = kappaLineEdit->text().toDouble();
+    building.roofHeight = roofHeightLineEdit->text().toDouble();
+
+    QVector<double> shortPeriodSa = {shortPeriodSaLineEdit->text().toDouble()};
+    QVector<double> oneSecondSa = {oneSecondSaLineEdit->text().toDouble()};
+
+    QVector<PerformancePoint> points;
+    QString err;
+    auto res = this->previewPerformancePoints({building}, {0}, shortPeriodSa, oneSecondSa, 1, points, err);
+
+    if(res != 0)
+    {
+        this->errorMessage(err);
+        return;
+    }
+
+    const auto& point = points.first();
+
+    QString text = "Sd = " + QString::number(point.spectralDisplacement, 'f', 3) + " in, Sa = " + QString::number(point.spectralAcceleration, 'f', 3) + " g, effective damping = " + QString::number(point.effectiveDamping, 'f', 1) + "%";
+
+    if(building.roofHeight > 0.0)
+        text += ", drift ratio = " + QString::number(point.driftRatio, 'g', 3);
+
+    if(!point.converged)
+        text += "\nThe demand exceeds the capacity of the building up to the largest displacement that was searched";
+
+    previewResultLabel->setText(text);
+}
+
+
+void ANACapacitySpectrumWidget::previewSelectedBuildings(void)
+{
+    previewResultLabel->clear();
+
+    auto theBuildingDB = ComponentDatabaseManager::getInstance()->getAssetDb("Buildings");
+
+    if(theBuildingDB == nullptr || theBuildingDB->isEmpty())
+    {
+        this->errorMessage("Load a building inventory to preview the performance points of its buildings");
+        return;
+    }
+
+    // Use the selected buildings if there are any, otherwise the whole inventory
+    QgsVectorLayer* layer = theBuildingDB->getSelectedLayer();
+    if(layer == nullptr || layer->featureCount() == 0)
+        layer = theBuildingDB->getMainLayer();
+
+    auto fields = layer->fields();
+    auto typeIndex = fields.lookupField("StructureType");
+    auto storiesIndex = fields.lookupField("NumberOfStories");
+    auto yearIndex = fields.lookupField("YearBuilt");
+
+    if(typeIndex == -1 || storiesIndex == -1)
+    {
+        this->errorMessage("The building inventory needs the StructureType and NumberOfStories attributes to preview the performance points");
+        return;
+    }
+
+    // The Hazus capacity curves of the model building types are in the Hazus data file of the backend
+    auto SCPrefs = SimCenterPreferences::getInstance();
+    QString hazusFilePath = SCPrefs->getAppDir() + QDir::separator() + "applications" + QDir::separator() + "createSAM" + QDir::separator()
+            + "MDOF-LU" + QDir::separator() + "data" + QDir::separator() + "HazusData.txt";
+
+    HazusMDOFGenerator hazusData;
+
+    QString err;
+    if(hazusData.readHazusData(hazusFilePath, err) != 0)
+    {
+        this->errorMessage(err);
+        return;
+    }
+
+    QgsAttributeList fieldIndexes = {typeIndex, storiesIndex};
+    if(yearIndex != -1)
+        fieldIndexes.append(yearIndex);
+
+    QgsFeatureRequest featRequest;
+    featRequest.setFlags(QgsFeatureRequest::NoGeometry);
+    featRequest.setSubsetOfAttributes(fieldIndexes);
+
+    const double kappa = kappaLineEdit->text().toDouble();
+    const double metersToInches = 1.0/0.0254;
+
+    QVector<CapacityCurveParameters> buildings;
+    buildings.reserve(layer->featureCount());
+
+    int numSkipped = 0;
+
+    QgsFeatureIterator featIt = layer->getFeatures(featRequest);
+    QgsFeature feature;
+    while(featIt.nextFeature(feature))
+    {
+        auto structureType = feature.attribute(typeIndex).toString();
+        auto numStories = feature.attribute(storiesIndex).toInt();
+        auto yearBuilt = yearIndex != -1 ? feature.attribute(yearIndex).toInt() : 0;
+
+        auto classIndex = hazusData.findBuildingClass(structureType, numStories, HazusMDOFGenerator::getDesignLevel(yearBuilt));
+
+        if(classIndex == -1)
+        {
+            ++numSkipped;
+            continue;
+        }
+
+        auto buildingClass = hazusData.getBuildingClass(classIndex);
+
+        if(buildingClass.ultimateDisplacement <= 0.0 || buildingClass.ultimateAcceleration <= 0.0)
+        {
+            ++numSkipped;
+            continue;
+        }
+
+        CapacityCurveParameters building;
+        building.yieldDisplacement = buildingClass.yieldDisplacement;
+        building.yieldAcceleration = buildingClass.yieldAcceleration;
+        building.ultimateDisplacement = buildingClass.ultimateDisplacement;
+        building.ultimateAcceleration = buildingClass.ultimateAcceleration;
+        building.elasticDamping = CapacitySpectrumMethod::getHazusElasticDamping(buildingClass.structureType);
+        building.kappa = kappa;
+        building.roofHeight = buildingClass.typicalHeight*metersToInches;
+        building.pushoverModeHeightRatio = buildingClass.modalHeightFactor;
+
+        buildings.append(building);
+    }
+
+    if(buildings.isEmpty())
+    {
+        this->errorMessage("None of the buildings have a structure type with a capacity curve in " + hazusFilePath);
+        return;
+    }
+
+    // Every building is at a site with the spectral accelerations of the preview
+    QVector<double> shortPeriodSa = {shortPeriodSaLineEdit->text().toDouble()};
+    QVector<double> oneSecondSa = {oneSecondSaLineEdit->text().toDouble()};
+    QVector<int> siteIndices(buildings.size(), 0);
+
+    QVector<PerformancePoint> points;
+    auto res = this->previewPerformancePoints(buildings, siteIndices, shortPeriodSa, oneSecondSa, 1, points, err);
+
+    if(res != 0)
+    {
+        this->errorMessage(err);
+        return;
+    }
+
+    double meanDisplacement = 0.0;
+    double meanDriftRatio = 0.0;
+    double maxDriftRatio = 0.0;
+    int numNotConverged = 0;
+
+    for(auto&& point : points)
+    {
+        meanDisplacement += point.spectralDisplacement;
+        meanDriftRatio += point.driftRatio;
+        maxDriftRatio = std::max(maxDriftRatio, point.driftRatio);
+
+        if(!point.converged)
+            ++numNotConverged;
+    }
+
+    meanDisplacement /= points.size();
+    meanDriftRatio /= points.size();
+
+    QString text = QString::number(points.size()) + " buildings: mean Sd = " + QString::number(meanDisplacement, 'f', 3) + " in, mean drift ratio = " + QString::number(meanDriftRatio, 'g', 3) + ", max drift ratio = " + QString::number(maxDriftRatio, 'g', 3);
+
+    if(numSkipped > 0)
+        text += "\n" + QString::number(numSkipped) + " buildings do not have a Hazus capacity curve";
+
+    if(numNotConverged > 0)
+        text += "\nThe demand exceeds the capacity of " + QString::number(numNotConverged) + " buildings up to the largest displacement that was searched";
+
+    previewResultLabel->setText(text);
+}
+
+
 bool ANACapacitySpectrumWidget::copyFiles(QString &destName)
 {
 
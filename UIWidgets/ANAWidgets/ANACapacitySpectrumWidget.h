@@ -42,13 +42,19 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 #include "SimCenterAppWidget.h"
 #include <QMainWindow>
 #include <QMap>
+#include <QVector>
 
 class QComboBox;
 class QCheckBox;
 class QLineEdit;
 class QHBoxLayout;
+class QLabel;
 class QWidget;
 class SimCenterAppSelection;
+class HAZUSDemandWidget;
+
+struct CapacityCurveParameters;
+struct PerformancePoint;
 
 
 class ANACapacitySpectrumWidget : public SimCenterAppWidget
@@ -68,8 +74,19 @@ public:
 
     bool outputCitation(QJsonObject &jsonObject);
 
+    // Performance points of a subset of the buildings with the selected models, averaged over the realizations of the spectral accelerations at their sites
+    // Gives a preview of the drifts and accelerations before the full analysis is run
+    int previewPerformancePoints(const QVector<CapacityCurveParameters>& buildings, const QVector<int>& siteIndices, const QVector<double>& shortPeriodSa, const QVector<double>& oneSecondSa, const int numRealizations, QVector<PerformancePoint>& expectedPoints, QString& err);
+
 public slots:
 
+private slots:
+
+    // Finds the performance point of the building and site entered in the preview box
+    void previewSingleBuilding(void);
+
+    // Finds the performance points of the selected buildings of the inventory, with the spectral accelerations of the preview box at every site
+    void previewSelectedBuildings(void);
 
 private:
 
@@ -81,6 +98,21 @@ private:
     SimCenterAppSelection* CapacitySelection;
     SimCenterAppSelection* DampingSelection;
 
+    HAZUSDemandWidget* hazusDemand;
+
+    // Capacity curve of a building and the spectral accelerations at its site for the preview
+    QComboBox* structureTypeComboBox;
+    QLineEdit* yieldDisplacementLineEdit;
+    QLineEdit* yieldAccelerationLineEdit;
+    QLineEdit* ultimateDisplacementLineEdit;
+    QLineEdit* ultimateAccelerationLineEdit;
+    QLineEdit* elasticDampingLineEdit;
+    QLineEdit* kappaLineEdit;
+    QLineEdit* roofHeightLineEdit;
+    QLineEdit* shortPeriodSaLineEdit;
+    QLineEdit* oneSecondSaLineEdit;
+    QLabel* previewResultLabel;
+
     QMap<QString, QString>* DemandAppNameToDisplayText;
     QMap<QString, QString>* CapacityAppNameToDisplayText;
     QMap<QString, QString>* DampingAppNameToDisplayText;
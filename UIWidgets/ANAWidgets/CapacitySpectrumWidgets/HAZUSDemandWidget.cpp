@@ -120,6 +120,12 @@ bool HAZUSDemandWidget::copyFiles(QString &destName)
 
 
 
+double HAZUSDemandWidget::getMagnitude(void) const
+{
+    return magnitudeLineEdit->text().toDouble();
+}
+
+
 bool
 HAZUSDemandWidget::outputCitation(QJsonObject &jsonObject)
 {
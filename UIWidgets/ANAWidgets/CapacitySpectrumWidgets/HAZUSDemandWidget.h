@@ -65,6 +65,8 @@ public:
 
     bool outputCitation(QJsonObject &jsonObject);
 
+    double getMagnitude(void) const;
+
 public slots:
 
 
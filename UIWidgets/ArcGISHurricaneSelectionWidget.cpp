@@ -46,7 +46,6 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 #include "HurricaneParameterWidget.h"
 #include "SimCenterPreferences.h"
 #include "SiteConfig.h"
-#include "GridNode.h"
 #include "NodeHandle.h"
 #include "LayerTreeItem.h"
 #include "PolygonBoundary.h"
@@ -292,10 +291,10 @@ void ArcGISHurricaneSelectionWidget::handleGridSelected(void)
     if(!siteGrid->isVisible())
         return;
 
-    // Get the vector of grid nodes
-    auto gridNodeVec = siteGrid->getGridNodeVec();
+    // Get the vector of grid points
+    auto gridPoints = siteGrid->getGridPoints();
 
-    if(gridNodeVec.isEmpty())
+    if(gridPoints.isEmpty())
         return;
 
     // Create the table to store the fields
@@ -330,14 +329,12 @@ void ArcGISHurricaneSelectionWidget::handleGridSelected(void)
     QStringList headerRow = {"GP_file", "Latitude", "Longitude"};
     gridData.push_back(headerRow);
 
-    for(int i = 0; i<gridNodeVec.size(); ++i)
+    for(int i = 0; i<gridPoints.size(); ++i)
     {
-        auto gridNode = gridNodeVec.at(i);
-
         // The station id
         auto stationName = QString::number(i+1);
 
-        auto screenPoint = gridNode->getPoint();
+        auto screenPoint = gridPoints.at(i);
 
         // The latitude and longitude
         auto longitude = theVisualizationWidget->getLongFromScreenPoint(screenPoint);
@@ -406,7 +403,7 @@ void ArcGISHurricaneSelectionWidget::handleLandfallPointSelected(void)
     if(!landfallPoint->isVisible())
         return;
 
-    // Get the vector of grid nodes
+    // Get the vector of grid points
     auto posNodeVec = landfallPoint->pos();
 
     if(posNodeVec.isNull())
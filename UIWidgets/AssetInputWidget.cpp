@@ -522,16 +522,14 @@ void AssetInputWidget::handleComponentSelection(void)
 
     auto selectedComponentIDs = selectComponentsLineEdit->getSelectedComponentIDs();
 
-    // First check that all of the selected IDs are within range
-    for(auto&& it : selectedComponentIDs)
+    // First check that all of the selected IDs are within range, the IDs are sorted so only the ends need to be checked
+    if(!selectedComponentIDs.isEmpty() && (selectedComponentIDs.first()<firstID || selectedComponentIDs.last()>lastID))
     {
-        if(it<firstID || it>lastID)
-        {
-            QString msg = "The component ID " + QString::number(it) + " is out of range of the components provided";
-            this->errorMessage(msg);
-            selectComponentsLineEdit->clear();
-            return;
-        }
+        auto outOfRangeID = selectedComponentIDs.first()<firstID ? selectedComponentIDs.first() : selectedComponentIDs.last();
+        QString msg = "The component ID " + QString::number(outOfRangeID) + " is out of range of the components provided";
+        this->errorMessage(msg);
+        selectComponentsLineEdit->clear();
+        return;
     }
 
     theComponentDb->startEditing();
@@ -1042,7 +1040,7 @@ void AssetInputWidget::handleComponentFilter(void)
         return;
     }
 
-    QVector<int> filterIds;
+    IDRangeSet filterIds;
     auto res = filterDelegateWidget->openQueryBuilderDialog(filterIds);
 
     if(res == -1)
@@ -1085,7 +1083,7 @@ QString AssetInputWidget::getAssetType() const
 
 int AssetInputWidget::applyFilterString(const QString& filter)
 {
-    QVector<int> filterIds;
+    IDRangeSet filterIds;
     auto res = filterDelegateWidget->setFilterString(filter,filterIds);
 
     if(res == -1)
@@ -41,7 +41,9 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 #include "QGISVisualizationWidget.h"
 #include "SimCenterMapcanvasWidget.h"
 #include "GIS_Selection.h"
+#include "GeoJSONFootprintReader.h"
 #include "qgsvectorlayer.h"
+#include "qgsvectordataprovider.h"
 #include "qgsrectangle.h"
 #include "qstackedwidget.h"
 #include <qgsmapcanvas.h>
@@ -51,6 +53,10 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 #include <SimCenterPreferences.h>
 #include "ModularPython.h"
 
+#include <QCoreApplication>
+#include <QFileInfo>
+#include <QFutureWatcher>
+#include <QtConcurrent/QtConcurrentRun>
 #include <QLabel>
 #include <QPushButton>
 #include <QStandardPaths>
@@ -376,14 +382,187 @@ void BrailsInventoryGenerator::clear(void)
 
 }
 
+namespace {
+
+// Files smaller than this are drawn quickly enough in full
+const qint64 minOverviewFileSize = 50*1024*1024;
+
+// Tolerance of the simplification in degrees, about 10 m, and the scale below which the full footprints are drawn
+const double overviewTolerance = 1.0e-4;
+const double fullDetailScale = 25000.0;
+
+struct FootprintOverview
+{
+    // Simplified footprints, empty if the file is not a GeoJSON feature collection
+    QgsFeatureList features;
+
+    qint64 numVertices = 0;
+
+    QString err;
+
+    // Layer of the full footprints, opened on the worker thread and moved to the thread of the application
+    QgsVectorLayer* fullLayer = nullptr;
+};
+
+
+// Reads the footprints a chunk at a time so that only their simplified polygons are kept in memory, runs off the GUI thread
+FootprintOverview readFootprintOverview(const QString& outputFile, const QString& layerName)
+{
+    const int chunkSize = 10000;
+
+    FootprintOverview overview;
+
+    GeoJSONFootprintReader reader;
+    reader.setSimplificationTolerances({overviewTolerance});
+
+    QString err;
+    if (reader.open(outputFile, err) == 0) {
+
+        QVector<BuildingFootprint> footprints;
+        while (true) {
+            auto numRead = reader.readChunk(chunkSize, footprints, err);
+
+            if (numRead < 0) {
+                overview.err = err;
+                overview.features.clear();
+                break;
+            }
+
+            if (numRead == 0)
+                break;
+
+            for (auto&& footprint : footprints) {
+                QgsMultiPolygonXY multiPolygon;
+
+                for (auto&& polygon : footprint.simplifiedPolygons.first()) {
+                    QgsPolygonXY qgsPolygon;
+
+                    for (auto&& ring : polygon) {
+                        QgsPolylineXY polyline;
+                        polyline.reserve(ring.size());
+
+                        for (auto&& point : ring)
+                            polyline.append(QgsPointXY(point.x(), point.y()));
+
+                        qgsPolygon.append(polyline);
+                    }
+
+                    multiPolygon.append(qgsPolygon);
+                }
+
+                QgsAttributes featAttributes(2);
+                featAttributes[0] = footprint.centroid.y();
+                featAttributes[1] = footprint.centroid.x();
+
+                QgsFeature feature;
+                feature.setGeometry(QgsGeometry::fromMultiPolygonXY(multiPolygon));
+                feature.setAttributes(featAttributes);
+                overview.features.append(feature);
+            }
+        }
+
+        overview.numVertices = reader.getNumVerticesRead();
+    }
+
+    // Opening the OGR layer reads the whole file, so it is also done here rather than on the GUI thread
+    overview.fullLayer = new QgsVectorLayer(outputFile, layerName, "ogr");
+    overview.fullLayer->moveToThread(QCoreApplication::instance()->thread());
+
+    return overview;
+}
+
+}
+
+
 void
 BrailsInventoryGenerator::loadVectorLayer(QString outputFile, QString layerName){
+
+    // Large footprint files are read on a worker thread, and a simplified overview of the footprints is shown before the full footprints are drawn
+    if (QFileInfo(outputFile).size() >= minOverviewFileSize) {
+
+        this->statusMessage("Reading the footprints in " + outputFile);
+
+        auto watcher = new QFutureWatcher<FootprintOverview>(this);
+
+        connect(watcher, &QFutureWatcher<FootprintOverview>::finished, this, [this, watcher, layerName]() {
+            auto overview = watcher->result();
+            watcher->deleteLater();
+
+            this->addFootprintLayers(layerName, overview.features, overview.numVertices, overview.err, overview.fullLayer);
+        });
+
+        watcher->setFuture(QtConcurrent::run(readFootprintOverview, outputFile, layerName));
+
+        return;
+    }
+
     auto layer = theVisualizationWidget->addVectorLayer(outputFile, layerName, "ogr");
     if (layer != nullptr) {
         theVisualizationWidget->zoomToActiveLayer();
     }
 }
 
+int
+BrailsInventoryGenerator::addFootprintLayers(const QString& layerName, const QgsFeatureList& overviewFeatures, const qint64 numVertices, const QString& err, QgsVectorLayer* footprintLayer){
+
+    if (!err.isEmpty())
+        this->errorMessage("Error reading an overview of the footprints: " + err);
+
+    if (footprintLayer == nullptr || !footprintLayer->isValid()) {
+        this->errorMessage("Error loading the layer " + layerName);
+        delete footprintLayer;
+        return -1;
+    }
+
+    // Not a GeoJSON feature collection, the full layer is drawn at all scales
+    if (overviewFeatures.isEmpty()) {
+        theVisualizationWidget->addMapLayer(footprintLayer);
+        theVisualizationWidget->zoomToLayer(footprintLayer);
+        return 0;
+    }
+
+    auto simplifiedLayer = theVisualizationWidget->addVectorLayer("MultiPolygon", layerName + " (simplified)");
+    if (simplifiedLayer == nullptr) {
+        this->errorMessage("Error creating the simplified footprint layer");
+        theVisualizationWidget->addMapLayer(footprintLayer);
+        return -1;
+    }
+
+    QList<QgsField> attribFields;
+    attribFields.push_back(QgsField("Latitude", QVariant::Double));
+    attribFields.push_back(QgsField("Longitude", QVariant::Double));
+
+    auto dProvider = simplifiedLayer->dataProvider();
+    dProvider->addAttributes(attribFields);
+    simplifiedLayer->updateFields();
+
+    QgsFeatureList featureList = overviewFeatures;
+    dProvider->addFeatures(featureList);
+
+    simplifiedLayer->updateExtents();
+
+    // The simplified footprints are drawn when zoomed out and the full footprints when zoomed in
+    simplifiedLayer->setScaleBasedVisibility(true);
+    simplifiedLayer->setMaximumScale(fullDetailScale);
+
+    footprintLayer->setScaleBasedVisibility(true);
+    footprintLayer->setMinimumScale(fullDetailScale);
+
+    theVisualizationWidget->addMapLayer(footprintLayer);
+
+    QVector<QgsMapLayer*> mapLayers;
+    mapLayers.push_back(footprintLayer);
+    mapLayers.push_back(simplifiedLayer);
+
+    theVisualizationWidget->createLayerGroup(mapLayers, layerName);
+
+    theVisualizationWidget->zoomToLayer(simplifiedLayer);
+
+    this->statusMessage("Simplified " + QString::number(numVertices) + " footprint vertices for drawing when zoomed out");
+
+    return 0;
+}
+
 QStringList
 BrailsInventoryGenerator::getBRAILSAttributes(void) {
 	// Get today's date:
@@ -826,9 +1005,14 @@ void BrailsInventoryGenerator::runBRAILS(void)
 
 void BrailsInventoryGenerator::coordsChanged(void)
 {
-	QVector<double> points = theSelectionWidget->getSelectedPoints();
-	minLat->setText(QString::number(points.at(0)));
-	minLong->setText(QString::number(points.at(1)));
-	maxLat->setText(QString::number(points.at(6)));
-	maxLong->setText(QString::number(points.at(7)));
+	const auto& latitudes = theSelectionWidget->getSelectedLatitudes();
+	const auto& longitudes = theSelectionWidget->getSelectedLongitudes();
+
+	if (latitudes.size() < 4)
+		return;
+
+	minLat->setText(QString::number(latitudes.at(0)));
+	minLong->setText(QString::number(longitudes.at(0)));
+	maxLat->setText(QString::number(latitudes.at(3)));
+	maxLong->setText(QString::number(longitudes.at(3)));
 }
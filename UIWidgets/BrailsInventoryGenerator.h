@@ -44,6 +44,8 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 #include <QGridLayout>
 #include <QStackedWidget>
 
+#include <qgsfeature.h>
+
 class SimCenterMapcanvasWidget;
 class QGISVisualizationWidget;
 class VisualizationWidget;
@@ -57,6 +59,7 @@ class QDir;
 class SC_FileEdit;
 class SC_ComboBox;
 class BrailsGoogleDialog;
+class QgsVectorLayer;
 
 typedef struct regionInputStruct {
 	double minLat;
@@ -153,6 +156,9 @@ private slots:
 	QStringList getBRAILSAttributes(void);
 
 private:
+    // Adds the full footprint layer and a layer with the simplified footprints that is drawn instead of the full footprints when zoomed out, only done for large files
+    int addFootprintLayers(const QString& layerName, const QgsFeatureList& overviewFeatures, const qint64 numVertices, const QString& err, QgsVectorLayer* footprintLayer);
+
 	std::unique_ptr<SimCenterMapcanvasWidget> mapViewSubWidget;
 	QGISVisualizationWidget* theVisualizationWidget = nullptr;
 
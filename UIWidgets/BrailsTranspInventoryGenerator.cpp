@@ -203,10 +203,15 @@ void BrailsTranspInventoryGenerator::runBRAILS(void)
 
 void BrailsTranspInventoryGenerator::coordsChanged(void)
 {
-  QVector<double> points = theSelectionWidget->getSelectedPoints();
-  minLat->setText(QString::number(points.at(0)));
-  minLong->setText(QString::number(points.at(1)));
-  maxLat->setText(QString::number(points.at(6)));
-  maxLong->setText(QString::number(points.at(7)));    
+  const auto& latitudes = theSelectionWidget->getSelectedLatitudes();
+  const auto& longitudes = theSelectionWidget->getSelectedLongitudes();
+
+  if (latitudes.size() < 4)
+    return;
+
+  minLat->setText(QString::number(latitudes.at(0)));
+  minLong->setText(QString::number(longitudes.at(0)));
+  maxLat->setText(QString::number(latitudes.at(3)));
+  maxLong->setText(QString::number(longitudes.at(3)));
 }
 
@@ -8,11 +8,23 @@
 
 #include "AssetFilterDelegate.h"
 #include "CSVReaderWriter.h"
+#include "NetworkConnectivity.h"
 
 #include <qgsfeature.h>
 #include <qgslinesymbol.h>
 #include <qgsmarkersymbol.h>
-
+#include <qgsgraduatedsymbolrenderer.h>
+#include <qgsvectorlayer.h>
+
+#include <QApplication>
+#include <QComboBox>
+#include <QGridLayout>
+#include <QGroupBox>
+#include <QLabel>
+#include <QLineEdit>
+#include <QPushButton>
+#include <QRegExp>
+#include <QSpinBox>
 #include <QHeaderView>
 #include <QFileDialog>
 #include <QSplitter>
@@ -54,6 +66,33 @@ CSVWaterNetworkInputWidget::CSVWaterNetworkInputWidget(QWidget *parent, Visualiz
 
     mainLayout->addWidget(verticalSplitter);
 
+    // Connectivity of the nodes to the sources when the pipes fail
+    QGroupBox* connectivityGroupBox = new QGroupBox("Node Connectivity",this);
+    QGridLayout* connectivityLayout = new QGridLayout(connectivityGroupBox);
+
+    failureProbabilityCombo = new QComboBox(this);
+    failureProbabilityCombo->setToolTip("Column of the pipelines table with the failure probability of each pipe");
+
+    sourceNodesLineEdit = new QLineEdit(this);
+    sourceNodesLineEdit->setToolTip("IDs of the source nodes, e.g., the reservoirs and tanks, separated by commas or spaces");
+
+    numRealizationsSpinBox = new QSpinBox(this);
+    numRealizationsSpinBox->setRange(1,1000000);
+    numRealizationsSpinBox->setValue(1000);
+
+    QPushButton* connectivityButton = new QPushButton("Compute Connectivity",this);
+    connect(connectivityButton,&QPushButton::clicked,this,&CSVWaterNetworkInputWidget::runNodeConnectivity);
+
+    connectivityLayout->addWidget(new QLabel("Pipe failure probability column:"),0,0);
+    connectivityLayout->addWidget(failureProbabilityCombo,0,1);
+    connectivityLayout->addWidget(new QLabel("Source node IDs:"),0,2);
+    connectivityLayout->addWidget(sourceNodesLineEdit,0,3);
+    connectivityLayout->addWidget(new QLabel("Realizations:"),1,0);
+    connectivityLayout->addWidget(numRealizationsSpinBox,1,1);
+    connectivityLayout->addWidget(connectivityButton,1,3);
+
+    mainLayout->addWidget(connectivityGroupBox);
+
     // Testing to remove
     //    theNodesWidget->setPathToComponentInputFile("/Users/steve/Desktop/SogaExample/node_information.csv");
     //    theNodesWidget->loadComponentData();
@@ -437,8 +476,174 @@ int CSVWaterNetworkInputWidget::getNodeMap()
 }
 
 
+int CSVWaterNetworkInputWidget::computeNodeConnectivity(const QString& failureProbabilityColumn, const QVector<qint64>& sourceNodeIDs, const int numRealizations, const quint64 seed)
+{
+    if(nodePointsMap.isEmpty() || thePipelinesWidget->isEmpty())
+    {
+        this->errorMessage("Error, the water network must be loaded before computing the connectivity of the nodes");
+        return -1;
+    }
+
+    auto pipelinesTableWidget = thePipelinesWidget->getTableWidget();
+
+    auto horzHeaders = thePipelinesWidget->getTableHorizontalHeadings();
+
+    auto indexNodeTag1 = horzHeaders.indexOf("node1");
+    auto indexNodeTag2 = horzHeaders.indexOf("node2");
+
+    if(indexNodeTag1 == -1 || indexNodeTag2 == -1)
+    {
+        this->errorMessage("Error, cannot find the column headers 'node1' and 'node2' that specify the starting and ending nodes of the pipes");
+        return -1;
+    }
+
+    auto indexFailureProb = horzHeaders.indexOf(failureProbabilityColumn);
+
+    if(indexFailureProb == -1)
+    {
+        this->errorMessage("Error, cannot find the column header '"+failureProbabilityColumn+"' that specifies the failure probability of the pipes");
+        return -1;
+    }
+
+    auto nRows = pipelinesTableWidget->rowCount();
+
+    QVector<qint64> edgeStartNodes(nRows);
+    QVector<qint64> edgeEndNodes(nRows);
+    QVector<double> failureProbabilities(nRows);
+
+    for(int i = 0; i<nRows; ++i)
+    {
+        edgeStartNodes[i] = pipelinesTableWidget->item(i,indexNodeTag1).toInt();
+        edgeEndNodes[i] = pipelinesTableWidget->item(i,indexNodeTag2).toInt();
+
+        bool OK = false;
+        failureProbabilities[i] = pipelinesTableWidget->item(i,indexFailureProb).toDouble(&OK);
+
+        if(!OK)
+        {
+            this->errorMessage("Error, the failure probability of the pipe in row "+QString::number(i+1)+" is not a number");
+            return -1;
+        }
+    }
+
+    QVector<qint64> nodeIDs;
+    nodeIDs.reserve(nodePointsMap.size());
+    for(auto it = nodePointsMap.keyBegin(); it != nodePointsMap.keyEnd(); ++it)
+        nodeIDs.append(*it);
+
+    NetworkConnectivity theNetwork;
+
+    QString err;
+    if(theNetwork.buildGraph(nodeIDs, edgeStartNodes, edgeEndNodes, err) != 0)
+    {
+        this->errorMessage(err);
+        return -1;
+    }
+
+    if(theNetwork.setSourceNodes(sourceNodeIDs, err) != 0)
+    {
+        this->errorMessage(err);
+        return -1;
+    }
+
+    this->statusMessage("Computing the connectivity of "+QString::number(theNetwork.numNodes())+" nodes over "+QString::number(numRealizations)+" realizations of pipe failures");
+    QApplication::processEvents();
+
+    if(theNetwork.sampleEdgeFailures(failureProbabilities, numRealizations, seed, err) != 0)
+    {
+        this->errorMessage(err);
+        return -1;
+    }
+
+    auto probabilities = theNetwork.getNodeConnectivityProbabilities();
+
+    QHash<qint64, double> nodeValues;
+    nodeValues.reserve(probabilities.size());
+    for(int i = 0; i<probabilities.size(); ++i)
+        nodeValues.insert(nodeIDs.at(i), probabilities.at(i));
+
+    auto nodesDb = ComponentDatabaseManager::getInstance()->getAssetDb("Water Network Nodes");
+
+    if(nodesDb == nullptr || !nodesDb->setAttributeValuesByKey("ID", "ConnectivityProbability", nodeValues, err))
+    {
+        this->errorMessage("Error, failed to set the connectivity probability of the water network nodes. "+err);
+        return -1;
+    }
+
+    this->statusMessage("On average "+QString::number(100.0*theNetwork.getMeanConnectedSinkFraction(),'f',1)+"% of the nodes stay connected to a source node");
+
+    return 0;
+}
+
+
+void CSVWaterNetworkInputWidget::runNodeConnectivity()
+{
+    QVector<qint64> sourceNodeIDs;
+
+    auto sourceIDStrs = sourceNodesLineEdit->text().split(QRegExp("[\\s,]+"), QString::SkipEmptyParts);
+
+    for(auto&& it : sourceIDStrs)
+    {
+        bool OK = false;
+        auto id = it.toLongLong(&OK);
+
+        if(!OK)
+        {
+            this->errorMessage("Error, the source node ID '"+it+"' is not an integer");
+            return;
+        }
+
+        sourceNodeIDs.append(id);
+    }
+
+    if(sourceNodeIDs.isEmpty())
+    {
+        this->errorMessage("Error, enter the IDs of the source nodes to compute the connectivity of the nodes");
+        return;
+    }
+
+    auto res = this->computeNodeConnectivity(failureProbabilityCombo->currentText(), sourceNodeIDs, numRealizationsSpinBox->value());
+
+    if(res != 0)
+        return;
+
+    auto nodesDb = ComponentDatabaseManager::getInstance()->getAssetDb("Water Network Nodes");
+
+    if(nodesDb != nullptr)
+        this->symbolizeNodeConnectivity(nodesDb->getMainLayer());
+}
+
+
+void CSVWaterNetworkInputWidget::symbolizeNodeConnectivity(QgsVectorLayer* layer)
+{
+    if(layer == nullptr)
+        return;
+
+    // Classes of the probability from disconnected (red) to connected (green)
+    const QVector<double> breaks = {0.0, 0.5, 0.8, 0.95, 1.0};
+    const QVector<QColor> colors = {QColor(215,25,28), QColor(253,174,97), QColor(166,217,106), QColor(26,150,65)};
+
+    QgsRangeList ranges;
+
+    for(int i = 0; i<colors.size(); ++i)
+    {
+        QgsSymbol* symbol = QgsSymbol::defaultSymbol(layer->geometryType());
+        symbol->setColor(colors.at(i));
+
+        auto label = QString::number(breaks.at(i)) + " - " + QString::number(breaks.at(i+1));
+
+        ranges.append(QgsRendererRange(breaks.at(i), breaks.at(i+1), symbol, label));
+    }
+
+    layer->setRenderer(new QgsGraduatedSymbolRenderer("ConnectivityProbability", ranges));
+    layer->triggerRepaint();
+}
+
+
 void CSVWaterNetworkInputWidget::clear()
 {
+    failureProbabilityCombo->clear();
+
     thePipelinesDb->clear();
     nodePointsMap.clear();
     theNodesWidget->clear();
@@ -470,4 +675,8 @@ void CSVWaterNetworkInputWidget::handleAssetsLoaded()
         return;
     }
 
+    // Offer the columns of the pipelines table for the failure probability of the pipes
+    failureProbabilityCombo->clear();
+    failureProbabilityCombo->addItems(thePipelinesWidget->getTableHorizontalHeadings());
+
 }
@@ -48,6 +48,10 @@ class QgsVectorLayer;
 class QgsFeature;
 class QgsGeometry;
 
+class QComboBox;
+class QLineEdit;
+class QSpinBox;
+
 class CSVWaterNetworkInputWidget : public SimCenterAppWidget
 {
     Q_OBJECT
@@ -59,6 +63,10 @@ public:
     int getNodeMap();
     virtual int loadPipelinesVisualization();
 
+    // Estimates the probability that each node stays connected to at least one of the source nodes, e.g., reservoirs and tanks, when the pipes fail independently
+    // The failure probability of each pipe is read from the given column of the pipelines table, and the result is written to the "ConnectivityProbability" field of the nodes
+    int computeNodeConnectivity(const QString& failureProbabilityColumn, const QVector<qint64>& sourceNodeIDs, const int numRealizations, const quint64 seed = 0);
+
     void clear();
 
     bool outputAppDataToJSON(QJsonObject &jsonObject);
@@ -68,6 +76,9 @@ public:
 protected slots:
     void handleAssetsLoaded();
 
+    // Runs the connectivity estimate with the inputs of the connectivity box and colors the nodes by the result
+    void runNodeConnectivity();
+
 protected:
     QGISVisualizationWidget* theVisualizationWidget = nullptr;
 
@@ -84,6 +95,13 @@ protected:
     // ID, QgsGeometry
     QMap<int, QgsPointXY> nodePointsMap;
 
+    // Colors the nodes by their probability of staying connected to a source node
+    void symbolizeNodeConnectivity(QgsVectorLayer* layer);
+
+    QComboBox* failureProbabilityCombo = nullptr;
+    QLineEdit* sourceNodesLineEdit = nullptr;
+    QSpinBox* numRealizationsSpinBox = nullptr;
+
 };
 
 #endif // CSVWaterNetworkInputWidget_H
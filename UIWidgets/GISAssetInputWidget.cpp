@@ -292,10 +292,10 @@ bool GISAssetInputWidget::loadAssetData(bool message)
     if(pathToComponentInputFile.compare("NULL") == 0)
         return false;
 
-    // Check if the directory exists
+    // Check if the directory exists, in-memory GDAL files are not on the disk
     QFileInfo file(pathToComponentInputFile);
 
-    if (!file.exists())
+    if (!file.exists() && !pathToComponentInputFile.startsWith("/vsimem/"))
     {
         auto relPathToComponentFile = QCoreApplication::applicationDirPath() + QDir::separator() + pathToComponentInputFile;
 
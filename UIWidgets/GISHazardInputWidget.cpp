@@ -47,6 +47,7 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 #include "ComponentDatabaseManager.h"
 #include "ComponentDatabase.h"
 #include "CRSSelectionWidget.h"
+#include "LayerClassifier.h"
 #include "QGISVisualizationWidget.h"
 
 #include "Utils/FileOperations.h"
@@ -60,6 +61,7 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 #include <QJsonObject>
 #include <QFileInfo>
 #include <QGridLayout>
+#include <QGroupBox>
 #include <QJsonArray>
 #include <QLabel>
 #include <QLineEdit>
@@ -67,6 +69,7 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 #include <QComboBox>
 #include <QPushButton>
 #include <QSpacerItem>
+#include <QSpinBox>
 #include <QStackedWidget>
 #include <QVBoxLayout>
 #include <QDir>
@@ -76,6 +79,9 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 #include <qgsrasterdataprovider.h>
 #include <qgscollapsiblegroupbox.h>
 #include <qgsproject.h>
+#include <qgsgraduatedsymbolrenderer.h>
+#include <qgscolorramp.h>
+#include <qgssymbol.h>
 
 // Test to remove start
 #include <chrono>
@@ -88,6 +94,10 @@ GISHazardInputWidget::GISHazardInputWidget(QGISVisualizationWidget* visWidget, Q
 {
     GISFilePath = "";
 
+    theClassifier = new LayerClassifier(this);
+
+    connect(theClassifier,&LayerClassifier::sketchesUpdated,this,&GISHazardInputWidget::handleSketchesUpdated);
+
     QVBoxLayout *layout = new QVBoxLayout;
     layout->addWidget(this->getGISHazardInputWidget());
     layout->setSpacing(0);
@@ -271,7 +281,38 @@ QWidget* GISHazardInputWidget::getGISHazardInputWidget(void)
     // fileLayout->addWidget(unitsWidget, 3,0,1,3);
     fileLayout->addWidget(theIMs, 3,0,1,3);
 
-    fileLayout->setRowStretch(4,1);
+    // Graduated symbology
+    QGroupBox* symbologyGroupBox = new QGroupBox("Symbology",this);
+    QGridLayout* symbologyLayout = new QGridLayout(symbologyGroupBox);
+
+    symbologyAttributeCombo = new QComboBox(this);
+    symbologyAttributeCombo->setSizePolicy(QSizePolicy::Expanding,QSizePolicy::Maximum);
+
+    classificationMethodCombo = new QComboBox(this);
+    classificationMethodCombo->addItem("Quantile",static_cast<int>(LayerClassifier::Method::Quantile));
+    classificationMethodCombo->addItem("Natural Breaks (Jenks)",static_cast<int>(LayerClassifier::Method::NaturalBreaks));
+
+    numClassesSpinBox = new QSpinBox(this);
+    numClassesSpinBox->setRange(2,10);
+    numClassesSpinBox->setValue(5);
+
+    classificationStatusLabel = new QLabel(this);
+
+    connect(symbologyAttributeCombo,&QComboBox::currentTextChanged,this,&GISHazardInputWidget::updateSymbology);
+    connect(classificationMethodCombo,QOverload<int>::of(&QComboBox::currentIndexChanged),this,&GISHazardInputWidget::updateSymbology);
+    connect(numClassesSpinBox,QOverload<int>::of(&QSpinBox::valueChanged),this,&GISHazardInputWidget::updateSymbology);
+
+    symbologyLayout->addWidget(new QLabel("Attribute:"),0,0);
+    symbologyLayout->addWidget(symbologyAttributeCombo,0,1,1,3);
+    symbologyLayout->addWidget(new QLabel("Classification:"),1,0);
+    symbologyLayout->addWidget(classificationMethodCombo,1,1);
+    symbologyLayout->addWidget(new QLabel("Classes:"),1,2);
+    symbologyLayout->addWidget(numClassesSpinBox,1,3);
+    symbologyLayout->addWidget(classificationStatusLabel,2,0,1,4);
+
+    fileLayout->addWidget(symbologyGroupBox, 4,0,1,3);
+
+    fileLayout->setRowStretch(5,1);
 
     return fileInputWidget;
 }
@@ -339,6 +380,10 @@ void GISHazardInputWidget::clear(void)
 
     eventTypeCombo->setCurrentIndex(0);
     theIMs->clear();
+
+    theClassifier->cancel();
+    symbologyAttributeCombo->clear();
+    classificationStatusLabel->clear();
 }
 
 
@@ -358,28 +403,104 @@ int GISHazardInputWidget::loadGISFile(void)
         return -1;
     }
 
-    // Color it differently for the various hazards
+    // Color it differently for the various hazards, other hazards get the default color rather than that of the previous load
+    hazardColor = Qt::darkRed;
+
     if(evtType.compare("Tsunami") == 0)
     {
-        theVisualizationWidget->createSimpleRenderer(Qt::blue,vectorLayer);
+        hazardColor = Qt::blue;
     }
     else if(evtType.compare("Earthquake") == 0)
     {
-        theVisualizationWidget->createSimpleRenderer(Qt::darkRed ,vectorLayer);
+        hazardColor = Qt::darkRed;
     }
     else if(evtType.compare("Hurricane") == 0)
     {
-        theVisualizationWidget->createSimpleRenderer(Qt::darkGray ,vectorLayer);
+        hazardColor = Qt::darkGray;
     }
 
+    theVisualizationWidget->createSimpleRenderer(hazardColor,vectorLayer);
+
     dataProvider = vectorLayer->dataProvider();
 
     theVisualizationWidget->zoomToLayer(vectorLayer);
 
+    // Sketch the attributes in the background, the layer is recolored as the sketches grow
+    classificationStatusLabel->clear();
+
+    {
+        QSignalBlocker blocker(symbologyAttributeCombo);
+        symbologyAttributeCombo->clear();
+    }
+
+    QString err;
+    if(theClassifier->classifyLayer(vectorLayer, err) != 0)
+    {
+        this->statusMessage(err);
+        return 0;
+    }
+
+    symbologyAttributeCombo->addItems(theClassifier->getAttributes());
+
     return 0;
 }
 
 
+void GISHazardInputWidget::handleSketchesUpdated(qint64 numFeatures, bool finished)
+{
+    if(finished)
+        classificationStatusLabel->setText("Classified "+QString::number(numFeatures)+" features");
+    else
+        classificationStatusLabel->setText("Classifying, "+QString::number(numFeatures)+" features read so far");
+
+    this->updateSymbology();
+}
+
+
+void GISHazardInputWidget::updateSymbology(void)
+{
+    auto attribute = symbologyAttributeCombo->currentText();
+
+    if(vectorLayer == nullptr || attribute.isEmpty())
+        return;
+
+    auto method = static_cast<LayerClassifier::Method>(classificationMethodCombo->currentData().toInt());
+
+    QVector<double> breaks;
+    QString err;
+    if(theClassifier->getBreaks(attribute, numClassesSpinBox->value(), method, breaks, err) != 0)
+    {
+        this->errorMessage(err);
+        return;
+    }
+
+    // Nothing is sketched yet
+    if(breaks.size() < 2)
+        return;
+
+    // Ramp from a pale tint of the hazard color to the hazard color
+    QgsGradientColorRamp colorRamp(QColor(255,255,204), hazardColor);
+
+    QgsRangeList ranges;
+
+    const int numRanges = breaks.size() - 1;
+    for(int i = 0; i<numRanges; ++i)
+    {
+        QgsSymbol* symbol = QgsSymbol::defaultSymbol(vectorLayer->geometryType());
+        symbol->setColor(colorRamp.color(numRanges == 1 ? 1.0 : static_cast<double>(i)/(numRanges - 1)));
+
+        auto label = QString::number(breaks.at(i),'g',4) + " - " + QString::number(breaks.at(i + 1),'g',4);
+
+        ranges.append(QgsRendererRange(breaks.at(i), breaks.at(i + 1), symbol, label));
+    }
+
+    QgsGraduatedSymbolRenderer* renderer = new QgsGraduatedSymbolRenderer(attribute, ranges);
+
+    vectorLayer->setRenderer(renderer);
+    vectorLayer->triggerRepaint();
+}
+
+
 void GISHazardInputWidget::handleLayerCrsChanged(const QgsCoordinateReferenceSystem & val)
 {
     if(vectorLayer)
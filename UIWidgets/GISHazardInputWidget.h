@@ -44,6 +44,7 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 
 #include <memory>
 
+#include <QColor>
 #include <QMap>
 
 class QGISVisualizationWidget;
@@ -54,11 +55,14 @@ class SimCenterUnitsWidget;
 class SimCenterIMWidget;
 class CRSSelectionWidget;
 
+class LayerClassifier;
+
 class QLineEdit;
 class QProgressBar;
 class QLabel;
 class QComboBox;
 class QGridLayout;
+class QSpinBox;
 
 class GISHazardInputWidget : public SimCenterAppWidget
 {
@@ -81,6 +85,10 @@ private slots:
     void chooseEventFileDialog(void);
     void handleLayerCrsChanged(const QgsCoordinateReferenceSystem & val);
 
+    // Colors the layer by the class breaks of the selected attribute from the sketches classified so far
+    void updateSymbology(void);
+    void handleSketchesUpdated(qint64 numFeatures, bool finished);
+
 signals:
     void outputDirectoryPathChanged(QString motionDir, QString eventFile);
     void eventTypeChangedSignal(QString eventType);
@@ -108,6 +116,14 @@ private:
     CRSSelectionWidget* crsSelectorWidget = nullptr;
     QComboBox* eventTypeCombo = nullptr;
 
+    // Graduated symbology of the hazard layer, the attribute values are sketched in the background
+    LayerClassifier* theClassifier = nullptr;
+    QComboBox* symbologyAttributeCombo = nullptr;
+    QComboBox* classificationMethodCombo = nullptr;
+    QSpinBox* numClassesSpinBox = nullptr;
+    QLabel* classificationStatusLabel = nullptr;
+    QColor hazardColor = Qt::darkRed;
+
 
 };
 
@@ -47,6 +47,10 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 #include <QJsonDocument>
 #include <QJsonArray>
 #include <QFile>
+#include <QtConcurrent/QtConcurrent>
+
+#include <cmath>
+#include <limits>
 
 GroundMotionStation::GroundMotionStation(QString path, double lat, double lon) : stationFilePath(path), latitude(lat), longitude(lon)
 {
@@ -250,6 +254,78 @@ QVector<GroundMotionTimeHistory> GroundMotionStation::getStationGroundMotions()
 }
 
 
+int GroundMotionStation::getNumGroundMotions() const
+{
+    return groundMotionTimeHistories.size();
+}
+
+
+int GroundMotionStation::computeResponseSpectra(const QVector<double>& periods, const QVector<double>& dampingRatios, QString& err)
+{
+    for(auto&& it : groundMotionTimeHistories)
+    {
+        if(it.computeResponseSpectra(periods, dampingRatios, err) != 0)
+            return -1;
+    }
+
+    return 0;
+}
+
+
+int GroundMotionStation::computeResponseSpectra(QVector<GroundMotionStation>& stations, const QVector<double>& periods, const QVector<double>& dampingRatios, QString& err)
+{
+    struct SpectraJob
+    {
+        GroundMotionStation* station = nullptr;
+        QString err;
+        int res = 0;
+    };
+
+    std::vector<SpectraJob> jobs(stations.size());
+    for(int i = 0; i<stations.size(); ++i)
+        jobs[i].station = &stations[i];
+
+    QtConcurrent::blockingMap(jobs, [&](SpectraJob& job)
+    {
+        job.res = job.station->computeResponseSpectra(periods, dampingRatios, job.err);
+    });
+
+    for(auto&& it : jobs)
+    {
+        if(it.res != 0)
+        {
+            err = "Error computing the response spectra at the station "+it.station->getStationFilePath()+": "+it.err;
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+
+double GroundMotionStation::getMeanSpectralAcceleration(const double period) const
+{
+    double sum = 0.0;
+    int count = 0;
+
+    for(auto&& it : groundMotionTimeHistories)
+    {
+        auto val = it.getSpectralAcceleration(period);
+
+        if(std::isnan(val))
+            continue;
+
+        sum += val;
+        ++count;
+    }
+
+    if(count == 0)
+        return std::numeric_limits<double>::quiet_NaN();
+
+    return sum/count;
+}
+
+
 QString GroundMotionStation::getStationFilePath() const
 {
     return stationFilePath;
@@ -59,6 +59,17 @@ public:
 
     QVector<GroundMotionTimeHistory> getStationGroundMotions() const;
 
+    int getNumGroundMotions() const;
+
+    // Computes the response spectra of the ground motions at the station, the spectra are cached in each ground motion
+    int computeResponseSpectra(const QVector<double>& periods, const QVector<double>& dampingRatios, QString& err);
+
+    // Computes the response spectra of the ground motions at each station, the stations are processed in parallel
+    static int computeResponseSpectra(QVector<GroundMotionStation>& stations, const QVector<double>& periods, const QVector<double>& dampingRatios, QString& err);
+
+    // The mean of the spectral accelerations of the ground motions at the station at one of the computed periods, NaN if there are no spectra
+    double getMeanSpectralAcceleration(const double period) const;
+
     QVariant getAttributeValue(const QString& key)
     {
         return stationFeature.attribute(key);
@@ -37,6 +37,10 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 // Written by: Stevan Gavrilovic
 
 #include "GroundMotionTimeHistory.h"
+#include "ResponseSpectrum.h"
+
+#include <cmath>
+#include <limits>
 
 GroundMotionTimeHistory::GroundMotionTimeHistory(QString name) : GMName(name)
 {
@@ -57,6 +61,7 @@ QVector<double> GroundMotionTimeHistory::getX() const
 void GroundMotionTimeHistory::setX(const QVector<double> &value)
 {
     x = value;
+    this->clearResponseSpectra();
 }
 
 
@@ -69,6 +74,7 @@ QVector<double> GroundMotionTimeHistory::getY() const
 void GroundMotionTimeHistory::setY(const QVector<double> &value)
 {
     y = value;
+    this->clearResponseSpectra();
 }
 
 
@@ -81,6 +87,7 @@ QVector<double> GroundMotionTimeHistory::getZ() const
 void GroundMotionTimeHistory::setZ(const QVector<double> &value)
 {
     z = value;
+    this->clearResponseSpectra();
 }
 
 
@@ -93,6 +100,7 @@ double GroundMotionTimeHistory::getDT() const
 void GroundMotionTimeHistory::setDT(double value)
 {
     dT = value;
+    this->clearResponseSpectra();
 }
 
 
@@ -147,4 +155,113 @@ double GroundMotionTimeHistory::getScalingFactor() const
 void GroundMotionTimeHistory::setScalingFactor(double value)
 {
     scalingFactor = value;
+    this->clearResponseSpectra();
+}
+
+
+int GroundMotionTimeHistory::computeResponseSpectra(const QVector<double>& periods, const QVector<double>& dampingRatios, QString& err)
+{
+    if(this->hasResponseSpectra() && periods == spectrumPeriods && dampingRatios == spectrumDampingRatios)
+        return 0;
+
+    this->clearResponseSpectra();
+
+    auto computeDirection = [&](const QVector<double>& acc, QVector<double>& spectrum) -> int
+    {
+        if(acc.isEmpty())
+            return 0;
+
+        if(ResponseSpectrum::compute(acc, dT, periods, dampingRatios, spectrum, err) != 0)
+        {
+            err = "Error computing the response spectrum of the ground motion "+GMName+": "+err;
+            return -1;
+        }
+
+        for(auto&& it : spectrum)
+            it *= scalingFactor;
+
+        return 0;
+    };
+
+    if(computeDirection(x, responseSpectrumX) != 0 || computeDirection(y, responseSpectrumY) != 0 || computeDirection(z, responseSpectrumZ) != 0)
+    {
+        this->clearResponseSpectra();
+        return -1;
+    }
+
+    spectrumPeriods = periods;
+    spectrumDampingRatios = dampingRatios;
+
+    return 0;
+}
+
+
+bool GroundMotionTimeHistory::hasResponseSpectra() const
+{
+    return !spectrumPeriods.isEmpty();
+}
+
+
+QVector<double> GroundMotionTimeHistory::getSpectrumPeriods() const
+{
+    return spectrumPeriods;
+}
+
+
+QVector<double> GroundMotionTimeHistory::getSpectrumDampingRatios() const
+{
+    return spectrumDampingRatios;
+}
+
+
+QVector<double> GroundMotionTimeHistory::getResponseSpectrumX() const
+{
+    return responseSpectrumX;
+}
+
+
+QVector<double> GroundMotionTimeHistory::getResponseSpectrumY() const
+{
+    return responseSpectrumY;
+}
+
+
+QVector<double> GroundMotionTimeHistory::getResponseSpectrumZ() const
+{
+    return responseSpectrumZ;
+}
+
+
+double GroundMotionTimeHistory::getSpectralAcceleration(const double period) const
+{
+    const double nanVal = std::numeric_limits<double>::quiet_NaN();
+
+    auto index = spectrumPeriods.indexOf(period);
+
+    if(index == -1 || spectrumDampingRatios.isEmpty())
+        return nanVal;
+
+    const bool hasX = !responseSpectrumX.isEmpty();
+    const bool hasY = !responseSpectrumY.isEmpty();
+
+    if(hasX && hasY)
+        return std::sqrt(responseSpectrumX.at(index)*responseSpectrumY.at(index));
+    else if(hasX)
+        return responseSpectrumX.at(index);
+    else if(hasY)
+        return responseSpectrumY.at(index);
+    else if(!responseSpectrumZ.isEmpty())
+        return responseSpectrumZ.at(index);
+
+    return nanVal;
+}
+
+
+void GroundMotionTimeHistory::clearResponseSpectra()
+{
+    spectrumPeriods.clear();
+    spectrumDampingRatios.clear();
+    responseSpectrumX.clear();
+    responseSpectrumY.clear();
+    responseSpectrumZ.clear();
 }
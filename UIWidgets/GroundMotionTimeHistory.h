@@ -74,8 +74,29 @@ public:
     double getScalingFactor() const;
     void setScalingFactor(double value);
 
+    // Computes the pseudo-spectral accelerations of the scaled record in each direction that has data, in the units of the record
+    // The spectra are cached, they are only recomputed if the periods or damping ratios change or if the record is modified
+    int computeResponseSpectra(const QVector<double>& periods, const QVector<double>& dampingRatios, QString& err);
+
+    bool hasResponseSpectra() const;
+
+    QVector<double> getSpectrumPeriods() const;
+
+    QVector<double> getSpectrumDampingRatios() const;
+
+    // Row-major with a row for each damping ratio and a column for each period, empty if the record has no data in the direction
+    QVector<double> getResponseSpectrumX() const;
+    QVector<double> getResponseSpectrumY() const;
+    QVector<double> getResponseSpectrumZ() const;
+
+    // The spectral acceleration at one of the cached periods for the first damping ratio, taken as the geometric mean of the horizontal components if both are available
+    // Returns NaN if there is no cached spectrum at the period
+    double getSpectralAcceleration(const double period) const;
+
 private:
 
+    void clearResponseSpectra();
+
     QString GMName;
 
     double dT;
@@ -89,6 +110,13 @@ private:
     double peakIntensityMeasureX;
     double peakIntensityMeasureY;
     double peakIntensityMeasureZ;
+
+    QVector<double> spectrumPeriods;
+    QVector<double> spectrumDampingRatios;
+
+    QVector<double> responseSpectrumX;
+    QVector<double> responseSpectrumY;
+    QVector<double> responseSpectrumZ;
 };
 
 #endif // GROUNDMOTIONTIMEHISTORY_H
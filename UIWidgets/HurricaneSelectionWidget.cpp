@@ -41,12 +41,13 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 #include "VisualizationWidget.h"
 #include "WorkflowAppR2D.h"
 #include "HurricaneParameterWidget.h"
+#include "HurricaneTrackFilterWidget.h"
 #include "SimCenterPreferences.h"
 #include "SiteConfig.h"
-#include "GridNode.h"
 #include "NodeHandle.h"
 #include "LayerTreeItem.h"
 #include "CSVReaderWriter.h"
+#include "HollandWindField.h"
 #include "Utils/ProgramOutputDialog.h"
 
 //Test
@@ -294,6 +295,8 @@ QStackedWidget* HurricaneSelectionWidget::getHurricaneSelectionWidget(void)
 
     hurricaneParamsWidget = new HurricaneParameterWidget();
 
+    trackFilterWidget = new HurricaneTrackFilterWidget();
+
     selectHurricaneLayout->addWidget(loadDbButton,0,0);
     selectHurricaneLayout->addWidget(selectHurricaneButton,0,1);
     selectHurricaneLayout->addWidget(selectedHurricaneLabel,1,0);
@@ -302,6 +305,7 @@ QStackedWidget* HurricaneSelectionWidget::getHurricaneSelectionWidget(void)
     selectHurricaneLayout->addWidget(selectedHurricaneSeason,2,1);
     selectHurricaneLayout->addWidget(SIDLabel,3,0);
     selectHurricaneLayout->addWidget(selectedHurricaneSID,3,1);
+    selectHurricaneLayout->addWidget(trackFilterWidget,4,0,1,2);
     selectHurricaneLayout->rowStretch(3);
 
     // Widget to specify hurricane track
@@ -468,6 +472,16 @@ QStackedWidget* HurricaneSelectionWidget::getHurricaneSelectionWidget(void)
     line2->setFrameShadow(QFrame::Sunken);
     bottomLayout->addWidget(line2);
 
+    QPushButton* previewButton = new QPushButton(tr("&Preview Wind Field"));
+    connect(previewButton,&QPushButton::clicked,this,&HurricaneSelectionWidget::handleWindFieldPreview);
+
+    bottomLayout->addWidget(previewButton);
+
+    QFrame* line3 = new QFrame();
+    line3->setFrameShape(QFrame::VLine);
+    line3->setFrameShadow(QFrame::Sunken);
+    bottomLayout->addWidget(line3);
+
     QLabel* runLabel = new QLabel("Run Hurricane Simulation:");
 
     runButton = new QPushButton(tr("&Run"));
@@ -565,8 +579,11 @@ void HurricaneSelectionWidget::loadHurricaneTrackData(void)
 
     emit loadingComplete(true);
 
-    if(res != 0)
+    // A successful load can still leave a warning, e.g., the tracks that were skipped
+    if(res == nullptr)
         this->errorMessage(errMsg);
+    else if(!errMsg.isEmpty())
+        this->infoMessage(errMsg);
 
     return;
 }
@@ -592,8 +609,8 @@ void HurricaneSelectionWidget::loadHurricaneButtonClicked(void)
 
     this->loadHurricaneTrackData();
 
-    loadDbButton->setText("Database Loaded");
-    loadDbButton->setEnabled(false);
+    // The database can be loaded again with a different filter
+    loadDbButton->setText("Reload Hurricane Database");
 
     // Enable selection
     mapViewSubWidget->enableSelectionTool();
@@ -613,6 +630,8 @@ void HurricaneSelectionWidget::clear(void)
     loadDbButton->setText("Load Hurricane Database");
     loadDbButton->setEnabled(true);
 
+    trackFilterWidget->clear();
+
     hurricaneParamsWidget->clear();
 
     this->clearGridFromMap();
@@ -1050,21 +1069,29 @@ int HurricaneSelectionWidget::loadResults(const QString& outputDir)
             return -1;
         }
 
-        auto pws = station->getStationData();
+        auto headings =  station->getStationDataHeaders();
 
-        if(pws.empty())
+        auto idxPWS = headings.indexOf("PWS");
+
+        if(idxPWS == -1)
         {
-            this->errorMessage("Error getting the peak wind speeds from the results");
+            this->errorMessage("Error, PWS index not found in headers");
             return -1;
         }
 
-        auto headings =  station->getStationDataHeaders();
+        // Only the peak wind speed column is parsed, the station values stay in the shared cache rather than in the station map
+        QVector<double> pws;
 
-        auto idxPWS = headings.indexOf("PWS");
+        try {
+            pws = station->getStationColumn("PWS");
+        } catch (const QString& err) {
+            this->errorMessage(err);
+            return -1;
+        }
 
-        if(idxPWS == -1)
+        if(pws.empty())
         {
-            this->errorMessage("Error, PWS index not found in headers");
+            this->errorMessage("Error getting the peak wind speeds from the results");
             return -1;
         }
 
@@ -1072,10 +1099,10 @@ int HurricaneSelectionWidget::loadResults(const QString& outputDir)
 
         for(int i = 0; i<pws.size()-1; ++i)
         {
-            pwsStr += pws[i].at(idxPWS) + ", ";
+            pwsStr += QString::number(pws[i]) + ", ";
         }
 
-        pwsStr += pws.back().at(idxPWS);
+        pwsStr += QString::number(pws.back());
 
         QString attribute = "Peak Wind Speeds";
 
@@ -1163,6 +1190,46 @@ void HurricaneSelectionWidget::handleHurricaneTrackImport(void)
 }
 
 
+int HurricaneSelectionWidget::getLandfallTrack(QVector<HurricaneTrackPoint>& track, QString& err)
+{
+    track.clear();
+
+    auto landfallObj = hurricaneParamsWidget->getLandfallParamsJson();
+
+    if(landfallObj.isEmpty())
+    {
+        err = "Please define the landfall parameters before previewing the wind field";
+        return -1;
+    }
+
+    HollandWindField windField;
+
+    HurricaneTrackPoint landfall;
+    landfall.latitude = landfallObj["Latitude"].toDouble();
+    landfall.longitude = landfallObj["Longitude"].toDouble();
+    landfall.heading = landfallObj["LandingAngle"].toDouble();
+
+    // The pressure is either the central pressure from the database or the pressure deficit that is entered by the user
+    auto pressure = landfallObj["Pressure"].toDouble();
+    landfall.pressureDeficit = pressure > 500.0 ? windField.getAmbientPressure() - pressure : pressure;
+
+    // Convert from kts to m/s and from nmile to km
+    landfall.translationSpeed = landfallObj["Speed"].toDouble()*0.514444;
+    landfall.radiusMaxWinds = landfallObj["Radius"].toDouble()*1.852;
+
+    if(landfall.pressureDeficit <= 0.0 || landfall.radiusMaxWinds <= 0.0)
+    {
+        err = "The pressure deficit and the radius of the storm at landfall must be greater than zero to preview the wind field";
+        return -1;
+    }
+
+    // Half a day on either side of landfall in 10 minute steps
+    track = HollandWindField::createLinearTrack(landfall, 12.0, 12.0, 10.0);
+
+    return 0;
+}
+
+
 QJsonArray HurricaneSelectionWidget::getTerrainData(void)
 {
     auto terrainPath = this->getTerrainGeojsonPath();
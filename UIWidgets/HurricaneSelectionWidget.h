@@ -54,6 +54,8 @@ class QgsVectorLayer;
 
 class VisualizationWidget;
 class HurricaneParameterWidget;
+class HurricaneTrackFilterWidget;
+struct HurricaneTrackPoint;
 class SiteGrid;
 class SiteConfig;
 
@@ -118,6 +120,9 @@ protected slots:
     virtual void handleLandfallPointSelected(void) = 0;
     virtual void clearLandfallFromMap(void) = 0;
 
+    // Computes the peak gusts of a parametric wind field along the landfall track and shows them on the map
+    virtual void handleWindFieldPreview(void) = 0;
+
 signals:
     void loadingComplete(const bool value);
     void outputDirectoryPathChanged(QString motionDir, QString eventFile);
@@ -128,6 +133,9 @@ protected:
 
     QJsonArray getTerrainData(void);
 
+    // Straight storm track through the landfall point from the landfall parameters
+    int getLandfallTrack(QVector<HurricaneTrackPoint>& track, QString& err);
+
     QPushButton* truncTrackSelectButton = nullptr;
     QPushButton* truncTrackApplyButton = nullptr;
     QPushButton* truncTrackClearButton = nullptr;
@@ -169,6 +177,9 @@ protected:
     QWidget* selectHurricaneWidget = nullptr;
     QWidget* specifyHurricaneWidget = nullptr;
     QPushButton* loadDbButton = nullptr;
+
+    // Season, basin and bounding box filter of the storms that are loaded from the database
+    HurricaneTrackFilterWidget* trackFilterWidget = nullptr;
     QLineEdit* terrainLineEdit = nullptr;
 
     QMap<QString,WindFieldStation> stationMap;
@@ -0,0 +1,161 @@
+/* *****************************************************************************
+Copyright (c) 2016-2021, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT,
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+// Written by: Stevan Gavrilovic
+
+#include "HurricaneTrackFilterWidget.h"
+
+#include <QCheckBox>
+#include <QDoubleValidator>
+#include <QGridLayout>
+#include <QLabel>
+#include <QLineEdit>
+#include <QSpinBox>
+
+HurricaneTrackFilterWidget::HurricaneTrackFilterWidget(QWidget* parent) : QWidget(parent)
+{
+    auto mainLayout = new QGridLayout(this);
+    mainLayout->setContentsMargins(0,5,0,0);
+
+    this->setSizePolicy(QSizePolicy::Maximum,QSizePolicy::Maximum);
+
+    // A season of zero is not used in the filter
+    auto createSeasonSpinBox = [this]()
+    {
+        auto spinBox = new QSpinBox(this);
+        spinBox->setRange(0,2100);
+        spinBox->setSpecialValueText("Any");
+        spinBox->setValue(0);
+        return spinBox;
+    };
+
+    minSeasonSpinBox = createSeasonSpinBox();
+    maxSeasonSpinBox = createSeasonSpinBox();
+
+    basinsLineEdit = new QLineEdit(this);
+    basinsLineEdit->setPlaceholderText("Any, e.g., NA, EP");
+    basinsLineEdit->setToolTip("Comma separated IBTrACS basin codes, e.g., NA for the North Atlantic and EP for the Eastern Pacific");
+
+    boundingBoxCheckBox = new QCheckBox("Only storms with a track point inside of the box",this);
+
+    auto createCoordinateLineEdit = [this](const double min, const double max)
+    {
+        auto lineEdit = new QLineEdit(this);
+        lineEdit->setValidator(new QDoubleValidator(min,max,6,lineEdit));
+        lineEdit->setMinimumWidth(75);
+        lineEdit->setEnabled(false);
+        connect(boundingBoxCheckBox,&QCheckBox::toggled,lineEdit,&QLineEdit::setEnabled);
+        return lineEdit;
+    };
+
+    minLatLineEdit = createCoordinateLineEdit(-90.0,90.0);
+    maxLatLineEdit = createCoordinateLineEdit(-90.0,90.0);
+    minLonLineEdit = createCoordinateLineEdit(-180.0,180.0);
+    maxLonLineEdit = createCoordinateLineEdit(-180.0,180.0);
+
+    mainLayout->addWidget(new QLabel("Seasons",this),0,0);
+    mainLayout->addWidget(minSeasonSpinBox,0,1);
+    mainLayout->addWidget(new QLabel("to",this),0,2);
+    mainLayout->addWidget(maxSeasonSpinBox,0,3);
+
+    mainLayout->addWidget(new QLabel("Basins",this),1,0);
+    mainLayout->addWidget(basinsLineEdit,1,1,1,3);
+
+    mainLayout->addWidget(boundingBoxCheckBox,2,0,1,4);
+
+    mainLayout->addWidget(new QLabel("Latitude [°N]",this),3,0);
+    mainLayout->addWidget(minLatLineEdit,3,1);
+    mainLayout->addWidget(new QLabel("to",this),3,2);
+    mainLayout->addWidget(maxLatLineEdit,3,3);
+
+    mainLayout->addWidget(new QLabel("Longitude [°E]",this),4,0);
+    mainLayout->addWidget(minLonLineEdit,4,1);
+    mainLayout->addWidget(new QLabel("to",this),4,2);
+    mainLayout->addWidget(maxLonLineEdit,4,3);
+}
+
+
+HurricaneTrackFilter HurricaneTrackFilterWidget::getFilter(QString& err) const
+{
+    HurricaneTrackFilter filter;
+
+    if(minSeasonSpinBox->value() > 0)
+        filter.minSeason = minSeasonSpinBox->value();
+
+    if(maxSeasonSpinBox->value() > 0)
+        filter.maxSeason = maxSeasonSpinBox->value();
+
+    for(auto&& basin : basinsLineEdit->text().split(",",QString::SkipEmptyParts))
+    {
+        auto code = basin.trimmed().toUpper();
+
+        if(!code.isEmpty())
+            filter.basins.append(code);
+    }
+
+    if(boundingBoxCheckBox->isChecked())
+    {
+        bool OK1, OK2, OK3, OK4;
+
+        filter.minLat = minLatLineEdit->text().toDouble(&OK1);
+        filter.maxLat = maxLatLineEdit->text().toDouble(&OK2);
+        filter.minLon = minLonLineEdit->text().toDouble(&OK3);
+        filter.maxLon = maxLonLineEdit->text().toDouble(&OK4);
+
+        if(!OK1 || !OK2 || !OK3 || !OK4 || filter.minLat > filter.maxLat || filter.minLon > filter.maxLon)
+        {
+            err = "The bounding box of the hurricane filter needs a minimum and maximum latitude and longitude, with the minimum less than the maximum";
+            return HurricaneTrackFilter();
+        }
+
+        filter.useBoundingBox = true;
+    }
+
+    return filter;
+}
+
+
+void HurricaneTrackFilterWidget::clear()
+{
+    minSeasonSpinBox->setValue(0);
+    maxSeasonSpinBox->setValue(0);
+    basinsLineEdit->clear();
+    boundingBoxCheckBox->setChecked(false);
+    minLatLineEdit->clear();
+    maxLatLineEdit->clear();
+    minLonLineEdit->clear();
+    maxLonLineEdit->clear();
+}
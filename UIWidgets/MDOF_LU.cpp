@@ -38,7 +38,11 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 
 #include "MDOF_LU.h"
 #include "SimCenterPreferences.h"
+#include "ComponentDatabaseManager.h"
+#include "HazusMDOFGenerator.h"
+#include "REmpiricalProbabilityDistribution.h"
 
+#include <QCoreApplication>
 #include <QDebug>
 #include <QFileDialog>
 #include <QFileInfo>
@@ -49,11 +53,20 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 #include <QLineEdit>
 #include <QPushButton>
 #include <QTextEdit>
+#include <QChart>
+#include <QChartView>
+#include <QLineSeries>
+#include <QValueAxis>
+
+#include <qgsvectorlayer.h>
+
+using namespace QtCharts;
 
 MDOF_LU::MDOF_LU(QWidget *parent)
   : SimCenterAppWidget(parent)
 {
     QGridLayout *layout = new QGridLayout();
+    theLayout = layout;
 
     QLabel *hazusLabel = new QLabel("Hazus Data File");
     hazusDataFile = new QLineEdit;
@@ -92,6 +105,14 @@ MDOF_LU::MDOF_LU(QWidget *parent)
     layout->addWidget(new QLabel("Default Story Height:"), 3,0);
     layout->addWidget(storyHeight,   3,1);
 
+    QPushButton *previewButton = new QPushButton("Preview Periods");
+    previewButton->setToolTip("First mode periods of the models of the buildings, built from the capacity curves of the Hazus data file and the story height");
+    periodSummaryLabel = new QLabel();
+    periodSummaryLabel->setWordWrap(true);
+    connect(previewButton,SIGNAL(clicked()),this,SLOT(previewPeriods()));
+    layout->addWidget(previewButton,      4,0);
+    layout->addWidget(periodSummaryLabel, 4,1,1,2);
+
     auto citation1 = new QLabel("This backend application used by this selection was provided by Prof. Xinzheng Lu, Tsinghua University, China. "
                                        "Users should cite the work as follows:");
 
@@ -106,12 +127,13 @@ MDOF_LU::MDOF_LU(QWidget *parent)
     citation2->setWordWrap(true);
     citation3->setWordWrap(true);
 
+    // Row 5 holds the period chart once there is a preview
     QLabel *spacer = new QLabel("");
-    layout->addWidget(spacer,4,0);
-    layout->addWidget(citation1, 5, 0, 1,2);
-    layout->addWidget(citation2, 6, 0, 1, 2);
-    layout->addWidget(citation3, 7, 0, 1, 2);
-    layout->setRowStretch(8,1);
+    layout->addWidget(spacer,6,0);
+    layout->addWidget(citation1, 7, 0, 1,2);
+    layout->addWidget(citation2, 8, 0, 1, 2);
+    layout->addWidget(citation3, 9, 0, 1, 2);
+    layout->setRowStretch(10,1);
 
     this->setLayout(layout);
 }
@@ -128,6 +150,10 @@ void MDOF_LU::clear(void)
     hazusDataFile->clear();
     stdStiffness->clear();
     stdDamping->clear();
+    periodSummaryLabel->clear();
+
+    if(periodChart != nullptr)
+        periodChart->removeAllSeries();
 }
 
 
@@ -154,7 +180,7 @@ bool MDOF_LU::outputAppDataToJSON(QJsonObject &jsonObject) {
     dataObj["stdDamping"] = stdDamping->text().toDouble();
 
     if(storyHeight->text() != "") {
-        dataObj["storyHeight"] = stdDamping->text();
+        dataObj["storyHeight"] = storyHeight->text().toDouble();
     }
 
     QFileInfo theFile(hazusDataFile->text());
@@ -251,6 +277,181 @@ void MDOF_LU::chooseFileName1(void) {
 }
 
 
+void MDOF_LU::previewPeriods(void)
+{
+    periodSummaryLabel->clear();
+
+    HazusMDOFGenerator generator;
+
+    // The models are built from the Hazus data file that is given to the backend, the table of the Hazus elastic periods that ships with R2D is used if there is none
+    QString hazusFilePath = hazusDataFile->text();
+
+    if(!QFileInfo::exists(hazusFilePath))
+        hazusFilePath = QCoreApplication::applicationDirPath() + QDir::separator() + "Databases" + QDir::separator() + "HazusMDOF" + QDir::separator() + "HazusBuildingPeriods.txt";
+
+    QString err;
+    if(generator.readHazusData(hazusFilePath, err) != 0)
+    {
+        this->errorMessage(err);
+        return;
+    }
+
+    generator.setStdStiffness(stdStiffness->text().toDouble());
+    generator.setStdDamping(stdDamping->text().toDouble());
+    generator.setStoryHeight(storyHeight->text().toDouble());
+
+    auto theBuildingDB = ComponentDatabaseManager::getInstance()->getAssetDb("Buildings");
+
+    if(theBuildingDB == nullptr || theBuildingDB->isEmpty())
+    {
+        this->errorMessage("Load a building inventory to preview the periods of the MDOF-LU models");
+        return;
+    }
+
+    // Use the selected buildings if there are any, otherwise the whole inventory
+    QgsVectorLayer* layer = theBuildingDB->getSelectedLayer();
+    if(layer == nullptr || layer->featureCount() == 0)
+        layer = theBuildingDB->getMainLayer();
+
+    auto fields = layer->fields();
+    auto typeIndex = fields.lookupField("StructureType");
+    auto storiesIndex = fields.lookupField("NumberOfStories");
+    auto areaIndex = fields.lookupField("PlanArea");
+    auto yearIndex = fields.lookupField("YearBuilt");
+
+    if(typeIndex == -1 || storiesIndex == -1)
+    {
+        this->errorMessage("The building inventory needs the StructureType and NumberOfStories attributes to preview the periods of the MDOF-LU models");
+        return;
+    }
+
+    QgsAttributeList fieldIndexes = {typeIndex, storiesIndex};
+    if(areaIndex != -1)
+        fieldIndexes.append(areaIndex);
+    if(yearIndex != -1)
+        fieldIndexes.append(yearIndex);
+
+    QgsFeatureRequest featRequest;
+    featRequest.setFlags(QgsFeatureRequest::NoGeometry);
+    featRequest.setSubsetOfAttributes(fieldIndexes);
+
+    QVector<MDOFBuilding> buildings;
+    buildings.reserve(layer->featureCount());
+
+    // The plan areas of the inventory are in sq ft, the periods do not depend on them since the stiffness is scaled with the weight
+    const double sqftToSqm = 0.09290304;
+
+    int numSkipped = 0;
+
+    QgsFeatureIterator featIt = layer->getFeatures(featRequest);
+    QgsFeature feature;
+    while(featIt.nextFeature(feature))
+    {
+        MDOFBuilding building;
+        building.structureType = feature.attribute(typeIndex).toString();
+        building.numStories = feature.attribute(storiesIndex).toInt();
+        building.planArea = areaIndex != -1 ? feature.attribute(areaIndex).toDouble()*sqftToSqm : 0.0;
+        building.yearBuilt = yearIndex != -1 ? feature.attribute(yearIndex).toInt() : 0;
+
+        if(building.planArea <= 0.0)
+            building.planArea = 1.0;
+
+        if(building.numStories < 1)
+        {
+            ++numSkipped;
+            continue;
+        }
+
+        buildings.append(building);
+    }
+
+    MDOFModels models;
+    if(generator.generateModels(buildings, 1, 1, models, err) != 0)
+    {
+        this->errorMessage(err);
+        return;
+    }
+
+    REmpiricalProbabilityDistribution probDist;
+
+    for(int i = 0; i<buildings.size(); ++i)
+    {
+        if(models.buildingClass.at(i) != -1)
+            probDist.addSample(models.periods.at(i*models.numModes));
+        else
+            ++numSkipped;
+    }
+
+    if(probDist.getNumberSamples() == 0)
+    {
+        this->errorMessage("None of the buildings have a structure type that is in the Hazus data file");
+        return;
+    }
+
+    periodSummaryLabel->setText("First mode period [s] of " + QString::number(probDist.getNumberSamples()) + " buildings: mean " + QString::number(probDist.mean(), 'f', 3) +
+                                ", min " + QString::number(probDist.getMin(), 'f', 3) + ", max " + QString::number(probDist.getMax(), 'f', 3) +
+                                (numSkipped > 0 ? ", " + QString::number(numSkipped) + " buildings without a model" : QString()));
+
+    QVector<double> xValues;
+    QVector<double> yValues;
+
+    // Handle the special case where there is only one sample
+    if(probDist.getNumberSamples() < 2)
+    {
+        xValues = probDist.getValues();
+        yValues.push_back(1.0);
+    }
+    else
+    {
+        xValues = probDist.getHistogramTicks();
+        yValues = probDist.getRelativeFrequencyDiagram();
+    }
+
+    QLineSeries *series = new QLineSeries();
+
+    for(int i = 0; i<yValues.size(); ++i)
+        series->append(xValues.at(i),yValues.at(i));
+
+    if(periodChart == nullptr)
+    {
+        periodChart = new QChart();
+        periodChart->setDropShadowEnabled(false);
+        periodChart->setMargins(QMargins(5,5,5,5));
+        periodChart->layout()->setContentsMargins(0, 0, 0, 0);
+        periodChart->legend()->setVisible(false);
+
+        periodChartView = new QChartView(periodChart);
+        periodChartView->setRenderHint(QPainter::Antialiasing);
+        periodChartView->setContentsMargins(0,0,0,0);
+        periodChartView->setMinimumHeight(200);
+        periodChartView->setSizePolicy(QSizePolicy::Expanding,QSizePolicy::Expanding);
+
+        theLayout->addWidget(periodChartView, 5, 0, 1, 3);
+    }
+    else
+    {
+        periodChart->removeAllSeries();
+
+        for(auto&& it : periodChart->axes())
+            periodChart->removeAxis(it);
+    }
+
+    periodChart->addSeries(series);
+
+    QValueAxis *axisX = new QValueAxis();
+    axisX->setGridLineVisible(false);
+    axisX->setTitleText("First Mode Period [s]");
+    periodChart->addAxis(axisX, Qt::AlignBottom);
+    series->attachAxis(axisX);
+
+    QValueAxis *axisY = new QValueAxis();
+    axisY->setGridLineVisible(false);
+    axisY->setTitleText("Relative Frequency %");
+    periodChart->addAxis(axisY, Qt::AlignLeft);
+    series->attachAxis(axisY);
+}
+
+
 bool MDOF_LU::copyFiles(QString &dirName) {
 
     QString fileName = hazusDataFile->text();
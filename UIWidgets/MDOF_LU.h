@@ -46,6 +46,13 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 #include <QComboBox>
 
 class InputWidgetParameters;
+class QLabel;
+
+namespace QtCharts
+{
+class QChartView;
+class QChart;
+}
 
 class MDOF_LU : public SimCenterAppWidget
 {
@@ -67,11 +74,19 @@ public slots:
    void clear(void) override;
    void chooseFileName1(void);
 
+   // Generates the models of the selected buildings with the native Hazus MDOF generator and plots the distribution of their first mode periods
+   void previewPeriods(void);
+
 private:
     QLineEdit *hazusDataFile;
     QLineEdit *stdStiffness;
     QLineEdit *stdDamping;
     QLineEdit *storyHeight;
+
+    QGridLayout *theLayout;
+    QLabel *periodSummaryLabel;
+    QtCharts::QChartView *periodChartView = nullptr;
+    QtCharts::QChart *periodChart = nullptr;
 };
 
 #endif // MDOF_LU_H
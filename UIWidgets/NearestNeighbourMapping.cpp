@@ -37,17 +37,28 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 // Written by: Stevan Gavrilovic
 
 #include "NearestNeighbourMapping.h"
+#include "NearestNeighbourMapper.h"
+#include "CSVReaderWriter.h"
+#include "REmpiricalProbabilityDistribution.h"
 #include "SimCenterPreferences.h"
 
+#include <QChart>
+#include <QChartView>
 #include <QComboBox>
 #include <QDebug>
 #include <QDir>
+#include <QFileDialog>
 #include <QGridLayout>
 #include <QGroupBox>
 #include <QIntValidator>
 #include <QJsonObject>
 #include <QLabel>
 #include <QLineEdit>
+#include <QLineSeries>
+#include <QPushButton>
+#include <QValueAxis>
+
+using namespace QtCharts;
 
 NearestNeighbourMapping::NearestNeighbourMapping(QWidget *parent) : SimCenterAppWidget(parent)
 {
@@ -82,7 +93,50 @@ NearestNeighbourMapping::NearestNeighbourMapping(QWidget *parent) : SimCenterApp
     regionalMapLayout->addWidget(new QLabel("Seed"), 2, 0);
     regionalMapLayout->addWidget(randomSeed, 2, 1);
 
-    regionalMapLayout->setRowStretch(3,1);
+    // Preview of the mapping before the analysis is run
+    QGroupBox* previewGroupBox = new QGroupBox("Mapping Preview", this);
+    previewLayout = new QGridLayout(previewGroupBox);
+
+    stationFileLineEdit = new QLineEdit(this);
+    stationFileLineEdit->setToolTip("CSV file with the Latitude and Longitude of the stations, e.g., the EventGrid.csv file of the hazard");
+    QPushButton* stationBrowseButton = new QPushButton("Browse",this);
+
+    assetFileLineEdit = new QLineEdit(this);
+    assetFileLineEdit->setToolTip("CSV file with the Latitude and Longitude of the assets");
+    QPushButton* assetBrowseButton = new QPushButton("Browse",this);
+
+    connect(stationBrowseButton, &QPushButton::clicked, this, [this]()
+    {
+        auto path = QFileDialog::getOpenFileName(this,tr("Station File"),QString(),QString("*.csv"));
+        if(!path.isEmpty())
+            stationFileLineEdit->setText(path);
+    });
+
+    connect(assetBrowseButton, &QPushButton::clicked, this, [this]()
+    {
+        auto path = QFileDialog::getOpenFileName(this,tr("Asset File"),QString(),QString("*.csv"));
+        if(!path.isEmpty())
+            assetFileLineEdit->setText(path);
+    });
+
+    QPushButton* previewButton = new QPushButton("Preview Mapping",this);
+
+    connect(previewButton, &QPushButton::clicked, this, &NearestNeighbourMapping::previewMapping);
+
+    mappingSummaryLabel = new QLabel(this);
+
+    previewLayout->addWidget(new QLabel("Station file"), 0, 0);
+    previewLayout->addWidget(stationFileLineEdit, 0, 1);
+    previewLayout->addWidget(stationBrowseButton, 0, 2);
+    previewLayout->addWidget(new QLabel("Asset file"), 1, 0);
+    previewLayout->addWidget(assetFileLineEdit, 1, 1);
+    previewLayout->addWidget(assetBrowseButton, 1, 2);
+    previewLayout->addWidget(previewButton, 2, 0);
+    previewLayout->addWidget(mappingSummaryLabel, 3, 0, 1, 3);
+
+    regionalMapLayout->addWidget(previewGroupBox, 3, 0, 1, 2);
+
+    regionalMapLayout->setRowStretch(4,1);
     
 }
 
@@ -141,6 +195,21 @@ void NearestNeighbourMapping::clear(void)
     srand(time(NULL));
     int randomNumber = rand() % 1000 + 1;
     randomSeed->setText(QString::number(randomNumber));    
+
+    assetIDs.clear();
+    stationIDs.clear();
+    mappingSamples.clear();
+    nearestDistances.clear();
+    numMappingSamples = 0;
+    mappingSummaryLabel->clear();
+
+    if(distanceChart != nullptr)
+    {
+        distanceChart->removeAllSeries();
+
+        for(auto&& it : distanceChart->axes())
+            distanceChart->removeAxis(it);
+    }
 }
 
 
@@ -149,3 +218,193 @@ bool NearestNeighbourMapping::copyFiles(QString &destName)
   return true;
 }
 
+
+int NearestNeighbourMapping::readLocations(const QString& pathToFile, const QStringList& idColumns, QStringList& ids, QVector<double>& latitudes, QVector<double>& longitudes, QString& err)
+{
+    CSVReaderWriter csvTool;
+
+    auto data = csvTool.parseCSVFile(pathToFile, err);
+
+    if(!err.isEmpty())
+        return -1;
+
+    if(data.size() < 2)
+    {
+        err = "The file " + pathToFile + " does not contain any rows";
+        return -1;
+    }
+
+    auto header = data.first();
+
+    auto latIndex = header.indexOf("Latitude");
+    auto lonIndex = header.indexOf("Longitude");
+
+    if(latIndex == -1 || lonIndex == -1)
+    {
+        err = "The file " + pathToFile + " must have Latitude and Longitude columns";
+        return -1;
+    }
+
+    int idIndex = -1;
+    for(auto&& it : idColumns)
+    {
+        idIndex = header.indexOf(it);
+        if(idIndex != -1)
+            break;
+    }
+
+    const int numRows = data.size() - 1;
+
+    ids.clear();
+    latitudes.clear();
+    longitudes.clear();
+
+    ids.reserve(numRows);
+    latitudes.reserve(numRows);
+    longitudes.reserve(numRows);
+
+    for(int i = 1; i<data.size(); ++i)
+    {
+        const auto& row = data.at(i);
+
+        if(row.size() != header.size())
+        {
+            err = "The number of items in row " + QString::number(i) + " of " + pathToFile + " does not match the header";
+            return -1;
+        }
+
+        bool latOk = false, lonOk = false;
+        latitudes.append(row.at(latIndex).toDouble(&latOk));
+        longitudes.append(row.at(lonIndex).toDouble(&lonOk));
+
+        if(!latOk || !lonOk)
+        {
+            err = "Could not read the coordinates in row " + QString::number(i) + " of " + pathToFile;
+            return -1;
+        }
+
+        ids.append(idIndex != -1 ? row.at(idIndex) : QString::number(i));
+    }
+
+    return 0;
+}
+
+
+void NearestNeighbourMapping::previewMapping(void)
+{
+    mappingSamples.clear();
+    nearestDistances.clear();
+    numMappingSamples = 0;
+    mappingSummaryLabel->clear();
+
+    QString err;
+
+    QVector<double> stationLatitudes, stationLongitudes;
+    if(this->readLocations(stationFileLineEdit->text(), {"GP_file", "ID", "id"}, stationIDs, stationLatitudes, stationLongitudes, err) != 0)
+    {
+        this->errorMessage(err);
+        return;
+    }
+
+    QVector<double> assetLatitudes, assetLongitudes;
+    if(this->readLocations(assetFileLineEdit->text(), {"id", "ID", "AIM_id"}, assetIDs, assetLatitudes, assetLongitudes, err) != 0)
+    {
+        this->errorMessage(err);
+        return;
+    }
+
+    NearestNeighbourMapper mapper;
+    if(mapper.setStations(stationLatitudes, stationLongitudes, err) != 0)
+    {
+        this->errorMessage(err);
+        return;
+    }
+
+    const int numSamples = samplesLineEdit->text().toInt();
+
+    auto res = mapper.computeMapping(assetLatitudes, assetLongitudes, neighborsLineEdit->text().toInt(), numSamples, randomSeed->text().toInt(), mappingSamples, nearestDistances, err);
+
+    if(res != 0)
+    {
+        this->errorMessage(err);
+        return;
+    }
+
+    numMappingSamples = numSamples;
+
+    this->plotDistanceDistribution();
+
+    this->statusMessage("Mapped " + QString::number(assetIDs.size()) + " assets to " + QString::number(stationIDs.size()) + " stations");
+}
+
+
+void NearestNeighbourMapping::plotDistanceDistribution(void)
+{
+    if(nearestDistances.isEmpty())
+        return;
+
+    REmpiricalProbabilityDistribution probDist;
+
+    for(auto&& it : nearestDistances)
+        probDist.addSample(it);
+
+    mappingSummaryLabel->setText("Distance to the nearest station [km]: mean " + QString::number(probDist.mean(), 'f', 2) +
+                                 ", max " + QString::number(probDist.getMax(), 'f', 2));
+
+    QVector<double> xValues;
+    QVector<double> yValues;
+
+    // Handle the special case where there is only one sample
+    if(probDist.getNumberSamples() < 2)
+    {
+        xValues = probDist.getValues();
+        yValues.push_back(1.0);
+    }
+    else
+    {
+        xValues = probDist.getHistogramTicks();
+        yValues = probDist.getRelativeFrequencyDiagram();
+    }
+
+    QLineSeries *series = new QLineSeries();
+
+    for(int i = 0; i<yValues.size(); ++i)
+        series->append(xValues.at(i),yValues.at(i));
+
+    if(distanceChart == nullptr)
+    {
+        distanceChart = new QChart();
+        distanceChart->setDropShadowEnabled(false);
+        distanceChart->setMargins(QMargins(5,5,5,5));
+        distanceChart->layout()->setContentsMargins(0, 0, 0, 0);
+        distanceChart->legend()->setVisible(false);
+
+        distanceChartView = new QChartView(distanceChart);
+        distanceChartView->setRenderHint(QPainter::Antialiasing);
+        distanceChartView->setContentsMargins(0,0,0,0);
+        distanceChartView->setMinimumHeight(200);
+        distanceChartView->setSizePolicy(QSizePolicy::Expanding,QSizePolicy::Expanding);
+
+        previewLayout->addWidget(distanceChartView, 4, 0, 1, 3);
+    }
+    else
+    {
+        distanceChart->removeAllSeries();
+
+        for(auto&& it : distanceChart->axes())
+            distanceChart->removeAxis(it);
+    }
+
+    distanceChart->addSeries(series);
+
+    QValueAxis *axisX = new QValueAxis();
+    axisX->setGridLineVisible(false);
+    axisX->setLabelsVisible(true);
+    axisX->setTitleText("Distance to nearest station [km]");
+    distanceChart->addAxis(axisX, Qt::AlignBottom);
+
+    axisX->setMin(0.0);
+
+    series->attachAxis(axisX);
+}
+
@@ -40,7 +40,18 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 
 #include <SimCenterAppWidget.h>
 
+#include <QStringList>
+#include <QVector>
+
 class QLineEdit;
+class QLabel;
+class QGridLayout;
+
+namespace QtCharts
+{
+class QChartView;
+class QChart;
+}
 
 class NearestNeighbourMapping : public SimCenterAppWidget
 {
@@ -58,10 +69,36 @@ public:
 
 signals:
 
+private slots:
+
+    // Maps the assets to the stations with the current settings and shows the distribution of the distances to the nearest station
+    void previewMapping(void);
+
 private:
+
+    // Reads the IDs and coordinates from a CSV file with latitude and longitude columns, the ID is taken from the first of the ID columns that is found, or is the row number
+    int readLocations(const QString& pathToFile, const QStringList& idColumns, QStringList& ids, QVector<double>& latitudes, QVector<double>& longitudes, QString& err);
+
+    void plotDistanceDistribution(void);
+
     QLineEdit *samplesLineEdit;
     QLineEdit *neighborsLineEdit;
     QLineEdit *randomSeed;
+
+    QLineEdit *stationFileLineEdit;
+    QLineEdit *assetFileLineEdit;
+    QLabel *mappingSummaryLabel;
+    QGridLayout *previewLayout;
+
+    QtCharts::QChartView *distanceChartView = nullptr;
+    QtCharts::QChart *distanceChart = nullptr;
+
+    // Result of the last preview, the samples are the station indices of each asset in a row-major table
+    QStringList assetIDs;
+    QStringList stationIDs;
+    QVector<int> mappingSamples;
+    QVector<double> nearestDistances;
+    int numMappingSamples = 0;
 };
 
 
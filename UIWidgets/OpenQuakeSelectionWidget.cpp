@@ -56,6 +56,11 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 #include <QFileDialog>
 #include <QStandardPaths>
 #include <QGroupBox>
+#include <QApplication>
+#include <QFileInfo>
+#include <QtConcurrent/QtConcurrent>
+
+#include <cmath>
 
 OpenQuakeSelectionWidget::OpenQuakeSelectionWidget(QGISVisualizationWidget* visWidget, QWidget *parent) : SimCenterAppWidget(parent), theVisualizationWidget(visWidget)
 {
@@ -250,16 +255,14 @@ void OpenQuakeSelectionWidget::loadOpenQuakeXMLData(void)
 
     auto filePath = xmlImportPathLineEdit->text();
 
-    // Load xml file
-    QFile file(filePath);
-    if (!file.open(QIODevice::ReadOnly ))
+    if(!QFileInfo::exists(filePath))
     {
         // Error while loading file
         this->errorMessage("Error while loading file "+filePath);
         return;
     }
 
-    if(!xmlGMs.isNull())
+    if(!sourceModelFilePath.isEmpty())
     {
         this->clear();
         xmlImportPathLineEdit->setText(filePath);
@@ -268,36 +271,34 @@ void OpenQuakeSelectionWidget::loadOpenQuakeXMLData(void)
     theStackedWidget->setCurrentWidget(progressBarWidget);
     progressBarWidget->setVisible(true);
 
-    // QDomDocument used to import XML data
-    // Set raw XML content into the QDomDocument
-    xmlGMs.setContent(&file);
-
-    // Close the file now that we are done with it
-    file.close();
+    progressBar->setRange(0,100);
+    progressBar->reset();
+    QApplication::processEvents();
 
-    // Extract the root element
-    auto root = xmlGMs.documentElement();
+    auto progress = [this](int percent)
+    {
+        progressBar->setValue(percent);
+        QApplication::processEvents();
+    };
 
-    // Get root names and attributes
-    //QString Type = root.tagName();
+    // Stream the sources out of the xml file in a single pass
+    OpenQuakeSourceModelReader sourceModelReader;
 
+    QVector<OpenQuakeSource> sources;
 
-    auto sourceModelList = root.elementsByTagName("sourceModel");
+    QString err;
+    auto res = sourceModelReader.readSourceModel(filePath, sources, err, progress);
 
-    if(sourceModelList.size() == 0)
+    if(res != 0)
     {
-        this->errorMessage("Could not find sourceModel tag in .xml file");
+        this->errorMessage(err);
         // Reset the widget back to the input pane and close
         theStackedWidget->setCurrentWidget(fileInputWidget);
         fileInputWidget->setVisible(true);
         return;
     }
 
-    auto sourceModelRoot = sourceModelList.at(0);
-
-    auto sourceList = sourceModelRoot.childNodes();
-
-    auto numSources = sourceList.size();
+    auto numSources = sourceModelReader.getNumSourcesInModel();
 
     if(numSources==0)
     {
@@ -308,84 +309,19 @@ void OpenQuakeSelectionWidget::loadOpenQuakeXMLData(void)
         return;
     }
 
-    auto sourceName = sourceModelRoot.attributes().namedItem("name").nodeValue();
-    this->statusMessage("Importing sources "+sourceName);
-
-    // For testing start
-    //    QSet<QString> sourceTypes;
-
-    //    for(int i = 0; i<numSources; ++i)
-    //    {
-    //        auto sourceType = sourceList.at(i).nodeName();
-
-    //        sourceTypes.insert(sourceType);
-    //    }
-
-    //    for(auto&& it: sourceTypes)
-    //        qDebug()<<it;
-    // For testing end
-
-    QDomNodeList pointSources = root.elementsByTagName("pointSource");
-
-    auto res = this->getPointSources(&pointSources);
-
-    if(res == -1)
-    {
-        this->errorMessage("Failed to import point sources. Something went wrong");
-        // Reset the widget back to the input pane and close
-        theStackedWidget->setCurrentWidget(fileInputWidget);
-        fileInputWidget->setVisible(true);
-        return;
-    }
-
-    QDomNodeList characLineSources = root.elementsByTagName("characteristicFaultSource");
-
-    res = this->getCharacteristicComplexLineSources(&characLineSources,true);
-
-    if(res == -1)
-    {
-        this->errorMessage("Failed to import line sources. Something went wrong");
-        // Reset the widget back to the input pane and close
-        theStackedWidget->setCurrentWidget(fileInputWidget);
-        fileInputWidget->setVisible(true);
-        return;
-    }
-
-
-    QDomNodeList compLineSources = root.elementsByTagName("complexFaultSource");
-
-    res = this->getCharacteristicComplexLineSources(&compLineSources,false);
-
-    if(res == -1)
-    {
-        this->errorMessage("Failed to import line sources. Something went wrong");
-        // Reset the widget back to the input pane and close
-        theStackedWidget->setCurrentWidget(fileInputWidget);
-        fileInputWidget->setVisible(true);
-        return;
-    }
-
+    sourceModelFilePath = filePath;
 
-    QDomNodeList simpleFaultSources = root.elementsByTagName("simpleFaultSource");
+    this->statusMessage("Importing sources "+sourceModelReader.getSourceModelName());
 
-    res = this->getSimpleFaultSources(&simpleFaultSources);
+    auto unsupportedTypes = sourceModelReader.getUnsupportedSourceTypes();
+    if(!unsupportedTypes.isEmpty())
+        this->infoMessage("The following source types are not supported and will not be imported: "+unsupportedTypes.join(", "));
 
-    if(res == -1)
-    {
-        this->errorMessage("Failed to import area sources. Something went wrong");
-        // Reset the widget back to the input pane and close
-        theStackedWidget->setCurrentWidget(fileInputWidget);
-        fileInputWidget->setVisible(true);
-        return;
-    }
-
-    QDomNodeList areaSources = root.elementsByTagName("areaSource");
-
-    res = this->getAreaSources(&areaSources);
+    res = this->addSourcesToLayers(sources);
 
     if(res == -1)
     {
-        this->errorMessage("Failed to import area sources. Something went wrong");
+        this->errorMessage("Failed to import the sources. Something went wrong");
         // Reset the widget back to the input pane and close
         theStackedWidget->setCurrentWidget(fileInputWidget);
         fileInputWidget->setVisible(true);
@@ -491,7 +427,7 @@ void OpenQuakeSelectionWidget::clear(void)
     xmlImportPathLineEdit->clear();
     xmlExportPathLineEdit->clear();
 
-    xmlGMs.clear();
+    sourceModelFilePath.clear();
 
     selectedLayerGroup.clear();
     referenceLayerGroup.clear();
@@ -535,463 +471,147 @@ void OpenQuakeSelectionWidget::clearSelection(void)
         areaReferenceLayer->removeSelection();
 }
 
-int OpenQuakeSelectionWidget::getPointSources(QDomNodeList* pointSources)
+int OpenQuakeSelectionWidget::addSourcesToLayers(const QVector<OpenQuakeSource>& sources)
 {
-
-    auto numSources = pointSources->size();
-    if(numSources == 0)
+    if(sources.isEmpty())
         return 0;
 
-    QDomNode firstItem = pointSources->item(0);
-
-    //auto nodeName = firstItem.nodeName();
-
-    QDomNamedNodeMap xmlAtrb = firstItem.attributes();
-
-    // Create the fields
-    QList<QgsField> attribFields;
-    for(int i = 0; i< xmlAtrb.size(); ++i)
-    {
-        QDomNode item = xmlAtrb.item(i);
-
-        auto name = item.nodeName();
-
-        attribFields.push_back(QgsField(name, QVariant::String));
-    }
-
-    // auto numFields = attribFields.size();
+    // Typed fields, the numeric parameters that are not given for a source are null
+    QList<QgsField> attribFields = {QgsField("id", QVariant::String),
+                                    QgsField("name", QVariant::String),
+                                    QgsField("tectonicRegion", QVariant::String),
+                                    QgsField("sourceType", QVariant::String),
+                                    QgsField("magScaleRel", QVariant::String),
+                                    QgsField("ruptAspectRatio", QVariant::Double),
+                                    QgsField("upperSeismoDepth", QVariant::Double),
+                                    QgsField("lowerSeismoDepth", QVariant::Double),
+                                    QgsField("dip", QVariant::Double),
+                                    QgsField("rake", QVariant::Double),
+                                    QgsField("aValue", QVariant::Double),
+                                    QgsField("bValue", QVariant::Double),
+                                    QgsField("minMag", QVariant::Double),
+                                    QgsField("maxMag", QVariant::Double)};
+
+    auto toVariant = [](const double val) -> QVariant
+    {
+        return std::isnan(val) ? QVariant(QVariant::Double) : QVariant(val);
+    };
 
-    QgsFeatureList featureList;
-    featureList.reserve(numSources);
-    for(int i = 0; i < numSources; ++i)
+    // Parsing the coordinates and creating the geometries is done on worker threads
+    struct FeatureJob
     {
-        QDomNode item = pointSources->item(i);
-
-        QDomNamedNodeMap xmlAtrb = item.attributes();
-
-        auto numAtributes = xmlAtrb.size();
-
-        // create the feature attributes
-        QgsAttributes featAttributes(numAtributes);
-
-        // Get the feature attibutes
-        for(int i = 0; i< numAtributes; ++i)
-        {
-            QDomNode item = xmlAtrb.item(i);
-            auto val = item.nodeValue();
-
-            featAttributes[i] = val;
-        }
-
-        QDomNode geom = item.namedItem("pointGeometry").namedItem("gml:Point").namedItem("gml:pos");
-
-        if(geom.isNull())
-        {
-            this->errorMessage("Could not get geometry for node "+item.nodeName());
-            return -1;
-        }
-
-        auto val = geom.toElement().text();
-
-        // Split according to space
-        auto pointsList = val.split(" ",Qt::SkipEmptyParts);
-
-        // First number is lon, second is lat
-        bool OK = true;
-
-        auto longitude = pointsList[0].toDouble(&OK);
-
-        if(!OK)
-        {
-            this->errorMessage("Error converting longitude to double for node "+item.nodeName());
-            return -1;
-        }
-
-        auto latitude = pointsList[1].toDouble(&OK);
-
-        if(!OK)
-        {
-            this->errorMessage("Error converting latitude to double for node "+item.nodeName());
-            return -1;
-        }
-
-        if(longitude == 0.0 || latitude == 0.0)
-        {
-            this->errorMessage("Error, zero lat lon values for node "+item.nodeName());
-            return -1;
-        }
-
-        // Create the feature
+        const OpenQuakeSource* source = nullptr;
         QgsFeature feature;
-        feature.setGeometry(QgsGeometry::fromPointXY(QgsPointXY(longitude,latitude)));
-        feature.setAttributes(featAttributes);
-        featureList.append(feature);
-    }
-
-    pointReferenceLayer = theVisualizationWidget->addVectorLayer("Point", "Point Sources");
-
-    if(pointReferenceLayer == nullptr)
-    {
-        this->errorMessage("Error creating a layer");
-        return -1;
-    }
-
-    referenceLayerGroup.append(pointReferenceLayer);
-
-    auto dProvider = pointReferenceLayer->dataProvider();
-    auto res = dProvider->addAttributes(attribFields);
-
-    if(!res)
-    {
-        this->errorMessage("Error adding attribute fields to layer");
-        theVisualizationWidget->removeLayer(pointReferenceLayer);
-        return -1;
-    }
-
-    pointReferenceLayer->updateFields(); // tell the vector layer to fetch changes from the provider
-
-    dProvider->addFeatures(featureList);
-    pointReferenceLayer->updateExtents();
-
-    theVisualizationWidget->createSymbolRenderer(Qgis::MarkerShape::Cross,Qt::black,2.0,pointReferenceLayer);
-
-
-    return 0;
-}
-
-
-int OpenQuakeSelectionWidget::getCharacteristicComplexLineSources(QDomNodeList* lineSources, bool isCharacteristic)
-{
-
-    auto numSources = lineSources->size();
-    if(numSources == 0)
-        return 0;
-
-    QDomNode firstItem = lineSources->item(0);
+        QString err;
+    };
 
-    // auto nodeName = firstItem.nodeName();
+    std::vector<FeatureJob> jobs(sources.size());
+    for(int i = 0; i<sources.size(); ++i)
+        jobs[i].source = &sources.at(i);
 
-    QDomNamedNodeMap xmlAtrb = firstItem.attributes();
+    const auto numAtrb = attribFields.size();
 
-    // Create the fields
-    QList<QgsField> attribFields;
-    for(int i = 0; i< xmlAtrb.size(); ++i)
+    QtConcurrent::blockingMap(jobs, [&](FeatureJob& job)
     {
-        QDomNode item = xmlAtrb.item(i);
-
-        auto name = item.nodeName();
-
-        attribFields.push_back(QgsField(name, QVariant::String));
-    }
+        auto source = job.source;
 
-    // auto numFields = attribFields.size();
+        QVector<double> lonLat;
+        if(source->getCoordinates(lonLat, job.err) != 0)
+            return;
 
-    auto getFeature = [=](const QStringList& pointsList, const QgsAttributes& featAttributes, const QDomNode& item) -> QgsFeature
-    {
+        QgsGeometry geom;
 
-        QgsPolylineXY lineGeom;
-        for(int i = 0; i<pointsList.size()-1; i+=3)
+        if(source->type == OpenQuakeSource::PointSource)
         {
-            // First number is lon, second is lat
-            bool OK = true;
-
-            auto longitude = pointsList[i].toDouble(&OK);
-
-            if(!OK)
-            {
-                this->errorMessage("Error converting longitude to double for node "+item.nodeName());
-                return -1;
-            }
-
-            auto latitude = pointsList[i+1].toDouble(&OK);
-
-            if(!OK)
+            if(lonLat.size() < 2)
             {
-                this->errorMessage("Error converting latitude to double for node "+item.nodeName());
-                return -1;
+                job.err = "Error, zero lat lon values for source "+source->id;
+                return;
             }
 
-            if(longitude == 0.0 || latitude == 0.0)
-            {
-                continue;
-                //this->errorMessage("Error, zero lat lon values for node "+item.nodeName());
-                //return -1;
-            }
-
-            lineGeom.append(QgsPointXY(longitude,latitude));
-        }
-
-        // Create the feature
-        QgsFeature feature;
-        feature.setGeometry(QgsGeometry::fromPolylineXY(lineGeom));
-        feature.setAttributes(featAttributes);
-
-        return feature;
-    };
-
-    QgsFeatureList featureList;
-    featureList.reserve(numSources);
-    for(int i = 0; i < numSources; ++i)
-    {
-        QDomNode item = lineSources->item(i);
-
-        QDomNamedNodeMap xmlAtrb = item.attributes();
-
-        auto numAtributes = xmlAtrb.size();
-
-        // create the feature attributes
-        QgsAttributes featAttributes(numAtributes);
-
-        // Get the feature attibutes
-        for(int i = 0; i< numAtributes; ++i)
-        {
-            QDomNode item = xmlAtrb.item(i);
-            auto val = item.nodeValue();
-
-            featAttributes[i] = val;
+            geom = QgsGeometry::fromPointXY(QgsPointXY(lonLat.at(0),lonLat.at(1)));
         }
-
-        // The top edge of the fault
-        QDomNode topEdgeGeom;
-
-        if(isCharacteristic)
-            topEdgeGeom = item.namedItem("surface");
         else
-            topEdgeGeom = item;
-
-        topEdgeGeom = topEdgeGeom.namedItem("complexFaultGeometry").namedItem("faultTopEdge").namedItem("gml:LineString").namedItem("gml:posList");
-
-        if(topEdgeGeom.isNull())
         {
-            this->errorMessage("Could not get geometry for node "+item.nodeName());
-            return -1;
-        }
+            QgsPolylineXY polyLine;
+            polyLine.reserve(lonLat.size()/2);
 
-        auto topVal = topEdgeGeom.toElement().text();
+            for(int i = 0; i+1<lonLat.size(); i+=2)
+                polyLine.append(QgsPointXY(lonLat.at(i),lonLat.at(i+1)));
 
-        // Split according to space
-        auto topEdgepointsList = topVal.split(" ",Qt::SkipEmptyParts);
-
-        auto topEdgefeature = getFeature(topEdgepointsList,featAttributes,item);
-
-        featureList.append(topEdgefeature);
-
-        // The bottom edge of the fault
-        //        QDomNode bottomEdgeGeom;
-
-        //        if(isCharacteristic)
-        //            bottomEdgeGeom = item.namedItem("surface");
-        //        else
-        //            bottomEdgeGeom = item;
-
-        //        bottomEdgeGeom = bottomEdgeGeom.namedItem("complexFaultGeometry").namedItem("faultBottomEdge").namedItem("gml:LineString").namedItem("gml:posList");
-
-
-        //        if(bottomEdgeGeom.isNull())
-        //        {
-        //            this->errorMessage("Could not get geometry for node "+item.nodeName());
-        //            return -1;
-        //        }
-
-        //        auto botVal = bottomEdgeGeom.toElement().text();
-
-        //        // Split according to space
-        //        auto botEdgepointsList = botVal.split(" ",Qt::SkipEmptyParts);
-
-        //        auto botEdgefeature = getFeature(botEdgepointsList,featAttributes,item);
-
-        //        featureList.append(botEdgefeature);
-    }
-
-    if(lineReferenceLayer == nullptr)
-    {
-        lineReferenceLayer = theVisualizationWidget->addVectorLayer("linestring", "Line Sources");
-
-        if(lineReferenceLayer == nullptr)
-        {
-            this->errorMessage("Error creating a layer");
-            return -1;
+            if(source->type == OpenQuakeSource::AreaSource)
+                geom = QgsGeometry::fromPolygonXY(QgsPolygonXY{polyLine});
+            else
+                geom = QgsGeometry::fromPolylineXY(polyLine);
         }
 
-        referenceLayerGroup.append(lineReferenceLayer);
-
-        auto dProvider = lineReferenceLayer->dataProvider();
-        auto res = dProvider->addAttributes(attribFields);
-
-        if(!res)
+        QgsAttributes featAttributes(numAtrb);
+        featAttributes[0] = source->id;
+        featAttributes[1] = source->name;
+        featAttributes[2] = source->tectonicRegion;
+        featAttributes[3] = source->typeName();
+        featAttributes[4] = source->magScaleRel;
+        featAttributes[5] = toVariant(source->ruptAspectRatio);
+        featAttributes[6] = toVariant(source->upperSeismoDepth);
+        featAttributes[7] = toVariant(source->lowerSeismoDepth);
+        featAttributes[8] = toVariant(source->dip);
+        featAttributes[9] = toVariant(source->rake);
+        featAttributes[10] = toVariant(source->aValue);
+        featAttributes[11] = toVariant(source->bValue);
+        featAttributes[12] = toVariant(source->minMag);
+        featAttributes[13] = toVariant(source->maxMag);
+
+        job.feature.setGeometry(geom);
+        job.feature.setAttributes(featAttributes);
+    });
+
+    QgsFeatureList pointFeatures;
+    QgsFeatureList lineFeatures;
+    QgsFeatureList areaFeatures;
+
+    for(auto&& job : jobs)
+    {
+        if(!job.err.isEmpty())
         {
-            this->errorMessage("Error adding attribute fields to layer");
-            theVisualizationWidget->removeLayer(lineReferenceLayer);
+            this->errorMessage(job.err);
             return -1;
         }
 
-        lineReferenceLayer->updateFields(); // tell the vector layer to fetch changes from the provider
-
-        dProvider->addFeatures(featureList);
-        lineReferenceLayer->updateExtents();
-
-        auto lineSymbol = new QgsLineSymbol();
-
-        lineSymbol->setWidth(0.75);
-
-        theVisualizationWidget->createSimpleRenderer(lineSymbol,lineReferenceLayer);
-    }
-    else
-    {
-        auto dProvider = lineReferenceLayer->dataProvider();
-
-        auto res = dProvider->addFeatures(featureList);
-
-        if(!res)
+        switch(job.source->type)
         {
-            this->errorMessage("Error adding features to layer");
-            theVisualizationWidget->removeLayer(lineReferenceLayer);
-            return -1;
+        case OpenQuakeSource::PointSource:
+            pointFeatures.append(job.feature);
+            break;
+        case OpenQuakeSource::AreaSource:
+            areaFeatures.append(job.feature);
+            break;
+        default:
+            lineFeatures.append(job.feature);
+            break;
         }
-
-        lineReferenceLayer->updateExtents();
-    }
-
-    return 0;
-}
-
-
-int OpenQuakeSelectionWidget::getSimpleFaultSources(QDomNodeList* lineSources)
-{
-
-    auto numSources = lineSources->size();
-    if(numSources == 0)
-        return 0;
-
-    QDomNode firstItem = lineSources->item(0);
-
-    // auto nodeName = firstItem.nodeName();
-
-    QDomNamedNodeMap xmlAtrb = firstItem.attributes();
-
-    // Create the fields
-    QList<QgsField> attribFields;
-    for(int i = 0; i< xmlAtrb.size(); ++i)
-    {
-        QDomNode item = xmlAtrb.item(i);
-
-        auto name = item.nodeName();
-
-        attribFields.push_back(QgsField(name, QVariant::String));
     }
 
-    // auto numFields = attribFields.size();
-
-    auto getFeature = [=](const QStringList& pointsList, const QgsAttributes& featAttributes, const QDomNode& item) -> QgsFeature
+    if(!pointFeatures.isEmpty())
     {
+        pointReferenceLayer = this->createReferenceLayer("Point", "Point Sources", attribFields);
 
-        QgsPolylineXY lineGeom;
-        for(int i = 0; i<pointsList.size()-1; i+=2)
-        {
-            // First number is lon, second is lat
-            bool OK = true;
-
-            auto longitude = pointsList[i].toDouble(&OK);
-
-            if(!OK)
-            {
-                this->errorMessage("Error converting longitude to double for node "+item.nodeName());
-                return -1;
-            }
-
-            auto latitude = pointsList[i+1].toDouble(&OK);
-
-            if(!OK)
-            {
-                this->errorMessage("Error converting latitude to double for node "+item.nodeName());
-                return -1;
-            }
-
-            if(longitude == 0.0 || latitude == 0.0)
-            {
-                continue;
-                //this->errorMessage("Error, zero lat lon values for node "+item.nodeName());
-                //return -1;
-            }
-
-            lineGeom.append(QgsPointXY(longitude,latitude));
-        }
-
-        // Create the feature
-        QgsFeature feature;
-        feature.setGeometry(QgsGeometry::fromPolylineXY(lineGeom));
-        feature.setAttributes(featAttributes);
-
-        return feature;
-    };
-
-    QgsFeatureList featureList;
-    featureList.reserve(numSources);
-    for(int i = 0; i < numSources; ++i)
-    {
-        QDomNode item = lineSources->item(i);
-
-        QDomNamedNodeMap xmlAtrb = item.attributes();
-
-        auto numAtributes = xmlAtrb.size();
-
-        // create the feature attributes
-        QgsAttributes featAttributes(numAtributes);
-
-        // Get the feature attibutes
-        for(int i = 0; i< numAtributes; ++i)
-        {
-            QDomNode item = xmlAtrb.item(i);
-            auto val = item.nodeValue();
-
-            featAttributes[i] = val;
-        }
-
-        // The top edge of the fault
-        QDomNode edgeGeom = item.namedItem("simpleFaultGeometry").namedItem("gml:LineString").namedItem("gml:posList");
-
-        if(edgeGeom.isNull())
-        {
-            this->errorMessage("Could not get geometry for node "+item.nodeName());
+        if(pointReferenceLayer == nullptr)
             return -1;
-        }
-
-        auto lineVal = edgeGeom.toElement().text();
-
-        // Split according to space
-        auto linePointsList = lineVal.split(" ",Qt::SkipEmptyParts);
 
-        auto linefeature = getFeature(linePointsList,featAttributes,item);
-
-        featureList.append(linefeature);
+        pointReferenceLayer->dataProvider()->addFeatures(pointFeatures, QgsFeatureSink::FastInsert);
+        pointReferenceLayer->updateExtents();
 
+        theVisualizationWidget->createSymbolRenderer(Qgis::MarkerShape::Cross,Qt::black,2.0,pointReferenceLayer);
     }
 
-    if(lineReferenceLayer == nullptr)
+    if(!lineFeatures.isEmpty())
     {
-        lineReferenceLayer = theVisualizationWidget->addVectorLayer("linestring", "Line Fault Sources");
+        lineReferenceLayer = this->createReferenceLayer("linestring", "Line Sources", attribFields);
 
         if(lineReferenceLayer == nullptr)
-        {
-            this->errorMessage("Error creating a layer");
             return -1;
-        }
 
-        referenceLayerGroup.append(lineReferenceLayer);
-
-        auto dProvider = lineReferenceLayer->dataProvider();
-        auto res = dProvider->addAttributes(attribFields);
-
-        if(!res)
-        {
-            this->errorMessage("Error adding attribute fields to layer");
-            theVisualizationWidget->removeLayer(lineReferenceLayer);
-            return -1;
-        }
-
-        lineReferenceLayer->updateFields(); // tell the vector layer to fetch changes from the provider
-
-        dProvider->addFeatures(featureList);
+        lineReferenceLayer->dataProvider()->addFeatures(lineFeatures, QgsFeatureSink::FastInsert);
         lineReferenceLayer->updateExtents();
 
         auto lineSymbol = new QgsLineSymbol();
@@ -1000,169 +620,54 @@ int OpenQuakeSelectionWidget::getSimpleFaultSources(QDomNodeList* lineSources)
 
         theVisualizationWidget->createSimpleRenderer(lineSymbol,lineReferenceLayer);
     }
-    else
-    {
-        auto dProvider = lineReferenceLayer->dataProvider();
 
-        auto res = dProvider->addFeatures(featureList);
+    if(!areaFeatures.isEmpty())
+    {
+        areaReferenceLayer = this->createReferenceLayer("polygon", "Area Sources", attribFields);
 
-        if(!res)
-        {
-            this->errorMessage("Error adding features to layer");
-            theVisualizationWidget->removeLayer(lineReferenceLayer);
+        if(areaReferenceLayer == nullptr)
             return -1;
-        }
-
-        lineReferenceLayer->updateExtents();
-    }
-
-    return 0;
-}
 
+        areaReferenceLayer->dataProvider()->addFeatures(areaFeatures, QgsFeatureSink::FastInsert);
+        areaReferenceLayer->updateExtents();
 
-int OpenQuakeSelectionWidget::getAreaSources(QDomNodeList* lineSources)
-{
-
-    auto numSources = lineSources->size();
-    if(numSources == 0)
-        return 0;
+        auto markerSymbol = new QgsFillSymbol();
 
-    QDomNode firstItem = lineSources->item(0);
+        markerSymbol->setColor(Qt::darkGray);
+        markerSymbol->setOpacity(0.30);
 
-    // auto nodeName = firstItem.nodeName();
-
-    QDomNamedNodeMap xmlAtrb = firstItem.attributes();
-
-    // Create the fields
-    QList<QgsField> attribFields;
-    for(int i = 0; i< xmlAtrb.size(); ++i)
-    {
-        QDomNode item = xmlAtrb.item(i);
-
-        auto name = item.nodeName();
-
-        attribFields.push_back(QgsField(name, QVariant::String));
+        theVisualizationWidget->createSimpleRenderer(markerSymbol,areaReferenceLayer);
     }
 
-    // auto numFields = attribFields.size();
-
-    auto getFeature = [=](const QStringList& pointsList, const QgsAttributes& featAttributes, const QDomNode& item) -> QgsFeature
-    {
-
-        QgsPolygonXY polygon;
-        QgsPolylineXY polyLineRing;
-        for(int i = 0; i<pointsList.size()-1; i+=2)
-        {
-            // First number is lon, second is lat
-            bool OK = true;
-
-            auto longitude = pointsList[i].toDouble(&OK);
-
-            if(!OK)
-            {
-                this->errorMessage("Error converting longitude to double for node "+item.nodeName());
-                return -1;
-            }
-
-            auto latitude = pointsList[i+1].toDouble(&OK);
-
-            if(!OK)
-            {
-                this->errorMessage("Error converting latitude to double for node "+item.nodeName());
-                return -1;
-            }
-
-            if(longitude == 0.0 || latitude == 0.0)
-                continue;
-
-
-            polyLineRing.append(QgsPointXY(longitude,latitude));
-        }
-
-        polygon.append(polyLineRing);
-
-        // Create the feature
-        QgsFeature feature;
-        feature.setGeometry(QgsGeometry::fromPolygonXY(polygon));
-        feature.setAttributes(featAttributes);
-
-        return feature;
-    };
-
-    QgsFeatureList featureList;
-    featureList.reserve(numSources);
-    for(int i = 0; i < numSources; ++i)
-    {
-        QDomNode item = lineSources->item(i);
-
-        QDomNamedNodeMap xmlAtrb = item.attributes();
-
-        auto numAtributes = xmlAtrb.size();
-
-        // create the feature attributes
-        QgsAttributes featAttributes(numAtributes);
-
-        // Get the feature attibutes
-        for(int i = 0; i< numAtributes; ++i)
-        {
-            QDomNode item = xmlAtrb.item(i);
-            auto val = item.nodeValue();
-
-            featAttributes[i] = val;
-        }
-
-        // The top edge of the fault
-        QDomNode polygonGeom = item.namedItem("areaGeometry").namedItem("gml:Polygon").namedItem("gml:exterior").namedItem("gml:LinearRing").namedItem("gml:posList");
-
-        if(polygonGeom.isNull())
-        {
-            this->errorMessage("Could not get geometry for node "+item.nodeName());
-            return -1;
-        }
-
-        auto posList = polygonGeom.toElement().text();
-
-        // Split according to space
-        auto polygonPointsList = posList.split(" ",Qt::SkipEmptyParts);
-
-        auto polygonFeature = getFeature(polygonPointsList,featAttributes,item);
+    return 0;
+}
 
-        featureList.append(polygonFeature);
-    }
 
-    areaReferenceLayer = theVisualizationWidget->addVectorLayer("polygon", "Area Sources");
+QgsVectorLayer* OpenQuakeSelectionWidget::createReferenceLayer(const QString& geometryType, const QString& layerName, const QList<QgsField>& attribFields)
+{
+    auto layer = theVisualizationWidget->addVectorLayer(geometryType, layerName);
 
-    if(areaReferenceLayer == nullptr)
+    if(layer == nullptr)
     {
         this->errorMessage("Error creating a layer");
-        return -1;
+        return nullptr;
     }
 
-    referenceLayerGroup.append(areaReferenceLayer);
-
-    auto dProvider = areaReferenceLayer->dataProvider();
+    auto dProvider = layer->dataProvider();
     auto res = dProvider->addAttributes(attribFields);
 
     if(!res)
     {
         this->errorMessage("Error adding attribute fields to layer");
-        theVisualizationWidget->removeLayer(areaReferenceLayer);
-        return -1;
+        theVisualizationWidget->removeLayer(layer);
+        return nullptr;
     }
 
-    areaReferenceLayer->updateFields(); // tell the vector layer to fetch changes from the provider
-
-    dProvider->addFeatures(featureList);
-    areaReferenceLayer->updateExtents();
-
-    auto markerSymbol = new QgsFillSymbol();
-
-    markerSymbol->setColor(Qt::darkGray);
-    markerSymbol->setOpacity(0.30);
+    layer->updateFields(); // tell the vector layer to fetch changes from the provider
 
-    theVisualizationWidget->createSimpleRenderer(markerSymbol,areaReferenceLayer);
+    referenceLayerGroup.append(layer);
 
-    return 0;
+    return layer;
 }
 
 
@@ -1373,79 +878,18 @@ void OpenQuakeSelectionWidget::handleSelectionDone(void)
         return;
     }
 
-    auto exportDoc = QDomDocument();
-
-    exportDoc.setContent(xmlGMs.toString());
-
-    auto root = exportDoc.documentElement();
+    // Stream the source model into the new file, keeping only the selected sources
+    OpenQuakeSourceModelReader sourceModelReader;
 
-    QDomNodeList sourceModelList = root.elementsByTagName("sourceModel");
+    QString err;
+    auto res = sourceModelReader.writeSelectedSources(sourceModelFilePath, filePathToSave, QSet<QString>(selectedIds.begin(), selectedIds.end()), err);
 
-    QVector<QDomNode> nodesToKeep;
-
-    // Lambda to do a one deep nested search for nodes
-    std::function<void(QDomNodeList&,bool)> nestedSearch = [&](QDomNodeList& list, bool checkChildren){
-
-        for(int i = 0; i<list.size(); ++i)
-        {
-            auto it = list.at(i);
-
-            auto nodeAttb = it.attributes();
-
-            auto id = nodeAttb.namedItem("id").nodeValue();
-
-            if(!id.isEmpty())
-            {
-                if(selectedIds.contains(id))
-                    nodesToKeep.push_back(it);
-            }
-            else
-            {
-                auto childNodes = it.childNodes();
-
-                if(!childNodes.isEmpty() && checkChildren == true)
-                    nestedSearch(childNodes,false);
-            }
-        }
-    };
-
-
-    nestedSearch(sourceModelList,true);
-
-    if(nodesToKeep.size() != selectedIds.size())
+    if(res != 0)
     {
-        this->errorMessage("Failed to find all of the selected nodes. Export failed!");
+        this->errorMessage(err);
         return;
     }
 
-    auto sourceModelElem = root.firstChildElement("sourceModel");
-
-    auto nodes = sourceModelElem.childNodes();
-
-    // Remove the old nodes from the source model
-    while(!nodes.isEmpty())
-    {
-        QDomNode node = nodes.at(0);
-        node.parentNode().removeChild(node);
-    }
-
-    // Put back the nodes we want to keep
-    for(auto&& it : nodesToKeep)
-        sourceModelElem.appendChild(it);
-
-
-    // Save the new xml file
-    QFile file(filePathToSave);
-    if( !file.open( QIODevice::WriteOnly | QIODevice::Text ) )
-    {
-        this->errorMessage("Failed to open file for writing.");
-        return;
-    }
-
-    QTextStream stream( &file );
-    stream << exportDoc.toString();
-    file.close();
-
     this->statusMessage("Successfully saved file to: "+filePathToSave);
 
     auto grp = theVisualizationWidget->getLayerGroup("OpenQuake Selected Sources");
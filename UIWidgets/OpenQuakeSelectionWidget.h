@@ -39,8 +39,7 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 // Written by: Stevan Gavrilovic
 
 #include "SimCenterAppWidget.h"
-
-#include <qdom.h>
+#include "OpenQuakeSourceModelReader.h"
 
 class SimCenterMapcanvasWidget;
 class QGISVisualizationWidget;
@@ -48,8 +47,8 @@ class QGISVisualizationWidget;
 class QgsMapLayer;
 class QgsVectorLayer;
 class QgsLayerTreeGroup;
+class QgsField;
 
-class QDomNodeList;
 class QStackedWidget;
 class QProgressBar;
 class QLabel;
@@ -93,20 +92,16 @@ private slots:
 private:
     void loadOpenQuakeXMLData(void);
 
-    QDomDocument xmlGMs;
+    // The source model file that is loaded, the export re-reads it to write the selected sources
+    QString sourceModelFilePath;
 
     QVector<QgsMapLayer*> referenceLayerGroup;
     QVector<QgsMapLayer*> selectedLayerGroup;
 
-    int getPointSources(QDomNodeList* pointSources);
-
-    int getCharacteristicComplexLineSources(QDomNodeList* lineSources, bool isCharacteristic);
-
-    int getSimpleFaultSources(QDomNodeList* lineSources);
-
-    int getComplexFaultSources(QDomNodeList* lineSources);
+    // Creates the features of the sources on worker threads and adds them to the point, line and area reference layers
+    int addSourcesToLayers(const QVector<OpenQuakeSource>& sources);
 
-    int getAreaSources(QDomNodeList* lineSources);
+    QgsVectorLayer* createReferenceLayer(const QString& geometryType, const QString& layerName, const QList<QgsField>& attribFields);
 
     QWidget* fileInputWidget = nullptr;
     QProgressBar* progressBar = nullptr;
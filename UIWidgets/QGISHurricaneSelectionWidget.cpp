@@ -40,11 +40,15 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 #include "QGISVisualizationWidget.h"
 #include "SimCenterMapcanvasWidget.h"
 #include "HurricaneParameterWidget.h"
+#include "HurricaneTrackFilterWidget.h"
+#include "HollandWindField.h"
+#include "ComponentDatabaseManager.h"
+#include "ComponentDatabase.h"
 
 #include "NodeHandle.h"
-#include "GridNode.h"
 #include "RectangleGrid.h"
 
+#include <QElapsedTimer>
 #include <QPushButton>
 #include <QJsonArray>
 #include <QLabel>
@@ -52,6 +56,8 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 
 #include <qgsmapcanvas.h>
 #include <qgsvectorlayer.h>
+#include <qgscoordinatetransform.h>
+#include <qgsproject.h>
 
 QGISHurricaneSelectionWidget::QGISHurricaneSelectionWidget(VisualizationWidget* visWidget, QWidget *parent) : HurricaneSelectionWidget(visWidget, parent)
 {
@@ -84,7 +90,18 @@ QGISHurricaneSelectionWidget::~QGISHurricaneSelectionWidget()
 
 QgsVectorLayer* QGISHurricaneSelectionWidget::importHurricaneTrackData(const QString &eventFile, QString &err)
 {
-    auto allHurricanesLayer = hurricaneImportTool->loadHurricaneDatabaseData(eventFile,err);
+    auto filter = trackFilterWidget->getFilter(err);
+
+    if(!err.isEmpty())
+        return nullptr;
+
+    // Remove the tracks of a previous load before loading them again with the new filter
+    theVisualizationWidget->removeLayer(hurricaneImportTool->getAllHurricanesLayer());
+
+    auto allHurricanesLayer = hurricaneImportTool->loadHurricaneDatabaseData(eventFile,err,filter);
+
+    if(allHurricanesLayer == nullptr)
+        return nullptr;
 
     // Set as the current layer so selection of tracks will register
     mapViewSubWidget->setCurrentLayer(allHurricanesLayer);
@@ -103,8 +120,10 @@ void QGISHurricaneSelectionWidget::clear(void)
     theVisualizationWidget->removeLayer(hurricaneTrackLayer);
     theVisualizationWidget->removeLayer(hurricaneTrackPointsLayer);
     theVisualizationWidget->removeLayer(terrainRoughnessLayer);
+    theVisualizationWidget->removeLayer(windFieldLayer);
 
     terrainRoughnessLayer = nullptr;
+    windFieldLayer = nullptr;
     gridLayer = nullptr;
     landfallLayer = nullptr;
     hurricaneTrackLayer = nullptr;
@@ -280,10 +299,10 @@ void QGISHurricaneSelectionWidget::handleGridSelected(void)
     if(!userGrid->isVisible())
         return;
 
-    // Get the vector of grid nodes
-    auto gridNodeVec = userGrid->getGridNodeVec();
+    // Get the vector of grid points
+    auto gridPoints = userGrid->getGridPoints();
 
-    if(gridNodeVec.isEmpty())
+    if(gridPoints.isEmpty())
         return;
 
     auto mapCanvas = mapViewSubWidget->mapCanvas();
@@ -306,14 +325,12 @@ void QGISHurricaneSelectionWidget::handleGridSelected(void)
     QStringList headerRow = {"GP_file", "Latitude", "Longitude"};
     gridData.push_back(headerRow);
 
-    for(int i = 0; i<gridNodeVec.size(); ++i)
+    for(int i = 0; i<gridPoints.size(); ++i)
     {
-        auto gridNode = gridNodeVec.at(i);
-
         // The station id
         auto stationName = QString::number(i+1);
 
-        auto screenPoint = gridNode->getPoint();
+        auto screenPoint = gridPoints.at(i);
 
         // The latitude and longitude
         auto longitude = theVisualizationWidget->getLongFromScreenPoint(screenPoint,mapCanvas);
@@ -398,7 +415,7 @@ void QGISHurricaneSelectionWidget::handleLandfallPointSelected(void)
         this->clearLandfallFromMap();
     }
 
-    // Get the vector of grid nodes
+    // Get the vector of grid points
     auto posNodeVec = userPoint->pos();
 
     if(posNodeVec.isNull())
@@ -591,3 +608,142 @@ bool QGISHurricaneSelectionWidget::outputToJSON(QJsonObject &jsonObject)
 
     return true;
 }
+
+
+void QGISHurricaneSelectionWidget::handleWindFieldPreview(void)
+{
+    QString err;
+
+    QVector<HurricaneTrackPoint> track;
+    if(this->getLandfallTrack(track, err) != 0)
+    {
+        this->errorMessage(err);
+        return;
+    }
+
+    // The sites are the grid stations and the locations of all of the assets in the inventory
+    QVector<double> latitudes;
+    QVector<double> longitudes;
+
+    for(auto&& it : stationMap)
+    {
+        latitudes.append(it.getLatitude());
+        longitudes.append(it.getLongitude());
+    }
+
+    QgsCoordinateReferenceSystem wgs84("EPSG:4326");
+
+    auto assetDbs = ComponentDatabaseManager::getInstance()->getAllAssetDatabases();
+
+    for(auto&& db : assetDbs)
+    {
+        auto layer = db->getMainLayer();
+
+        if(layer == nullptr)
+            continue;
+
+        QgsCoordinateTransform transform(layer->crs(), wgs84, QgsProject::instance());
+
+        QgsFeatureRequest featRequest;
+        featRequest.setNoAttributes();
+
+        latitudes.reserve(latitudes.size() + layer->featureCount());
+        longitudes.reserve(longitudes.size() + layer->featureCount());
+
+        auto featIt = layer->getFeatures(featRequest);
+
+        QgsFeature feat;
+        while (featIt.nextFeature(feat))
+        {
+            auto geom = feat.geometry();
+
+            if(geom.isEmpty())
+                continue;
+
+            auto point = geom.centroid().asPoint();
+
+            if(layer->crs() != wgs84)
+                point = transform.transform(point);
+
+            latitudes.append(point.y());
+            longitudes.append(point.x());
+        }
+    }
+
+    if(latitudes.isEmpty())
+    {
+        this->errorMessage("Please define a grid or load an asset inventory before previewing the wind field");
+        return;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    HollandWindField windField;
+
+    QVector<double> peakGusts;
+    if(windField.computePeakGusts(track, latitudes, longitudes, peakGusts, err) != 0)
+    {
+        this->errorMessage(err);
+        return;
+    }
+
+    auto computeTime = timer.elapsed();
+
+    if(windFieldLayer)
+    {
+        theVisualizationWidget->removeLayer(windFieldLayer);
+        windFieldLayer = nullptr;
+    }
+
+    windFieldLayer = theVisualizationWidget->addVectorLayer("Point", "Wind Field Preview");
+
+    if(windFieldLayer == nullptr)
+    {
+        this->errorMessage("Error creating the wind field layer");
+        return;
+    }
+
+    QList<QgsField> attribFields;
+    attribFields.push_back(QgsField("Latitude", QVariant::Double));
+    attribFields.push_back(QgsField("Longitude", QVariant::Double));
+    attribFields.push_back(QgsField("PeakGust", QVariant::Double));
+
+    auto dProvider = windFieldLayer->dataProvider();
+
+    if(!dProvider->addAttributes(attribFields))
+    {
+        this->errorMessage("Error adding attribute fields to the wind field layer");
+        theVisualizationWidget->removeLayer(windFieldLayer);
+        windFieldLayer = nullptr;
+        return;
+    }
+
+    windFieldLayer->updateFields();
+
+    auto featFields = windFieldLayer->fields();
+
+    QgsFeatureList featureList;
+    featureList.reserve(latitudes.size());
+
+    for(int i = 0; i<latitudes.size(); ++i)
+    {
+        QgsAttributes featAttributes(attribFields.size());
+        featAttributes[0] = latitudes.at(i);
+        featAttributes[1] = longitudes.at(i);
+        featAttributes[2] = peakGusts.at(i);
+
+        QgsFeature feature;
+        feature.setFields(featFields);
+        feature.setGeometry(QgsGeometry::fromPointXY(QgsPointXY(longitudes.at(i),latitudes.at(i))));
+        feature.setAttributes(featAttributes);
+        featureList.append(feature);
+    }
+
+    dProvider->addFeatures(featureList);
+    windFieldLayer->updateExtents();
+
+    theVisualizationWidget->createPrettyGraduatedRenderer("PeakGust",Qt::yellow,Qt::red,5,windFieldLayer);
+
+    this->statusMessage("Computed the peak gusts [m/s] at "+QString::number(latitudes.size())+" sites over "+QString::number(track.size())+" time steps in "+QString::number(computeTime)+" ms");
+}
@@ -91,6 +91,8 @@ private slots:
 
     void handleTerrainImport(void);
 
+    void handleWindFieldPreview(void);
+
 signals:
     void loadingComplete(const bool value);
     void outputDirectoryPathChanged(QString motionDir, QString eventFile);
@@ -108,6 +110,7 @@ private:
     QgsVectorLayer* terrainRoughnessLayer = nullptr;
     QgsVectorLayer* hurricaneTrackLayer = nullptr;
     QgsVectorLayer* hurricaneTrackPointsLayer = nullptr;
+    QgsVectorLayer* windFieldLayer = nullptr;
 
 };
 
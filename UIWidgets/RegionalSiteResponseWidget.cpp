@@ -51,7 +51,6 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 #include "Vs30Widget.h"
 #include "BedrockDepthWidget.h"
 #include "SoilModelWidget.h"
-#include "GridNode.h"
 #include "SimCenterPreferences.h"
 #include "QGISSiteInputWidget.h"
 
@@ -1340,16 +1339,15 @@ void RegionalSiteResponseWidget::getSiteData(void)
             this->statusMessage(msg);
             return;
         }
-        // Get the vector of grid nodes
-        auto gridNodeVec = userGrid->getGridNodeVec();
+        // Get the vector of grid points
+        auto gridPoints = userGrid->getGridPoints();
         auto mapCanvas = mapViewSubWidget->getMapCanvasWidget()->mapCanvas();
-        for(int i = 0; i<gridNodeVec.size(); ++i)
+        for(int i = 0; i<gridPoints.size(); ++i)
         {
-            auto gridNode = gridNodeVec.at(i);
             QStringList stationRow;
             // The station id
             stationRow.push_back(QString::number(i));
-            auto screenPoint = gridNode->getPoint();
+            auto screenPoint = gridPoints.at(i);
             // The latitude and longitude
             auto longitude = theVisualizationWidget->getLongFromScreenPoint(screenPoint,mapCanvas);
             auto latitude = theVisualizationWidget->getLatFromScreenPoint(screenPoint,mapCanvas);
@@ -38,16 +38,33 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 
 #include "SiteSpecifiedMapping.h"
 #include "SimCenterPreferences.h"
+#include "ComponentDatabaseManager.h"
+#include "CSVReaderWriter.h"
 
 #include <QComboBox>
 #include <QDebug>
 #include <QDir>
+#include <QFile>
+#include <QFileDialog>
+#include <QFileInfo>
 #include <QVBoxLayout>
+#include <QGridLayout>
 #include <QGroupBox>
 #include <QIntValidator>
 #include <QJsonObject>
 #include <QLabel>
 #include <QLineEdit>
+#include <QPushButton>
+#include <QTextStream>
+
+#include <algorithm>
+
+namespace {
+
+// Number of asset IDs that are listed in the messages
+const int maxListedIDs = 10;
+
+}
 
 SiteSpecifiedMapping::SiteSpecifiedMapping(QWidget *parent) : SimCenterAppWidget(parent)
 {
@@ -59,6 +76,46 @@ SiteSpecifiedMapping::SiteSpecifiedMapping(QWidget *parent) : SimCenterAppWidget
     infoLabel->setText("Hazard values are provided,  or calculated,  at each asset site.");
 
     regionalMapLayout->addWidget(infoLabel);
+
+    // Check of the sites before the analysis is run
+    QGroupBox* validationGroupBox = new QGroupBox("Site Validation", this);
+    QGridLayout* validationLayout = new QGridLayout(validationGroupBox);
+
+    siteFileLineEdit = new QLineEdit(this);
+    siteFileLineEdit->setToolTip("CSV file with a row for each site, e.g., the EventGrid.csv file of the hazard");
+    QPushButton* siteBrowseButton = new QPushButton("Browse",this);
+
+    connect(siteBrowseButton, &QPushButton::clicked, this, [this]()
+    {
+        auto path = QFileDialog::getOpenFileName(this,tr("Event Grid File"),QString(),QString("*.csv"));
+        if(!path.isEmpty())
+            siteFileLineEdit->setText(path);
+    });
+
+    siteIDColumnLineEdit = new QLineEdit(this);
+    siteIDColumnLineEdit->setText("GP_file");
+    siteIDColumnLineEdit->setToolTip("Column of the event grid with the ID of the asset at each site, either the ID itself or a file name that ends with it, e.g., site12.csv");
+
+    QPushButton* validateButton = new QPushButton("Validate Sites",this);
+    QPushButton* saveButton = new QPushButton("Save Event Grid",this);
+    saveButton->setToolTip("Saves the rows of the event grid that are the sites of the selected assets, in the layout of the event grid");
+
+    connect(validateButton, &QPushButton::clicked, this, &SiteSpecifiedMapping::validateSites);
+    connect(saveButton, &QPushButton::clicked, this, &SiteSpecifiedMapping::saveEventGrid);
+
+    validationSummaryLabel = new QLabel(this);
+    validationSummaryLabel->setWordWrap(true);
+
+    validationLayout->addWidget(new QLabel("Event grid file"), 0, 0);
+    validationLayout->addWidget(siteFileLineEdit, 0, 1);
+    validationLayout->addWidget(siteBrowseButton, 0, 2);
+    validationLayout->addWidget(new QLabel("Site ID column"), 1, 0);
+    validationLayout->addWidget(siteIDColumnLineEdit, 1, 1);
+    validationLayout->addWidget(validateButton, 2, 0);
+    validationLayout->addWidget(saveButton, 2, 1, Qt::AlignLeft);
+    validationLayout->addWidget(validationSummaryLabel, 3, 0, 1, 3);
+
+    regionalMapLayout->addWidget(validationGroupBox);
     regionalMapLayout->addStretch();
 }
 
@@ -95,9 +152,246 @@ bool SiteSpecifiedMapping::inputAppDataFromJSON(QJsonObject &jsonObject)
 }
 
 
-void SiteSpecifiedMapping::clear(void)
+bool SiteSpecifiedMapping::copyFiles(QString &/*dirName*/)
 {
+    // The backend reads the event grid of the hazard, so nothing is written here, the assets without a site are only reported
+    if(siteFileLineEdit->text().isEmpty())
+        return true;
+
+    QString summary;
+    QString err;
+
+    auto numUnmatched = this->joinSites(summary, err);
+
+    if(numUnmatched == -1)
+        this->infoMessage("Could not validate the sites: " + err);
+    else if(numUnmatched > 0)
+        this->infoMessage("Warning, " + QString::number(numUnmatched) + " assets do not have a site in " + siteFileLineEdit->text() + "\n" + summary);
+
+    return true;
+}
+
+
+int SiteSpecifiedMapping::joinSites(QString& summary, QString& err)
+{
+    siteTable.clear();
+    assetTypes.clear();
+    assetIDs.clear();
+    joinResults.clear();
+
+    auto pathToFile = siteFileLineEdit->text();
+
+    if(pathToFile.isEmpty())
+    {
+        err = "Select the event grid file to validate the sites";
+        return -1;
+    }
+
+    CSVReaderWriter csvTool;
+
+    auto data = csvTool.parseCSVFile(pathToFile, err);
+
+    if(!err.isEmpty())
+        return -1;
+
+    if(data.size() < 2)
+    {
+        err = "The file " + pathToFile + " does not contain any rows";
+        return -1;
+    }
+
+    auto idIndex = data.first().indexOf(siteIDColumnLineEdit->text());
+
+    if(idIndex == -1)
+    {
+        err = "The file " + pathToFile + " does not have a " + siteIDColumnLineEdit->text() + " column";
+        return -1;
+    }
+
+    // Gather the site IDs into a column first, the join only works on the integer IDs
+    QVector<qint64> siteIDs;
+    siteIDs.reserve(data.size() - 1);
+
+    for(int i = 1; i<data.size(); ++i)
+    {
+        const auto& row = data.at(i);
+
+        qint64 id = 0;
+        if(idIndex >= row.size() || !IDHashJoin::parseID(row.at(idIndex), id))
+        {
+            err = "Could not read the site ID in row " + QString::number(i) + " of " + pathToFile;
+            return -1;
+        }
+
+        siteIDs.append(id);
+    }
+
+    IDHashJoin siteJoin;
+    QVector<int> duplicateSites;
+
+    if(siteJoin.setSiteIDs(siteIDs, duplicateSites, err) != 0)
+        return -1;
+
+    int numUnmatched = 0;
+
+    QStringList summaryLines;
+
+    if(!duplicateSites.isEmpty())
+        summaryLines.append(QString::number(duplicateSites.size()) + " sites have an ID that an earlier site already has, e.g., " + QString::number(siteIDs.at(duplicateSites.first())) + ", the first of the sites is used");
+
+    auto assetDbs = ComponentDatabaseManager::getInstance()->getAllAssetDatabases();
+
+    for(auto&& db : assetDbs)
+    {
+        auto ids = db->getSelectedComponentIDs();
+
+        if(ids.isEmpty())
+            continue;
+
+        IDJoinResult result;
+
+        assetTypes.append(db->getComponentType());
+        assetIDs.append(ids.toVector());
+
+        if(siteJoin.join(assetIDs.last(), result, err) != 0)
+            return -1;
+
+        QString line = assetTypes.last() + ": " + QString::number(result.numMatched) + " of " + QString::number(assetIDs.last().size()) + " assets have a site";
+
+        if(!result.unmatchedAssets.isEmpty())
+        {
+            QStringList listedIDs;
+            for(int i = 0; i<result.unmatchedAssets.size() && i<maxListedIDs; ++i)
+                listedIDs.append(QString::number(assetIDs.last().at(result.unmatchedAssets.at(i))));
+
+            line += ", no site for " + listedIDs.join(", ") + (result.unmatchedAssets.size() > maxListedIDs ? ", ..." : "");
+        }
 
+        if(!result.duplicateAssets.isEmpty())
+            line += ", " + QString::number(result.duplicateAssets.size()) + " duplicated asset IDs";
+
+        summaryLines.append(line);
+
+        numUnmatched += result.unmatchedAssets.size();
+        joinResults.append(result);
+    }
+
+    if(assetTypes.isEmpty())
+    {
+        err = "Select the assets to analyze before validating the sites";
+        return -1;
+    }
+
+    summary = summaryLines.join("\n");
+
+    siteTable = data;
+
+    return numUnmatched;
+}
+
+
+int SiteSpecifiedMapping::writeEventGrid(const QString& pathToFile, QString& err)
+{
+    if(siteTable.isEmpty())
+    {
+        err = "Validate the sites before saving the event grid";
+        return -1;
+    }
+
+    // Rows of the sites that an asset maps to, in the order of the event grid
+    QVector<int> siteRows;
+
+    for(auto&& result : joinResults)
+    {
+        for(auto&& row : result.siteRows)
+        {
+            if(row != -1)
+                siteRows.append(row);
+        }
+    }
+
+    std::sort(siteRows.begin(), siteRows.end());
+    siteRows.erase(std::unique(siteRows.begin(), siteRows.end()), siteRows.end());
+
+    QFile file(pathToFile);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text))
+    {
+        err = "Could not open the file " + pathToFile + " for writing";
+        return -1;
+    }
+
+    QTextStream stream(&file);
+
+    // The cells of the event grid are quoted again since they may contain commas
+    stream << CSVReaderWriter::joinRow(siteTable.first()) << "\n";
+
+    for(auto&& row : siteRows)
+        stream << CSVReaderWriter::joinRow(siteTable.at(row + 1)) << "\n";
+
+    file.close();
+
+    return 0;
+}
+
+
+void SiteSpecifiedMapping::validateSites(void)
+{
+    validationSummaryLabel->clear();
+
+    QString summary;
+    QString err;
+
+    auto numUnmatched = this->joinSites(summary, err);
+
+    if(numUnmatched == -1)
+    {
+        this->errorMessage(err);
+        return;
+    }
+
+    validationSummaryLabel->setText(summary);
+
+    if(numUnmatched > 0)
+        this->infoMessage("Warning, " + QString::number(numUnmatched) + " assets do not have a site in " + siteFileLineEdit->text());
+    else
+        this->statusMessage("Every asset has a site in " + siteFileLineEdit->text());
+}
+
+
+void SiteSpecifiedMapping::saveEventGrid(void)
+{
+    if(siteTable.isEmpty())
+    {
+        this->errorMessage("Validate the sites before saving the event grid");
+        return;
+    }
+
+    auto pathToFile = QFileDialog::getSaveFileName(this,tr("Save Event Grid"),QString(),QString("*.csv"));
+
+    if(pathToFile.isEmpty())
+        return;
+
+    QString err;
+    if(this->writeEventGrid(pathToFile, err) != 0)
+    {
+        this->errorMessage(err);
+        return;
+    }
+
+    this->statusMessage("Saved the event grid of the selected assets to " + pathToFile);
+}
+
+
+void SiteSpecifiedMapping::clear(void)
+{
+    siteFileLineEdit->clear();
+    siteIDColumnLineEdit->setText("GP_file");
+    validationSummaryLabel->clear();
+
+    siteTable.clear();
+    assetTypes.clear();
+    assetIDs.clear();
+    joinResults.clear();
 }
 
 
@@ -39,8 +39,13 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 // Written by: Stevan Gavrilovic
 
 #include <SimCenterAppWidget.h>
+#include "IDHashJoin.h"
+
+#include <QStringList>
+#include <QVector>
 
 class QLabel;
+class QLineEdit;
 
 class SiteSpecifiedMapping : public SimCenterAppWidget
 {
@@ -53,15 +58,42 @@ public:
     bool outputAppDataToJSON(QJsonObject &jsonObject);
     bool inputAppDataFromJSON(QJsonObject &jsonObject);
 
+    // Reports the assets without a site if an event grid is given, the backend maps the assets to the sites of the event grid of the hazard itself
+    bool copyFiles(QString &dirName);
+
     void clear(void);
 
 public slots:
 
 signals:
 
+private slots:
+
+    // Joins the assets selected for analysis to the sites of the event grid and reports the assets without a site and the duplicated IDs
+    void validateSites(void);
+
+    // Saves the sites of the selected assets as an event grid with the columns of the original one
+    void saveEventGrid(void);
+
 private:
+
+    // Returns the number of assets without a site, or -1 on an error
+    int joinSites(QString& summary, QString& err);
+
+    int writeEventGrid(const QString& pathToFile, QString& err);
+
     QLabel *infoLabel;
 
+    QLineEdit *siteFileLineEdit;
+    QLineEdit *siteIDColumnLineEdit;
+    QLabel *validationSummaryLabel;
+
+    // Result of the last join, the event grid table and the joins of the IDs of each asset type
+    QVector<QStringList> siteTable;
+    QStringList assetTypes;
+    QVector<QVector<qint64>> assetIDs;
+    QVector<IDJoinResult> joinResults;
+
 };
 
 
@@ -42,8 +42,11 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 #include "VisualizationWidget.h"
 #include "WorkflowAppR2D.h"
 #include "SimCenterUnitsWidget.h"
+#include "ResponseSpectrum.h"
 
 #include <QApplication>
+#include <QChart>
+#include <QChartView>
 #include <QDialog>
 #include <QFile>
 #include <QFileDialog>
@@ -52,12 +55,14 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 #include <QGridLayout>
 #include <QLabel>
 #include <QLineEdit>
+#include <QLineSeries>
 #include <QProgressBar>
 #include <QComboBox>
 #include <QPushButton>
 #include <QSpacerItem>
 #include <QStackedWidget>
 #include <QVBoxLayout>
+#include <QValueAxis>
 #include <QDir>
 #include <QString>
 
@@ -65,6 +70,11 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 
 #include <qgsvectorlayer.h>
 
+#include <algorithm>
+#include <cmath>
+
+using namespace QtCharts;
+
 
 UserInputGMWidget::UserInputGMWidget(QGISVisualizationWidget* visWidget, QWidget *parent) : SimCenterAppWidget(parent), theVisualizationWidget(visWidget)
 {
@@ -264,7 +274,23 @@ QStackedWidget* UserInputGMWidget::getUserInputGMWidget(void)
 
     fileLayout->addWidget(unitsWidget,2,0,1,3);
 
-    fileLayout->setRowStretch(3,1);
+    // Response spectra of the stations, shown once the ground motions are loaded
+    spectrumWidget = new QWidget();
+    auto spectrumLayout = new QGridLayout(spectrumWidget);
+    spectrumLayout->setContentsMargins(0,0,0,0);
+
+    spectrumStationCombo = new QComboBox();
+    connect(spectrumStationCombo, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &UserInputGMWidget::plotStationSpectrum);
+
+    spectrumLayout->addWidget(new QLabel("Station Response Spectra"), 0, 0);
+    spectrumLayout->addWidget(spectrumStationCombo, 0, 1);
+    spectrumLayout->setColumnStretch(1,1);
+
+    spectrumWidget->setVisible(false);
+
+    fileLayout->addWidget(spectrumWidget,3,0,1,3);
+
+    fileLayout->setRowStretch(4,1);
 
     //
     // progress bar
@@ -440,6 +466,103 @@ void UserInputGMWidget::clear(void)
     motionDirLineEdit->clear();
 
     unitsWidget->clear();
+
+    stationList.clear();
+    spectrumStationCombo->clear();
+    spectrumWidget->setVisible(false);
+}
+
+
+void UserInputGMWidget::plotStationSpectrum(int index)
+{
+    if(index < 0 || index >= stationList.size())
+        return;
+
+    auto groundMotions = stationList.at(index).getStationGroundMotions();
+
+    if(groundMotions.isEmpty() || !groundMotions.front().hasResponseSpectra())
+        return;
+
+    auto periods = groundMotions.front().getSpectrumPeriods();
+
+    if(spectrumChart == nullptr)
+    {
+        spectrumChart = new QChart();
+        spectrumChart->setDropShadowEnabled(false);
+        spectrumChart->setMargins(QMargins(5,5,5,5));
+        spectrumChart->layout()->setContentsMargins(0, 0, 0, 0);
+        spectrumChart->legend()->setVisible(false);
+
+        spectrumChartView = new QChartView(spectrumChart);
+        spectrumChartView->setRenderHint(QPainter::Antialiasing);
+        spectrumChartView->setContentsMargins(0,0,0,0);
+        spectrumChartView->setMinimumHeight(250);
+        spectrumChartView->setSizePolicy(QSizePolicy::Expanding,QSizePolicy::Expanding);
+
+        static_cast<QGridLayout*>(spectrumWidget->layout())->addWidget(spectrumChartView, 1, 0, 1, 2);
+    }
+    else
+    {
+        spectrumChart->removeAllSeries();
+
+        for(auto&& it : spectrumChart->axes())
+            spectrumChart->removeAxis(it);
+    }
+
+    QValueAxis *axisX = new QValueAxis();
+    axisX->setGridLineVisible(false);
+    axisX->setTitleText("Period [s]");
+    spectrumChart->addAxis(axisX, Qt::AlignBottom);
+
+    QValueAxis *axisY = new QValueAxis();
+    axisY->setTitleText("Spectral Acceleration");
+    spectrumChart->addAxis(axisY, Qt::AlignLeft);
+
+    auto addSeries = [&](QLineSeries* series)
+    {
+        spectrumChart->addSeries(series);
+        series->attachAxis(axisX);
+        series->attachAxis(axisY);
+    };
+
+    double maxSa = 0.0;
+
+    // The spectrum of each ground motion in grey
+    for(auto&& motion : groundMotions)
+    {
+        QLineSeries *series = new QLineSeries();
+        series->setPen(QPen(Qt::gray, 1.0));
+
+        for(auto&& period : periods)
+        {
+            auto sa = motion.getSpectralAcceleration(period);
+
+            if(std::isnan(sa))
+                continue;
+
+            series->append(period, sa);
+            maxSa = std::max(maxSa, sa);
+        }
+
+        addSeries(series);
+    }
+
+    // The mean spectrum of the station in bold black
+    QLineSeries *meanSeries = new QLineSeries();
+    meanSeries->setPen(QPen(Qt::black, 3.0));
+
+    for(auto&& period : periods)
+    {
+        auto sa = stationList.at(index).getMeanSpectralAcceleration(period);
+
+        if(!std::isnan(sa))
+            meanSeries->append(period, sa);
+    }
+
+    addSeries(meanSeries);
+
+    axisX->setRange(0.0, periods.isEmpty() ? 1.0 : periods.back());
+    axisY->setRange(0.0, maxSa > 0.0 ? 1.05*maxSa : 1.0);
 }
 
 void UserInputGMWidget::loadUserGMData(void)
@@ -547,6 +670,15 @@ void UserInputGMWidget::loadUserGMData(void)
     }
 
     QgsFeatureList featureList;
+
+    // The stations in the order of the features, kept on the widget with their response spectra
+    stationList.clear();
+    spectrumStationCombo->clear();
+    spectrumWidget->setVisible(false);
+
+    QVector<GroundMotionStation> stations;
+    stations.reserve(numRows);
+
     // Get the data
     for(int i = 0; i<numRows; ++i)
     {
@@ -646,6 +778,8 @@ void UserInputGMWidget::loadUserGMData(void)
         feature.setAttributes(featAttributes);
         featureList.append(feature);
 
+        stations.append(GMStation);
+
         ++count;
         progressLabel->clear();
         progressBar->setValue(count);
@@ -653,6 +787,58 @@ void UserInputGMWidget::loadUserGMData(void)
         QApplication::processEvents();
     }
 
+    // Compute the response spectra of the imported time histories, and add the spectral accelerations at a few periods to the stations as intensity measures
+    auto hasTimeHistories = std::any_of(stations.begin(), stations.end(), [](const GroundMotionStation& station){ return station.getNumGroundMotions() != 0; });
+
+    if(hasTimeHistories)
+    {
+        progressLabel->setText("Computing the response spectra of the ground motions");
+        QApplication::processEvents();
+
+        QString errSpectra;
+        auto res = GroundMotionStation::computeResponseSpectra(stations, ResponseSpectrum::getDefaultPeriods(), {0.05}, errSpectra);
+
+        if(res != 0)
+        {
+            this->infoMessage("Warning, could not compute the response spectra of the ground motions. "+errSpectra);
+        }
+        else
+        {
+            const QVector<double> imPeriods = {0.3, 1.0, 3.0};
+
+            for(auto&& period : imPeriods)
+                attribFields.push_back(QgsField("SA("+QString::number(period,'f',1)+")", QVariant::Double));
+
+            for(int i = 0; i<featureList.size(); ++i)
+            {
+                auto featAttributes = featureList[i].attributes();
+
+                for(auto&& period : imPeriods)
+                {
+                    auto sa = stations.at(i).getMeanSpectralAcceleration(period);
+                    featAttributes.append(std::isnan(sa) ? QVariant() : QVariant(sa));
+                }
+
+                featureList[i].setAttributes(featAttributes);
+            }
+
+            stationList = stations;
+
+            QStringList stationNames;
+            for(int i = 0; i<numRows; ++i)
+                stationNames.append(data.at(i).at(0));
+
+            spectrumStationCombo->blockSignals(true);
+            spectrumStationCombo->addItems(stationNames);
+            spectrumStationCombo->blockSignals(false);
+
+            spectrumWidget->setVisible(true);
+
+            this->plotStationSpectrum(0);
+        }
+
+        progressLabel->clear();
+    }
 
     auto vectorLayer = qgisVizWidget->addVectorLayer("Point", "Ground Motion Grid");
 
@@ -52,6 +52,13 @@ class QStackedWidget;
 class QLineEdit;
 class QProgressBar;
 class QLabel;
+class QComboBox;
+
+namespace QtCharts
+{
+    class QChart;
+    class QChartView;
+}
 
 
 class UserInputGMWidget : public SimCenterAppWidget
@@ -81,6 +88,9 @@ private slots:
     void chooseEventFileDialog(void);
     void chooseMotionDirDialog(void);
 
+    // Plots the response spectra of the ground motions at a station and their mean
+    void plotStationSpectrum(int index);
+
 signals:
     void outputDirectoryPathChanged(QString motionDir, QString eventFile);
     void eventTypeChangedSignal(QString eventType);
@@ -106,8 +116,14 @@ private:
     QWidget* fileInputWidget;
     QProgressBar* progressBar;
 
+    // The stations of the loaded event grid with their response spectra, in the order of the features of the layer
     QVector<GroundMotionStation> stationList;
 
+    QWidget* spectrumWidget = nullptr;
+    QComboBox* spectrumStationCombo = nullptr;
+    QtCharts::QChart* spectrumChart = nullptr;
+    QtCharts::QChartView* spectrumChartView = nullptr;
+
     SimCenterUnitsWidget* unitsWidget;
 
 };
@@ -45,7 +45,6 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 #include "WindFieldStation.h"
 #include "SimCenterUnitsWidget.h"
 
-#include "QGISHurricanePreprocessor.h"
 #include "QGISVisualizationWidget.h"
 
 #include <qgsvectorlayer.h>
@@ -312,41 +311,6 @@ void UserInputHurricaneWidget::showEventSelectDialog(void)
 }
 
 
-void UserInputHurricaneWidget::loadHurricaneTrackData(void)
-{
-
-    auto qgisVizWidget = static_cast<QGISVisualizationWidget*>(theVisualizationWidget);
-
-    if(qgisVizWidget == nullptr)
-    {
-        qDebug()<<"Failed to cast to ArcGISVisualizationWidget";
-        return;
-    }
-
-    QGISHurricanePreprocessor hurricaneImportTool(progressBar, qgisVizWidget, this);
-
-    theStackedWidget->setCurrentWidget(progressBarWidget);
-    progressBarWidget->setVisible(true);
-
-    QString errMsg;
-    auto res = hurricaneImportTool.loadHurricaneDatabaseData(eventFile,errMsg);
-
-    if(res != 0)
-        this->statusMessage(errMsg);
-
-    // Reset the widget back to the input pane and close
-    theStackedWidget->setCurrentWidget(fileInputWidget);
-    fileInputWidget->setVisible(true);
-
-    if(theStackedWidget->isModal())
-        theStackedWidget->close();
-
-    emit loadingComplete(true);
-
-    return;
-}
-
-
 void UserInputHurricaneWidget::chooseEventDirDialog(void)
 {
 
@@ -471,6 +435,9 @@ void UserInputHurricaneWidget::clear(void)
 
     this->hideProgressBar();
     unitsWidget->clear();
+
+    stationMap.clear();
+    stationDataHeadings.clear();
 }
 
 
@@ -487,6 +454,8 @@ void UserInputHurricaneWidget::loadUserWFData(void)
     // Clear the units widget
     unitsWidget->clear();
 
+    stationMap.clear();
+
     this->statusMessage("Loading wind field data");
     CSVReaderWriter csvTool;
 
@@ -535,7 +504,7 @@ void UserInputHurricaneWidget::loadUserWFData(void)
     }
 
     // Get the header file
-    auto stationDataHeadings = sampleStationData.first();
+    stationDataHeadings = sampleStationData.first();
 
 
     // Create the fields
@@ -545,7 +514,10 @@ void UserInputHurricaneWidget::loadUserWFData(void)
     attribFields.push_back(QgsField("Station Name", QVariant::String));
     attribFields.push_back(QgsField("Latitude", QVariant::Double));
     attribFields.push_back(QgsField("Longitude", QVariant::Double));
+    attribFields.push_back(QgsField("Station File", QVariant::String));
+    attribFields.push_back(QgsField("Number of Time Steps", QVariant::Int));
 
+    // The series of a station are only filled in when its feature is selected
     for(auto&& it : stationDataHeadings)
     {
         attribFields.push_back(QgsField(it, QVariant::String));
@@ -612,6 +584,7 @@ void UserInputHurricaneWidget::loadUserWFData(void)
 
         WFStation.setStationFilePath(stationPath);
 
+        // Only the headings and the row offsets are read here, the values are parsed when the station is selected
         try
         {
             WFStation.importWindFieldStation();
@@ -627,7 +600,27 @@ void UserInputHurricaneWidget::loadUserWFData(void)
             return;
         }
 
-        auto stationData = WFStation.getStationData();
+        // The number of headings in the file
+        auto numParams = WFStation.getNumColumns();
+        auto numRows = WFStation.getNumRows();
+
+        if(numParams == 0 || numRows == 0)
+        {
+            this->errorMessage("Error, the wind field file of the station " + stationName + " does not contain any data");
+
+            this->hideProgressBar();
+
+            return;
+        }
+
+        if(7 + numParams > attribFields.size())
+        {
+            this->errorMessage("Error, the wind field file of the station " + stationName + " has more columns than the wind field files of the other stations");
+
+            this->hideProgressBar();
+
+            return;
+        }
 
         // create the feature attributes
         QgsAttributes featAttributes(attribFields.size());
@@ -637,26 +630,8 @@ void UserInputHurricaneWidget::loadUserWFData(void)
         featAttributes[2] = stationName; // Station Name
         featAttributes[3] = latitude; // Latitude
         featAttributes[4] = longitude; // Longitude
-
-        // The number of headings in the file
-        auto numParams =stationData.front().size();
-
-        QVector<QString> dataStrs(numParams);
-
-        for(int i = 0; i<stationData.size(); ++i)
-        {
-            auto stationParams = stationData[i];
-
-            for(int j = 0; j<numParams; ++j)
-            {
-                dataStrs[j] += stationParams[j] + " ";
-            }
-        }
-
-        for(int i = 0; i<numParams; ++i)
-        {
-            featAttributes[5+i] = dataStrs[i];
-        }
+        featAttributes[5] = stationPath; // Station File
+        featAttributes[6] = numRows; // Number of Time Steps
 
         // Create the point and add it to the feature table
         QgsFeature feature;
@@ -664,7 +639,7 @@ void UserInputHurricaneWidget::loadUserWFData(void)
         feature.setAttributes(featAttributes);
         featureList.append(feature);
 
-        WFStation.setStationFeature(feature);
+        stationMap.insert(stationName, WFStation);
 
         ++count;
         progressLabel->clear();
@@ -702,6 +677,8 @@ void UserInputHurricaneWidget::loadUserWFData(void)
 
     QGsVisWidget->createSymbolRenderer(Qgis::MarkerShape::Cross,Qt::black,2.0,vectorLayer);
 
+    connect(vectorLayer, &QgsVectorLayer::selectionChanged, this, &UserInputHurricaneWidget::handleStationSelection);
+
     progressLabel->setVisible(false);
 
     // Reset the widget back to the input pane and close
@@ -720,6 +697,93 @@ void UserInputHurricaneWidget::loadUserWFData(void)
 
 
 
+void UserInputHurricaneWidget::handleStationSelection(const QgsFeatureIds& selected, const QgsFeatureIds& deselected, bool /*clearAndSelect*/)
+{
+    auto vectorLayer = qobject_cast<QgsVectorLayer*>(this->sender());
+
+    if(vectorLayer == nullptr)
+        return;
+
+    auto stationNameIndex = vectorLayer->fields().lookupField("Station Name");
+
+    if(stationNameIndex == -1)
+        return;
+
+    QgsChangedAttributesMap changedAttributes;
+
+    // Drop the series of the deselected stations so that the layer only holds the series of the selected stations
+    for(auto&& fid : deselected)
+    {
+        QgsAttributeMap attributeMap;
+        for(auto&& heading : stationDataHeadings)
+        {
+            auto index = vectorLayer->fields().lookupField(heading);
+            if(index != -1)
+                attributeMap.insert(index, QVariant());
+        }
+
+        changedAttributes.insert(fid, attributeMap);
+    }
+
+    for(auto&& fid : selected)
+    {
+        auto feature = vectorLayer->getFeature(fid);
+
+        auto stationName = feature.attribute(stationNameIndex).toString();
+
+        auto it = stationMap.constFind(stationName);
+
+        if(it == stationMap.constEnd())
+            continue;
+
+        const WindFieldStation& station = it.value();
+
+        std::shared_ptr<const QVector<double>> stationValues;
+
+        try
+        {
+            stationValues = station.getStationValues();
+        }
+        catch(QString msg)
+        {
+            this->errorMessage("Error reading the wind field file of the station " + stationName + "\n" + msg);
+            continue;
+        }
+
+        auto numParams = station.getNumColumns();
+        auto numRows = station.getNumRows();
+
+        QVector<QString> dataStrs(numParams);
+
+        for(int i = 0; i<numRows; ++i)
+        {
+            const double* stationParams = stationValues->constData() + i*numParams;
+
+            for(int j = 0; j<numParams; ++j)
+            {
+                dataStrs[j] += QString::number(stationParams[j]) + " ";
+            }
+        }
+
+        QgsAttributeMap attributeMap;
+        auto headings = station.getStationDataHeaders();
+        for(int i = 0; i<numParams && i<headings.size(); ++i)
+        {
+            auto index = vectorLayer->fields().lookupField(headings.at(i));
+            if(index != -1)
+                attributeMap.insert(index, dataStrs[i]);
+        }
+
+        changedAttributes.insert(fid, attributeMap);
+    }
+
+    if(changedAttributes.isEmpty())
+        return;
+
+    vectorLayer->dataProvider()->changeAttributeValues(changedAttributes);
+}
+
+
 void UserInputHurricaneWidget::showProgressBar(void)
 {
     theStackedWidget->setCurrentWidget(progressBarWidget);
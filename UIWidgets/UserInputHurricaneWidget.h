@@ -39,6 +39,9 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 // Written by: Stevan Gavrilovic, Frank McKenna
 
 #include "SimCenterAppWidget.h"
+#include "WindFieldStation.h"
+
+#include <qgsfeatureid.h>
 
 #include <memory>
 
@@ -76,10 +79,12 @@ public slots:
 private slots:
 
     void loadUserWFData(void);
-    void loadHurricaneTrackData(void);
     void chooseEventFileDialog(void);
     void chooseEventDirDialog(void);
 
+    // Parses the series of the selected stations into the attributes of their features and drops the series of the deselected stations
+    void handleStationSelection(const QgsFeatureIds& selected, const QgsFeatureIds& deselected, bool clearAndSelect);
+
 signals:
     void outputDirectoryPathChanged(QString eventDir, QString eventFile);
     void loadingComplete(const bool value);
@@ -107,6 +112,11 @@ private:
 
     SimCenterUnitsWidget* unitsWidget;
 
+    // Stations of the wind field keyed by the station name, only their files are indexed at import
+    QMap<QString, WindFieldStation> stationMap;
+
+    QStringList stationDataHeadings;
+
 };
 
 #endif // UserInputHurricaneWidget_H
@@ -47,6 +47,168 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 #include <QJsonDocument>
 #include <QJsonArray>
 #include <QFile>
+#include <QHash>
+#include <QtNumeric>
+
+#include <cstring>
+#include <list>
+#include <mutex>
+
+namespace {
+
+// Least recently used cache of the station values, keyed by the path of the station file
+class StationValueCache
+{
+public:
+
+    std::shared_ptr<const QVector<double>> find(const QString& key)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        auto it = entries.find(key);
+        if(it == entries.end())
+            return nullptr;
+
+        // Move the station to the front of the usage order
+        order.splice(order.begin(), order, it->position);
+
+        return it->values;
+    }
+
+    void insert(const QString& key, const std::shared_ptr<const QVector<double>>& values)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        this->removeEntry(key);
+
+        order.push_front(key);
+        entries.insert(key, {values, order.begin()});
+        memoryUsed += getSize(values);
+
+        this->evict();
+    }
+
+    void remove(const QString& key)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        this->removeEntry(key);
+    }
+
+    void setMemoryLimit(const qint64 numBytes)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        memoryLimit = numBytes;
+
+        this->evict();
+    }
+
+    qint64 getMemoryLimit(void)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        return memoryLimit;
+    }
+
+private:
+
+    struct Entry
+    {
+        std::shared_ptr<const QVector<double>> values;
+        std::list<QString>::iterator position;
+    };
+
+    static qint64 getSize(const std::shared_ptr<const QVector<double>>& values)
+    {
+        return static_cast<qint64>(values->size())*static_cast<qint64>(sizeof(double));
+    }
+
+    void removeEntry(const QString& key)
+    {
+        auto it = entries.find(key);
+        if(it == entries.end())
+            return;
+
+        memoryUsed -= getSize(it->values);
+        order.erase(it->position);
+        entries.erase(it);
+    }
+
+    // Drops the least recently used stations until the cache is within its limit, the values stay alive for as long as a caller holds on to them
+    void evict(void)
+    {
+        while(memoryUsed > memoryLimit && !order.empty())
+            this->removeEntry(order.back());
+    }
+
+    std::mutex mutex;
+
+    QHash<QString, Entry> entries;
+
+    // Keys from the most to the least recently used
+    std::list<QString> order;
+
+    qint64 memoryLimit = 256*1024*1024;
+    qint64 memoryUsed = 0;
+};
+
+
+StationValueCache& getStationValueCache(void)
+{
+    static StationValueCache cache;
+    return cache;
+}
+
+
+// Text of a range of an open file, the range is mapped into memory if it can be and read otherwise
+class FileRange
+{
+public:
+
+    bool open(QFile& file, const qint64 offset, const qint64 size)
+    {
+        if(size <= 0)
+            return true;
+
+        uchar* mapped = file.map(offset, size);
+        if(mapped != nullptr)
+        {
+            text = reinterpret_cast<const char*>(mapped);
+            length = size;
+            return true;
+        }
+
+        if(!file.seek(offset))
+            return false;
+
+        buffer = file.read(size);
+        text = buffer.constData();
+        length = buffer.size();
+
+        return length == size;
+    }
+
+    const char* data(void) const
+    {
+        return text;
+    }
+
+    qint64 size(void) const
+    {
+        return length;
+    }
+
+private:
+
+    QByteArray buffer;
+
+    const char* text = nullptr;
+    qint64 length = 0;
+};
+
+}
+
 
 WindFieldStation::WindFieldStation(QString name, double lat, double lon) : stationName(name), latitude(lat), longitude(lon)
 {
@@ -67,25 +229,53 @@ double WindFieldStation::getLongitude() const
 
 void WindFieldStation::importWindFieldStation(void)
 {
-    CSVReaderWriter csvTool;
-
-    QString err;
-    QVector<QStringList> data = csvTool.parseCSVFile(stationFilePath,err);
-
-    // Return if there is an error or the data is empty
-    if(!err.isEmpty())
-        throw err;
-
-    if(data.size() < 2)
+    tableHeadings.clear();
+    rowOffsets.clear();
+
+    // Values parsed from an earlier import of the file may be out of date
+    getStationValueCache().remove(stationFilePath);
+
+    QFile file(stationFilePath);
+    if(!file.open(QIODevice::ReadOnly))
+        throw "Could not open the file " + stationFilePath;
+
+    const qint64 fileSize = file.size();
+
+    FileRange range;
+    if(!range.open(file, 0, fileSize))
+        throw "Could not read the file " + stationFilePath;
+
+    const char* text = range.data();
+
+    // Index the start of each row that is not blank, the first of them holds the headings
+    qint64 pos = 0;
+    while(pos < fileSize)
+    {
+        const char* newLine = static_cast<const char*>(std::memchr(text + pos, '\n', static_cast<size_t>(fileSize - pos)));
+        const qint64 end = newLine != nullptr ? newLine - text : fileSize;
+
+        QByteArray line = QByteArray::fromRawData(text + pos, static_cast<int>(end - pos)).trimmed();
+
+        if(!line.isEmpty())
+        {
+            if(tableHeadings.isEmpty())
+            {
+                for(auto&& it : QString::fromUtf8(line).split(','))
+                    tableHeadings.append(it.trimmed());
+            }
+            else
+            {
+                rowOffsets.append(pos);
+            }
+        }
+
+        pos = end + 1;
+    }
+
+    if(rowOffsets.isEmpty())
         throw "The file " + stationFilePath + " is empty";
 
-    // Get the header file
-    tableHeadings = data.first();
-
-    // Pop off the row that contains the header information
-    data.pop_front();
-
-    stationData = data;
+    rowOffsets.append(fileSize);
 }
 
 
@@ -120,7 +310,19 @@ int WindFieldStation::updateFeatureAttribute(const QString& attribute, const QVa
 
 QVector<QStringList> WindFieldStation::getStationData() const
 {
-    return stationData;
+    CSVReaderWriter csvTool;
+
+    QString err;
+    QVector<QStringList> data = csvTool.parseCSVFile(stationFilePath,err);
+
+    if(!err.isEmpty())
+        return QVector<QStringList>();
+
+    // Pop off the row that contains the header information
+    if(!data.isEmpty())
+        data.pop_front();
+
+    return data;
 }
 
 QStringList WindFieldStation::getStationDataHeaders() const
@@ -128,3 +330,104 @@ QStringList WindFieldStation::getStationDataHeaders() const
     return tableHeadings;
 }
 
+
+int WindFieldStation::getNumRows(void) const
+{
+    return rowOffsets.isEmpty() ? 0 : rowOffsets.size() - 1;
+}
+
+
+int WindFieldStation::getNumColumns(void) const
+{
+    return tableHeadings.size();
+}
+
+
+std::shared_ptr<const QVector<double>> WindFieldStation::getStationValues(void) const
+{
+    auto& cache = getStationValueCache();
+
+    auto values = cache.find(stationFilePath);
+    if(values)
+        return values;
+
+    if(rowOffsets.isEmpty())
+        throw "The file " + stationFilePath + " has not been imported";
+
+    QFile file(stationFilePath);
+    if(!file.open(QIODevice::ReadOnly))
+        throw "Could not open the file " + stationFilePath;
+
+    if(file.size() < rowOffsets.last())
+        throw "The file " + stationFilePath + " changed after it was imported";
+
+    const qint64 firstOffset = rowOffsets.first();
+
+    FileRange range;
+    if(!range.open(file, firstOffset, rowOffsets.last() - firstOffset))
+        throw "Could not read the file " + stationFilePath;
+
+    const int numRows = this->getNumRows();
+    const int numColumns = this->getNumColumns();
+
+    auto parsedValues = std::make_shared<QVector<double>>(numRows*numColumns, qQNaN());
+    double* valuePtr = parsedValues->data();
+
+    for(int i = 0; i<numRows; ++i)
+    {
+        const char* cell = range.data() + (rowOffsets.at(i) - firstOffset);
+        const char* rowEnd = range.data() + (rowOffsets.at(i + 1) - firstOffset);
+
+        for(int j = 0; j<numColumns && cell < rowEnd; ++j)
+        {
+            const char* comma = static_cast<const char*>(std::memchr(cell, ',', static_cast<size_t>(rowEnd - cell)));
+            const char* cellEnd = comma != nullptr ? comma : rowEnd;
+
+            bool OK;
+            const double value = QByteArray::fromRawData(cell, static_cast<int>(cellEnd - cell)).trimmed().toDouble(&OK);
+
+            if(OK)
+                valuePtr[i*numColumns + j] = value;
+
+            cell = cellEnd + 1;
+        }
+    }
+
+    cache.insert(stationFilePath, parsedValues);
+
+    return parsedValues;
+}
+
+
+QVector<double> WindFieldStation::getStationColumn(const QString& heading) const
+{
+    QVector<double> column;
+
+    const int index = tableHeadings.indexOf(heading);
+    if(index == -1)
+        return column;
+
+    auto values = this->getStationValues();
+
+    const int numRows = this->getNumRows();
+    const int numColumns = this->getNumColumns();
+
+    column.reserve(numRows);
+    for(int i = 0; i<numRows; ++i)
+        column.append(values->at(i*numColumns + index));
+
+    return column;
+}
+
+
+void WindFieldStation::setCacheMemoryLimit(const qint64 numBytes)
+{
+    getStationValueCache().setMemoryLimit(numBytes);
+}
+
+
+qint64 WindFieldStation::getCacheMemoryLimit(void)
+{
+    return getStationValueCache().getMemoryLimit();
+}
+
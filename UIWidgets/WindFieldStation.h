@@ -43,6 +43,10 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 
 #include <qgsfeature.h>
 
+#include <memory>
+
+// Station of a wind field, the station file is only indexed when it is imported
+// The values of the station are parsed from the file when they are asked for and kept in a least recently used cache that is shared by all of the stations, so that a hurricane with tens of thousands of stations does not hold all of its station files in memory
 class WindFieldStation
 {
 public:
@@ -57,6 +61,7 @@ public:
     QString getStationFilePath() const;
     void setStationFilePath(const QString &value);
 
+    // Reads the headings of the station file and the offset of each of its rows
     void importWindFieldStation(void);
 
     // Function to convert a QString and QVariant to double
@@ -82,10 +87,25 @@ public:
 
     int updateFeatureAttribute(const QString& attribute, const QVariant& value);
 
+    // Cells of the station file as text, parsed from the file on every call, empty if the file cannot be read
     QVector<QStringList> getStationData() const;
 
     QStringList getStationDataHeaders() const;
 
+    int getNumRows(void) const;
+    int getNumColumns(void) const;
+
+    // Row-major values of the station file, the cells that are not numbers are NaN
+    // Throws an error exception if the file cannot be read
+    std::shared_ptr<const QVector<double>> getStationValues(void) const;
+
+    // Values of the column with the heading, empty if there is no such column
+    QVector<double> getStationColumn(const QString& heading) const;
+
+    // Limit in bytes on the station values that are kept in the cache, the least recently used stations are dropped first
+    static void setCacheMemoryLimit(const qint64 numBytes);
+    static qint64 getCacheMemoryLimit(void);
+
 private:
 
     QString stationFilePath;
@@ -96,7 +116,8 @@ private:
 
     double longitude;
 
-    QVector<QStringList> stationData;
+    // Offsets in the file of the start and end of each row after the headings, the end of the last row is the last entry
+    QVector<qint64> rowOffsets;
 
     QStringList tableHeadings;
 
@@ -17,6 +17,7 @@
 #include <epanet2_2.h>
 #include <types.h>
 #include <funcs.h>
+#include <outputJSON.h>
 
 void  writeConsole(char *s)
 {
@@ -27,8 +28,6 @@ void  writeConsole(char *s)
 static Project __defaultProject;
 static Project *_defaultProject = &__defaultProject;
 
-int outputJSON(Project *, const char *);
-
 // Functions for creating and removing default temporary files
 static void createtmpfiles()
 {
@@ -46,20 +45,14 @@ static void removetmpfiles()
 
 
 
-int createJSON(const char *f1, const char *f2, const char *f3, const char *f4) {
+static int openProject(const char *f1, const char *f2, const char *f3) {
   
 /*--------------------------------------------------------------
- **  Input:   argc    = number of command line arguments
- **           *argv[] = array of command line arguments
- **  Output:  none
- **  Purpose: main program stub for command line EPANET
- **
- **  Command line for stand-alone operation is:
- **    progname f1  f2  f3
- **  where progname = name of executable this code was compiled to,
- **  f1 = name of input file,
- **  f2 = name of report file
- **  f3 = name of binary output file (optional).
+ **  Input:   f1 = name of input file,
+ **           f2 = name of report file
+ **           f3 = name of binary output file (optional).
+ **  Output:  0 if the project was opened without warnings or errors
+ **  Purpose: opens the inp file in the default project
  **--------------------------------------------------------------
  */
 
@@ -100,7 +93,48 @@ int createJSON(const char *f1, const char *f2, const char *f3, const char *f4) {
     }
   }
   
-  if (f4 != 0) {
-    outputJSON(theProjectPtr, f4);
-  }
+  return 0;
+}
+
+
+int createJSON(const char *f1, const char *f2, const char *f3, const char *f4) {
+  
+/*--------------------------------------------------------------
+ **  Input:   f1 = name of input file,
+ **           f2 = name of report file
+ **           f3 = name of binary output file (optional).
+ **           f4 = name of GeoJSON file (optional).
+ **  Output:  0 on success
+ **  Purpose: writes the network of an inp file to a GeoJSON file
+ **--------------------------------------------------------------
+ */
+
+  int errcode = openProject(f1, f2, f3);
+  if (errcode != 0)
+    return errcode;
+
+  if (f4 != 0)
+    return outputJSON(_defaultProject, f4);
+
+  return 0;
+}
+
+
+int streamInpFile(const char *f1, const char *f2, const char *f3, NetworkSink *sink) {
+
+/*--------------------------------------------------------------
+ **  Input:   f1 = name of input file,
+ **           f2 = name of report file
+ **           f3 = name of binary output file (optional).
+ **           sink = receiver of the network records
+ **  Output:  0 on success
+ **  Purpose: pushes the network of an inp file into a sink
+ **--------------------------------------------------------------
+ */
+
+  int errcode = openProject(f1, f2, f3);
+  if (errcode != 0)
+    return errcode;
+
+  return streamNetwork(_defaultProject, sink);
 }
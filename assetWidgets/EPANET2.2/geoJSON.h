@@ -1 +1,19 @@
+#ifndef GEOJSON_H
+#define GEOJSON_H
+
+#include "outputJSON.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 int  createJSON(const char *f1, const char *f2, const char *f3, const char *f4);
+
+// Opens an inp file and pushes its nodes and links into the sink instead of writing them to a file
+int  streamInpFile(const char *f1, const char *f2, const char *f3, NetworkSink *sink);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
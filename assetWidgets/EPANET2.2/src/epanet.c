@@ -47,6 +47,7 @@ int DLLEXPORT EN_createproject(EN_Project *p)
     getTmpName(project->TmpHydFname);
     getTmpName(project->TmpOutFname);
     getTmpName(project->TmpStatFname);
+    opensymboliccache();
     *p = project;
     return 0;
 }
@@ -68,6 +69,7 @@ int DLLEXPORT EN_deleteproject(EN_Project p)
     remove(p->TmpOutFname);
     remove(p->TmpStatFname);
     free(p);
+    closesymboliccache();
     return 0;
 }
 
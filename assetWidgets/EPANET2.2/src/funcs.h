@@ -157,6 +157,11 @@ void    getenergy(Project *, int, double *, double *);
 double  tankvolume(Project *, int, double);
 double  tankgrade(Project *, int, double);
 
+// ------- SMATRIX.C -------------------
+
+void    opensymboliccache(void);
+void    closesymboliccache(void);
+
 // ------- HYDCOEFFS.C -----------------
 
 void    resistcoeff(Project *, int);
@@ -4,7 +4,9 @@
 
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 #include "types.h"
+#include "outputJSON.h"
 //#include "enumstxt.h"
 
 static inline const char *getStatusType(int f)
@@ -25,42 +27,27 @@ static inline const char *getPumpType(int f)
   return strings[f];
 }
 
-int outputJSON(Project *theProjectPtr, const char *fileName) {
+int streamNetwork(Project *theProjectPtr, NetworkSink *sink) {
 
-  //
-  // open file, error message and return -1 if error
-  //
-  
-  FILE* jsonFile = fopen(fileName, "w"); 
-  if (jsonFile == 0) {
-    printf("ERROR: Coul not open file: %s\n",fileName);
-    return -1;
-  }
-
-  //
-  // start of GeoJSON
-  //
-  
-  fprintf(jsonFile, "\n{\n \"type\":\"FeatureCollection\", \"features\":[");
+  NetworkRecord record;
+  NetworkAttribute attributes[16];
+  int n;
 
   int numNodes = theProjectPtr->network.Nnodes;
   int numTanks = theProjectPtr->network.Ntanks;
-  int numJuncs = theProjectPtr->network.Njuncs;
   int numLinks = theProjectPtr->network.Nlinks;
-  int numPipes = theProjectPtr->network.Npipes;
   int numPumps = theProjectPtr->network.Npumps; 
-  int numValves = theProjectPtr->network.Nvalves;
 
+  // helpers filling the next attribute of the record
+#define ADD_DOUBLE(n, key, value) (attributes[n].name = key, attributes[n].type = NETWORK_DOUBLE, attributes[n].number = (value), attributes[n].string = 0, n++)
+#define ADD_INT(n, key, value) (attributes[n].name = key, attributes[n].type = NETWORK_INT, attributes[n].number = (value), attributes[n].string = 0, n++)
+#define ADD_STRING(n, key, value) (attributes[n].name = key, attributes[n].type = NETWORK_STRING, attributes[n].number = 0.0, attributes[n].string = (value), n++)
+
+  record.attributes = attributes;
+
+  if (sink->begin != 0 && sink->begin(sink->context, numNodes, numLinks) != 0)
+    return -1;
 
-  printf("\n\t numNodes %d, numTanks %d, numJuncs %d, numLinks %d, numPipes %d, numPumps %d numValves: %d.\n",
-	 numNodes,
-	 numTanks,
-	 numJuncs,
-	 numLinks,
-	 numPipes,
-	 numPumps,
-	 numValves);  
-  
   //
   // output Junctions
   //
@@ -68,23 +55,21 @@ int outputJSON(Project *theProjectPtr, const char *fileName) {
   for (int i=1; i<=numNodes; i++) { // not standard C indexing
     Snode *theNode = &theProjectPtr->network.Node[i];
     if (theNode->Type == JUNCTION) {
-      if (i == 1) // the == 1 is needed to for no initial comma
-	fprintf(jsonFile,"\n {\"type\":\"Feature\",\"geometry\":{ \"type\":\"Point\", \"coordinates\":[%f,%f]},\"id\":\"1\", \"properties\":{\"type\":\"Junction\",\"InpID\":\"%s\", \"El\":%f, \"C0\":%f, \"Ke\":%f}}",
-		theNode->X,
-		theNode->Y,
-		theNode->ID,
-		theNode->El,	       
-		theNode->C0,
-		theNode->Ke);
-      else
-	fprintf(jsonFile,",\n {\"type\":\"Feature\",\"geometry\":{ \"type\":\"Point\", \"coordinates\":[%f,%f]}, \"id\":\"%d\", \"properties\":{\"type\":\"Junction\",\"InpID\":\"%s\", \"El\":%f, \"C0\":%f, \"Ke\":%f}}",
-		theNode->X,
-		theNode->Y,
-		i,
-		theNode->ID,
-		theNode->El,	       
-		theNode->C0,
-		theNode->Ke);	    
+      n = 0;
+      ADD_DOUBLE(n, "El", theNode->El);
+      ADD_DOUBLE(n, "C0", theNode->C0);
+      ADD_DOUBLE(n, "Ke", theNode->Ke);
+
+      record.type = "Junction";
+      record.index = i;
+      record.id = theNode->ID;
+      record.numPoints = 1;
+      record.x[0] = theNode->X;
+      record.y[0] = theNode->Y;
+      record.numAttributes = n;
+
+      if (sink->record(sink->context, &record) != 0)
+	return -1;
     }
   }
 
@@ -97,28 +82,35 @@ int outputJSON(Project *theProjectPtr, const char *fileName) {
     Slink *theLink = &theProjectPtr->network.Link[thePump->Link];
     Snode *startNode= &theProjectPtr->network.Node[theLink->N1];
     Snode *endNode = &theProjectPtr->network.Node[theLink->N2];
-    fprintf(jsonFile,",\n {\"type\":\"Feature\",\"geometry\":{ \"type\":\"LineString\", \"coordinates\":[[%f,%f],[%f,%f]]},\"id\":\"%d\", \"properties\":{\"type\":\"Pump\",\"InpID\":\"%s\", \"Ptype\":\"%s\", \"Q0\":%f, \"Qmax\":%f, \"Hmax\": %f, \"H0\":%f, \"R\":%f, \"N\":%f, \"Hcurve\":%d, \"Ecurve\":%d, \"Upat\":%d,\"Epat\":%d, \"Ecost\":%f,\"startNode\":\"%s\", \"endNode\":\"%s\"}}",
-	    startNode->X,
-	    startNode->Y,
-	    endNode->X,
-	    endNode->Y,
-	    i,
-	    theLink->ID,
-	    getPumpType(thePump->Ptype),
-	    thePump->Q0,
-	    thePump->Qmax,
-	    thePump->Hmax,
-	    thePump->H0,
-	    thePump->R,
-	    thePump->N,
-	    thePump->Hcurve,
-	    thePump->Ecurve,
-	    thePump->Upat,
-	    thePump->Epat,	     
-	    thePump->Ecost,
-	    startNode->ID,
-	    endNode->ID);	   
 
+    n = 0;
+    ADD_STRING(n, "Ptype", getPumpType(thePump->Ptype));
+    ADD_DOUBLE(n, "Q0", thePump->Q0);
+    ADD_DOUBLE(n, "Qmax", thePump->Qmax);
+    ADD_DOUBLE(n, "Hmax", thePump->Hmax);
+    ADD_DOUBLE(n, "H0", thePump->H0);
+    ADD_DOUBLE(n, "R", thePump->R);
+    ADD_DOUBLE(n, "N", thePump->N);
+    ADD_INT(n, "Hcurve", thePump->Hcurve);
+    ADD_INT(n, "Ecurve", thePump->Ecurve);
+    ADD_INT(n, "Upat", thePump->Upat);
+    ADD_INT(n, "Epat", thePump->Epat);
+    ADD_DOUBLE(n, "Ecost", thePump->Ecost);
+    ADD_STRING(n, "startNode", startNode->ID);
+    ADD_STRING(n, "endNode", endNode->ID);
+
+    record.type = "Pump";
+    record.index = i;
+    record.id = theLink->ID;
+    record.numPoints = 2;
+    record.x[0] = startNode->X;
+    record.y[0] = startNode->Y;
+    record.x[1] = endNode->X;
+    record.y[1] = endNode->Y;
+    record.numAttributes = n;
+
+    if (sink->record(sink->context, &record) != 0)
+      return -1;
   }
 
   //
@@ -127,30 +119,34 @@ int outputJSON(Project *theProjectPtr, const char *fileName) {
   
   for (int i=1; i<=numLinks; i++) { // not standard C indexing
     Slink *theLink = &theProjectPtr->network.Link[i];
-    int type = theLink->Type;
-    char *ID = theLink->ID;
     Snode *startNode = &theProjectPtr->network.Node[theLink->N1];
     Snode *endNode = &theProjectPtr->network.Node[theLink->N2];
     if (theLink->Type == PIPE) {
-      fprintf(jsonFile,",\n {\"type\":\"Feature\",\"geometry\":{ \"type\":\"LineString\", \"coordinates\":[[%f,%f],[%f,%f]]},\"id\": \"%d\", \"properties\":{\"type\":\"Pipe\",\"InpID\":\"%s\", \"Diam\":%f, \"Kc\":%f, \"Len\":%f, \"Status\":\"%s\", \"Km\":%f, \"Kb\":%f, \"Kw\":%f, \"R\":%f,\"Rc\":%f,\"startNode\":\"%s\", \"endNode\":\"%s\"}}",
-	      startNode->X,
-	      startNode->Y,
-	      endNode->X,
-	      endNode->Y,
-	      i,
-	      theLink->ID,
-	      theLink->Diam,
-	      theLink->Kc,
-	      theLink->Len,
-	      getStatusType(theLink->Status),
-	      theLink->Km,
-	      theLink->Kb,
-	      theLink->Kw,
-	      theLink->R,
-	      theLink->Rc,
-	      startNode->ID,
-	      endNode->ID);
-      
+      n = 0;
+      ADD_DOUBLE(n, "Diam", theLink->Diam);
+      ADD_DOUBLE(n, "Kc", theLink->Kc);
+      ADD_DOUBLE(n, "Len", theLink->Len);
+      ADD_STRING(n, "Status", getStatusType(theLink->Status));
+      ADD_DOUBLE(n, "Km", theLink->Km);
+      ADD_DOUBLE(n, "Kb", theLink->Kb);
+      ADD_DOUBLE(n, "Kw", theLink->Kw);
+      ADD_DOUBLE(n, "R", theLink->R);
+      ADD_DOUBLE(n, "Rc", theLink->Rc);
+      ADD_STRING(n, "startNode", startNode->ID);
+      ADD_STRING(n, "endNode", endNode->ID);
+
+      record.type = "Pipe";
+      record.index = i;
+      record.id = theLink->ID;
+      record.numPoints = 2;
+      record.x[0] = startNode->X;
+      record.y[0] = startNode->Y;
+      record.x[1] = endNode->X;
+      record.y[1] = endNode->Y;
+      record.numAttributes = n;
+
+      if (sink->record(sink->context, &record) != 0)
+	return -1;
       
     } else if (theLink->Type == CVPIPE) {
       
@@ -170,49 +166,206 @@ int outputJSON(Project *theProjectPtr, const char *fileName) {
     int nodeID = theTank->Node;
     double A = theTank->A;
     Snode *theNode = &theProjectPtr->network.Node[nodeID];      
-    if (A == 0) {   // keeping tanks and resrvoirs seperate for now .. might not want all the stuff in the structure depending on type
-      fprintf(jsonFile,",\n {\"type\":\"Feature\",\"geometry\":{ \"type\":\"Point\", \"coordinates\":[%f,%f]},\"id\":\"%d\", \"properties\":{\"type\":\"Reservoir\",\"InpID\":\"%s\", \"H0\":%f, \"Vmin\":%f, \"Vmax\":%f, \"V0\": %f, \"Kb\":%f, \"V\":%f, \"C\":%f, \"Pat\":%d, \"Vcurve\":%d, \"MixModel\":\"%s\", \"V1Max\":%f, \"CanOverflow\":%d}}",
-	      theNode->X,
-	      theNode->Y,
-	      i,
-	      theNode->ID,
-	      theTank->H0,
-	      theTank->Vmin,
-	      theTank->Vmax,
-	      theTank->V0,
-	      theTank->Kb,
-	      theTank->V,
-	      theTank->C,
-	      theTank->Pat,
-	      theTank->Vcurve,
-	      getMixType(theTank->MixModel),	       
-	      theTank->V1max,
-	      theTank->CanOverflow);		    
-    } else {
-      fprintf(jsonFile,",\n {\"type\":\"Feature\",\"geometry\":{ \"type\":\"Point\", \"coordinates\":[%f,%f]}, \"id\":\"%d\", \"properties\":{\"type\":\"Tank\",\"InpID\":\"%s\", \"H0\":%f, \"Vmin\":%f, \"Vmax\":%f, \"V0\": %f, \"Kb\":%f, \"V\":%f, \"C\":%f, \"Pat\":%d, \"Vcurve\":%d, \"MixModel\":\"%s\", \"V1Max\":%f, \"CanOverflow\":%d}}",
-	      theNode->X,
-	      theNode->Y,
-	      i,
-	      theNode->ID,
-	      theTank->H0,
-	      theTank->Vmin,
-	      theTank->Vmax,
-	      theTank->V0,
-	      theTank->Kb,
-	      theTank->V,
-	      theTank->C,
-	      theTank->Pat,
-	      theTank->Vcurve,
-	      getMixType(theTank->MixModel),	       
-	      theTank->V1max,
-	      theTank->CanOverflow);		          
-    }
+
+    n = 0;
+    ADD_DOUBLE(n, "H0", theTank->H0);
+    ADD_DOUBLE(n, "Vmin", theTank->Vmin);
+    ADD_DOUBLE(n, "Vmax", theTank->Vmax);
+    ADD_DOUBLE(n, "V0", theTank->V0);
+    ADD_DOUBLE(n, "Kb", theTank->Kb);
+    ADD_DOUBLE(n, "V", theTank->V);
+    ADD_DOUBLE(n, "C", theTank->C);
+    ADD_INT(n, "Pat", theTank->Pat);
+    ADD_INT(n, "Vcurve", theTank->Vcurve);
+    ADD_STRING(n, "MixModel", getMixType(theTank->MixModel));
+    ADD_DOUBLE(n, "V1Max", theTank->V1max);
+    ADD_INT(n, "CanOverflow", theTank->CanOverflow);
+
+    // keeping tanks and resrvoirs seperate for now .. might not want all the stuff in the structure depending on type
+    record.type = (A == 0) ? "Reservoir" : "Tank";
+    record.index = i;
+    record.id = theNode->ID;
+    record.numPoints = 1;
+    record.x[0] = theNode->X;
+    record.y[0] = theNode->Y;
+    record.numAttributes = n;
+
+    if (sink->record(sink->context, &record) != 0)
+      return -1;
+  }
+
+#undef ADD_DOUBLE
+#undef ADD_INT
+#undef ADD_STRING
+
+  if (sink->end != 0 && sink->end(sink->context) != 0)
+    return -1;
+
+  return 0;
+}
+
+//
+// GeoJSON sink
+//
+
+static void writeJSONString(FILE *jsonFile, const char *string)
+{
+  fputc('"', jsonFile);
+  for (const char *c = string; *c != 0; c++) {
+    if (*c == '"' || *c == '\\')
+      fputc('\\', jsonFile);
+    fputc(*c, jsonFile);
   }
+  fputc('"', jsonFile);
+}
+
+static int jsonSinkBegin(void *context, int numNodes, int numLinks)
+{
+  JSONSink *jsonSink = (JSONSink *)context;
+  (void)numNodes;
+  (void)numLinks;
+
+  //
+  // start of GeoJSON
+  //
+  
+  fprintf(jsonSink->file, "\n{\n \"type\":\"FeatureCollection\", \"features\":[");
+  jsonSink->numFeatures = 0;
+  return 0;
+}
+
+static int jsonSinkRecord(void *context, const NetworkRecord *record)
+{
+  JSONSink *jsonSink = (JSONSink *)context;
+  FILE *jsonFile = jsonSink->file;
+
+  // no comma before the first feature
+  fprintf(jsonFile, "%s\n {\"type\":\"Feature\",\"geometry\":{ \"type\":", jsonSink->numFeatures == 0 ? "" : ",");
+  if (record->numPoints == 1)
+    fprintf(jsonFile, "\"Point\", \"coordinates\":[%f,%f]}", record->x[0], record->y[0]);
+  else
+    fprintf(jsonFile, "\"LineString\", \"coordinates\":[[%f,%f],[%f,%f]]}", record->x[0], record->y[0], record->x[1], record->y[1]);
+
+  fprintf(jsonFile, ",\"id\":\"%d\", \"properties\":{\"type\":\"%s\",\"InpID\":", record->index, record->type);
+  writeJSONString(jsonFile, record->id);
+
+  for (int i=0; i<record->numAttributes; i++) {
+    const NetworkAttribute *attribute = &record->attributes[i];
+    fprintf(jsonFile, ", \"%s\":", attribute->name);
+    if (attribute->type == NETWORK_DOUBLE)
+      fprintf(jsonFile, "%f", attribute->number);
+    else if (attribute->type == NETWORK_INT)
+      fprintf(jsonFile, "%d", (int)attribute->number);
+    else
+      writeJSONString(jsonFile, attribute->string);
+  }
+  fprintf(jsonFile, "}}");
+
+  jsonSink->numFeatures++;
+  return ferror(jsonFile) ? -1 : 0;
+}
+
+static int jsonSinkEnd(void *context)
+{
+  JSONSink *jsonSink = (JSONSink *)context;
 
   // finish the JSON file
-  fprintf(jsonFile, "\n]}\n");
+  fprintf(jsonSink->file, "\n]}\n");
+
+  int error = ferror(jsonSink->file);
+
+  // keep the output only if it was written completely
+  if (closeJSONSink(jsonSink, !error) != 0)
+    error = 1;
+
+  return error ? -1 : 0;
+}
+
+int openJSONSink(JSONSink *jsonSink, NetworkSink *sink, const char *fileName) {
+
+  jsonSink->file = 0;
+  jsonSink->numFeatures = 0;
+
+  //
+  // the output goes to fileName.tmp until it is complete
+  //
+
+  size_t length = strlen(fileName);
+  jsonSink->fileName = (char *)malloc(length + 1);
+  jsonSink->tempFileName = (char *)malloc(length + 5);
+  if (jsonSink->fileName == 0 || jsonSink->tempFileName == 0) {
+    free(jsonSink->fileName);
+    free(jsonSink->tempFileName);
+    jsonSink->fileName = 0;
+    jsonSink->tempFileName = 0;
+    return -1;
+  }
+  strcpy(jsonSink->fileName, fileName);
+  strcpy(jsonSink->tempFileName, fileName);
+  strcat(jsonSink->tempFileName, ".tmp");
+
+  //
+  // open file, error message and return -1 if error
+  //
+
+  jsonSink->file = fopen(jsonSink->tempFileName, "w");
+  if (jsonSink->file == 0) {
+    fprintf(stderr, "ERROR: Could not open file: %s\n", jsonSink->tempFileName);
+    closeJSONSink(jsonSink, 0);
+    return -1;
+  }
 
-  fclose(jsonFile);
+  sink->context = jsonSink;
+  sink->begin = jsonSinkBegin;
+  sink->record = jsonSinkRecord;
+  sink->end = jsonSinkEnd;
 
   return 0;
 }
+
+int closeJSONSink(JSONSink *jsonSink, int keep) {
+
+  int error = 0;
+
+  if (jsonSink->file != 0) {
+    if (fclose(jsonSink->file) != 0)
+      error = 1;
+    jsonSink->file = 0;
+  }
+
+  if (jsonSink->tempFileName != 0) {
+    if (keep && !error) {
+      // rename does not replace an existing file on all platforms
+      remove(jsonSink->fileName);
+      if (rename(jsonSink->tempFileName, jsonSink->fileName) != 0) {
+        fprintf(stderr, "ERROR: Could not move %s to %s\n", jsonSink->tempFileName, jsonSink->fileName);
+        error = 1;
+      }
+    }
+    if (!keep || error)
+      remove(jsonSink->tempFileName);
+  }
+
+  free(jsonSink->fileName);
+  free(jsonSink->tempFileName);
+  jsonSink->fileName = 0;
+  jsonSink->tempFileName = 0;
+
+  return error ? -1 : 0;
+}
+
+int outputJSON(Project *theProjectPtr, const char *fileName) {
+
+  JSONSink jsonSink;
+  NetworkSink sink;
+
+  if (openJSONSink(&jsonSink, &sink, fileName) != 0)
+    return -1;
+
+  int result = streamNetwork(theProjectPtr, &sink);
+
+  // discard the temporary file if the output stopped before the end
+  closeJSONSink(&jsonSink, 0);
+
+  return result;
+}
@@ -0,0 +1,78 @@
+//
+// Streaming output of the nodes and links of a network. The network is
+// pushed one record at a time into a sink, so that a consumer can build
+// its own data structures without formatting and re-parsing text.
+// The GeoJSON file writer is one such sink.
+//
+
+#ifndef OUTPUTJSON_H
+#define OUTPUTJSON_H
+
+#include <stdio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct Project;
+
+// Types of attribute values
+#define NETWORK_DOUBLE 0
+#define NETWORK_INT    1
+#define NETWORK_STRING 2
+
+typedef struct {
+  const char *name;
+  int         type;      // NETWORK_DOUBLE, NETWORK_INT or NETWORK_STRING
+  double      number;    // value of double and int attributes
+  const char *string;    // value of string attributes
+} NetworkAttribute;
+
+typedef struct {
+  const char *type;      // Junction, Pump, Pipe, Reservoir or Tank
+  int         index;     // EPANET index of the node or link
+  const char *id;        // ID in the inp file
+  int         numPoints; // 1 for nodes, 2 for links
+  double      x[2];      // coordinates of the node, or of the start and end nodes of the link
+  double      y[2];
+  int         numAttributes;
+  const NetworkAttribute *attributes;
+} NetworkRecord;
+
+// The records and attributes passed to a sink are only valid during the call,
+// each callback returns 0 on success and anything else to stop the output
+typedef struct {
+  void *context;
+  int (*begin)(void *context, int numNodes, int numLinks);
+  int (*record)(void *context, const NetworkRecord *record);
+  int (*end)(void *context);
+} NetworkSink;
+
+// Pushes the junctions, pumps, pipes, reservoirs and tanks of a project into a sink
+int streamNetwork(struct Project *theProjectPtr, NetworkSink *sink);
+
+// Sink that writes the records as a GeoJSON feature collection. The records
+// are written to a temporary file next to the GeoJSON file, which replaces
+// the GeoJSON file once the output is complete, so that an inp file that
+// fails to parse does not leave a truncated GeoJSON file behind
+typedef struct {
+  FILE *file;
+  int   numFeatures;
+  char *fileName;
+  char *tempFileName;
+} JSONSink;
+
+int openJSONSink(JSONSink *jsonSink, NetworkSink *sink, const char *fileName);
+
+// Closes the sink if it is still open, and moves the temporary file onto the
+// GeoJSON file if keep is nonzero or removes it otherwise. Safe to call on a
+// sink that was already closed at the end of the output
+int closeJSONSink(JSONSink *jsonSink, int keep);
+
+int outputJSON(struct Project *theProjectPtr, const char *fileName);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -278,6 +278,9 @@ void initpointers(Project *pr)
     pr->hydraul.smatrix.XLNZ = NULL;
     pr->hydraul.smatrix.NZSUB = NULL;
     pr->hydraul.smatrix.LNZ = NULL;
+    pr->hydraul.smatrix.Lij = NULL;
+    pr->hydraul.smatrix.Super = NULL;
+    pr->hydraul.smatrix.Symbolic = NULL;
 
     initrules(pr);
 }
@@ -16,6 +16,16 @@
    createsparse() -- called from openhyd() in HYDRAUL.C
    freesparse()   -- called from closehyd() in HYDRAUL.C
    linsolve()     -- called from netsolve() in HYDRAUL.C
+   opensymboliccache()  -- called from EN_createproject() in EPANET.C
+   closesymboliccache() -- called from EN_deleteproject() in EPANET.C
+
+ The symbolic factorization of the solution matrix (node re-ordering and
+ positions of non-zero coeffs.) depends only on the network's topology.
+ It is kept in a small process-wide cache so that projects that open
+ networks with the same topology (e.g., many runs on one network) share
+ a single copy of it instead of recomputing it. The cache lives as long
+ as at least one project exists and is emptied when the last project is
+ deleted.
 */
 
 #include <stdlib.h>
@@ -26,6 +36,20 @@
 
 #include <time.h>  //For optional timer macros
 
+// Lock protecting the symbolic factorization cache
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+static SRWLOCK SymbolicLock = SRWLOCK_INIT;
+#define LOCKSYMBOLIC()   AcquireSRWLockExclusive(&SymbolicLock)
+#define UNLOCKSYMBOLIC() ReleaseSRWLockExclusive(&SymbolicLock)
+#else
+#include <pthread.h>
+static pthread_mutex_t SymbolicLock = PTHREAD_MUTEX_INITIALIZER;
+#define LOCKSYMBOLIC()   pthread_mutex_lock(&SymbolicLock)
+#define UNLOCKSYMBOLIC() pthread_mutex_unlock(&SymbolicLock)
+#endif
+
 #include "text.h"
 #include "types.h"
 #include "funcs.h"
@@ -39,6 +63,8 @@ extern int genmmd(int *neqns, int *xadj, int *adjncy, int *invp, int *perm,
 int  createsparse(Project *);
 void freesparse(Project *);
 int  linsolve(Smatrix *, int);
+void opensymboliccache(void);
+void closesymboliccache(void);
 
 // Local functions
 static int     allocsmatrix(Smatrix *, int, int);
@@ -47,15 +73,28 @@ static int     localadjlists(Network *, Smatrix *);
 static int     paralink(Network *, Smatrix *, int, int, int k);
 static void    xparalinks(Network *);
 static int     reordernodes(Project *);
-static int     factorize(Project *);
-static int     growlist(Project *, int);
-static int     newlink(Project *, Padjlist);
-static int     linked(Network *, int, int);
-static int     addlink(Network *, int, int, int);
-static int     storesparse(Project *, int);
+static int     symbfactor(Project *, int);
+static int     growsparse(Smatrix *, int);
 static int     sortsparse(Smatrix *, int);
 static void    transpose(int, int *, int *, int *, int *,
                          int *, int *, int *);
+static void    findsupernodes(Smatrix *, int);
+static unsigned long topologykey(Network *);
+static int     sametopology(Network *, Ssymbolic *);
+static Ssymbolic *findsymbolic(Network *);
+static Ssymbolic *newsymbolic(Network *, Smatrix *);
+static Ssymbolic *registersymbolic(Ssymbolic *);
+static void    releasesymbolic(Ssymbolic *);
+static void    freesymbolic(Ssymbolic *);
+
+// Maximum number of symbolic factorizations kept in the cache
+#define MAXSYMBOLIC 4
+
+static Ssymbolic *SymbolicCache[MAXSYMBOLIC];
+static long       SymbolicClock = 0;
+
+// Number of projects that have been created and not yet deleted
+static int        SymbolicUsers = 0;
 
 
 /*************************************************************************
@@ -85,38 +124,62 @@ int  createsparse(Project *pr)
 {
     Network *net = &pr->network;
     Smatrix *sm = &pr->hydraul.smatrix;
+    Ssymbolic *sym;
 
     int errcode = 0;
 
 //    cleartimer(SmatrixTimer);
 //    starttimer(SmatrixTimer);
 
-    // Allocate sparse matrix data structures
-    errcode = allocsmatrix(sm, net->Nnodes, net->Nlinks);
-    if (errcode) return errcode;
-
-    // Build a local version of node-link adjacency lists
-    // with parallel links removed
-    errcode = localadjlists(net, sm);
-    if (errcode) return errcode;
-
-    // Re-order nodes to minimize number of non-zero coeffs.
-    // in factorized solution matrix
-    ERRCODE(reordernodes(pr));
-
-    // Factorize solution matrix by updating adjacency lists
-    // with non-zero connections due to fill-ins
-    sm->Ncoeffs = net->Nlinks;
-    ERRCODE(factorize(pr));
-
-    // Allocate memory for sparse storage of positions of non-zero
-    // coeffs. and store these positions in vector NZSUB
-    ERRCODE(storesparse(pr, net->Njuncs));
-
-    // Free memory used for local adjacency lists and sort
-    // row indexes in NZSUB to optimize linsolve()
-    freeadjlists(net);
-    ERRCODE(sortsparse(sm, net->Njuncs));
+    // Use the symbolic factorization of a network with the
+    // same topology if one has already been made
+    sym = findsymbolic(net);
+    if (sym == NULL)
+    {
+        // Allocate sparse matrix data structures
+        errcode = allocsmatrix(sm, net->Nnodes, net->Nlinks);
+        if (errcode) return errcode;
+
+        // Build a local version of node-link adjacency lists
+        // with parallel links removed
+        errcode = localadjlists(net, sm);
+        if (errcode) return errcode;
+
+        // Re-order nodes to minimize number of non-zero coeffs.
+        // in factorized solution matrix
+        ERRCODE(reordernodes(pr));
+
+        // Symbolically factorize the solution matrix, storing the
+        // positions of the non-zero coeffs. (including fill-ins)
+        // of each column in vector NZSUB
+        ERRCODE(symbfactor(pr, net->Njuncs));
+
+        // Free memory used for local adjacency lists and sort
+        // row indexes in NZSUB to optimize linsolve()
+        freeadjlists(net);
+        ERRCODE(sortsparse(sm, net->Njuncs));
+
+        // Find groups of consecutive columns with the same
+        // non-zero pattern for the blocked numeric factorization
+        sm->Super = (int *)calloc(net->Njuncs + 2, sizeof(int));
+        ERRCODE(MEMCHECK(sm->Super));
+        if (errcode) return errcode;
+        findsupernodes(sm, net->Njuncs);
+
+        // Hand the symbolic factorization over to the cache
+        sym = newsymbolic(net, sm);
+        if (sym == NULL) return 101;
+        sym = registersymbolic(sym);
+    }
+    sm->Symbolic = sym;
+    sm->Ncoeffs = sym->Ncoeffs;
+    sm->Order = sym->Order;
+    sm->Row = sym->Row;
+    sm->Ndx = sym->Ndx;
+    sm->XLNZ = sym->XLNZ;
+    sm->NZSUB = sym->NZSUB;
+    sm->LNZ = sym->LNZ;
+    sm->Super = sym->Super;
 
     // Allocate memory used by linear eqn. solver
     ERRCODE(alloclinsolve(sm, net->Nnodes));
@@ -142,11 +205,19 @@ int  allocsmatrix(Smatrix *sm, int Nnodes, int Nlinks)
     sm->Aij   = NULL;
     sm->Aii   = NULL;
     sm->F     = NULL;
+    sm->Lij   = NULL;
     sm->temp  = NULL;
+    sm->work  = NULL;
     sm->link  = NULL;
     sm->first = NULL;
 
     // Memory for representing sparse matrix data structure
+    // (allocated in symbfactor() or shared with the cache)
+    sm->XLNZ     = NULL;
+    sm->NZSUB    = NULL;
+    sm->LNZ      = NULL;
+    sm->Super    = NULL;
+    sm->Symbolic = NULL;
     sm->Order  = (int *) calloc(Nnodes+1,  sizeof(int));
     sm->Row    = (int *) calloc(Nnodes+1,  sizeof(int));
     sm->Ndx    = (int *) calloc(Nlinks+1,  sizeof(int));
@@ -172,13 +243,17 @@ int  alloclinsolve(Smatrix *sm, int n)
     sm->Aij   = (double *)calloc(sm->Ncoeffs + 1, sizeof(double));
     sm->Aii   = (double *)calloc(n, sizeof(double));
     sm->F     = (double *)calloc(n, sizeof(double));
+    sm->Lij   = (double *)calloc(sm->Ncoeffs + 2, sizeof(double));
     sm->temp  = (double *)calloc(n, sizeof(double));
+    sm->work  = (double *)calloc(n, sizeof(double));
     sm->link  = (int *)calloc(n, sizeof(int));
     sm->first = (int *)calloc(n, sizeof(int));
     ERRCODE(MEMCHECK(sm->Aij));
     ERRCODE(MEMCHECK(sm->Aii));
     ERRCODE(MEMCHECK(sm->F));
+    ERRCODE(MEMCHECK(sm->Lij));
     ERRCODE(MEMCHECK(sm->temp));
+    ERRCODE(MEMCHECK(sm->work));
     ERRCODE(MEMCHECK(sm->link));
     ERRCODE(MEMCHECK(sm->first));
     return errcode;
@@ -201,17 +276,33 @@ void  freesparse(Project *pr)
 //    printf("\n    Processing Time = %7.3f s", gettimer(SmatrixTimer));
 //    printf("\n");
 
+    // The symbolic factorization belongs to the cache
+    if (sm->Symbolic)
+    {
+        releasesymbolic(sm->Symbolic);
+        sm->Symbolic = NULL;
+        sm->Order = NULL;
+        sm->Row = NULL;
+        sm->Ndx = NULL;
+        sm->XLNZ = NULL;
+        sm->NZSUB = NULL;
+        sm->LNZ = NULL;
+        sm->Super = NULL;
+    }
     FREE(sm->Order);
     FREE(sm->Row);
     FREE(sm->Ndx);
     FREE(sm->XLNZ);
     FREE(sm->NZSUB);
     FREE(sm->LNZ);
+    FREE(sm->Super);
 
     FREE(sm->Aij);
     FREE(sm->Aii);
     FREE(sm->F);
+    FREE(sm->Lij);
     FREE(sm->temp);
+    FREE(sm->work);
     FREE(sm->link);
     FREE(sm->first);
 }
@@ -424,226 +515,139 @@ int   reordernodes(Project *pr)
     return errcode;
 }
 
-
-int factorize(Project *pr)
+int  symbfactor(Project *pr, int n)
 /*
 **--------------------------------------------------------------
-** Input:   none
+** Input:   n = number of rows in solution matrix
 ** Output:  returns error code
-** Purpose: symbolically factorizes the solution matrix in
-**          terms of its adjacency lists
+** Purpose: symbolically factorizes the solution matrix by
+**          storing the row indexes of the non-zeros of each
+**          column of the lower triangular portion of the
+**          factorized matrix, including fill-ins
+**
+** NOTE:   The non-zeros of column i are those of the original
+**         matrix plus those of each column whose first
+**         non-zero is in row i (its children in the elimination
+**         tree). Each column is merged into exactly one other
+**         column, so the work is proportional to the number of
+**         non-zeros in the factorized matrix (see A. George and
+**         J. W-H Liu, "Computer Solution of Large Sparse Positive
+**         Definite Systems", Prentice-Hall, 1981).
 **--------------------------------------------------------------
 */
 {
-    Network *net = &pr->network;
-    Smatrix *sm = &pr->hydraul.smatrix;
+    Network  *net = &pr->network;
+    Smatrix  *sm = &pr->hydraul.smatrix;
 
-    int k, knode;
+    int i, ii, j, k, kk, c, parent, size;
     int errcode = 0;
+    int *marker, *head, *next;
     Padjlist alink;
 
-    // Find degree of each junction node
-    sm->Degree = (int *)calloc(net->Nnodes + 1, sizeof(int));
-    if (sm->Degree == NULL) return 101;
+    // Allocate sparse matrix storage, which grows as fill-ins are found
+    size = net->Nlinks + n + 2;
+    sm->XLNZ  = (int *) calloc(n+2, sizeof(int));
+    sm->NZSUB = (int *) calloc(size, sizeof(int));
+    sm->LNZ   = (int *) calloc(size, sizeof(int));
+    ERRCODE(MEMCHECK(sm->XLNZ));
+    ERRCODE(MEMCHECK(sm->NZSUB));
+    ERRCODE(MEMCHECK(sm->LNZ));
 
-    // NOTE: For purposes of node re-ordering, Tanks (nodes with
-    //       indexes above Njuncs) have zero degree of adjacency.
+    // Work arrays: marker flags the rows already in a column,
+    // head and next hold the children of each column
+    marker = (int *) calloc(n+1, sizeof(int));
+    head   = (int *) calloc(n+1, sizeof(int));
+    next   = (int *) calloc(n+1, sizeof(int));
+    ERRCODE(MEMCHECK(marker));
+    ERRCODE(MEMCHECK(head));
+    ERRCODE(MEMCHECK(next));
 
-    for (k = 1; k <= net->Njuncs; k++)
-    {
-        for (alink = net->Adjlist[k]; alink != NULL; alink = alink->next)
-        {
-            if (alink->node > 0) sm->Degree[k]++;
-        }
-    }
+    // Fill-ins are given positions in Aij after those of the links
+    sm->Ncoeffs = net->Nlinks;
 
-    // Augment each junction's adjacency list to account for
-    // new connections created when solution matrix is solved.
-    // NOTE: Only junctions (indexes <= Njuncs) appear in solution matrix.
-    for (k = 1; k <= net->Njuncs; k++)          // Examine each junction
+    k = 1;
+    if (!errcode) sm->XLNZ[1] = 1;
+    for (i = 1; i <= n && !errcode; i++)   // column
     {
-        knode = sm->Order[k];                   // Re-ordered index
-        if (!growlist(pr, knode))               // Augment adjacency list
-        {
-            errcode = 101;
-            break;
-        }
-        sm->Degree[knode] = 0;                  // In-activate node
-    }
-    free(sm->Degree);
-    return errcode;
-}
-
+        marker[i] = i;
 
-int  growlist(Project *pr, int knode)
-/*
-**--------------------------------------------------------------
-** Input:   knode = node index
-** Output:  returns 1 if successful, 0 if not
-** Purpose: creates new entries in knode's adjacency list for
-**          all unlinked pairs of active nodes that are
-**          adjacent to knode
-**--------------------------------------------------------------
-*/
-{
-    Network *net = &pr->network;
-    Smatrix *sm = &pr->hydraul.smatrix;
-
-    int node;
-    Padjlist alink;
-
-    // Iterate through all nodes connected to knode
-    for (alink = net->Adjlist[knode]; alink != NULL; alink = alink -> next)
-    {
-        node = alink->node;                   // End node of connecting link
-        if (node > 0 && sm->Degree[node] > 0) // End node is active
+        // Non-zeros of the original matrix
+        ii = sm->Order[i];
+        for (alink = net->Adjlist[ii]; alink != NULL; alink = alink->next)
         {
-            sm->Degree[node]--;           // Reduce degree of adjacency
-            if (!newlink(pr, alink))      // Add to adjacency list
+            if (alink->node == 0) continue;
+            j = sm->Row[alink->node];      // row
+            if (j > i && j <= n && marker[j] != i)
             {
-                return 0;
+                if (k >= size && (size = growsparse(sm, size)) == 0) break;
+                marker[j] = i;
+                sm->NZSUB[k] = j;
+                sm->LNZ[k] = alink->link;
+                k++;
             }
         }
-  }
-  return 1;
-}
-
 
-int  newlink(Project *pr, Padjlist alink)
-/*
-**--------------------------------------------------------------
-** Input:   alink = element of node's adjacency list
-** Output:  returns 1 if successful, 0 if not
-** Purpose: links end of current adjacent link to end nodes of
-**          all links that follow it on adjacency list
-**--------------------------------------------------------------
-*/
-{
-    Network *net = &pr->network;
-    Smatrix *sm = &pr->hydraul.smatrix;
-
-    int inode, jnode;
-    Padjlist blink;
-
-    // Scan all entries in adjacency list that follow anode.
-    inode = alink->node;             // End node of connection to anode
-    for (blink = alink->next; blink != NULL; blink = blink->next)
-    {
-        jnode = blink->node;          // End node of next connection
-
-        // If jnode still active, and inode not connected to jnode,
-        // then add a new connection between inode and jnode.
-        if (jnode > 0 && sm->Degree[jnode] > 0)  // jnode still active
+        // Fill-ins from the columns that are children of column i
+        for (c = head[i]; c != 0 && size > 0; c = next[c])
         {
-            if (!linked(net, inode, jnode))      // inode not linked to jnode
+            for (kk = sm->XLNZ[c]; kk < sm->XLNZ[c+1]; kk++)
             {
-                // Since new connection represents a non-zero coeff.
-                // in the solution matrix, update the coeff. count.
+                j = sm->NZSUB[kk];
+                if (marker[j] == i) continue;
+                if (k >= size && (size = growsparse(sm, size)) == 0) break;
+                marker[j] = i;
                 sm->Ncoeffs++;
-
-                // Update adjacency lists for inode & jnode to
-                // reflect the new connection.
-                if (!addlink(net, inode, jnode, sm->Ncoeffs)) return 0;
-                if (!addlink(net, jnode, inode, sm->Ncoeffs)) return 0;
-                sm->Degree[inode]++;
-                sm->Degree[jnode]++;
+                sm->NZSUB[k] = j;
+                sm->LNZ[k] = sm->Ncoeffs;
+                k++;
             }
         }
-    }
-    return 1;
-}
-
+        if (size == 0)
+        {
+            errcode = 101;
+            break;
+        }
+        sm->XLNZ[i+1] = k;
 
-int  linked(Network *net, int i, int j)
-/*
-**--------------------------------------------------------------
-** Input:   i = node index
-**          j = node index
-** Output:  returns 1 if nodes i and j are linked, 0 if not
-** Purpose: checks if nodes i and j are already linked.
-**--------------------------------------------------------------
-*/
-{
-    Padjlist alink;
-    for (alink = net->Adjlist[i]; alink != NULL; alink = alink->next)
-    {
-        if (alink->node == j) return 1;
+        // The parent of column i is its first non-zero row
+        if (k > sm->XLNZ[i])
+        {
+            parent = n + 1;
+            for (kk = sm->XLNZ[i]; kk < k; kk++)
+            {
+                if (sm->NZSUB[kk] < parent) parent = sm->NZSUB[kk];
+            }
+            next[i] = head[parent];
+            head[parent] = i;
+        }
     }
-    return 0;
-}
 
-
-int  addlink(Network *net, int i, int j, int n)
-/*
-**--------------------------------------------------------------
-** Input:   i = node index
-**          j = node index
-**          n = link index
-** Output:  returns 1 if successful, 0 if not
-** Purpose: augments node i's adjacency list with node j
-**--------------------------------------------------------------
-*/
-{
-    Padjlist alink;
-    alink = (struct Sadjlist *) malloc(sizeof(struct Sadjlist));
-    if (alink == NULL) return 0;
-    alink->node = j;
-    alink->link = n;
-    alink->next = net->Adjlist[i];
-    net->Adjlist[i] = alink;
-    return 1;
+    // Reclaim memory
+    FREE(marker);
+    FREE(head);
+    FREE(next);
+    return errcode;
 }
 
 
-int  storesparse(Project *pr, int n)
+int  growsparse(Smatrix *sm, int size)
 /*
 **--------------------------------------------------------------
-** Input:   n = number of rows in solution matrix
-** Output:  returns error code
-** Purpose: stores row indexes of non-zeros of each column of
-**          lower triangular portion of factorized matrix
+** Input:   size = current size of the NZSUB and LNZ arrays
+** Output:  returns the new size, or 0 if out of memory
+** Purpose: doubles the storage for non-zero coeffs.
 **--------------------------------------------------------------
 */
 {
-    Network  *net = &pr->network;
-    Smatrix  *sm = &pr->hydraul.smatrix;
-
-    int i, ii, j, k, l, m;
-    int errcode = 0;
-    Padjlist alink;
-
-    // Allocate sparse matrix storage
-    sm->XLNZ  = (int *) calloc(n+2, sizeof(int));
-    sm->NZSUB = (int *) calloc(sm->Ncoeffs+2, sizeof(int));
-    sm->LNZ   = (int *) calloc(sm->Ncoeffs+2, sizeof(int));
-    ERRCODE(MEMCHECK(sm->XLNZ));
-    ERRCODE(MEMCHECK(sm->NZSUB));
-    ERRCODE(MEMCHECK(sm->LNZ));
-    if (errcode) return errcode;
-
-    // Generate row index pointers for each column of matrix
-    k = 0;
-    sm->XLNZ[1] = 1;
-    for (i = 1; i <= n; i++)            // column
-    {
-        m = 0;
-        ii = sm->Order[i];
-        for (alink = net->Adjlist[ii]; alink != NULL; alink = alink->next)
-        {
-            if (alink->node == 0) continue;
-            j = sm->Row[alink->node];    // row
-            l = alink->link;
-            if (j > i && j <= n)
-            {
-                m++;
-                k++;
-                sm->NZSUB[k] = j;
-                sm->LNZ[k] = l;
-            }
-        }
-        sm->XLNZ[i+1] = sm->XLNZ[i] + m;
-    }
-    return errcode;
+    int *nzsub, *lnz;
+
+    nzsub = (int *) realloc(sm->NZSUB, 2 * size * sizeof(int));
+    if (nzsub == NULL) return 0;
+    sm->NZSUB = nzsub;
+    lnz = (int *) realloc(sm->LNZ, 2 * size * sizeof(int));
+    if (lnz == NULL) return 0;
+    sm->LNZ = lnz;
+    return 2 * size;
 }
 
 
@@ -725,6 +729,321 @@ void  transpose(int n, int *il, int *jl, int *xl, int *ilt, int *jlt,
     }
 }
 
+void  findsupernodes(Smatrix *sm, int n)
+/*
+**--------------------------------------------------------------
+** Input:   n = number of rows in solution matrix
+** Output:  none
+** Purpose: finds the first column of the supernode that each
+**          column of the factorized matrix belongs to
+**
+** NOTE:   Column j joins the supernode of column j-1 when the
+**         first non-zero of column j-1 is in row j and column
+**         j has the remaining non-zeros of column j-1. The
+**         columns of a supernode then share all of their rows
+**         below the supernode, stored at the end of each column.
+**--------------------------------------------------------------
+*/
+{
+    int j;
+    int *XLNZ = sm->XLNZ;
+    int *NZSUB = sm->NZSUB;
+
+    if (n > 0) sm->Super[1] = 1;
+    for (j = 2; j <= n; j++)
+    {
+        if (XLNZ[j] > XLNZ[j-1] && NZSUB[XLNZ[j-1]] == j &&
+            XLNZ[j] - XLNZ[j-1] == XLNZ[j+1] - XLNZ[j] + 1)
+        {
+            sm->Super[j] = sm->Super[j-1];
+        }
+        else sm->Super[j] = j;
+    }
+}
+
+
+unsigned long  topologykey(Network *net)
+/*
+**--------------------------------------------------------------
+** Input:   none
+** Output:  returns hash of network topology
+** Purpose: computes a key for looking up a network's symbolic
+**          factorization in the cache
+**--------------------------------------------------------------
+*/
+{
+    int k;
+    unsigned long key = 2166136261UL;
+
+    key = (key ^ (unsigned long)net->Nnodes) * 16777619UL;
+    key = (key ^ (unsigned long)net->Njuncs) * 16777619UL;
+    key = (key ^ (unsigned long)net->Nlinks) * 16777619UL;
+    for (k = 1; k <= net->Nlinks; k++)
+    {
+        key = (key ^ (unsigned long)net->Link[k].N1) * 16777619UL;
+        key = (key ^ (unsigned long)net->Link[k].N2) * 16777619UL;
+    }
+    return key;
+}
+
+
+int  sametopology(Network *net, Ssymbolic *sym)
+/*
+**--------------------------------------------------------------
+** Input:   sym = symbolic factorization
+** Output:  returns 1 if sym was made for the network's topology
+** Purpose: compares a network with a cached factorization
+**--------------------------------------------------------------
+*/
+{
+    int k;
+
+    if (sym->Nnodes != net->Nnodes || sym->Njuncs != net->Njuncs ||
+        sym->Nlinks != net->Nlinks) return 0;
+    for (k = 1; k <= net->Nlinks; k++)
+    {
+        if (sym->N1[k] != net->Link[k].N1 ||
+            sym->N2[k] != net->Link[k].N2) return 0;
+    }
+    return 1;
+}
+
+
+Ssymbolic  *findsymbolic(Network *net)
+/*
+**--------------------------------------------------------------
+** Input:   none
+** Output:  returns a cached symbolic factorization or NULL
+** Purpose: looks up the symbolic factorization of a network
+**          with the same topology and adds a reference to it
+**--------------------------------------------------------------
+*/
+{
+    int i;
+    unsigned long key = topologykey(net);
+    Ssymbolic *sym = NULL;
+
+    LOCKSYMBOLIC();
+    for (i = 0; i < MAXSYMBOLIC; i++)
+    {
+        if (SymbolicCache[i] && SymbolicCache[i]->Key == key &&
+            sametopology(net, SymbolicCache[i]))
+        {
+            sym = SymbolicCache[i];
+            sym->Refcount++;
+            sym->Lastused = ++SymbolicClock;
+            break;
+        }
+    }
+    UNLOCKSYMBOLIC();
+    return sym;
+}
+
+
+Ssymbolic  *newsymbolic(Network *net, Smatrix *sm)
+/*
+**--------------------------------------------------------------
+** Input:   sm = sparse matrix with a symbolic factorization
+** Output:  returns the symbolic factorization or NULL
+** Purpose: moves the symbolic factorization out of a sparse
+**          matrix so that it can be shared
+**--------------------------------------------------------------
+*/
+{
+    int k;
+    Ssymbolic *sym;
+
+    sym = (Ssymbolic *) calloc(1, sizeof(Ssymbolic));
+    if (sym == NULL) return NULL;
+    sym->N1 = (int *) calloc(net->Nlinks+1, sizeof(int));
+    sym->N2 = (int *) calloc(net->Nlinks+1, sizeof(int));
+    if (sym->N1 == NULL || sym->N2 == NULL)
+    {
+        freesymbolic(sym);
+        return NULL;
+    }
+
+    // Topology of the network
+    sym->Key = topologykey(net);
+    sym->Nnodes = net->Nnodes;
+    sym->Njuncs = net->Njuncs;
+    sym->Nlinks = net->Nlinks;
+    for (k = 1; k <= net->Nlinks; k++)
+    {
+        sym->N1[k] = net->Link[k].N1;
+        sym->N2[k] = net->Link[k].N2;
+    }
+
+    // Symbolic factorization
+    sym->Ncoeffs = sm->Ncoeffs;
+    sym->Order = sm->Order;
+    sym->Row = sm->Row;
+    sym->Ndx = sm->Ndx;
+    sym->XLNZ = sm->XLNZ;
+    sym->NZSUB = sm->NZSUB;
+    sym->LNZ = sm->LNZ;
+    sym->Super = sm->Super;
+    sm->Order = NULL;
+    sm->Row = NULL;
+    sm->Ndx = NULL;
+    sm->XLNZ = NULL;
+    sm->NZSUB = NULL;
+    sm->LNZ = NULL;
+    sm->Super = NULL;
+    return sym;
+}
+
+
+Ssymbolic  *registersymbolic(Ssymbolic *sym)
+/*
+**--------------------------------------------------------------
+** Input:   sym = new symbolic factorization
+** Output:  returns the symbolic factorization to use
+** Purpose: adds a new symbolic factorization to the cache,
+**          replacing the least recently used one not in use
+**--------------------------------------------------------------
+*/
+{
+    int i, slot = -1;
+    Ssymbolic *old;
+
+    LOCKSYMBOLIC();
+
+    // Another project may have cached the same topology meanwhile
+    for (i = 0; i < MAXSYMBOLIC; i++)
+    {
+        old = SymbolicCache[i];
+        if (old && old->Key == sym->Key && old->Nnodes == sym->Nnodes &&
+            old->Njuncs == sym->Njuncs && old->Nlinks == sym->Nlinks &&
+            memcmp(old->N1, sym->N1, (sym->Nlinks+1)*sizeof(int)) == 0 &&
+            memcmp(old->N2, sym->N2, (sym->Nlinks+1)*sizeof(int)) == 0)
+        {
+            old->Refcount++;
+            old->Lastused = ++SymbolicClock;
+            UNLOCKSYMBOLIC();
+            freesymbolic(sym);
+            return old;
+        }
+    }
+
+    // Find an empty slot or the least recently used unreferenced entry
+    for (i = 0; i < MAXSYMBOLIC; i++)
+    {
+        old = SymbolicCache[i];
+        if (old == NULL)
+        {
+            slot = i;
+            break;
+        }
+        if (old->Refcount == 0 &&
+            (slot < 0 || old->Lastused < SymbolicCache[slot]->Lastused)) slot = i;
+    }
+
+    sym->Refcount = 1;
+    sym->Lastused = ++SymbolicClock;
+    if (slot >= 0)
+    {
+        old = SymbolicCache[slot];
+        if (old) freesymbolic(old);
+        SymbolicCache[slot] = sym;
+        sym->Cached = 1;
+    }
+    UNLOCKSYMBOLIC();
+    return sym;
+}
+
+
+void  releasesymbolic(Ssymbolic *sym)
+/*
+**--------------------------------------------------------------
+** Input:   sym = symbolic factorization
+** Output:  none
+** Purpose: removes a project's reference to a symbolic
+**          factorization, freeing it if it is not cached
+**--------------------------------------------------------------
+*/
+{
+    int unused;
+
+    LOCKSYMBOLIC();
+    sym->Refcount--;
+    unused = (sym->Refcount == 0 && !sym->Cached);
+    UNLOCKSYMBOLIC();
+    if (unused) freesymbolic(sym);
+}
+
+
+void  opensymboliccache(void)
+/*
+**--------------------------------------------------------------
+** Input:   none
+** Output:  none
+** Purpose: registers a new project as a user of the symbolic
+**          factorization cache
+**--------------------------------------------------------------
+*/
+{
+    LOCKSYMBOLIC();
+    SymbolicUsers++;
+    UNLOCKSYMBOLIC();
+}
+
+
+void  closesymboliccache(void)
+/*
+**--------------------------------------------------------------
+** Input:   none
+** Output:  none
+** Purpose: removes a deleted project from the users of the
+**          symbolic factorization cache, emptying the cache
+**          when no project is left
+**--------------------------------------------------------------
+*/
+{
+    int i;
+    Ssymbolic *unused[MAXSYMBOLIC];
+    int nunused = 0;
+
+    LOCKSYMBOLIC();
+    if (SymbolicUsers > 0) SymbolicUsers--;
+    if (SymbolicUsers == 0)
+    {
+        for (i = 0; i < MAXSYMBOLIC; i++)
+        {
+            if (SymbolicCache[i] == NULL) continue;
+
+            // A factorization still in use is freed by its last release
+            if (SymbolicCache[i]->Refcount == 0) unused[nunused++] = SymbolicCache[i];
+            else SymbolicCache[i]->Cached = 0;
+            SymbolicCache[i] = NULL;
+        }
+    }
+    UNLOCKSYMBOLIC();
+    for (i = 0; i < nunused; i++) freesymbolic(unused[i]);
+}
+
+
+void  freesymbolic(Ssymbolic *sym)
+/*
+**--------------------------------------------------------------
+** Input:   sym = symbolic factorization
+** Output:  none
+** Purpose: frees memory used by a symbolic factorization
+**--------------------------------------------------------------
+*/
+{
+    FREE(sym->N1);
+    FREE(sym->N2);
+    FREE(sym->Order);
+    FREE(sym->Row);
+    FREE(sym->Ndx);
+    FREE(sym->XLNZ);
+    FREE(sym->NZSUB);
+    FREE(sym->LNZ);
+    FREE(sym->Super);
+    free(sym);
+}
+
 
 int  linsolve(Smatrix *sm, int n)
 /*
@@ -744,67 +1063,116 @@ int  linsolve(Smatrix *sm, int n)
 **            XLNZ  (start position of each column in NZSUB)
 **            NZSUB (row index of each non-zero in each column)
 **            LNZ   (position of each NZSUB entry in Aij array)
+**            Super (first column of each column's supernode)
 **
 **  This procedure has been adapted from subroutines GSFCT and
 **  GSSLV in the book "Computer Solution of Large Sparse
 **  Positive Definite Systems" by A. George and J. W-H Liu
-**  (Prentice-Hall, 1981).
+**  (Prentice-Hall, 1981). The factorization works on whole
+**  supernodes (see findsupernodes()) so that the modifications
+**  by their columns are made with dense, contiguous loops.
 **--------------------------------------------------------------
 */
 {
     double *Aii  = sm->Aii;
     double *Aij  = sm->Aij;
+    double *Lij  = sm->Lij;
     double *B    = sm->F;
     double *temp = sm->temp;
+    double *work = sm->work;
     int *LNZ     = sm->LNZ;
     int *XLNZ    = sm->XLNZ;
     int *NZSUB   = sm->NZSUB;
+    int *Super   = sm->Super;
     int *link    = sm->link;
     int *first   = sm->first;
 
-    int    i, istop, istrt, isub, j, k, kfirst, newk;
+    int    i, istop, istrt, isub, j, k, kfirst, klast, m, newk, tail;
     double bj, diagj, ljk;
+    double *lj;
+    const double *lk;
 
     memset(temp,  0, (n + 1) * sizeof(double));
+    memset(work,  0, (n + 1) * sizeof(double));
     memset(link,  0, (n + 1) * sizeof(int));
     memset(first, 0, (n + 1) * sizeof(int));
 
+   // Gather the off-diagonal coeffs. into the column storage
+   // of the factorized matrix
+   istop = XLNZ[n+1] - 1;
+   for (i = 1; i <= istop; i++) Lij[i] = Aij[LNZ[i]];
+
    // Begin numerical factorization of matrix A into L
    //   Compute column L(*,j) for j = 1,...n
    for (j = 1; j <= n; j++)
    {
-      // For each column L(*,k) that affects L(*,j):
       diagj = 0.0;
-      newk = link[j];
-      k = newk;
-      while (k != 0)
+      istrt = XLNZ[j];
+      istop = XLNZ[j+1] - 1;
+      m = istop - istrt + 1;
+      lj = &Lij[istrt];
+
+      // Modification of L(*,j) by the preceding columns L(*,k) of
+      // its own supernode, which have the same rows below row j
+      for (k = Super[j]; k < j; k++)
       {
-         // Outer product modification of L(*,j) by
-         // L(*,k) starting at first[k] of L(*,k)
-         newk = link[k];
-         kfirst = first[k];
-         ljk = Aij[LNZ[kfirst]];
+         kfirst = XLNZ[k] + j - k - 1;     // Position of row j
+         ljk = Lij[kfirst];
          diagj += ljk*ljk;
-         istrt = kfirst + 1;
-         istop = XLNZ[k+1] - 1;
-         if (istop >= istrt)
-         {
-
-	     // Before modification, update vectors 'first'
-	     // and 'link' for future modification steps
-            first[k] = istrt;
-            isub = NZSUB[istrt];
-            link[k] = link[isub];
-            link[isub] = k;
+         lk = &Lij[kfirst + 1];
+         for (i = 0; i < m; i++) lj[i] -= lk[i]*ljk;
+      }
 
-	    // The actual mod is saved in vector 'temp'
-            for (i = istrt; i <= istop; i++)
+      // For each supernode, identified by its last column klast,
+      // that affects L(*,j):
+      newk = link[j];
+      while (newk != 0)
+      {
+         // Outer product modification of L(*,j) by the
+         // supernode starting at first[klast] of L(*,klast)
+         klast = newk;
+         newk = link[klast];
+         kfirst = first[klast];
+         tail = XLNZ[klast+1] - kfirst;   // Rows from row j down
+         if (Super[klast] == klast)
+         {
+            ljk = Lij[kfirst];
+            diagj += ljk*ljk;
+            for (i = kfirst + 1; i < XLNZ[klast+1]; i++)
             {
                isub = NZSUB[i];
-               temp[isub] += Aij[LNZ[i]]*ljk;
+               temp[isub] += Lij[i]*ljk;
             }
          }
-         k = newk;
+         else
+         {
+            // Sum the modifications by all of the supernode's
+            // columns densely before scattering them to 'temp'
+            for (k = Super[klast]; k <= klast; k++)
+            {
+               i = XLNZ[k+1] - tail;           // Position of row j
+               ljk = Lij[i];
+               diagj += ljk*ljk;
+               lk = &Lij[i + 1];
+               for (i = 0; i < tail - 1; i++) work[i] += lk[i]*ljk;
+            }
+            for (i = 0; i < tail - 1; i++)
+            {
+               isub = NZSUB[kfirst + 1 + i];
+               temp[isub] += work[i];
+               work[i] = 0.0;
+            }
+         }
+
+         // Update vectors 'first' and 'link' for the
+         // supernode's next modification step
+         if (tail > 1)
+         {
+            first[klast] = kfirst + 1;
+            isub = NZSUB[kfirst + 1];
+            link[klast] = link[isub];
+            link[isub] = klast;
+         }
       }
 
       // Apply the modifications accumulated
@@ -816,21 +1184,21 @@ int  linsolve(Smatrix *sm, int n)
       }
       diagj = sqrt(diagj);
       Aii[j] = diagj;
-      istrt = XLNZ[j];
-      istop = XLNZ[j+1] - 1;
-      if (istop >= istrt)
+      for (i = istrt; i <= istop; i++)
+      {
+         isub = NZSUB[i];
+         Lij[i] = (Lij[i] - temp[isub])/diagj;
+         temp[isub] = 0.0;
+      }
+
+      // Once the last column of a supernode is done, the
+      // supernode can modify the columns below it
+      if (m > 0 && (j == n || Super[j+1] != Super[j]))
       {
          first[j] = istrt;
          isub = NZSUB[istrt];
          link[j] = link[isub];
          link[isub] = j;
-         for (i = istrt; i <= istop; i++)
-         {
-            isub = NZSUB[i];
-            bj = (Aij[LNZ[i]] - temp[isub])/diagj;
-            Aij[LNZ[i]] = bj;
-            temp[isub] = 0.0;
-         }
       }
    }      // next j
 
@@ -846,7 +1214,7 @@ int  linsolve(Smatrix *sm, int n)
          for (i = istrt; i <= istop; i++)
          {
             isub = NZSUB[i];
-            B[isub] -= Aij[LNZ[i]]*bj;
+            B[isub] -= Lij[i]*bj;
          }
       }
    }
@@ -862,7 +1230,7 @@ int  linsolve(Smatrix *sm, int n)
          for (i = istrt; i <= istop; i++)
          {
             isub = NZSUB[i];
-            bj -= Aij[LNZ[i]]*B[isub];
+            bj -= Lij[i]*B[isub];
          }
       }
       B[j] = bj/Aii[j];
@@ -671,6 +671,35 @@ typedef struct {
 
 } Rules;
 
+// Symbolic Factorization of a Sparse Matrix
+// (shared by all projects whose networks have the same topology)
+typedef struct Ssymbolic {
+
+  int
+    Refcount,    // Number of projects using the factorization
+    Cached,      // 1 if held in the symbolic factorization cache
+    Nnodes,      // Number of nodes of the network
+    Njuncs,      // Number of junctions of the network
+    Nlinks,      // Number of links of the network
+    Ncoeffs,     // Number of non-zero matrix coeffs
+    *N1,         // Start node of each link
+    *N2,         // End node of each link
+    *Order,      // Node-to-row of re-ordered matrix
+    *Row,        // Row-to-node of re-ordered matrix
+    *Ndx,        // Index of link's coeff. in Aij
+    *XLNZ,       // Start position of each column in NZSUB
+    *NZSUB,      // Row index of each coeff. in each column
+    *LNZ,        // Position of each coeff. in Aij array
+    *Super;      // First column of the supernode of each column
+
+  unsigned long
+    Key;         // Hash of the network topology
+
+  long
+    Lastused;    // Time stamp of last use, for cache eviction
+
+} Ssymbolic;
+
 // Sparse Matrix Wrapper
 typedef struct {
 
@@ -678,7 +707,9 @@ typedef struct {
     *Aii,        // Diagonal matrix coeffs.
     *Aij,        // Non-zero, off-diagonal matrix coeffs.
     *F,          // Right hand side vector
-    *temp;       // Array used by linear eqn. solver
+    *Lij,        // Off-diagonal coeffs. of factorized matrix
+    *temp,       // Array used by linear eqn. solver
+    *work;       // Array used by linear eqn. solver
 
   int
     Ncoeffs,     // Number of non-zero matrix coeffs
@@ -688,10 +719,13 @@ typedef struct {
     *XLNZ,       // Start position of each column in NZSUB
     *NZSUB,      // Row index of each coeff. in each column
     *LNZ,        // Position of each coeff. in Aij array
-    *Degree,     // Number of links adjacent to each node
+    *Super,      // First column of the supernode of each column
     *link,       // Array used by linear eqn. solver
     *first;      // Array used by linear eqn. solver
 
+  Ssymbolic
+    *Symbolic;   // Shared symbolic factorization
+
 } Smatrix;
 
 // Hydraulics Solver Wrapper
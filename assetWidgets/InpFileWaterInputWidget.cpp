@@ -41,10 +41,15 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 #include "GISAssetInputWidget.h"
 #include "MultiComponentR2D.h"
 
+#include "EPANET2.2/geoJSON.h"
+
 #include <qgslinesymbol.h>
 #include <qgsmarkersymbol.h>
 #include <qgsjsonutils.h>
 
+#include <cpl_conv.h>
+#include <cpl_vsi.h>
+
 #include <QLineEdit>
 #include <QLabel>
 #include <QPushButton>
@@ -56,9 +61,10 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 #include <QApplication>
 #include <QStandardPaths>
 #include <QJsonObject>
-#include <QTemporaryFile>
 #include <QJsonDocument>
 
+#include <cstring>
+
 InpFileWaterInputWidget::InpFileWaterInputWidget(QWidget *parent, VisualizationWidget* visWidget, QString componentType, QString appType) : SimCenterAppWidget(parent), componentType(componentType), appType(appType)
 {
     theVisualizationWidget = static_cast<QGISVisualizationWidget*>(visWidget);
@@ -107,7 +113,16 @@ InpFileWaterInputWidget::InpFileWaterInputWidget(QWidget *parent, VisualizationW
 
 InpFileWaterInputWidget::~InpFileWaterInputWidget()
 {
+    this->removeMemLayerFiles();
+}
+
 
+void InpFileWaterInputWidget::removeMemLayerFiles(void)
+{
+    for (auto&& it : memLayerFiles)
+        VSIUnlink(it.toUtf8().constData());
+
+    memLayerFiles.clear();
 }
 
 /**
@@ -413,6 +428,7 @@ void InpFileWaterInputWidget::clear()
     theAssetInputWidgetList.clear();
     theAssetLayerList.clear();
     mainAssetWidget->removeAllComponents();
+    this->removeMemLayerFiles();
     inpFileLineEdit->clear();
     for(auto field : FieldNameToLineEdit.keys())
     {
@@ -447,7 +463,76 @@ void InpFileWaterInputWidget::chooseAssetFileDialog(void)
     return;
 }
 
-extern "C" int createJSON(const char *, const char *, const char *, const char *);
+namespace {
+
+// Receives the nodes and links of the network straight from EPANET and builds the GeoJSON features of each asset type from them
+// The records are also passed on to the GeoJSON file writer, so the file that is used in the analysis is written without being parsed again here
+struct AssetLayerSink
+{
+    JSONSink jsonSink;
+    NetworkSink jsonWriter;
+
+    QMap<QString, QJsonArray> featuresByType;
+
+    static int begin(void *context, int numNodes, int numLinks)
+    {
+        auto sink = static_cast<AssetLayerSink*>(context);
+        return sink->jsonWriter.begin(sink->jsonWriter.context, numNodes, numLinks);
+    }
+
+    static int record(void *context, const NetworkRecord *record)
+    {
+        auto sink = static_cast<AssetLayerSink*>(context);
+
+        QJsonObject geometry;
+        if (record->numPoints == 1)
+        {
+            geometry["type"] = "Point";
+            geometry["coordinates"] = QJsonArray({record->x[0], record->y[0]});
+        }
+        else
+        {
+            geometry["type"] = "LineString";
+            geometry["coordinates"] = QJsonArray({QJsonArray({record->x[0], record->y[0]}), QJsonArray({record->x[1], record->y[1]})});
+        }
+
+        QString assetType = QString::fromUtf8(record->type);
+
+        QJsonObject properties;
+        properties["type"] = assetType;
+        properties["InpID"] = QString::fromUtf8(record->id);
+
+        for (int i = 0; i < record->numAttributes; ++i)
+        {
+            const NetworkAttribute& attribute = record->attributes[i];
+
+            if (attribute.type == NETWORK_DOUBLE)
+                properties[attribute.name] = attribute.number;
+            else if (attribute.type == NETWORK_INT)
+                properties[attribute.name] = static_cast<int>(attribute.number);
+            else
+                properties[attribute.name] = QString::fromUtf8(attribute.string);
+        }
+
+        QJsonObject feature;
+        feature["type"] = "Feature";
+        feature["geometry"] = geometry;
+        feature["id"] = QString::number(record->index);
+        feature["properties"] = properties;
+
+        sink->featuresByType[assetType].append(feature);
+
+        return sink->jsonWriter.record(sink->jsonWriter.context, record);
+    }
+
+    static int end(void *context)
+    {
+        auto sink = static_cast<AssetLayerSink*>(context);
+        return sink->jsonWriter.end(sink->jsonWriter.context);
+    }
+};
+
+}
 
 bool InpFileWaterInputWidget::loadAssetData()
 {
@@ -467,106 +552,84 @@ bool InpFileWaterInputWidget::loadAssetData()
     geoJsonFileName = writableDir.filePath("sc_inpFileGeoJSON.json");
     QString tmp1 = writableDir.filePath("SimCenter.thing1");
     QString tmp2 = writableDir.filePath("SimCenter.thing2");
-       
-    createJSON(pathInpFileWater.toStdString().c_str(),
-	       tmp1.toStdString().c_str(),
-	       tmp2.toStdString().c_str(),
-	       geoJsonFileName.toStdString().c_str());
-	
-    QFile jsonFile(geoJsonFileName);
-    // back to Stevan    
-
-    QMap<QString, QList<QJsonObject>> assetDictionary;
 
-    QJsonObject crs;
-    if (jsonFile.exists() && jsonFile.open(QFile::ReadOnly)) {
-      
-      QJsonDocument exDoc = QJsonDocument::fromJson(jsonFile.readAll());
-      QJsonObject jsonObject = exDoc.object();
-      
-      //if(jsonObject.contains("crs"))
-        //crs = jsonObject["crs"].toObject();
-      //QString crsString = crs["properties"].toObject()["name"].toString();
-      //QgsCoordinateReferenceSystem qgsCRS = QgsCoordinateReferenceSystem(inputCRS);
-      QgsCoordinateReferenceSystem qgsCRS = QgsCoordinateReferenceSystem(defaultCRS);
-
-      if (!qgsCRS.isValid()){
-	        qgsCRS.createFromOgcWmsCrs(defaultCRS);
-       }
-        
-      if (!qgsCRS.isValid()){
-	        QString msg = "Default CRS is not valid. Choose an existing CRS.";
-	        //QString msg = "The CRS: " + crsString + " defined in " + geoJsonFileName + " is invalid and ignored.";
-	        errorMessage(msg);
-        }
+    // The features are built directly from the records that EPANET streams out, while the same records are written to the GeoJSON file
+    AssetLayerSink assetSink;
+    if (openJSONSink(&assetSink.jsonSink, &assetSink.jsonWriter, geoJsonFileName.toStdString().c_str()) != 0)
+    {
+        this->errorMessage("Failed to open file at location: "+ geoJsonFileName);
+        return false;
+    }
 
-        crsSelectorWidget->setCRS(qgsCRS);
-        QJsonArray features = jsonObject["features"].toArray();
+    NetworkSink sink;
+    sink.context = &assetSink;
+    sink.begin = &AssetLayerSink::begin;
+    sink.record = &AssetLayerSink::record;
+    sink.end = &AssetLayerSink::end;
 
-        for (const QJsonValue& valueIt : features) {
+    auto res = streamInpFile(pathInpFileWater.toStdString().c_str(),
+                             tmp1.toStdString().c_str(),
+                             tmp2.toStdString().c_str(),
+                             &sink);
 
-            QJsonObject value = valueIt.toObject();
+    // The sink replaces the GeoJSON file at the end of the output, if EPANET stopped before it the previous file is kept
+    closeJSONSink(&assetSink.jsonSink, 0);
 
-            // Get the type
-            QJsonObject assetProperties = value["properties"].toObject();
+    if (res != 0)
+    {
+        this->errorMessage("Failed to read the network in the inp file: "+ pathInpFileWater);
+        return false;
+    }
 
-            if (!jsonObject.contains("type")) {
-                this->errorMessage("The Json object is missing the 'type' key that defines the asset type");
-                return false;
-            }
+    QJsonObject crs;
 
-            QString assetType = assetProperties["type"].toString();
+    QgsCoordinateReferenceSystem qgsCRS = QgsCoordinateReferenceSystem(defaultCRS);
 
-            if (!assetDictionary.contains(assetType))
-            {
-                assetDictionary[assetType] = QList<QJsonObject>({value});
-            }
-            else
-            {
-                QList<QJsonObject>& featList = assetDictionary[assetType];
-                featList.append(value);
-            }
-        }
+    if (!qgsCRS.isValid()){
+        qgsCRS.createFromOgcWmsCrs(defaultCRS);
     }
-    else{
-        this->errorMessage("Failed to open file at location: "+ geoJsonFileName);
-        return false;
+
+    if (!qgsCRS.isValid()){
+        QString msg = "Default CRS is not valid. Choose an existing CRS.";
+        errorMessage(msg);
     }
 
+    crsSelectorWidget->setCRS(qgsCRS);
+
+    const auto& assetDictionary = assetSink.featuresByType;
+
+    // Unlink the layer files of a previous load, ogr keeps the data of any layer that still has a file open until it is closed
+    this->removeMemLayerFiles();
+
     for (auto it = assetDictionary.begin(); it != assetDictionary.end(); ++it)
     {
         QString assetType = it.key();
-        QList<QJsonObject> features = it.value();
-
-        QJsonArray featuresArray;
-        for (const auto& obj : features) {
-            featuresArray.append(obj);
-        }
+        const QJsonArray& features = it.value();
 
         QJsonObject assetDictionary;
         assetDictionary["type"]="FeatureCollection";
-        assetDictionary["features"]=featuresArray;
+        assetDictionary["features"]=features;
 
         if(!crs.isEmpty())
             assetDictionary["crs"]=crs;
 
-        //QDir tempDir(QDir::tempPath());
-		QTemporaryFile tempFile;
-		
-		tempFile.setFileTemplate(tempFile.fileTemplate() + "_" + assetType + ".geojson");
-        //QString outputFile = tempDir.absolutePath() + QDir::separator() + assetType + ".geojson";
+        // The layer of each asset type is handed to ogr as an in-memory GDAL file, so that it is not written to and read back from the disk
+        QByteArray layerData = QJsonDocument(assetDictionary).toJson(QJsonDocument::Compact);
 
-		if (tempFile.open())
-        {
+        QString outputFile = "/vsimem/R2D_InpFile_" + QString::number(reinterpret_cast<quintptr>(this)) + "_" + assetType + ".geojson";
+        QByteArray outputFilePath = outputFile.toUtf8();
 
-            QString outputFile = tempFile.fileName();
+        // GDAL takes ownership of the copy of the data and frees it when the file is unlinked
+        VSIUnlink(outputFilePath.constData());
+        GByte* memData = static_cast<GByte*>(CPLMalloc(layerData.size()));
+        memcpy(memData, layerData.constData(), layerData.size());
 
-            // Write the file to the folderd
-            QJsonDocument doc(assetDictionary);
-            tempFile.write(doc.toJson());
+        VSILFILE* memFile = VSIFileFromMemBuffer(outputFilePath.constData(), memData, layerData.size(), TRUE);
 
-			// Close the file
-            tempFile.close();
+        if (memFile != nullptr)
+        {
+            VSIFCloseL(memFile);
+            memLayerFiles.append(outputFile);
 
             this->statusMessage("Loading asset type "+assetType+" with "+ QString::number(features.size())+" features");
 
@@ -599,13 +662,10 @@ bool InpFileWaterInputWidget::loadAssetData()
             theAssetLayerList.append(thisAssetWidget->getMainLayer());
 
             mainAssetWidget->addComponent(assetType, thisAssetWidget);
-
-
-            // Automatically delete the temporary file when it goes out of scope or when the application exits
-            tempFile.setAutoRemove(true);
         }
         else {
-            this->errorMessage("Failed to create temporary file for " + assetType);
+            CPLFree(memData);
+            this->errorMessage("Failed to create the in-memory layer file for " + assetType);
         }
 
 
@@ -91,6 +91,10 @@ protected:
     QList<GISAssetInputWidget*> theAssetInputWidgetList;
     QList<QgsMapLayer*> theAssetLayerList;
 
+    // In-memory GDAL files of the asset type layers, they live as long as their layers since ogr may open them again
+    QStringList memLayerFiles;
+    void removeMemLayerFiles(void);
+
     QString componentType;
     QString appType;
 
@@ -68,6 +68,7 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 #include <QLineEdit>
 #include <QCheckBox>
 #include <QFile>
+#include <QFileInfo>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonParseError>
@@ -77,6 +78,13 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 #include <QGroupBox>
 #include <ResultsWidget.h>
 #include "ResidualDemandResults.h"
+#include "TrafficAssignment.h"
+
+#include <QApplication>
+#include <QHash>
+#include <QTextStream>
+
+#include <cmath>
 
 ResidualDemandWidget::ResidualDemandWidget(QWidget *parent) : SimCenterAppWidget(parent)
 {
@@ -173,10 +181,19 @@ ResidualDemandWidget::ResidualDemandWidget(QWidget *parent) : SimCenterAppWidget
     mainLayout->addWidget(createAnimationCheckbox, numRow, 3, 1, 1);
     numRow++;
 
+    //8. Congestion preview with the native traffic assignment
+    previewButton = new QPushButton("Preview Congestion");
+    previewButton->setToolTip("Assigns the pre-event demand to the undamaged road network and the post-event demand to the network with the damage of the first realization to analyze, from the results of the last workflow run");
+    previewSummaryLabel = new QLabel();
+    mainLayout->addWidget(previewButton, numRow, 0, 1, 1);
+    mainLayout->addWidget(previewSummaryLabel, numRow, 1, 1, 4);
+    numRow++;
+
     mainLayout->setRowStretch(numRow, 1);
     mainLayout->setColumnStretch(5, 1);
 
     connect(postEventODCheckBox, &SC_CheckBox::stateChanged, this, &ResidualDemandWidget::togglePostEventODFileEdit);
+    connect(previewButton, &QPushButton::clicked, this, &ResidualDemandWidget::previewCongestion);
 //    theR2DResultsWidget = WorkflowAppR2D::getInstance()->getTheResultsWidget();
 //    theResidualDemandResultsWidget = new ResidualDemandResults(theR2DResultsWidget);
 
@@ -217,6 +234,7 @@ void ResidualDemandWidget::clear(void)
     twoWayEdgeCheckbox->setChecked(false);
     createAnimationCheckbox->setChecked(true);
     damageInputMethodComboBox->setCurrentIndex(0);
+    previewSummaryLabel->clear();
     if (resultWidget != nullptr) {
         resultWidget->clear();
     }
@@ -238,6 +256,441 @@ void ResidualDemandWidget::selectComponents(void)
     }
 }
 
+int ResidualDemandWidget::readRoadNetwork(const QString& pathToFile, TrafficAssignment& network, QStringList& linkIDs, QStringList& nodeIDs, QString& err)
+{
+    linkIDs.clear();
+    nodeIDs.clear();
+
+    QFile file(pathToFile);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        err = "Could not open the road network edges file " + pathToFile;
+        return -1;
+    }
+
+    QJsonParseError parseError;
+    QJsonDocument jsonDoc = QJsonDocument::fromJson(file.readAll(), &parseError);
+    file.close();
+
+    if (parseError.error != QJsonParseError::NoError) {
+        err = "JSON parse error in the road network edges file: " + parseError.errorString();
+        return -1;
+    }
+
+    // Defaults for edges without a speed or capacity, the speed is in mph and the capacity in vehicles per hour per lane
+    const double defaultSpeed = 25.0;
+    const double laneCapacity = 1800.0;
+
+    QHash<QString,int> nodeIndices;
+    auto getNodeIndex = [&](const QJsonValue& value) {
+        QString nodeID = value.toVariant().toString();
+        auto it = nodeIndices.constFind(nodeID);
+        if (it != nodeIndices.constEnd())
+            return it.value();
+
+        nodeIndices.insert(nodeID, nodeIDs.size());
+        nodeIDs.append(nodeID);
+        return nodeIDs.size() - 1;
+    };
+
+    QVector<RoadLink> links;
+    QJsonArray features = jsonDoc.object().value("features").toArray();
+    for (const QJsonValue &feature : features) {
+        QJsonObject properties = feature.toObject().value("properties").toObject();
+
+        if (!properties.contains("start_nid") || !properties.contains("end_nid")) {
+            err = "Every edge of the road network must have a \"start_nid\" and an \"end_nid\" property";
+            return -1;
+        }
+
+        RoadLink link;
+        link.startNode = getNodeIndex(properties.value("start_nid"));
+        link.endNode = getNodeIndex(properties.value("end_nid"));
+
+        // The length is in m and the speed in mph, as in the residual demand backend
+        double speed = properties.value("maxspeed").toVariant().toDouble();
+        if (speed <= 0.0)
+            speed = defaultSpeed;
+
+        link.freeFlowTime = properties.value("length").toVariant().toDouble()/(speed*0.44704);
+
+        link.capacity = properties.value("capacity").toVariant().toDouble();
+        if (link.capacity <= 0.0)
+            link.capacity = std::max(properties.value("lanes").toVariant().toDouble(), 1.0)*laneCapacity;
+
+        QString linkID = properties.value("id").toVariant().toString();
+
+        links.append(link);
+        linkIDs.append(linkID);
+
+        if (twoWayEdgeCheckbox->isChecked()) {
+            std::swap(link.startNode, link.endNode);
+            links.append(link);
+            linkIDs.append(linkID);
+        }
+    }
+
+    if (links.isEmpty()) {
+        err = "The road network edges file " + pathToFile + " does not have any edges";
+        return -1;
+    }
+
+    return network.setNetwork(nodeIDs.size(), links, err);
+}
+
+
+int ResidualDemandWidget::readTrips(const QString& pathToFile, const QHash<QString,int>& nodeIndices, const QVector<int>& hours, QVector<RoadTrip>& trips, QStringList& agentIDs, QString& err)
+{
+    trips.clear();
+    agentIDs.clear();
+
+    QFile file(pathToFile);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        err = "Could not open the traffic demand file " + pathToFile;
+        return -1;
+    }
+
+    QTextStream in(&file);
+    QStringList headers = in.readLine().trimmed().split(",");
+    int agentIndex = headers.indexOf("agent_id");
+    int originIndex = headers.indexOf("origin_nid");
+    int destinationIndex = headers.indexOf("destin_nid");
+    int hourIndex = headers.indexOf("hour");
+
+    if (originIndex == -1 || destinationIndex == -1) {
+        err = "Columns named \"origin_nid\" or \"destin_nid\" not found in the traffic demand file " + pathToFile;
+        return -1;
+    }
+
+    // Trips from or to nodes that are not on the road network are skipped
+    int row = 0;
+    while (!in.atEnd()) {
+        QStringList values = in.readLine().trimmed().split(",");
+        if (values.size() <= std::max(originIndex, destinationIndex))
+            continue;
+
+        QString agentID = (agentIndex != -1 && agentIndex < values.size()) ? values[agentIndex] : QString::number(row);
+        ++row;
+
+        RoadTrip trip;
+        if (hourIndex != -1 && hourIndex < values.size())
+            trip.hour = values[hourIndex].toInt();
+
+        if (!hours.isEmpty() && !hours.contains(trip.hour))
+            continue;
+
+        auto origin = nodeIndices.constFind(values[originIndex]);
+        auto destination = nodeIndices.constFind(values[destinationIndex]);
+        if (origin == nodeIndices.constEnd() || destination == nodeIndices.constEnd())
+            continue;
+
+        trip.origin = origin.value();
+        trip.destination = destination.value();
+
+        trips.append(trip);
+        agentIDs.append(agentID);
+    }
+
+    file.close();
+
+    return 0;
+}
+
+
+int ResidualDemandWidget::readCapacityFactors(const QString& pathToDamageFile, const QString& pathToCapacityMap, const QStringList& linkIDs, QVector<double>& capacityFactors, int& numReducedLinks, QString& err)
+{
+    capacityFactors.fill(1.0, linkIDs.size());
+    numReducedLinks = 0;
+
+    auto readJsonObject = [&err](const QString& pathToFile, QJsonObject& obj) {
+        QFile file(pathToFile);
+        if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+            err = "Could not open the file " + pathToFile;
+            return -1;
+        }
+
+        QJsonParseError parseError;
+        QJsonDocument jsonDoc = QJsonDocument::fromJson(file.readAll(), &parseError);
+        file.close();
+
+        if (parseError.error != QJsonParseError::NoError || !jsonDoc.isObject()) {
+            err = "JSON parse error in the file " + pathToFile + ": " + parseError.errorString();
+            return -1;
+        }
+
+        obj = jsonDoc.object();
+        return 0;
+    };
+
+    QJsonObject capacityMap;
+    QJsonObject damageResults;
+    if (readJsonObject(pathToCapacityMap, capacityMap) != 0 || readJsonObject(pathToDamageFile, damageResults) != 0)
+        return -1;
+
+    // The results of a workflow run group the assets by their type under the transportation network
+    if (damageResults.contains("TransportationNetwork"))
+        damageResults = damageResults.value("TransportationNetwork").toObject();
+
+    QHash<QString,QVector<int>> linksByID;
+    for (int i = 0; i < linkIDs.size(); ++i)
+        linksByID[linkIDs.at(i)].append(i);
+
+    for (auto assetType = damageResults.constBegin(); assetType != damageResults.constEnd(); ++assetType) {
+
+        if (!capacityMap.contains(assetType.key()))
+            continue;
+
+        QJsonObject typeCapacities = capacityMap.value(assetType.key()).toObject();
+        QJsonObject assets = assetType.value().toObject();
+
+        for (auto asset = assets.constBegin(); asset != assets.constEnd(); ++asset) {
+            QJsonObject assetObj = asset.value().toObject();
+
+            // The critical damage state is the most likely one if it is given, otherwise the largest damage state of the components of the asset
+            int damageState = -1;
+            QJsonObject damage = assetObj.value("Damage").toObject();
+            QJsonObject r2dRes = assetObj.value("R2Dres").toObject();
+            if (damage.contains("R2Dres_MostLikelyCriticalDamageState")) {
+                damageState = damage.value("R2Dres_MostLikelyCriticalDamageState").toVariant().toInt();
+            } else if (!damage.isEmpty()) {
+                for (auto it = damage.constBegin(); it != damage.constEnd(); ++it)
+                    damageState = std::max(damageState, it.value().toVariant().toInt());
+            } else if (r2dRes.contains("R2Dres_MostLikelyCriticalDamageState")) {
+                damageState = r2dRes.value("R2Dres_MostLikelyCriticalDamageState").toVariant().toInt();
+            }
+
+            if (damageState < 0)
+                continue;
+
+            QString dsKey = QString::number(damageState);
+            if (!typeCapacities.contains(dsKey))
+                dsKey = "DS" + dsKey;
+
+            if (!typeCapacities.contains(dsKey)) {
+                err = "The capacity map does not have the damage state " + QString::number(damageState) + " of the asset type " + assetType.key();
+                return -1;
+            }
+
+            double factor = typeCapacities.value(dsKey).toVariant().toDouble();
+
+            // Bridges and tunnels carry the road that they are on
+            QString roadID = asset.key();
+            QJsonObject generalInformation = assetObj.value("GeneralInformation").toObject();
+            if (generalInformation.contains("RoadID"))
+                roadID = generalInformation.value("RoadID").toVariant().toString();
+
+            for (auto&& link : linksByID.value(roadID)) {
+                if (factor < capacityFactors[link]) {
+                    if (capacityFactors[link] == 1.0)
+                        ++numReducedLinks;
+                    capacityFactors[link] = std::max(factor, 0.0);
+                }
+            }
+        }
+    }
+
+    return 0;
+}
+
+
+void ResidualDemandWidget::previewCongestion(void)
+{
+    previewSummaryLabel->clear();
+
+    QString err;
+    TrafficAssignment network;
+    QStringList linkIDs;
+    QStringList nodeIDs;
+
+    if (this->readRoadNetwork(pathEdgesFile->getFilename(), network, linkIDs, nodeIDs, err) != 0) {
+        this->errorMessage(err);
+        return;
+    }
+
+    QHash<QString,int> nodeIndices;
+    for (int i = 0; i < nodeIDs.size(); ++i)
+        nodeIndices.insert(nodeIDs.at(i), i);
+
+    QVector<int> hours;
+    QStringList hourList = simulationHourList->text().split(',', QString::SkipEmptyParts);
+    for (const QString &str : hourList) {
+        bool ok;
+        int hour = str.trimmed().toInt(&ok);
+        if (!ok) {
+            this->errorMessage(QString("Invalid Hour List input: ") + str);
+            return;
+        }
+        hours.append(hour);
+    }
+
+    QVector<RoadTrip> preTrips;
+    QVector<RoadTrip> postTrips;
+    QStringList preAgentIDs;
+    QStringList postAgentIDs;
+
+    if (this->readTrips(pathODFilePre->getFilename(), nodeIndices, hours, preTrips, preAgentIDs, err) != 0) {
+        this->errorMessage(err);
+        return;
+    }
+
+    if (postEventODCheckBox->isChecked()) {
+        postTrips = preTrips;
+        postAgentIDs = preAgentIDs;
+    } else if (this->readTrips(pathODFilePost->getFilename(), nodeIndices, hours, postTrips, postAgentIDs, err) != 0) {
+        this->errorMessage(err);
+        return;
+    }
+
+    // The damage of the first realization to analyze is read from the results of the last workflow run
+    IDRangeSet realizations;
+    if (realizations.fromString(realizationInputWidget->text(), err) != 0 || realizations.isEmpty()) {
+        this->errorMessage("Select the realizations to analyze, the preview applies the damage of the first one. " + err);
+        return;
+    }
+
+    const qint64 realization = realizations.first();
+    QString resultsDir = SimCenterPreferences::getInstance()->getLocalWorkDir() + QDir::separator() + "tmp.SimCenter" + QDir::separator() + "Results";
+    QString pathToDamageFile = resultsDir + QDir::separator() + "Results_" + QString::number(realization) + ".json";
+
+    if (!QFileInfo::exists(pathToDamageFile)) {
+        this->errorMessage("The damage of realization " + QString::number(realization) + " is not in " + resultsDir
+                           + ", run the workflow with the damage and loss of the transportation network before the preview");
+        return;
+    }
+
+    QVector<double> capacityFactors;
+    int numReducedLinks = 0;
+    if (this->readCapacityFactors(pathToDamageFile, pathCapacityMapFile->getFilename(), linkIDs, capacityFactors, numReducedLinks, err) != 0) {
+        this->errorMessage(err);
+        return;
+    }
+
+    this->statusMessage("Assigning " + QString::number(preTrips.size()) + " pre-event and " + QString::number(postTrips.size())
+                        + " post-event trips to a road network of " + QString::number(network.getNumLinks()) + " links, "
+                        + QString::number(numReducedLinks) + " of them with a reduced capacity in realization " + QString::number(realization));
+    QApplication::processEvents();
+
+    // The pre-event demand is assigned to the undamaged network and the post-event demand to the damaged one, as in the residual demand backend
+    QVector<double> undamagedVolumes, undamagedTimes, damagedVolumes, damagedTimes;
+    int undamagedFirstHour = 0, undamagedNumHours = 0, damagedFirstHour = 0, damagedNumHours = 0;
+
+    if (network.assign(preTrips, QVector<double>(), undamagedVolumes, undamagedTimes, undamagedFirstHour, undamagedNumHours, err) != 0) {
+        this->errorMessage(err);
+        return;
+    }
+
+    if (network.assign(postTrips, capacityFactors, damagedVolumes, damagedTimes, damagedFirstHour, damagedNumHours, err) != 0) {
+        this->errorMessage(err);
+        return;
+    }
+
+    QString previewDir = SimCenterPreferences::getInstance()->getLocalWorkDir() + QDir::separator() + "ResidualDemandPreview";
+    QDir().mkpath(previewDir);
+
+    // Link volumes, volume-to-capacity ratios, and travel times of each hour
+    const int numLinks = network.getNumLinks();
+
+    auto getVolume = [numLinks](const QVector<double>& volumes, const int firstHour, const int numHours, const int hour, const int link) {
+        if (hour < firstHour || hour >= firstHour + numHours)
+            return 0.0;
+        return volumes[(hour - firstHour)*numLinks + link];
+    };
+
+    const int firstHour = std::min(undamagedNumHours > 0 ? undamagedFirstHour : damagedFirstHour, damagedNumHours > 0 ? damagedFirstHour : undamagedFirstHour);
+    const int lastHour = std::max(undamagedFirstHour + undamagedNumHours, damagedFirstHour + damagedNumHours);
+
+    QFile linkFile(previewDir + QDir::separator() + "link_congestion.csv");
+    if (!linkFile.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        this->errorMessage("Error: Cannot write the link congestion file in " + previewDir);
+        return;
+    }
+
+    int numCongestedLinks = 0;
+    QTextStream linkStream(&linkFile);
+    linkStream << "edge_id,start_nid,end_nid,hour,capacity,free_flow_time,capacity_damaged,volume_undamaged,vc_ratio_undamaged,travel_time_undamaged,volume_damaged,vc_ratio_damaged,travel_time_damaged\n";
+
+    for (int hour = firstHour; hour < lastHour; ++hour) {
+        for (int i = 0; i < numLinks; ++i) {
+            RoadLink link = network.getLink(i);
+            double damagedCapacity = link.capacity*capacityFactors.at(i);
+            double undamagedVolume = getVolume(undamagedVolumes, undamagedFirstHour, undamagedNumHours, hour, i);
+            double damagedVolume = getVolume(damagedVolumes, damagedFirstHour, damagedNumHours, hour, i);
+
+            if (damagedVolume > damagedCapacity)
+                ++numCongestedLinks;
+
+            // A closed link carries no traffic and has no finite travel time
+            double damagedRatio = damagedCapacity > 0.0 ? damagedVolume/damagedCapacity : 0.0;
+            QString damagedTime = damagedCapacity > 0.0 ? QString::number(network.getLinkTravelTime(link.freeFlowTime, damagedVolume, damagedCapacity)) : QString("inf");
+
+            linkStream << linkIDs.at(i) << "," << nodeIDs.at(link.startNode) << "," << nodeIDs.at(link.endNode) << "," << hour << ","
+                       << link.capacity << "," << link.freeFlowTime << "," << damagedCapacity << ","
+                       << undamagedVolume << "," << undamagedVolume/link.capacity << "," << network.getLinkTravelTime(link.freeFlowTime, undamagedVolume, link.capacity) << ","
+                       << damagedVolume << "," << damagedRatio << "," << damagedTime << "\n";
+        }
+    }
+
+    linkFile.close();
+
+    // Trip delays in the schema of the trip_info_compare.csv of the residual demand backend, the trips are matched by their agent id
+    QHash<QString,int> preTripIndices;
+    for (int i = 0; i < preAgentIDs.size(); ++i)
+        preTripIndices.insert(preAgentIDs.at(i), i);
+
+    QFile tripFile(previewDir + QDir::separator() + "trip_info_compare.csv");
+    if (!tripFile.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        this->errorMessage("Error: Cannot write the trip comparison file in " + previewDir);
+        return;
+    }
+
+    int numIncompleteTrips = 0;
+    int numDelays = 0;
+    double totalDelay = 0.0;
+    double totalDelayRatio = 0.0;
+
+    QTextStream tripStream(&tripFile);
+    tripStream << "agent_id,origin_nid,destin_nid,hour,travel_time_used_undamaged,travel_time_used_damaged,delay_duration,delay_ratio\n";
+
+    for (int i = 0; i < postAgentIDs.size(); ++i) {
+        auto it = preTripIndices.constFind(postAgentIDs.at(i));
+        if (it == preTripIndices.constEnd())
+            continue;
+
+        const RoadTrip& trip = postTrips.at(i);
+        double undamagedTime = undamagedTimes.at(it.value());
+        double damagedTime = damagedTimes.at(i);
+
+        tripStream << postAgentIDs.at(i) << "," << nodeIDs.at(trip.origin) << "," << nodeIDs.at(trip.destination) << "," << trip.hour << ",";
+
+        if (std::isinf(undamagedTime) || std::isinf(damagedTime)) {
+            ++numIncompleteTrips;
+            tripStream << (std::isinf(undamagedTime) ? QString("inf") : QString::number(undamagedTime)) << ","
+                       << (std::isinf(damagedTime) ? QString("inf") : QString::number(damagedTime)) << ",inf,inf\n";
+            continue;
+        }
+
+        double delay = damagedTime - undamagedTime;
+        double delayRatio = undamagedTime > 0.0 ? delay/undamagedTime : 0.0;
+
+        ++numDelays;
+        totalDelay += delay;
+        totalDelayRatio += delayRatio;
+
+        tripStream << undamagedTime << "," << damagedTime << "," << delay << "," << delayRatio << "\n";
+    }
+
+    tripFile.close();
+
+    QString meanDelay = numDelays > 0 ? QString::number(totalDelay/numDelays, 'f', 1) : QString("-");
+    QString meanDelayRatio = numDelays > 0 ? QString::number(totalDelayRatio/numDelays, 'f', 3) : QString("-");
+
+    previewSummaryLabel->setText("Realization " + QString::number(realization) + ", mean delay: " + meanDelay + " s, mean delay ratio: " + meanDelayRatio
+                                 + ", incomplete trips: " + QString::number(numIncompleteTrips)
+                                 + ", link hours over capacity: " + QString::number(numCongestedLinks));
+
+    this->statusMessage("Wrote the congestion preview to " + previewDir);
+}
+
+
 void ResidualDemandWidget::handleInputTypeChanged(){
     if (damageInputMethodComboBox->currentIndex()==1){
         realizationToAnalyzeLabel->hide();
@@ -40,6 +40,10 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 // Written by: Jinyan Zhao, Sina Naeimi
 #include "SimCenterAppWidget.h"
 
+#include <QHash>
+#include <QStringList>
+#include <QVector>
+
 class VisualizationWidget;
 class SC_DoubleLineEdit;
 class SC_FileEdit;
@@ -55,6 +59,8 @@ class QLabel;
 class QGroupBox;
 class ResidualDemandResults;
 class ResultsWidget;
+class TrafficAssignment;
+struct RoadTrip;
 
 
 class ResidualDemandWidget : public SimCenterAppWidget
@@ -83,8 +89,22 @@ private slots:
   void handleInputTypeChanged(void);
     void togglePostEventODFileEdit(int state);
     void selectComponents(void);
+
+    // Assigns the pre-event demand to the undamaged road network and the post-event demand to the network damaged by the first realization to analyze, with the native traffic assignment
+    // The link congestion and the trip delays are written to the working directory
+    void previewCongestion(void);
 private:
 
+    // Reads the links of the edges GeoJSON file, the node ids are numbered in the order that they are found
+    int readRoadNetwork(const QString& pathToFile, TrafficAssignment& network, QStringList& linkIDs, QStringList& nodeIDs, QString& err);
+
+    // Reads the trips of an origin-destination file, only the trips in the simulation hours are kept if any are given
+    int readTrips(const QString& pathToFile, const QHash<QString,int>& nodeIndices, const QVector<int>& hours, QVector<RoadTrip>& trips, QStringList& agentIDs, QString& err);
+
+    // Reads the damage states of a realization from the results of a workflow run and maps them to a capacity factor for each link with the capacity map
+    // Links without a damaged asset keep their full capacity, the factor of a link with several assets is the smallest one
+    int readCapacityFactors(const QString& pathToDamageFile, const QString& pathToCapacityMap, const QStringList& linkIDs, QVector<double>& capacityFactors, int& numReducedLinks, QString& err);
+
 //SC_DirEdit *damageStateDataSrource;
 AssetInputDelegate *realizationInputWidget;
 SC_DirEdit *resultsDir;
@@ -99,6 +119,8 @@ SC_CheckBox *twoWayEdgeCheckbox;
 SC_CheckBox *createAnimationCheckbox;
 SC_ComboBox *damageInputMethodComboBox;
 QPushButton *runButton;
+QPushButton *previewButton;
+QLabel *previewSummaryLabel;
 QLabel *realizationToAnalyzeLabel;
 QGroupBox* theGroupBox;
 QString appInputPath;
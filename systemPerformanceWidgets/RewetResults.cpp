@@ -48,6 +48,7 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 #include "REmpiricalProbabilityDistribution.h"
 #include "TablePrinter.h"
 #include "TableNumberItem.h"
+#include "TimeSeriesAggregator.h"
 #include "VisualizationWidget.h"
 #include "WorkflowAppR2D.h"
 #include "Utils/ProgramOutputDialog.h"
@@ -166,9 +167,9 @@ int RewetResults::addResultSubtab(QString name, QWidget* existTab, QString &dirN
         QJsonObject jsonObj = jsonDoc.object();
         
 
-        // Create a map to store the series. The first map is for the metrics, the second map is for the realizations
+        // Create a map to store the series. The first map is for the metrics, the second map is for the mean, percentile and sampled realization curves
         allSeiries = new QMap<QString, QMap<QString, QLineSeries *>>();
-        // Read series data and store them in the map
+        // Aggregate the realizations and store the curves in the map
         int ret_value =  extractDataFramJSON(jsonObj, allSeiries);
 
         // Set titles for the chart
@@ -178,10 +179,8 @@ int RewetResults::addResultSubtab(QString name, QWidget* existTab, QString &dirN
         // titles.insert("vAxis", "Percent");    
 
         // sCreate SC_TimeSeries Widget
+        // The mean and percentile curves are already in the series, computed over all of the realizations
         chart = new SC_TimeSeriesResultChart(allSeiries, rewetResultWidget);
-        // Add mean and 90th percentile lines
-        chart->addMean("Mean", QColor("Black"), Qt::SolidLine, 3);
-        chart->addPercentile("90th Percentile", 0.95, QColor("red"), Qt::CustomDashLine, 3);
         // Add the chart to the layout
         rewetWidgetLayout->addWidget(chart);
 
@@ -243,69 +242,104 @@ int RewetResults::extractDataFramJSON(QJsonObject jsonObj, QMap<QString, QMap<QS
             metricName = metricKey;
         }
         
-        metricObject = metricObject["Data"].toObject();
+        const QJsonObject dataObject = metricObject["Data"].toObject();
 
-        // QMap<QString, QMap<QString, QLineSeries *>> *allSeiries = new QMap<QString, QMap<QString, QLineSeries *>>();
+        QStringList realizationKeys = dataObject.keys();
+        if (realizationKeys.isEmpty())
+            continue;
 
-        QMap<QString, QLineSeries *> seriesMap;
-
-        // Iterate over the QN values
-        for (auto realizationIT = metricObject.begin(); realizationIT != metricObject.end(); ++realizationIT) {
+        // Reads the time series of one realization, called from worker threads
+        auto realizationReader = [&dataObject](const QString &realizationKey, QMap<QString, RealizationSeries> &series, QString &err) {
 
-            // Create a new QLineSeries        
-            QLineSeries *series = new QLineSeries();
-            
-            // Get the key of the realization
-            QString realizationKey = realizationIT.key();
             bool ConversionStatus;
-            int realizationCounter = realizationKey.toInt(&ConversionStatus, 10);
+            realizationKey.toInt(&ConversionStatus, 10);
             // Check if the conversion was successful
             if (!ConversionStatus){
+                err = "rewetResults - realization key is not an integer: " + realizationKey;
                 return -1;
             }
-                                        
+
             // Get the value of the realization
-            QJsonObject RealizationObject = metricObject[realizationKey].toObject();
-
-            // Collect the keys into a list
-            QStringList timeKeys = RealizationObject.keys();
-            // Convert the keys to floats and store them in a list of pairs (float, QString)
-            QList<QPair<float, QString>> timePairs;
-            for (const QString &key : timeKeys) {
-                bool ConversionStatus;
-                float time = key.toFloat(&ConversionStatus);
+            QJsonObject RealizationObject = dataObject.value(realizationKey).toObject();
+
+            // Convert the keys to floats and store them in a list of pairs (float, double)
+            QList<QPair<float, double>> timePairs;
+            for (auto timeIT = RealizationObject.constBegin(); timeIT != RealizationObject.constEnd(); ++timeIT) {
+                float time = timeIT.key().toFloat(&ConversionStatus);
                 if (!ConversionStatus) {
-                    qDebug() << "rewetResults - Failed to convert time to float: " + key;
+                    err = "rewetResults - Failed to convert time to float: " + timeIT.key();
+                    return -1;
+                }
+
+                if (!timeIT.value().isDouble()) {
+                    err = "rewetResults - metricValue is not double at time " + timeIT.key();
                     return -1;
                 }
-                timePairs.append(qMakePair(time, key));
+
+                timePairs.append(qMakePair(time, timeIT.value().toDouble()));
             }
 
-            // Sort the list of pairs in descending order based on the float values
-            std::sort(timePairs.begin(), timePairs.end(), [](const QPair<float, QString> &a, const QPair<float, QString> &b) {
+            // Sort the list of pairs in ascending order based on the time
+            std::sort(timePairs.begin(), timePairs.end(), [](const QPair<float, double> &a, const QPair<float, double> &b) {
                 return a.first < b.first;
             });
 
-            // Iterate over the sorted list of pairs
-            for (const QPair<float, QString> &pair : timePairs) {
-                float time = pair.first;
-                QString timeValue = pair.second;
+            RealizationSeries &realizationSeries = series["metric"];
+            for (const QPair<float, double> &pair : timePairs) {
+                realizationSeries.time.append(pair.first);
+                realizationSeries.values.append(pair.second * 100); // Sina added here to convert ratio to percent.
+            }
 
-                // Get the value of the time
-                QJsonValue metricValue = RealizationObject[timeValue];
-            
-                double metric;
-                if (metricValue.isDouble()) {
-                    metric = metricValue.toDouble();
-                } else {
-                    qDebug() << "rewetResults - metricValue is not double: " + QString::number(metric);
-                    return -1;
-                }
+            return 0;
+        };
 
-                series->append(time, metric * 100); // Sina added here to convert ratio to percent.
-            }
-            seriesMap[QString(realizationIT.key())] = series;
+        // The time axis resolves the time steps of the first realization
+        QVector<double> firstTimes;
+        QJsonObject firstRealization = dataObject.value(realizationKeys.first()).toObject();
+        for (auto timeIT = firstRealization.constBegin(); timeIT != firstRealization.constEnd(); ++timeIT)
+            firstTimes.append(timeIT.key().toDouble());
+
+        double startTime = firstTimes.isEmpty() ? 0.0 : *std::min_element(firstTimes.begin(), firstTimes.end());
+        double timeStep = TimeSeriesAggregator::suggestTimeStep(firstTimes);
+
+        QMap<QString, TimeSeriesAggregator> aggregators;
+        QString err;
+        QStringList skippedRealizations;
+        if (TimeSeriesAggregator::aggregateRealizations(realizationKeys, realizationReader, startTime, timeStep, aggregators, err, 5, &skippedRealizations) != 0) {
+            qDebug() << err;
+            return -1;
         }
+
+        // A realization that could not be read is left out of the curves instead of dropping the chart
+        for (const QString &skipped : skippedRealizations)
+            qDebug() << "rewetResults - skipping the realization " + skipped;
+
+        const TimeSeriesAggregator &metricAggregator = aggregators["metric"];
+        QVector<double> timeAxis = metricAggregator.getTimeAxis();
+
+        auto createSeries = [&timeAxis](const QVector<double> &values, const QString &name, const QPen &pen) {
+            QLineSeries *series = new QLineSeries();
+            QVector<QPointF> points(timeAxis.size());
+            for (int i = 0; i < timeAxis.size(); ++i)
+                points[i] = QPointF(timeAxis[i], values[i]);
+            series->replace(points);
+            series->setName(name);
+            series->setPen(pen);
+            return series;
+        };
+
+        QMap<QString, QLineSeries *> seriesMap;
+
+        // A few sampled realizations instead of every realization
+        auto sampledRealizations = metricAggregator.getSampledRealizations();
+        for (auto it = sampledRealizations.constBegin(); it != sampledRealizations.constEnd(); ++it)
+            seriesMap[it.key()] = createSeries(it.value(), it.key(), QPen(Qt::blue));
+
+        // Mean and 5th-95th percentile band over all of the realizations, styled as the addMean and addPercentile curves of the chart
+        seriesMap["Mean"] = createSeries(metricAggregator.getMean(), "Mean", QPen(QColor("Black"), 3, Qt::SolidLine));
+        seriesMap["5th Percentile"] = createSeries(metricAggregator.getPercentile(0.05), "5th Percentile", QPen(QColor("red"), 3, Qt::DashLine));
+        seriesMap["95th Percentile"] = createSeries(metricAggregator.getPercentile(0.95), "95th Percentile", QPen(QColor("red"), 3, Qt::DashLine));
+
         allSeiries->insert(metricName, seriesMap);
 
     }